@@ -10,7 +10,7 @@ bl_info = {
 }
 
 import bpy
-from . ui   import panels, workspace, piano_roll, beat_grid
+from . ui   import panels, workspace, piano_roll, beat_grid, spectrum
 from . core import register as core_register
 
 
@@ -36,6 +36,7 @@ def register():
     workspace.register()
     piano_roll.register()
     beat_grid.register()
+    spectrum.register()
     core_register.register()
 
     if on_load_post not in bpy.app.handlers.load_post:
@@ -70,6 +71,7 @@ def unregister():
     bpy.app.timers.register(_cleanup, first_interval=0.1)
 
     core_register.unregister()
+    spectrum.unregister()
     beat_grid.unregister()
     piano_roll.unregister()
     workspace.unregister()
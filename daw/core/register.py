@@ -3,28 +3,30 @@ core/register.py
 
 Motor de áudio da DAW — iniciado automaticamente ao ativar o addon.
 Fica ativo o tempo todo sem necessidade de interação do usuário.
-Reconecta automaticamente se a DLL cair.
+
+O motor roda em outro processo (daw_engine/core/engine_process.py): um
+crash nele não derruba o Blender e o callback de áudio não disputa o GIL
+com a UI. A DLL, quando existe, é carregada lá. Um heartbeat verificado a
+cada 0.25 s reinicia o processo se ele cair ou travar.
 """
 
 import bpy
-import os
-import sys
-import ctypes
 import traceback
 from pathlib import Path
 from bpy.props import FloatProperty, IntProperty, StringProperty, BoolProperty
 
+from ..daw_engine.core.engine_process import CHECK_INTERVAL, ENGINE_PROCESS
+
 # ═══════════════════════════════════════════════════════════════
 #  SINGLETON DO ENGINE
 # ═══════════════════════════════════════════════════════════════
 
-_engine = None          # instância DAWEngine
-_engine_ok = False      # True = rodando sem erros
-_dll_directory_handle = None  # Guarda o handle do diretório de DLLs do Windows
+_engine = None          # EngineProcess (mesma API do DAWEngine do bridge)
+_engine_ok = False      # True = processo de pé e heartbeat andando
 
 
 def get_engine():
-    return _engine if _engine_ok else None
+    return _engine if _engine is not None and ENGINE_PROCESS.running else None
 
 
 def _find_dll() -> Path | None:
@@ -56,79 +58,28 @@ def _find_dll() -> Path | None:
     return None
 
 
-def _preload_deps(dll_path: Path):
-    """Pré-carrega o diretório e dependências que daw_engine.dll precisa."""
-    global _dll_directory_handle
-    if sys.platform != 'win32':
-        return
-
-    bin_dir = str(dll_path.parent)
-
-    # Injeta a pasta bin diretamente no buscador de DLLs do Windows para este processo
-    if hasattr(os, "add_dll_directory") and _dll_directory_handle is None:
-        try:
-            _dll_directory_handle = os.add_dll_directory(bin_dir)
-            print(f"[DAW Engine] Diretório de DLLs adicionado ao runtime: {bin_dir}")
-        except Exception as e:
-            print(f"[DAW Engine] Erro ao adicionar add_dll_directory: {e}")
-
-    # Fallback clássico modificando o PATH do ambiente
-    if bin_dir not in os.environ.get('PATH', ''):
-        os.environ['PATH'] = bin_dir + os.pathsep + os.environ.get('PATH', '')
-
-    # Tenta carregar explicitamente as dependências comuns do MinGW se estiverem na pasta
-    deps = ['libwinpthread-1.dll', 'libgcc_s_seh-1.dll', 'libstdc++-6.dll', 'libgomp-1.dll']
-    for dep in deps:
-        dep_path = dll_path.parent / dep
-        if dep_path.exists():
-            try:
-                ctypes.CDLL(str(dep_path))
-                print(f"[DAW Engine] Dependência carregada com sucesso: {dep}")
-            except Exception as e:
-                print(f"[DAW Engine] Falha interna ao pré-carregar {dep}: {e}")
-
-
 def _start_engine() -> bool:
-    """Inicia o motor de áudio. Retorna True se bem-sucedido."""
+    """Lança o processo do motor de áudio. Retorna True se o processo subiu."""
     global _engine, _engine_ok
 
     try:
         dll = _find_dll()
         if dll is None:
-            print("[DAW Engine] DLL não encontrada — motor de áudio desativado")
-            _engine_ok = False
-            return False
+            print("[DAW Engine] DLL não encontrada — usando o motor Python")
 
-        # Configura o ambiente e pré-carrega runtime do C++/MinGW
-        _preload_deps(dll)
-
-        # Adiciona o diretório python do seu addon ao sys.path para achar o 'daw_bridge'
-        py_dir = dll.parent.parent / "python"
-        if str(py_dir) not in sys.path:
-            sys.path.insert(0, str(py_dir))
-
-        # Importação dinâmica da ponte python/C++
-        from daw_bridge import DAWEngine
-        e = DAWEngine(str(dll))
-
-        # 1. Executa o mapeamento obrigatório de tipos via ctypes
-        if not e.load():
-            print("[DAW Engine] Falha ao executar e.load() no bridge")
+        if not ENGINE_PROCESS.launch(
+            dll_path=str(dll) if dll else None,
+            sample_rate=44100,
+            buffer_size=512,
+        ):
             _engine_ok = False
             return False
 
-        # 2. Inicializa passando as assinaturas e chaves idênticas do daw_bridge.py
-        if not e.init(sample_rate=44100, bit_depth=24, buffer_frames=512, bpm=120.0):
-            print("[DAW Engine] Falha na inicialização interna do motor (init retornou falso)")
-            _engine_ok = False
-            return False
+        ENGINE_PROCESS.set_bpm(120.0)
+        ENGINE_PROCESS.set_master_volume(0.85)
 
-        e.set_bpm(120.0)
-        e.set_master_volume(0.85)
-
-        _engine    = e
-        _engine_ok = True
-        print(f"[DAW Engine] ✅ Motor iniciado com sucesso — {dll.name}")
+        _engine = ENGINE_PROCESS
+        print(f"[DAW Engine] ✅ Processo do motor lançado — {dll.name if dll else 'Python'}")
         return True
 
     except Exception as ex:
@@ -140,37 +91,35 @@ def _start_engine() -> bool:
 
 def _stop_engine():
     """Para o motor com segurança."""
-    global _engine, _engine_ok, _dll_directory_handle
-    if _engine and _engine_ok:
-        try:
-            _engine.shutdown()
-            print("[DAW Engine] Motor parado")
-        except Exception as e:
-            print(f"[DAW Engine] Aviso ao parar: {e}")
-
-    # Fecha o handle do diretório do Windows se existir
-    if _dll_directory_handle:
-        try:
-            _dll_directory_handle.close()
-        except Exception:
-            pass
-        _dll_directory_handle = None
+    global _engine, _engine_ok
+    try:
+        ENGINE_PROCESS.shutdown()
+        print("[DAW Engine] Motor parado")
+    except Exception as e:
+        print(f"[DAW Engine] Aviso ao parar: {e}")
 
     _engine    = None
     _engine_ok = False
 
 
 # ═══════════════════════════════════════════════════════════════
-#  WATCHDOG — mantém o motor vivo
+#  HEARTBEAT — mantém o motor vivo
 # ═══════════════════════════════════════════════════════════════
 
-def _watchdog():
-    """Roda a cada 5s verificando se o motor ainda está ativo."""
+def _heartbeat():
+    """
+    Confere o heartbeat do processo do motor (leitura do bloco de estado,
+    sem chamar o motor). O EngineProcess reinicia sozinho um processo
+    morto ou travado; se ele desistiu, tenta de novo a cada 5 s.
+    """
     global _engine_ok
-    if not _engine_ok:
-        print("[DAW Engine] Watchdog: detectou motor offline. Tentando reconectar...")
+    if not ENGINE_PROCESS.running:
+        _engine_ok = False
+        print("[DAW Engine] Heartbeat: motor offline. Tentando relançar...")
         _start_engine()
-    return 5.0
+        return 5.0
+    _engine_ok = ENGINE_PROCESS.check()
+    return CHECK_INTERVAL
 
 
 # ═══════════════════════════════════════════════════════════════
@@ -235,6 +184,18 @@ class DAWProperties(bpy.types.PropertyGroup):
         subtype='FACTOR',
         update=lambda self, ctx: _on_volume_change(self, ctx))
 
+    show_spectrum: BoolProperty(
+        name="Espectro",
+        description="Analisador de espectro do master no Node Editor",
+        default=False
+    )
+
+    midi_port: StringProperty(
+        name="Porta MIDI",
+        description="Porta de entrada MIDI (vazio = primeira disponível)",
+        default=""
+    )
+
     status: StringProperty(default="Iniciando...")
 
 
@@ -243,6 +204,10 @@ def _on_bpm_change(self, context):
     if e:
         try: e.set_bpm(self.bpm)
         except Exception: pass
+    try:
+        from ..modules.playlist.snapping import SNAP
+        SNAP.sync_tempo(self.bpm)
+    except Exception: pass
 
 
 def _on_volume_change(self, context):
@@ -341,6 +306,27 @@ class DAW_OT_LoadAudio(bpy.types.Operator):
         return {'FINISHED'}
 
 
+class DAW_OT_MidiInput(bpy.types.Operator):
+    bl_idname      = "daw.midi_input"
+    bl_label       = "Entrada MIDI"
+    bl_description = "Abre/fecha a porta MIDI ao vivo no processo do motor"
+    enable: BoolProperty(default=True)
+    virtual: BoolProperty(name="Porta virtual", default=False)
+
+    def execute(self, context):
+        e = get_engine()
+        if not e or not hasattr(e, "open_midi_input"):
+            self.report({'ERROR'}, "Motor não disponível")
+            return {'CANCELLED'}
+        if self.enable:
+            e.open_midi_input(context.scene.daw.midi_port, virtual=self.virtual)
+            self.report({'INFO'}, f"🎹 MIDI: {context.scene.daw.midi_port or 'primeira porta'}")
+        else:
+            e.close_midi_input()
+            self.report({'INFO'}, "🎹 MIDI fechado")
+        return {'FINISHED'}
+
+
 # ═══════════════════════════════════════════════════════════════
 #  PANEL (Mantido como redundância ou painel de debug do Motor)
 # ═══════════════════════════════════════════════════════════════
@@ -360,10 +346,12 @@ class DAW_PT_Engine(bpy.types.Panel):
         box = layout.box()
         row = box.row()
         if _engine_ok:
-            row.label(text="Motor C++: Conectado", icon='CHECKMARK')
+            row.label(text="Motor: Conectado", icon='CHECKMARK')
         else:
-            row.label(text="Motor C++: Desconectado (Sem DLL)", icon='ERROR')
+            row.label(text="Motor: Desconectado", icon='ERROR')
             box.label(text="Verifique o Console do Sistema", icon='INFO')
+        if ENGINE_PROCESS.restarts:
+            box.label(text=f"Reinícios: {ENGINE_PROCESS.restarts}")
 
         if _engine_ok and _engine:
             try:
@@ -372,6 +360,16 @@ class DAW_PT_Engine(bpy.types.Panel):
                     box4 = layout.box()
                     box4.label(text=f"Peak  L:{s.peak_left:.3f}  R:{s.peak_right:.3f}")
                     box4.label(text=f"Tracks Ativas: {s.track_count}")
+                    box4.label(text=f"CPU: {s.cpu_load:.0%}   Xruns: {s.xruns}")
+
+                    box5 = layout.box()
+                    box5.prop(daw, "midi_port")
+                    row = box5.row(align=True)
+                    if s.midi_input:
+                        row.label(text="MIDI: aberto", icon='CHECKMARK')
+                        row.operator("daw.midi_input", text="Fechar").enable = False
+                    else:
+                        row.operator("daw.midi_input", text="Abrir MIDI").enable = True
             except Exception:
                 pass
 
@@ -382,7 +380,7 @@ class DAW_PT_Engine(bpy.types.Panel):
 
 classes = [
     DAWProperties,
-    DAW_OT_Play, DAW_OT_Stop, DAW_OT_Record, DAW_OT_LoadAudio,
+    DAW_OT_Play, DAW_OT_Stop, DAW_OT_Record, DAW_OT_LoadAudio, DAW_OT_MidiInput,
     DAW_PT_Engine,
 ]
 
@@ -397,8 +395,8 @@ def register():
 
     def _auto_start():
         _start_engine()
-        if not bpy.app.timers.is_registered(_watchdog):
-            bpy.app.timers.register(_watchdog, first_interval=5.0, persistent=True)
+        if not bpy.app.timers.is_registered(_heartbeat):
+            bpy.app.timers.register(_heartbeat, first_interval=CHECK_INTERVAL, persistent=True)
         return None
 
     bpy.app.timers.register(_auto_start, first_interval=0.5)
@@ -406,8 +404,8 @@ def register():
 
 
 def unregister():
-    if bpy.app.timers.is_registered(_watchdog):
-        bpy.app.timers.unregister(_watchdog)
+    if bpy.app.timers.is_registered(_heartbeat):
+        bpy.app.timers.unregister(_heartbeat)
 
     _stop_engine()
 
@@ -8,6 +8,12 @@ Responsabilidades deste pacote:
     state.py    — ENGINE_STATE: singleton com status em tempo real (xruns, CPU...)
     callback.py — AudioCallback: __call__ chamado pela thread de áudio do SO
     stream.py   — OutputStream: cria e controla o sd.OutputStream
+    sampleclock.py — SAMPLE_CLOCK: relógio de samples do audio thread
+    layout.py   — layouts de barramento (estéreo, 5.1, 7.1, ambisônico), pan e downmix
+    buffer.py   — AudioBuffer planar/intercalado e BUFFER_POOL (reuso sem realocar)
+    arena.py    — ENGINE_ARENA: scratch por bloco, resetado no início do callback
+    realtime.py — REALTIME: SCHED_FIFO/rtkit, afinidade de CPU e mlock (Linux, opt-in)
+    spectrum.py — SpectrumAnalyzer: ring de análise + FFT numa worker thread
 
 Fluxo de dados:
     Engine.start()
@@ -43,6 +49,10 @@ from .backend import (
     create_backend,
 )
 from .state import AudioState, ENGINE_STATE
+from .sampleclock import SampleClock, SAMPLE_CLOCK
+from .arena import ScratchArena, ENGINE_ARENA
+from .realtime import RealtimeManager, REALTIME
+from .spectrum import AnalysisRing, SpectrumAnalyzer, SPECTRUM_BANDS, SPECTRUM_SLOTS
 from .callback import AudioCallback
 from .stream import OutputStream
 
@@ -65,6 +75,20 @@ __all__ = [
     # Estado
     "AudioState",
     "ENGINE_STATE",
+    # Relógio
+    "SampleClock",
+    "SAMPLE_CLOCK",
+    # Scratch por bloco
+    "ScratchArena",
+    "ENGINE_ARENA",
+    # Tempo real
+    "RealtimeManager",
+    "REALTIME",
+    # Espectro
+    "AnalysisRing",
+    "SpectrumAnalyzer",
+    "SPECTRUM_BANDS",
+    "SPECTRUM_SLOTS",
     # Stream
     "AudioCallback",
     "OutputStream",
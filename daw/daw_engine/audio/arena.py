@@ -0,0 +1,399 @@
+"""
+Scratch Arena
+
+Memória de rascunho por bloco para o caminho de tempo real.
+
+Por que:
+
+    Mixer, Channel, Synth, Voice, Oscillator e ADSR criavam arrays numpy
+    novos a cada bloco — sempre com os mesmos shapes. Cada np.zeros /
+    np.empty / astype no callback é uma alocação no heap (malloc + objeto
+    Python), exatamente o que callback.py proíbe.
+
+Modelo:
+
+    Um slab contíguo por dtype (float32 para áudio, float64 para fases),
+    pré-alocado com base em ENGINE_CONFIG.buffer_size. scratch(shape)
+    devolve uma view do slab e avança um ponteiro (bump allocator).
+    temp() é o rascunho efêmero (float64) de valores que não saem da
+    função que os pediu — reaproveitado a cada chamada, numa região
+    própria: nunca sobrepõe o que scratch() entregou.
+
+    reset() no início de cada callback zera os ponteiros — O(1), nada é
+    liberado nem limpo. Tudo que foi entregue no bloco anterior passa a
+    ser reaproveitado: um array de scratch só vale até o próximo reset().
+
+Thread:
+
+    A arena pertence à thread que chamou reset() por último (a thread de
+    áudio). Em qualquer outra thread (render offline, freeze, UI, testes)
+    scratch() cai para np.empty — o mesmo código de DSP funciona nos dois
+    contextos sem compartilhar memória entre threads.
+
+Debug (debug=True):
+
+    - reset() envenena com NaN a região usada no bloco anterior. Ler um
+      array depois do reset (use-after-reset) propaga NaN até a saída —
+      check_output() conta e avisa.
+    - Escrever num array velho suja a região envenenada que não foi
+      reentregue; reset() confere e conta em stale_writes.
+    - peak_usage / overflows sempre são registrados; report() resume.
+
+    Envenenar custa O(usado) — só em debug. Em produção reset() é O(1).
+"""
+
+from __future__ import annotations
+
+import threading
+from typing import Dict, Tuple, Union
+
+import numpy as np
+
+from ..core.logger import LOGGER
+from .config import ENGINE_CONFIG
+
+
+Shape = Union[int, Tuple[int, ...]]
+
+
+# Quantos blocos mono de buffer_size cabem no slab float32.
+# 512 × 512 frames × 4 bytes = 1 MiB — dezenas de canais estéreo e as
+# formas de onda de vozes × unison (supersaw de 7 em acordes de 4 notas
+# em 5 canais); report() mostra o pico real para ajustar.
+
+DEFAULT_BLOCKS = 512
+
+# Slab float64 do scratch(): fases do banco de osciladores, (vozes ×
+# unison, frames) por Synth a cada bloco — as mesmas linhas das formas
+# de onda float32, então a mesma ordem de grandeza de blocos
+
+DEFAULT_BLOCKS_F64 = 256
+
+# Região de temp(): um valor efêmero de até 4 × buffer_size por vez
+
+TEMP_BLOCKS = 4
+
+
+class ScratchArena:
+
+    """
+    Bump allocator de arrays de rascunho, resetado a cada bloco.
+
+        ENGINE_ARENA.reset()                 # início do callback
+        buf = ENGINE_ARENA.scratch(frames)   # float32, conteúdo indefinido
+        mix = ENGINE_ARENA.zeros((frames, 2))
+    """
+
+    def __init__(
+
+        self,
+
+        buffer_size: int = 0,
+
+        blocks: int = DEFAULT_BLOCKS,
+
+        debug: bool = False,
+
+    ):
+
+        self.debug = debug
+
+        self.blocks = blocks
+
+        self._owner = None          # ident da thread dona (a do callback)
+
+        self.generation = 0
+
+        self.peak_usage = 0         # em bytes, somando os slabs
+
+        self.overflows = 0
+
+        self.stale_writes = 0
+
+        self.nan_blocks = 0
+
+        self.configure(buffer_size or ENGINE_CONFIG.buffer_size)
+
+    # ============================================================
+    # CONFIGURAÇÃO (fora da thread de áudio)
+    # ============================================================
+
+    def configure(self, buffer_size: int, blocks: int = 0) -> None:
+
+        """Realoca os slabs para um novo buffer_size. Chamar com o stream parado."""
+
+        if blocks:
+            self.blocks = blocks
+
+        self.buffer_size = int(buffer_size)
+
+        self._slabs: Dict[np.dtype, np.ndarray] = {
+
+            np.dtype(np.float32): np.zeros(self.buffer_size * self.blocks, dtype=np.float32),
+
+            np.dtype(np.float64): np.zeros(self.buffer_size * DEFAULT_BLOCKS_F64, dtype=np.float64),
+        }
+
+        self._offsets: Dict[np.dtype, int] = {dt: 0 for dt in self._slabs}
+
+        # temp() fora dos slabs: reusar o início dele não pisa em scratch()
+
+        self._temp = np.zeros(self.buffer_size * TEMP_BLOCKS, dtype=np.float64)
+
+        # arange pré-calculado: rampas (fase, envelope) sem np.arange no bloco
+
+        self._ramps = {dt: np.arange(self.buffer_size * 4, dtype=dt) for dt in self._slabs}
+
+        if self.debug:
+            for slab in self._slabs.values():
+                slab.fill(np.nan)
+
+    @property
+    def capacity(self) -> int:
+
+        """Capacidade total em bytes."""
+
+        return sum(s.nbytes for s in self._slabs.values()) + self._temp.nbytes
+
+    def arrays(self):
+
+        """Os slabs e a região de temp() — para prefault/mlock (audio/realtime.py)."""
+
+        return list(self._slabs.values()) + [self._temp]
+
+    def prefault(self) -> int:
+
+        """
+        Escreve em todas as páginas dos slabs (np.zeros pode devolver
+        páginas ainda não mapeadas): o page fault acontece aqui, não no
+        primeiro bloco. Retorna os bytes tocados.
+        """
+
+        for slab in self.arrays():
+            slab.fill(np.nan if self.debug else 0)
+
+        return self.capacity
+
+    # ============================================================
+    # BLOCO
+    # ============================================================
+
+    def reset(self) -> None:
+
+        """
+        Início de bloco: tudo que foi entregue volta a ser livre.
+
+        Também torna a thread chamadora a dona da arena.
+        """
+
+        used = 0
+
+        for dt, off in self._offsets.items():
+            used += off * dt.itemsize
+
+        if used > self.peak_usage:
+            self.peak_usage = used
+
+        if self.debug:
+            self._poison()
+
+        for dt in self._offsets:
+            self._offsets[dt] = 0
+
+        self.generation += 1
+
+        self._owner = threading.get_ident()
+
+    def release_thread(self) -> None:
+
+        """A thread dona deixa de usar a arena (stream parado)."""
+
+        self._owner = None
+
+    @property
+    def active(self) -> bool:
+
+        """True se scratch() nesta thread vem do slab."""
+
+        return self._owner == threading.get_ident()
+
+    # ============================================================
+    # ALOCAÇÃO
+    # ============================================================
+
+    def scratch(self, shape: Shape, dtype=np.float32) -> np.ndarray:
+
+        """
+        Array C-contíguo de rascunho, conteúdo indefinido.
+
+        Válido até o próximo reset(). Fora da thread dona, ou se o slab
+        esgotou, devolve np.empty (correto, só não é livre de alocação).
+        """
+
+        if self._owner != threading.get_ident():
+            return np.empty(shape, dtype=dtype)
+
+        dt = np.dtype(dtype)
+        slab = self._slabs.get(dt)
+
+        if slab is None:
+            return np.empty(shape, dtype=dtype)
+
+        size = shape if isinstance(shape, int) else int(np.prod(shape))
+        off = self._offsets[dt]
+        end = off + size
+
+        if end > len(slab):
+            self.overflows += 1
+            return np.empty(shape, dtype=dtype)
+
+        self._offsets[dt] = end
+        return slab[off:end].reshape(shape)
+
+    def temp(self, frames: int, dtype=np.float64) -> np.ndarray:
+
+        """
+        Rascunho efêmero: sempre o início da região de temp() (float64),
+        sem avançar ponteiro. Vale só até a próxima chamada de temp() —
+        para valores intermediários que morrem dentro da mesma função
+        (fases do oscilador). Outros dtypes caem para np.empty.
+        """
+
+        if self._owner != threading.get_ident():
+            return np.empty(frames, dtype=dtype)
+
+        if np.dtype(dtype) != np.float64 or frames > len(self._temp):
+            return np.empty(frames, dtype=dtype)
+
+        return self._temp[:frames]
+
+    def zeros(self, shape: Shape, dtype=np.float32) -> np.ndarray:
+
+        out = self.scratch(shape, dtype)
+        out.fill(0)
+        return out
+
+    def ramp(self, frames: int, dtype=np.float64) -> np.ndarray:
+
+        """0, 1, ..., frames-1 — view somente leitura de um arange pré-calculado."""
+
+        base = self._ramps.get(np.dtype(dtype))
+
+        if base is None or frames > len(base):
+            return np.arange(frames, dtype=dtype)
+
+        return base[:frames]
+
+    # ============================================================
+    # DEBUG
+    # ============================================================
+
+    def _poison(self) -> None:
+
+        for dt, slab in self._slabs.items():
+
+            off = self._offsets[dt]
+
+            # Região envenenada no reset anterior e não reentregue neste
+            # bloco: se não é mais NaN, alguém escreveu num array velho
+
+            tail = slab[off:]
+            if len(tail) and not np.isnan(tail).all():
+                self.stale_writes += 1
+                tail.fill(np.nan)
+
+            slab[:off].fill(np.nan)
+
+    def check_output(self, out: np.ndarray) -> bool:
+
+        """
+        Debug: confere se a saída do bloco tem NaN (scratch lido depois do
+        reset). Retorna False e conta em nan_blocks se tiver.
+        """
+
+        if not self.debug:
+            return True
+
+        if np.isnan(out).any():
+            self.nan_blocks += 1
+            return False
+
+        return True
+
+    def set_debug(self, enabled: bool) -> None:
+
+        self.debug = enabled
+
+        for slab in self.arrays():
+            slab.fill(np.nan if enabled else 0)
+
+    # ============================================================
+    # RELATÓRIO
+    # ============================================================
+
+    def stats(self) -> dict:
+
+        return {
+
+            "capacity": self.capacity,
+
+            "peak_usage": self.peak_usage,
+
+            "peak_ratio": self.peak_usage / self.capacity if self.capacity else 0.0,
+
+            "overflows": self.overflows,
+
+            "stale_writes": self.stale_writes,
+
+            "nan_blocks": self.nan_blocks,
+
+            "generation": self.generation,
+        }
+
+    def report(self) -> None:
+
+        s = self.stats()
+
+        LOGGER.info(
+
+            "Arena",
+
+            f"pico {s['peak_usage'] / 1024:.1f} KiB de {s['capacity'] / 1024:.1f} KiB "
+            f"({s['peak_ratio']:.0%}), {s['overflows']} overflows, "
+            f"{s['generation']} blocos",
+        )
+
+        if s["stale_writes"] or s["nan_blocks"]:
+
+            LOGGER.warning(
+
+                "Arena",
+
+                f"use-after-reset: {s['stale_writes']} escritas em scratch velho, "
+                f"{s['nan_blocks']} blocos com NaN na saída",
+            )
+
+        if s["overflows"]:
+
+            LOGGER.warning("Arena", "Slab pequeno para a sessão — aumente 'blocks'")
+
+    def reset_stats(self) -> None:
+
+        self.peak_usage = 0
+
+        self.overflows = 0
+
+        self.stale_writes = 0
+
+        self.nan_blocks = 0
+
+    def __repr__(self) -> str:
+
+        return (
+            f"ScratchArena({self.capacity // 1024} KiB, peak={self.peak_usage // 1024} KiB, "
+            f"overflows={self.overflows}, debug={self.debug})"
+        )
+
+
+# Instância global
+ENGINE_ARENA = ScratchArena()
@@ -1,14 +1,61 @@
 """
 Audio Buffer
+
+Buffer de áudio com layout explícito e pool de reuso.
+
+Layouts:
+
+    PLANAR       (channels, frames) C-contíguo — cada canal é uma linha
+                 contígua. É o layout de DSP: left/right/channel(i) são
+                 views contíguas (SIMD e cache felizes).
+
+    INTERLEAVED  (frames, channels) C-contíguo — o que o PortAudio entrega
+                 em outdata/indata.
+
+Conversões sem cópia intermediária:
+
+    buffer.interleaved   — view (frames, channels) de qualquer layout
+                           (num buffer planar é o transposto, zero-copy)
+    buffer.planar        — view (channels, frames) de qualquer layout
+    write_interleaved()  — escreve direto no outdata do stream: a única
+                           passagem de memória é a escrita no dispositivo
+    AudioBuffer.wrap()   — embrulha um array existente (ex.: indata) sem copiar
+
+Pool:
+
+    BufferPool guarda buffers livres por (layout, canais, frames, dtype).
+    acquire() tira da lista livre (só aloca se vazia), release() devolve.
+    append()/pop() de lista são atômicos sob o GIL — seguro entre a thread
+    de áudio e a da UI sem lock.
 """
 
 from __future__ import annotations
 
+from contextlib import contextmanager
+from enum import Enum
+from typing import Dict, Iterator, List, Optional, Tuple
+
 import numpy as np
 
 
+class BufferLayout(Enum):
+
+    PLANAR = "planar"
+
+    INTERLEAVED = "interleaved"
+
+
 class AudioBuffer:
 
+    """
+    Buffer de 'frames' amostras × 'channels' canais.
+
+    'data' continua sendo (frames, channels), como antes — em buffers
+    planares é uma view transposta (sem cópia).
+    """
+
+    __slots__ = ("_storage", "layout", "_pool", "_key")
+
     def __init__(
 
         self,
@@ -19,40 +66,266 @@ class AudioBuffer:
 
         dtype=np.float32,
 
+        layout: BufferLayout = BufferLayout.PLANAR,
+
     ):
 
-        self.data = np.zeros(
+        shape = (channels, frames) if layout is BufferLayout.PLANAR else (frames, channels)
 
-            (frames, channels),
+        self._storage = np.zeros(shape, dtype=dtype)
 
-            dtype=dtype
+        self.layout = layout
 
-        )
+        self._pool: Optional["BufferPool"] = None
+
+        self._key: Optional[Tuple] = None
 
     # ----------------------------
 
-    def clear(self):
+    @classmethod
+    def wrap(cls, array: np.ndarray, layout: BufferLayout = BufferLayout.INTERLEAVED) -> "AudioBuffer":
 
-        self.data.fill(0)
+        """Embrulha um array 2D existente sem copiar (ex.: indata do stream)."""
 
+        if array.ndim != 2:
+            raise ValueError("AudioBuffer.wrap espera um array 2D.")
+
+        buf = cls.__new__(cls)
+        buf._storage = array
+        buf.layout = layout
+        buf._pool = None
+        buf._key = None
+        return buf
+
+    # ----------------------------
+    # Views
     # ----------------------------
 
+    @property
+    def planar(self) -> np.ndarray:
+
+        """(channels, frames). Contíguo se o buffer é planar."""
+
+        return self._storage if self.layout is BufferLayout.PLANAR else self._storage.T
+
+    @property
+    def interleaved(self) -> np.ndarray:
+
+        """(frames, channels). Contíguo se o buffer é intercalado."""
+
+        return self._storage if self.layout is BufferLayout.INTERLEAVED else self._storage.T
+
+    @property
+    def data(self) -> np.ndarray:
+
+        return self.interleaved
+
+    def channel(self, index: int) -> np.ndarray:
+
+        return self.planar[index]
+
     @property
     def left(self):
 
-        return self.data[:,0]
+        return self.planar[0]
 
     @property
     def right(self):
 
-        return self.data[:,1]
+        return self.planar[1]
+
+    def view(self, start: int, stop: int) -> "AudioBuffer":
+
+        """Sub-buffer [start, stop) em frames, compartilhando memória."""
+
+        if self.layout is BufferLayout.PLANAR:
+            part = self._storage[:, start:stop]
+        else:
+            part = self._storage[start:stop]
+        return AudioBuffer.wrap(part, self.layout)
+
+    # ----------------------------
+    # Conversão
+    # ----------------------------
+
+    def write_interleaved(self, out: np.ndarray) -> None:
+
+        """Escreve o conteúdo em 'out' (frames, channels) — ex.: outdata."""
+
+        np.copyto(out, self.interleaved)
+
+    def read_interleaved(self, src: np.ndarray) -> None:
+
+        """Carrega (frames, channels) — ex.: indata — para dentro do buffer."""
+
+        np.copyto(self.interleaved, src)
+
+    def to_layout(self, layout: BufferLayout, pool: Optional["BufferPool"] = None) -> "AudioBuffer":
+
+        """Cópia no outro layout (do pool, se dado). Mesmo layout: retorna self."""
+
+        if layout is self.layout:
+            return self
+
+        if pool is not None:
+            out = pool.acquire(self.frames, self.channels, self.dtype, layout)
+        else:
+            out = AudioBuffer(self.frames, self.channels, self.dtype, layout)
+        np.copyto(out.planar, self.planar)
+        return out
+
+    # ----------------------------
+
+    def clear(self):
+
+        self._storage.fill(0)
+
+    def release(self) -> None:
+
+        """Devolve ao pool de origem (no-op para buffers fora de pool)."""
+
+        if self._pool is not None:
+            self._pool.release(self)
 
     @property
     def frames(self):
 
-        return self.data.shape[0]
+        return self._storage.shape[1 if self.layout is BufferLayout.PLANAR else 0]
 
     @property
     def channels(self):
 
-        return self.data.shape[1]
\ No newline at end of file
+        return self._storage.shape[0 if self.layout is BufferLayout.PLANAR else 1]
+
+    @property
+    def dtype(self):
+
+        return self._storage.dtype
+
+    def __repr__(self) -> str:
+
+        return f"AudioBuffer({self.channels}ch × {self.frames}, {self.layout.value}, {self.dtype})"
+
+
+# ============================================================
+# POOL
+# ============================================================
+
+class BufferPool:
+
+    """
+    Listas livres de AudioBuffer por (layout, canais, frames, dtype).
+
+    'max_free' limita quantos buffers ociosos cada chave guarda — o
+    excedente devolvido é descartado para o GC.
+    """
+
+    def __init__(self, max_free: int = 32):
+
+        self.max_free = max_free
+
+        self._free: Dict[Tuple, List[AudioBuffer]] = {}
+
+        self.hits = 0
+
+        self.misses = 0
+
+    @staticmethod
+    def _key(frames, channels, dtype, layout) -> Tuple:
+
+        return (layout, int(channels), int(frames), np.dtype(dtype).str)
+
+    def acquire(
+
+        self,
+
+        frames,
+
+        channels=2,
+
+        dtype=np.float32,
+
+        layout: BufferLayout = BufferLayout.PLANAR,
+
+        clear: bool = True,
+
+    ) -> AudioBuffer:
+
+        """Buffer livre do pool (zerado, a menos que clear=False)."""
+
+        key = self._key(frames, channels, dtype, layout)
+        free = self._free.get(key)
+
+        try:
+            buf = free.pop()            # AttributeError se free é None
+            self.hits += 1
+            if clear:
+                buf.clear()
+        except (AttributeError, IndexError):
+            buf = AudioBuffer(frames, channels, dtype, layout)
+            buf._pool = self
+            buf._key = key
+            self.misses += 1
+
+        return buf
+
+    def release(self, buf: AudioBuffer) -> None:
+
+        free = self._free.get(buf._key)
+        if free is None:
+            free = self._free.setdefault(buf._key, [])
+        if len(free) < self.max_free:
+            free.append(buf)
+
+    @contextmanager
+    def lease(self, frames, channels=2, dtype=np.float32,
+              layout: BufferLayout = BufferLayout.PLANAR) -> Iterator[AudioBuffer]:
+
+        """with pool.lease(512, 2) as buf: ... — devolvido ao sair."""
+
+        buf = self.acquire(frames, channels, dtype, layout)
+        try:
+            yield buf
+        finally:
+            self.release(buf)
+
+    def preallocate(self, count, frames, channels=2, dtype=np.float32,
+                    layout: BufferLayout = BufferLayout.PLANAR) -> None:
+
+        """Enche a lista livre antes de o stream começar (nada de alocar no callback)."""
+
+        bufs = [self.acquire(frames, channels, dtype, layout) for _ in range(count)]
+        for b in bufs:
+            self.release(b)
+
+    def arrays(self) -> List[np.ndarray]:
+
+        """Memória dos buffers livres — para prefault/mlock (audio/realtime.py)."""
+
+        return [buf._storage for free in self._free.values() for buf in free]
+
+    def prefault(self) -> int:
+
+        """Toca todas as páginas dos buffers livres. Retorna os bytes tocados."""
+
+        total = 0
+        for arr in self.arrays():
+            arr.fill(0)
+            total += arr.nbytes
+        return total
+
+    def free_count(self) -> int:
+
+        return sum(len(v) for v in self._free.values())
+
+    def clear(self) -> None:
+
+        self._free.clear()
+
+    def __repr__(self) -> str:
+
+        return f"BufferPool(free={self.free_count()}, hits={self.hits}, misses={self.misses})"
+
+
+# Instância global
+BUFFER_POOL = BufferPool()
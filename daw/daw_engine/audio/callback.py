@@ -20,7 +20,12 @@ from __future__ import annotations
 
 import numpy as np
 
+from .arena import ENGINE_ARENA
+from .buffer import AudioBuffer
+from .realtime import REALTIME
 from .state import ENGINE_STATE
+from .sampleclock import SAMPLE_CLOCK
+from ..midi.queue import make_block_buffer
 
 
 class AudioCallback:
@@ -29,6 +34,13 @@ class AudioCallback:
 
         self.generator = None
 
+        # Fila SPSC de eventos MIDI ao vivo (ver midi/queue.py).
+        # O bloco de saída é pré-alocado: drenar a fila não aloca.
+
+        self.midi_queue = None
+
+        self._midi_block = make_block_buffer()
+
     # -------------------------------------------------------
 
     def set_generator(self, generator):
@@ -43,6 +55,19 @@ class AudioCallback:
 
     # -------------------------------------------------------
 
+    def set_midi_queue(self, queue):
+
+        """
+        Conecta a fila de eventos MIDI ao vivo (MidiEventQueue).
+
+        Os eventos são drenados no início de cada bloco e entregues ao
+        gerador com offset em samples dentro do bloco.
+        """
+
+        self.midi_queue = queue
+
+    # -------------------------------------------------------
+
     def __call__(
 
         self,
@@ -61,14 +86,71 @@ class AudioCallback:
 
             ENGINE_STATE.xruns += 1
 
+        # Scratch do bloco anterior volta a ser livre — O(1)
+
+        ENGINE_ARENA.reset()
+
+        # Primeiro bloco em modo tempo real: a thread do PortAudio se
+        # registra (só enfileira o tid — a troca de política é feita fora)
+
+        if REALTIME.pending:
+
+            REALTIME.register_current_thread("audio")
+
+        block_start = ENGINE_STATE.frames_processed
+
+        SAMPLE_CLOCK.mark(block_start)
+
         if self.generator is None:
 
             outdata.fill(0)
 
+            ENGINE_STATE.frames_processed += frames
+
             return
 
-        audio = self.generator.process(frames)
+        count = 0
+
+        if self.midi_queue is not None:
+
+            count = self.midi_queue.pop_block(
+
+                block_start,
+
+                frames,
+
+                self._midi_block,
+
+            )
+
+        if count:
+
+            audio = self.generator.process(
+
+                frames,
+
+                self._midi_block[:count],
+
+            )
+
+        else:
+
+            audio = self.generator.process(frames)
+
+        if isinstance(audio, AudioBuffer):
+
+            # Planar → intercalado direto no buffer do dispositivo
+
+            audio.write_interleaved(outdata)
+
+            audio.release()
+
+        else:
+
+            outdata[:] = audio
+
+        if ENGINE_ARENA.debug:
 
-        outdata[:] = audio
+            ENGINE_ARENA.check_output(outdata)
 
         ENGINE_STATE.frames_processed += frames
\ No newline at end of file
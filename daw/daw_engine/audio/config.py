@@ -51,12 +51,26 @@ DEFAULT_BUFFER_SIZE = 512
 
 DEFAULT_CHANNELS = 2
 
+MAX_CHANNELS = 16            # ambisônico de 3ª ordem (16 canais ACN)
+
 DEFAULT_MASTER_VOLUME = 1.0
 
 DEFAULT_BPM = 120
 
 DEFAULT_PPQ = 960
 
+# Buffer sizes de um clique (AudioOutput.use_profile): latência mínima
+# para gravar, folga de CPU para mixar
+
+BUFFER_PROFILES = {
+
+    "recording": 64,
+
+    "default": DEFAULT_BUFFER_SIZE,
+
+    "mixing": 2048,
+}
+
 
 # ============================================================
 # CONFIG
@@ -93,6 +107,23 @@ class AudioConfig:
 
     latency: str = "low"
 
+    # Nome do layout em audio/layout.py ("stereo", "5.1", "7.1",
+    # "ambix1", "ambix3"...). Vazio = layout padrão para 'channels'.
+    layout: str = ""
+
+    # Modo tempo real (audio/realtime.py) — opt-in, só no Linux.
+    # lock_memory: "" (nada), "pools" (mlock da arena e do pool),
+    # "all" (mlockall — só no processo da engine, nunca dentro do Blender).
+    realtime: bool = False
+
+    rt_priority: int = 70
+
+    cpu_affinity: tuple = ()
+
+    lock_memory: str = "pools"
+
+    prefault: bool = True
+
     extra: dict = field(default_factory=dict)
 
     # --------------------------------------------------------
@@ -110,8 +141,15 @@ class AudioConfig:
         if self.buffer_size <= 0:
             raise ValueError("Buffer Size inválido.")
 
-        if self.channels not in (1, 2):
-            raise ValueError("A engine suporta apenas Mono ou Stereo.")
+        if not 1 <= self.channels <= MAX_CHANNELS:
+            raise ValueError(f"Número de canais deve estar entre 1 e {MAX_CHANNELS}.")
+
+        from .layout import get_layout, layout_for_channels
+        layout = get_layout(self.layout) if self.layout else layout_for_channels(self.channels)
+        if layout.channels != self.channels:
+            raise ValueError(
+                f"Layout '{layout.name}' tem {layout.channels} canais, configurado {self.channels}."
+            )
 
         if not 0.0 <= self.master_volume <= 1.0:
             raise ValueError("Master Volume deve estar entre 0.0 e 1.0.")
@@ -122,6 +160,12 @@ class AudioConfig:
         if self.ppq <= 0:
             raise ValueError("PPQ inválido.")
 
+        if not 1 <= self.rt_priority <= 99:
+            raise ValueError("Prioridade de tempo real deve estar entre 1 e 99.")
+
+        if self.lock_memory not in ("", "pools", "all"):
+            raise ValueError("lock_memory deve ser '', 'pools' ou 'all'.")
+
 # ============================================================
 #  RESETAR CONFIG GLOBAL
 # ============================================================
@@ -138,6 +182,12 @@ class AudioConfig:
      self.output_device = None
      self.input_device = None
      self.latency = "low"
+     self.layout = ""
+     self.realtime = False
+     self.rt_priority = 70
+     self.cpu_affinity = ()
+     self.lock_memory = "pools"
+     self.prefault = True
      self.extra.clear()
 
 # ============================================================
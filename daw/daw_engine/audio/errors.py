@@ -229,6 +229,26 @@ class RoutingError(MixerError):
     default_message = "Invalid mixer routing."
 
 
+# ==========================================================
+# PLUGINS
+# ==========================================================
+
+class PluginError(AudioEngineError):
+    default_message = "Plugin error."
+
+
+class PluginNotFound(PluginError):
+    default_message = "Plugin not found."
+
+
+class PluginLoadError(PluginError):
+    default_message = "Plugin failed to load."
+
+
+class PluginHostError(PluginError):
+    default_message = "Plugin host process failed."
+
+
 # ==========================================================
 # TRANSPORT
 # ==========================================================
@@ -0,0 +1,345 @@
+"""
+DAW Engine - Channel Layouts
+
+Layouts de barramento com N canais: mono, estéreo, 5.1, 7.1 (ITU-R
+BS.775 / BS.2051) e ambisônico de 1ª e 3ª ordem (AmbiX: ACN + SN3D).
+
+Responsabilidade:
+- Metadados do layout (rótulos, direção de cada alto-falante, LFE)
+- Leis de pan vetorizadas — uma chamada calcula os ganhos de TODOS os
+  canais do mixer de uma vez:
+      estéreo     → potência constante (a mesma lei do Channel)
+      surround    → VBAP 2D entre pares de alto-falantes adjacentes
+      ambisônico  → codificação por harmônicos esféricos reais
+- Matrizes de downmix (n_origem, n_destino): aplicar é um único matmul
+  por bloco — apply_matrix(buf, M) == buf @ M
+
+Convenção de ângulos: graus, azimute positivo à ESQUERDA (0 = frente,
+90 = esquerda), elevação positiva para cima.
+
+Nenhum processamento por amostra fica aqui — só as matrizes.
+"""
+
+from __future__ import annotations
+
+from dataclasses import dataclass
+from typing import Dict, Optional, Tuple
+
+import numpy as np
+
+
+# ============================================================
+# LAYOUT
+# ============================================================
+
+@dataclass(frozen=True)
+class SpeakerLayout:
+    """
+    Layout de um barramento.
+
+    Layouts de alto-falantes têm uma direção por canal; ambisonic_order > 0
+    indica um barramento ambisônico ((ordem + 1)² canais, sem direções).
+    """
+
+    name: str
+
+    labels: Tuple[str, ...]
+
+    azimuths: Tuple[float, ...] = ()
+
+    elevations: Tuple[float, ...] = ()
+
+    lfe: int = -1                       # índice do canal LFE (-1 = nenhum)
+
+    ambisonic_order: int = 0
+
+    # --------------------------------------------------------
+
+    @property
+    def channels(self) -> int:
+        return len(self.labels)
+
+    @property
+    def is_ambisonic(self) -> bool:
+        return self.ambisonic_order > 0
+
+    def speakers(self) -> np.ndarray:
+        """Índices dos canais com alto-falante direcional (sem LFE)."""
+        return np.array([i for i in range(self.channels) if i != self.lfe], dtype=np.intp)
+
+    def __repr__(self) -> str:
+        return f"SpeakerLayout('{self.name}', {self.channels} ch)"
+
+
+def _ambisonic_layout(order: int) -> SpeakerLayout:
+    n = (order + 1) ** 2
+    return SpeakerLayout(
+        name=f"ambix{order}",
+        labels=tuple(f"ACN{i}" for i in range(n)),
+        ambisonic_order=order,
+    )
+
+
+MONO = SpeakerLayout("mono", ("M",), (0.0,), (0.0,))
+
+STEREO = SpeakerLayout("stereo", ("L", "R"), (30.0, -30.0), (0.0, 0.0))
+
+SURROUND_51 = SpeakerLayout(
+    "5.1",
+    ("L", "R", "C", "LFE", "Ls", "Rs"),
+    (30.0, -30.0, 0.0, 0.0, 110.0, -110.0),
+    (0.0,) * 6,
+    lfe=3,
+)
+
+SURROUND_71 = SpeakerLayout(
+    "7.1",
+    ("L", "R", "C", "LFE", "Lss", "Rss", "Lrs", "Rrs"),
+    (30.0, -30.0, 0.0, 0.0, 90.0, -90.0, 150.0, -150.0),
+    (0.0,) * 8,
+    lfe=3,
+)
+
+AMBISONIC_FOA = _ambisonic_layout(1)
+
+AMBISONIC_TOA = _ambisonic_layout(3)
+
+LAYOUTS: Dict[str, SpeakerLayout] = {
+    l.name: l for l in (MONO, STEREO, SURROUND_51, SURROUND_71, AMBISONIC_FOA, AMBISONIC_TOA)
+}
+
+
+def layout_for_channels(channels: int) -> SpeakerLayout:
+    """Layout padrão para um número de canais (4 e 16 → ambisônico)."""
+    for layout in (MONO, STEREO, AMBISONIC_FOA, SURROUND_51, SURROUND_71, AMBISONIC_TOA):
+        if layout.channels == channels:
+            return layout
+    raise ValueError(f"Nenhum layout padrão com {channels} canais.")
+
+
+def get_layout(name: str) -> SpeakerLayout:
+    try:
+        return LAYOUTS[name]
+    except KeyError:
+        raise ValueError(f"Layout desconhecido: '{name}'.") from None
+
+
+# ============================================================
+# AMBISONIA — harmônicos esféricos reais (ACN, SN3D)
+# ============================================================
+
+def ambisonic_gains(order: int, azimuth: np.ndarray, elevation: np.ndarray) -> np.ndarray:
+    """
+    Coeficientes de codificação (n_fontes, (ordem+1)²) para fontes nas
+    direções dadas (graus). Ordem 1..3.
+    """
+    if not 1 <= order <= 3:
+        raise ValueError("Ordem ambisônica suportada: 1 a 3.")
+
+    az = np.radians(np.atleast_1d(np.asarray(azimuth, dtype=np.float64)))
+    el = np.radians(np.atleast_1d(np.asarray(elevation, dtype=np.float64)))
+    az, el = np.broadcast_arrays(az, el)
+
+    x = np.cos(az) * np.cos(el)
+    y = np.sin(az) * np.cos(el)
+    z = np.sin(el)
+
+    cols = [np.ones_like(x), y, z, x]
+
+    if order >= 2:
+        s3 = np.sqrt(3.0)
+        cols += [
+            s3 * x * y,
+            s3 * y * z,
+            0.5 * (3.0 * z * z - 1.0),
+            s3 * x * z,
+            0.5 * s3 * (x * x - y * y),
+        ]
+
+    if order >= 3:
+        a = np.sqrt(5.0 / 8.0)
+        b = np.sqrt(15.0)
+        c = np.sqrt(3.0 / 8.0)
+        cols += [
+            a * y * (3.0 * x * x - y * y),
+            b * x * y * z,
+            c * y * (5.0 * z * z - 1.0),
+            0.5 * z * (5.0 * z * z - 3.0),
+            c * x * (5.0 * z * z - 1.0),
+            0.5 * b * z * (x * x - y * y),
+            a * x * (x * x - 3.0 * y * y),
+        ]
+
+    return np.stack(cols, axis=1).astype(np.float32)
+
+
+# ============================================================
+# VBAP 2D
+# ============================================================
+
+def vbap_gains(layout: SpeakerLayout, azimuth: np.ndarray) -> np.ndarray:
+    """
+    Ganhos VBAP (n_fontes, layout.channels) para fontes no plano
+    horizontal. Cada fonte cai no par de alto-falantes adjacentes que a
+    contém; ganhos normalizados em potência. LFE sempre 0.
+    """
+    az = np.radians(np.atleast_1d(np.asarray(azimuth, dtype=np.float64)))
+    out = np.zeros((len(az), layout.channels), dtype=np.float32)
+
+    spk = layout.speakers()
+    if len(spk) == 1:
+        out[:, spk[0]] = 1.0
+        return out
+
+    spk_az = np.radians(np.asarray(layout.azimuths, dtype=np.float64)[spk])
+    order = np.argsort(spk_az)
+    a = spk[order]
+    b = np.roll(a, -1)                                  # pares adjacentes (circular)
+    ang_a = np.radians(np.asarray(layout.azimuths)[a])
+    ang_b = np.radians(np.asarray(layout.azimuths)[b])
+
+    # Base de cada par (P, 2, 2) e sua inversa
+    base = np.stack([
+        np.stack([np.cos(ang_a), np.sin(ang_a)], axis=1),
+        np.stack([np.cos(ang_b), np.sin(ang_b)], axis=1),
+    ], axis=1)
+    inv = np.linalg.pinv(base)                          # (P, 2, 2)
+
+    p = np.stack([np.cos(az), np.sin(az)], axis=1)      # (S, 2)
+    g = np.einsum("sd,pde->spe", p, inv)                # (S, P, 2)
+
+    # Par escolhido: o de maior ganho mínimo (≥ 0 quando o par contém a fonte)
+    best = np.argmax(g.min(axis=2), axis=1)             # (S,)
+    rows = np.arange(len(az))
+    gp = np.clip(g[rows, best], 0.0, None)
+    norm = np.sqrt((gp * gp).sum(axis=1, keepdims=True))
+    gp /= np.where(norm > 0.0, norm, 1.0)
+
+    np.add.at(out, (rows, a[best]), gp[:, 0])
+    np.add.at(out, (rows, b[best]), gp[:, 1])
+    return out
+
+
+# ============================================================
+# PAN (todos os canais do mixer de uma vez)
+# ============================================================
+
+STEREO_STAGE_DEG = 30.0      # pan ±1 desloca a fonte ±30° (largura do estéreo)
+
+
+def panning_gains(
+    layout:    SpeakerLayout,
+    pan:       np.ndarray,
+    azimuth:   Optional[np.ndarray] = None,
+    elevation: Optional[np.ndarray] = None,
+) -> np.ndarray:
+    """
+    Matriz de ganhos (n_canais_mixer, layout.channels).
+
+    Estéreo usa a lei de potência constante sobre 'pan'. Nos demais
+    layouts a direção efetiva é azimute − 30°·pan: o pan continua movendo
+    a fonte no palco frontal e o azimute gira o palco.
+    """
+    pan = np.asarray(pan, dtype=np.float64)
+    n = len(pan)
+
+    if layout.channels == 1:
+        return np.ones((n, 1), dtype=np.float32)
+
+    if layout is STEREO or (layout.channels == 2 and not layout.is_ambisonic):
+        angle = (pan + 1.0) * 0.25 * np.pi
+        return np.stack([np.cos(angle), np.sin(angle)], axis=1).astype(np.float32)
+
+    az = np.zeros(n) if azimuth is None else np.asarray(azimuth, dtype=np.float64)
+    el = np.zeros(n) if elevation is None else np.asarray(elevation, dtype=np.float64)
+    az = az - STEREO_STAGE_DEG * pan
+
+    if layout.is_ambisonic:
+        return ambisonic_gains(layout.ambisonic_order, az, el)
+    return vbap_gains(layout, az)
+
+
+# ============================================================
+# DOWNMIX
+# ============================================================
+
+_M3DB = float(np.sqrt(0.5))      # -3 dB
+
+
+def _stereo_fold(layout: SpeakerLayout) -> np.ndarray:
+    """
+    Fold-down para estéreo no estilo ITU-R BS.775: frontais L/R inteiros,
+    centro e surrounds a -3 dB no lado correspondente, LFE descartado.
+    """
+    m = np.zeros((layout.channels, 2), dtype=np.float32)
+    for i, az in enumerate(layout.azimuths):
+        if i == layout.lfe:
+            continue
+        if abs(az) < 1e-6 or abs(abs(az) - 180.0) < 1e-6:
+            m[i] = (_M3DB, _M3DB)
+        else:
+            g = 1.0 if abs(az) <= 60.0 else _M3DB
+            m[i, 0 if az > 0 else 1] = g
+    return m
+
+
+def downmix_matrix(src: SpeakerLayout, dst: SpeakerLayout) -> np.ndarray:
+    """
+    Matriz (src.channels, dst.channels): saída = bloco @ matriz.
+
+    alto-falantes → estéreo/mono : fold-down ITU
+    alto-falantes → alto-falantes: cada canal re-panejado com VBAP na sua
+                                   direção (LFE → LFE, se houver)
+    alto-falantes → ambisônico   : codificação de cada direção
+    ambisônico → alto-falantes   : decodificador mode-matching (pinv)
+    ambisônico → ambisônico      : trunca / completa com zeros por ordem
+    """
+    if src == dst:
+        return np.eye(src.channels, dtype=np.float32)
+
+    if src.is_ambisonic and dst.is_ambisonic:
+        m = np.zeros((src.channels, dst.channels), dtype=np.float32)
+        k = min(src.channels, dst.channels)
+        m[np.arange(k), np.arange(k)] = 1.0
+        return m
+
+    if src.is_ambisonic:
+        spk = dst.speakers()
+        y = ambisonic_gains(
+            src.ambisonic_order,
+            np.asarray(dst.azimuths)[spk],
+            np.asarray(dst.elevations or (0.0,) * dst.channels)[spk],
+        ).astype(np.float64)                               # (n_spk, n_sh)
+        m = np.zeros((src.channels, dst.channels), dtype=np.float32)
+        m[:, spk] = np.linalg.pinv(y)                      # (n_sh, n_spk)
+        return m
+
+    if dst.is_ambisonic:
+        spk = src.speakers()
+        m = np.zeros((src.channels, dst.channels), dtype=np.float32)
+        m[spk] = ambisonic_gains(
+            dst.ambisonic_order,
+            np.asarray(src.azimuths)[spk],
+            np.asarray(src.elevations or (0.0,) * src.channels)[spk],
+        )
+        return m
+
+    if dst.channels == 2:
+        return _stereo_fold(src)
+
+    if dst.channels == 1:
+        if src.channels == 1:
+            return np.ones((1, 1), dtype=np.float32)
+        return _stereo_fold(src) @ np.full((2, 1), _M3DB, dtype=np.float32)
+
+    m = np.zeros((src.channels, dst.channels), dtype=np.float32)
+    spk = src.speakers()
+    m[spk] = vbap_gains(dst, np.asarray(src.azimuths)[spk])
+    if src.lfe >= 0 and dst.lfe >= 0:
+        m[src.lfe, dst.lfe] = 1.0
+    return m
+
+
+def apply_matrix(buffer: np.ndarray, matrix: np.ndarray, out: Optional[np.ndarray] = None) -> np.ndarray:
+    """(frames, n_src) @ (n_src, n_dst) → (frames, n_dst) — um matmul por bloco."""
+    return np.matmul(buffer, matrix, out=out)
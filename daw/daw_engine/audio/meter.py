@@ -10,16 +10,21 @@ from __future__ import annotations
 
 import numpy as np
 
+from .buffer import AudioBuffer
+
 
 class AudioMeter:
 
+    """
+    Medidor por canal — qualquer número de canais (estéreo, 5.1, 7.1,
+    ambisônico). peak/rms devolvem uma tupla com um valor por canal.
+    """
+
     def __init__(self):
 
-        self._peak_left = 0.0
-        self._peak_right = 0.0
+        self._peak = np.zeros(2, dtype=np.float32)
 
-        self._rms_left = 0.0
-        self._rms_right = 0.0
+        self._rms = np.zeros(2, dtype=np.float32)
 
         self._clipping = False
 
@@ -28,44 +33,37 @@ class AudioMeter:
     def process(self, buffer: np.ndarray):
 
         """
-        buffer shape:
+        buffer: AudioBuffer ou array (frames, channels)
 
-        (frames, channels)
+        A redução é feita sobre a visão planar — com AudioBuffer planar
+        cada canal é uma linha contígua.
         """
 
-        if buffer.size == 0:
-            return
+        if isinstance(buffer, AudioBuffer):
+            planar = buffer.planar
+        else:
+            if buffer.ndim == 1:
+                buffer = buffer.reshape(-1, 1)
+            planar = buffer.T
 
-        left = buffer[:, 0]
-        right = buffer[:, 1]
+        if planar.size == 0:
+            return
 
-        self._peak_left = float(np.max(np.abs(left)))
-        self._peak_right = float(np.max(np.abs(right)))
+        self._peak = np.max(np.abs(planar), axis=1)
 
-        self._rms_left = float(np.sqrt(np.mean(left * left)))
-        self._rms_right = float(np.sqrt(np.mean(right * right)))
+        self._rms = np.sqrt(np.mean(planar * planar, axis=1))
 
-        self._clipping = (
-            self._peak_left >= 1.0
-            or
-            self._peak_right >= 1.0
-        )
+        self._clipping = bool(np.any(self._peak >= 1.0))
 
     # ---------------------------------------------------------
 
     @property
     def peak(self):
-        return (
-            self._peak_left,
-            self._peak_right,
-        )
+        return tuple(self._peak.tolist())
 
     @property
     def rms(self):
-        return (
-            self._rms_left,
-            self._rms_right,
-        )
+        return tuple(self._rms.tolist())
 
     @property
     def clipping(self):
@@ -75,10 +73,8 @@ class AudioMeter:
 
     def reset(self):
 
-        self._peak_left = 0.0
-        self._peak_right = 0.0
+        self._peak = np.zeros_like(self._peak)
 
-        self._rms_left = 0.0
-        self._rms_right = 0.0
+        self._rms = np.zeros_like(self._rms)
 
-        self._clipping = False
\ No newline at end of file
+        self._clipping = False
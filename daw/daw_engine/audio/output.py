@@ -1,11 +1,37 @@
 """
 Master Output
+
+Dono do par AudioCallback + OutputStream.
+
+Reconfiguração (reconfigure / use_profile):
+
+    Trocar buffer_size ou sample_rate exige parar o stream de qualquer
+    jeito — o PortAudio não muda o bloco de um stream aberto. Em vez de
+    cada parte da engine descobrir a mudança sozinha, reconfigure() faz
+    tudo de uma vez, na thread que chamou:
+
+        1. para o stream (stop() do PortAudio espera o callback em curso
+           terminar — a thread de áudio fica drenada)
+        2. aplica e valida o ENGINE_CONFIG novo (rollback se inválido)
+        3. redimensiona BUFFER_POOL e ENGINE_ARENA
+        4. sample rate novo → generator.set_sample_rate() (Mixer → canais
+           → Synth/osciladores/inserts) e os listeners registrados
+        5. reancora o SAMPLE_CLOCK e religa o stream se estava ativo
+
+    Se o dispositivo recusar a configuração nova, volta para a anterior.
 """
 
 from __future__ import annotations
 
-from .callback import AudioCallback
+from typing import Callable, List, Optional
 
+from ..core.logger import LOGGER
+from .arena import ENGINE_ARENA
+from .buffer import BUFFER_POOL
+from .callback import AudioCallback
+from .config import BUFFER_PROFILES, ENGINE_CONFIG
+from .sampleclock import SAMPLE_CLOCK
+from .state import ENGINE_STATE
 from .stream import OutputStream
 
 
@@ -21,6 +47,11 @@ class AudioOutput:
 
         )
 
+        # fn(sample_rate, buffer_size) chamados em reconfigure(), com o
+        # stream parado — coeficientes dependentes de rate, caches...
+
+        self._listeners: List[Callable[[int, int], None]] = []
+
     # -------------------------------------
 
     def set_generator(
@@ -39,6 +70,22 @@ class AudioOutput:
 
     # -------------------------------------
 
+    def set_midi_queue(
+
+        self,
+
+        queue
+
+    ):
+
+        self.callback.set_midi_queue(
+
+            queue
+
+        )
+
+    # -------------------------------------
+
     def start(self):
 
         self.stream.start()
@@ -55,4 +102,163 @@ class AudioOutput:
 
     def active(self):
 
-        return self.stream.active
\ No newline at end of file
+        return self.stream.active
+
+    # -------------------------------------
+    # Reconfiguração
+    # -------------------------------------
+
+    def add_reconfigure_listener(self, fn: Callable[[int, int], None]) -> None:
+
+        if fn not in self._listeners:
+
+            self._listeners.append(fn)
+
+    def remove_reconfigure_listener(self, fn: Callable[[int, int], None]) -> None:
+
+        if fn in self._listeners:
+
+            self._listeners.remove(fn)
+
+    # -------------------------------------
+
+    def reconfigure(
+
+        self,
+
+        sample_rate: Optional[int] = None,
+
+        buffer_size: Optional[int] = None,
+
+    ) -> bool:
+
+        """
+        Troca sample rate e/ou buffer size num passo só.
+
+        Levanta ValueError se a configuração for inválida (nada muda).
+        Retorna False se o dispositivo recusou e a anterior foi restaurada.
+        """
+
+        old_rate = ENGINE_CONFIG.sample_rate
+
+        old_size = ENGINE_CONFIG.buffer_size
+
+        new_rate = old_rate if sample_rate is None else int(sample_rate)
+
+        new_size = old_size if buffer_size is None else int(buffer_size)
+
+        if (new_rate, new_size) == (old_rate, old_size):
+
+            return True
+
+        was_active = self.active
+
+        self.stream.stop()
+
+        ENGINE_CONFIG.sample_rate = new_rate
+
+        ENGINE_CONFIG.buffer_size = new_size
+
+        try:
+
+            ENGINE_CONFIG.validate()
+
+        except ValueError:
+
+            self._apply(old_rate, old_size, old_rate, was_active)
+
+            raise
+
+        self._apply(new_rate, new_size, old_rate, False)
+
+        if not was_active:
+
+            LOGGER.info("Audio", f"Configuração: {new_rate} Hz, {new_size} frames")
+
+            return True
+
+        try:
+
+            self.stream.start()
+
+        except Exception as e:
+
+            LOGGER.error(
+
+                "Audio",
+
+                f"Dispositivo recusou {new_rate} Hz / {new_size} frames ({e}) — restaurando",
+            )
+
+            self.stream.stop()
+
+            self._apply(old_rate, old_size, new_rate, True)
+
+            return False
+
+        LOGGER.info(
+
+            "Audio",
+
+            f"Reconfigurado: {new_rate} Hz, {new_size} frames "
+            f"({new_size / new_rate * 1000:.1f} ms)",
+        )
+
+        return True
+
+    def use_profile(self, name: str) -> bool:
+
+        """Aplica um buffer size de BUFFER_PROFILES ('recording', 'mixing'...)."""
+
+        if name not in BUFFER_PROFILES:
+
+            raise ValueError(
+
+                f"Perfil desconhecido: '{name}'. Disponíveis: {list(BUFFER_PROFILES)}"
+            )
+
+        return self.reconfigure(buffer_size=BUFFER_PROFILES[name])
+
+    # -------------------------------------
+
+    def _apply(self, rate: int, size: int, previous_rate: int, restart: bool) -> None:
+
+        """Redimensiona e propaga 'rate'/'size' com o stream parado."""
+
+        ENGINE_CONFIG.sample_rate = rate
+
+        ENGINE_CONFIG.buffer_size = size
+
+        # Buffers do tamanho antigo não servem mais; start() pré-aloca os novos
+
+        BUFFER_POOL.clear()
+
+        if ENGINE_ARENA.buffer_size != size:
+
+            ENGINE_ARENA.configure(size)
+
+        if rate != previous_rate:
+
+            generator = self.callback.generator
+
+            if hasattr(generator, "set_sample_rate"):
+
+                generator.set_sample_rate(rate)
+
+        for fn in list(self._listeners):
+
+            try:
+
+                fn(rate, size)
+
+            except Exception as e:
+
+                LOGGER.error("Audio", f"Erro em listener de reconfiguração: {e}")
+
+        # Nova âncora: frames anteriores foram contados no rate antigo
+
+        SAMPLE_CLOCK.mark(ENGINE_STATE.frames_processed)
+
+        if restart:
+
+            self.stream.start()
@@ -0,0 +1,548 @@
+"""
+Realtime
+
+Modo tempo real (opt-in) para a thread de áudio no Linux.
+
+Por que:
+
+    O PortAudio cria a thread do callback com prioridade normal. Ela
+    disputa CPU com a UI, o depsgraph e o render do Blender — e perde:
+    basta um pico de carga para o bloco atrasar (xrun). Páginas dos pools
+    que nunca foram tocadas (ou foram para o swap) viram page faults
+    dentro do callback.
+
+O que este módulo faz quando ENGINE_CONFIG.realtime está ligado:
+
+    prioridade   SCHED_FIFO na thread do callback (e prioridade menor nas
+                 threads de controle). Direto via sched_setscheduler se o
+                 processo tem RLIMIT_RTPRIO/CAP_SYS_NICE; senão pede ao
+                 rtkit (D-Bus), como PipeWire/JACK fazem.
+
+    afinidade    sched_setaffinity das threads registradas para as CPUs
+                 de ENGINE_CONFIG.cpu_affinity (ex.: um núcleo isolado).
+
+    memória      prefault: escreve em todas as páginas dos slabs da
+                 ENGINE_ARENA e dos buffers livres do BUFFER_POOL antes
+                 do primeiro bloco. lock_memory: mlock() desses mesmos
+                 intervalos (não mlockall — dentro do Blender isso
+                 travaria a memória do processo inteiro; no processo da
+                 engine, lock_memory="all" usa mlockall).
+
+Como a thread do callback é do PortAudio, ela só se registra
+(register_current_thread — guarda o tid, não faz syscall); a troca de
+política roda numa thread auxiliar, porque a chamada ao rtkit é um
+round-trip D-Bus de milissegundos.
+
+Diagnóstico: cada passo que falha por falta de privilégio entra em
+REALTIME.report (e no LOGGER) com o motivo e o que configurar
+(limits.conf, grupo audio, rtkit).
+
+Fora do Linux tudo vira no-op com um aviso no diagnóstico.
+"""
+
+from __future__ import annotations
+
+import ctypes
+import ctypes.util
+import importlib.util
+import os
+import queue
+import sys
+import threading
+from typing import Dict, List, Optional, Tuple
+
+import numpy as np
+
+from ..core.logger import LOGGER
+from .arena import ENGINE_ARENA
+from .buffer import BUFFER_POOL
+from .config import ENGINE_CONFIG
+
+
+LINUX = sys.platform.startswith("linux")
+
+# Prioridade das threads de controle (drenagem de comandos, MIDI) em
+# relação à do callback: abaixo dela, acima de tudo que é normal
+
+WORKER_PRIORITY_OFFSET = 10
+
+# rtkit exige RLIMIT_RTTIME definido (µs de CPU contínua em RT antes do
+# SIGXCPU) — proteção contra uma thread RT em loop travar a máquina
+
+RTTIME_LIMIT_US = 200_000
+
+_MCL_CURRENT = 1
+
+_MCL_FUTURE = 2
+
+
+# ============================================================
+# LIBC
+# ============================================================
+
+def _libc():
+
+    name = ctypes.util.find_library("c")
+
+    try:
+        return ctypes.CDLL(name, use_errno=True) if name else None
+    except OSError:
+        return None
+
+
+class _Range:
+
+    """(endereço, tamanho) de um array numpy, para mlock/munlock."""
+
+    __slots__ = ("addr", "size")
+
+    def __init__(self, array: np.ndarray):
+
+        self.addr = array.ctypes.data
+
+        self.size = array.nbytes
+
+
+# ============================================================
+# REALTIME
+# ============================================================
+
+class RealtimeManager:
+
+    def __init__(self):
+
+        self.report: Dict[str, str] = {}
+
+        self.active = False
+
+        self.pending = False            # callback ainda não se registrou
+
+        self._threads: Dict[int, str] = {}                  # tid → papel
+
+        self._requests: "queue.SimpleQueue[Tuple[int, str]]" = queue.SimpleQueue()
+
+        self._worker: Optional[threading.Thread] = None
+
+        self._locked: List[_Range] = []
+
+        self._mlockall = False
+
+        self._libc = _libc() if LINUX else None
+
+    # ============================================================
+    # CICLO DE VIDA (thread de controle)
+    # ============================================================
+
+    def prepare(self) -> bool:
+
+        """
+        Chamado por OutputStream.start(), depois de pré-alocar os pools.
+        Retorna True se o modo tempo real está ligado.
+        """
+
+        if not ENGINE_CONFIG.realtime:
+
+            return False
+
+        if not LINUX:
+
+            self._diag("platform", f"modo tempo real só é suportado no Linux ({sys.platform})")
+
+            return False
+
+        self.active = True
+
+        self.pending = True
+
+        self.prefault()
+
+        mode = ENGINE_CONFIG.lock_memory
+
+        if mode == "all":
+
+            self.lock_all()
+
+        elif mode:
+
+            self.lock_pools()
+
+        self._ensure_worker()
+
+        return True
+
+    def release(self) -> None:
+
+        """Stream parado: solta os intervalos travados."""
+
+        self.unlock()
+
+        self.active = False
+
+        self.pending = False
+
+        self._threads.clear()
+
+    # ============================================================
+    # THREADS
+    # ============================================================
+
+    def register_current_thread(self, role: str = "audio") -> None:
+
+        """
+        Registra a thread chamadora para receber prioridade/afinidade.
+        Seguro dentro do callback: só enfileira o tid.
+        """
+
+        if self.active:
+
+            self.pending = False
+
+            self._requests.put((threading.get_native_id(), role))
+
+    def promote_current_thread(self, role: str = "worker") -> bool:
+
+        """Aplica a política já, na thread chamadora (threads de controle próprias)."""
+
+        if not (ENGINE_CONFIG.realtime and LINUX):
+
+            return False
+
+        return self._apply(threading.get_native_id(), role)
+
+    def _ensure_worker(self) -> None:
+
+        if self._worker is not None and self._worker.is_alive():
+
+            return
+
+        self._worker = threading.Thread(target=self._run, name="daw-realtime", daemon=True)
+
+        self._worker.start()
+
+    def _run(self) -> None:
+
+        while True:
+
+            tid, role = self._requests.get()
+
+            if tid < 0:
+
+                return
+
+            if self._threads.get(tid) != role:
+
+                self._apply(tid, role)
+
+    def _apply(self, tid: int, role: str) -> bool:
+
+        self._threads[tid] = role
+
+        prio = ENGINE_CONFIG.rt_priority
+
+        if role != "audio":
+
+            prio = max(1, prio - WORKER_PRIORITY_OFFSET)
+
+        ok = self._set_fifo(tid, prio, role)
+
+        cpus = ENGINE_CONFIG.cpu_affinity
+
+        if cpus:
+
+            try:
+
+                os.sched_setaffinity(tid, set(cpus))
+
+                self.report[f"{role}.affinity"] = f"ok: CPUs {sorted(cpus)}"
+
+            except OSError as e:
+
+                self._diag(f"{role}.affinity", f"sched_setaffinity{sorted(cpus)} falhou: {e.strerror}")
+
+        return ok
+
+    def _set_fifo(self, tid: int, prio: int, role: str) -> bool:
+
+        try:
+
+            os.sched_setscheduler(tid, os.SCHED_FIFO, os.sched_param(prio))
+
+            self.report[f"{role}.priority"] = f"ok: SCHED_FIFO {prio} (direto)"
+
+            LOGGER.info("Realtime", f"Thread {role} ({tid}) em SCHED_FIFO {prio}")
+
+            return True
+
+        except PermissionError:
+
+            direct = "sem RLIMIT_RTPRIO/CAP_SYS_NICE"
+
+        except OSError as e:
+
+            direct = e.strerror
+
+        err = self._rtkit(tid, prio)
+
+        if err is None:
+
+            self.report[f"{role}.priority"] = "ok: SCHED_FIFO via rtkit"
+
+            LOGGER.info("Realtime", f"Thread {role} ({tid}) em tempo real via rtkit")
+
+            return True
+
+        self._diag(
+
+            f"{role}.priority",
+
+            f"sem tempo real ({direct}; rtkit: {err}). Adicione o usuário ao grupo "
+            f"'audio' com '@audio - rtprio 95' em /etc/security/limits.conf, "
+            f"ou instale/ative o rtkit",
+        )
+
+        return False
+
+    def _rtkit(self, tid: int, prio: int) -> Optional[str]:
+
+        """Pede SCHED_FIFO ao rtkit. None se deu certo, senão o motivo."""
+
+        try:
+
+            import dbus
+
+        except ImportError:
+
+            return "módulo dbus (dbus-python) ausente"
+
+        try:
+
+            import resource
+
+            soft, hard = resource.getrlimit(resource.RLIMIT_RTTIME)
+
+            if soft == resource.RLIM_INFINITY or soft > RTTIME_LIMIT_US:
+
+                resource.setrlimit(resource.RLIMIT_RTTIME, (RTTIME_LIMIT_US, hard))
+
+            bus = dbus.SystemBus()
+
+            obj = bus.get_object("org.freedesktop.RealtimeKit1", "/org/freedesktop/RealtimeKit1")
+
+            props = dbus.Interface(obj, "org.freedesktop.DBus.Properties")
+
+            max_prio = int(props.Get("org.freedesktop.RealtimeKit1", "MaxRealtimePriority"))
+
+            rtkit = dbus.Interface(obj, "org.freedesktop.RealtimeKit1")
+
+            rtkit.MakeThreadRealtime(dbus.UInt64(tid), dbus.UInt32(min(prio, max_prio)))
+
+            return None
+
+        except Exception as e:
+
+            return str(e).splitlines()[0] if str(e) else type(e).__name__
+
+    # ============================================================
+    # MEMÓRIA
+    # ============================================================
+
+    @staticmethod
+    def _pool_arrays() -> List[np.ndarray]:
+
+        return ENGINE_ARENA.arrays() + BUFFER_POOL.arrays()
+
+    def prefault(self) -> int:
+
+        """Page faults dos pools agora, não no callback. Bytes tocados."""
+
+        if not ENGINE_CONFIG.prefault:
+
+            return 0
+
+        total = ENGINE_ARENA.prefault() + BUFFER_POOL.prefault()
+
+        self.report["memory.prefault"] = f"ok: {total / 1024:.0f} KiB"
+
+        return total
+
+    def lock_pools(self) -> bool:
+
+        """mlock() dos slabs da arena e dos buffers livres do pool."""
+
+        libc = self._libc
+
+        if libc is None:
+
+            self._diag("memory.lock", "libc não encontrada")
+
+            return False
+
+        self.unlock()
+
+        failed = 0
+
+        for arr in self._pool_arrays():
+
+            r = _Range(arr)
+
+            if libc.mlock(ctypes.c_void_p(r.addr), ctypes.c_size_t(r.size)) == 0:
+
+                self._locked.append(r)
+
+            else:
+
+                failed += 1
+
+        locked = sum(r.size for r in self._locked)
+
+        if failed:
+
+            self._diag(
+
+                "memory.lock",
+
+                f"mlock falhou em {failed} buffer(s) ({os.strerror(ctypes.get_errno())}); "
+                f"RLIMIT_MEMLOCK = {self._memlock_limit()} — aumente 'memlock' em limits.conf",
+            )
+
+            return False
+
+        self.report["memory.lock"] = f"ok: {locked / 1024:.0f} KiB travados (pools)"
+
+        return True
+
+    def lock_all(self) -> bool:
+
+        """mlockall(MCL_CURRENT | MCL_FUTURE) — só faz sentido no processo da engine."""
+
+        libc = self._libc
+
+        if libc is None:
+
+            self._diag("memory.lock", "libc não encontrada")
+
+            return False
+
+        if libc.mlockall(_MCL_CURRENT | _MCL_FUTURE) != 0:
+
+            self._diag(
+
+                "memory.lock",
+
+                f"mlockall falhou ({os.strerror(ctypes.get_errno())}); "
+                f"RLIMIT_MEMLOCK = {self._memlock_limit()}",
+            )
+
+            return False
+
+        self._mlockall = True
+
+        self.report["memory.lock"] = "ok: mlockall (processo inteiro)"
+
+        return True
+
+    def unlock(self) -> None:
+
+        libc = self._libc
+
+        if libc is None:
+
+            return
+
+        for r in self._locked:
+
+            libc.munlock(ctypes.c_void_p(r.addr), ctypes.c_size_t(r.size))
+
+        self._locked.clear()
+
+        if self._mlockall:
+
+            libc.munlockall()
+
+            self._mlockall = False
+
+    @staticmethod
+    def _memlock_limit() -> str:
+
+        try:
+
+            import resource
+
+            soft, _ = resource.getrlimit(resource.RLIMIT_MEMLOCK)
+
+            return "ilimitado" if soft == resource.RLIM_INFINITY else f"{soft // 1024} KiB"
+
+        except Exception:
+
+            return "?"
+
+    # ============================================================
+    # DIAGNÓSTICO
+    # ============================================================
+
+    def _diag(self, key: str, message: str) -> None:
+
+        if self.report.get(key) != message:
+
+            LOGGER.warning("Realtime", message)
+
+        self.report[key] = message
+
+    def diagnose(self) -> Dict[str, str]:
+
+        """
+        O que este processo pode fazer, sem mudar nada — para a UI mostrar
+        antes de o usuário ligar o modo tempo real.
+        """
+
+        out: Dict[str, str] = {"platform": sys.platform}
+
+        if not LINUX:
+
+            out["realtime"] = "indisponível fora do Linux"
+
+            return out
+
+        import resource
+
+        rtprio = resource.getrlimit(resource.RLIMIT_RTPRIO)[0]
+
+        out["rtprio_limit"] = "ilimitado" if rtprio == resource.RLIM_INFINITY else str(rtprio)
+
+        out["memlock_limit"] = self._memlock_limit()
+
+        if os.geteuid() == 0:
+
+            out["direct_fifo"] = "sim (root)"
+
+        elif rtprio == resource.RLIM_INFINITY or rtprio >= ENGINE_CONFIG.rt_priority:
+
+            out["direct_fifo"] = "sim"
+
+        else:
+
+            out["direct_fifo"] = f"não (RLIMIT_RTPRIO {rtprio} < {ENGINE_CONFIG.rt_priority})"
+
+        if importlib.util.find_spec("dbus") is not None:
+
+            out["rtkit"] = "dbus-python disponível"
+
+        else:
+
+            out["rtkit"] = "dbus-python ausente"
+
+        out["cpus"] = str(sorted(os.sched_getaffinity(0)))
+
+        return out
+
+    def shutdown(self) -> None:
+
+        if self._worker is not None and self._worker.is_alive():
+
+            self._requests.put((-1, ""))
+
+        self.release()
+
+
+# Instância global
+REALTIME = RealtimeManager()
@@ -0,0 +1,74 @@
+"""
+DAW Engine - Sample Clock
+
+Relógio de samples compartilhado entre o audio thread e threads de entrada
+(MIDI, controle).
+
+O AudioCallback marca, no início de cada bloco, o par
+(frames já processados, perf_counter()). Qualquer outra thread converte
+"agora" para a posição em samples do audio thread interpolando a partir
+dessa âncora — é assim que eventos MIDI ao vivo recebem timestamp no
+mesmo relógio que o Mixer usa para renderizar.
+
+A âncora é publicada como UMA tupla (atribuição atômica sob o GIL),
+então leitores nunca veem frames de um bloco com o tempo de outro.
+"""
+
+from __future__ import annotations
+
+import time
+
+from .config import ENGINE_CONFIG
+
+
+class SampleClock:
+
+    def __init__(self):
+
+        # (frames no início do bloco, perf_counter no início do bloco, sample_rate)
+        self._anchor = (0, time.perf_counter(), ENGINE_CONFIG.sample_rate)
+
+    # ---------------------------------------------------------
+
+    def mark(self, block_start: int):
+
+        """
+        Chamado pelo AudioCallback no início de cada bloco.
+        """
+
+        self._anchor = (
+            block_start,
+            time.perf_counter(),
+            ENGINE_CONFIG.sample_rate,
+        )
+
+    # ---------------------------------------------------------
+
+    def now(self) -> int:
+
+        """
+        Posição atual estimada em samples (relógio do audio thread).
+        """
+
+        return self.at(time.perf_counter())
+
+    # ---------------------------------------------------------
+
+    def at(self, perf_time: float) -> int:
+
+        """
+        Converte um instante de time.perf_counter() para samples.
+        """
+
+        frames, anchor_time, sample_rate = self._anchor
+
+        return frames + int((perf_time - anchor_time) * sample_rate)
+
+    # ---------------------------------------------------------
+
+    def reset(self):
+
+        self._anchor = (0, time.perf_counter(), ENGINE_CONFIG.sample_rate)
+
+
+SAMPLE_CLOCK = SampleClock()
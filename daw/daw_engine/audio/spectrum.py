@@ -0,0 +1,312 @@
+"""
+DAW Engine - Spectrum Analyzer
+
+Espectro do master (e de até SPECTRUM_SLOTS − 1 canais) para os painéis.
+
+Por que não calcular no redraw:
+    Uma FFT de 4096 pontos por redraw, na thread do Blender, somada ao
+    resto da UI, trava a interface — e o AudioMeter só tem pico e RMS.
+    Aqui o trabalho fica dividido em três lados, nenhum esperando outro:
+
+    audio thread  capture(): copia o bloco (downmix mono) para o
+                  AnalysisRing. Só cópia, O(frames), sem lock e sem
+                  alocação.
+    worker        a ANALYSIS_RATE Hz (não a cada bloco de áudio): pega as
+                  últimas FFT_SIZE amostras de cada slot, janela de Hann,
+                  rfft de todos os slots de uma vez, agrega os bins em
+                  SPECTRUM_BANDS bandas logarítmicas e suaviza no tempo
+                  (ataque rápido, release lento).
+    painel        read(): cópia de um array fixo (slots, bandas) já
+                  normalizado em 0–1 — pronto para virar geometria.
+
+Bandas logarítmicas:
+    SPECTRUM_BANDS bandas entre SPECTRUM_MIN_HZ e SPECTRUM_MAX_HZ. No
+    grave a banda é mais estreita que um bin da FFT: o valor vem da
+    interpolação do espectro no centro da banda. Acima disso cada banda
+    é o MÁXIMO dos bins que cobre (um seno no agudo não some diluído
+    numa banda larga). Os dois casos são um np.interp e um
+    np.maximum.reduceat para todos os slots — sem laço por banda.
+
+Escala:
+    Seno de 0 dBFS → 1.0; SPECTRUM_FLOOR_DB → 0.0. O array publicado
+    é normalizado assim (zero = silêncio), o que também faz de um bloco
+    zerado em memória compartilhada um espectro válido.
+
+Slot sem áudio novo (canal mutado, transporte parado, callback sem
+chamar) decai até o piso em vez de congelar no último espectro.
+
+Sem bpy.
+"""
+
+from __future__ import annotations
+
+import threading
+import time
+from typing import Optional
+
+import numpy as np
+
+from ..core.logger import LOGGER
+
+
+SPECTRUM_BANDS   = 96
+SPECTRUM_SLOTS   = 4          # 0 = master, 1… = canais escolhidos
+SPECTRUM_MIN_HZ  = 20.0
+SPECTRUM_MAX_HZ  = 20000.0
+SPECTRUM_FLOOR_DB = -96.0
+
+FFT_SIZE      = 4096
+ANALYSIS_RATE = 30.0          # Hz — FFTs por segundo (o olho não vê mais que isso)
+ATTACK_TIME   = 0.01          # s
+RELEASE_TIME  = 0.35          # s
+
+MASTER_SLOT = 0
+
+
+# ------------------------------------------------------------------
+# Ring de análise
+# ------------------------------------------------------------------
+
+class AnalysisRing:
+    """
+    Últimas 'capacity' amostras mono de cada slot (SPSC, sem lock).
+
+    Mesmo modelo da midi/queue.py: o produtor (audio thread) grava as
+    amostras e SÓ DEPOIS publica _write[slot]. Diferente da fila MIDI, o
+    produtor nunca espera nem descarta — ele sobrescreve o que é velho: a
+    análise só quer as amostras mais recentes, não todas.
+
+    O leitor copia a janela e confere se o produtor deu a volta por cima
+    dela durante a cópia (torn read); nesse caso a janela é descartada.
+    """
+
+    def __init__(self, slots: int = SPECTRUM_SLOTS, capacity: int = 4 * FFT_SIZE) -> None:
+        size = 1
+        while size < capacity:
+            size <<= 1
+        self.capacity = size
+        self._mask = size - 1
+        self._data = np.zeros((slots, size), dtype=np.float32)
+        self._write = [0] * slots     # só o produtor escreve
+        self._downmix = {}            # canais → pesos (C,) do downmix mono
+
+    # Produtor --------------------------------------------------------
+
+    def write(self, slot: int, block: np.ndarray) -> None:
+        """block (frames,) ou (frames, canais) — downmix mono na cópia."""
+        frames = len(block)
+        if frames == 0:
+            return
+        if frames > self.capacity:
+            block = block[-self.capacity:]
+            frames = self.capacity
+        w = self._write[slot]
+        start = w & self._mask
+        first = min(frames, self.capacity - start)
+        row = self._data[slot]
+        if block.ndim == 1:
+            row[start:start + first] = block[:first]
+            row[:frames - first] = block[first:]
+        else:
+            # Downmix como produto escalar (frames, C) · (C,): uma chamada
+            # BLAS — mean(axis=1) custa ~20× mais num bloco estéreo
+            channels = block.shape[1]
+            weights = self._downmix.get(channels)
+            if weights is None:
+                weights = self._downmix[channels] = np.full(channels, 1.0 / channels, np.float32)
+            if block.dtype != np.float32:
+                block = block.astype(np.float32)
+            np.dot(block[:first], weights, out=row[start:start + first])
+            if first < frames:
+                np.dot(block[first:], weights, out=row[:frames - first])
+        self._write[slot] = w + frames            # publica depois da cópia
+
+    # Consumidor ------------------------------------------------------
+
+    def written(self, slot: int) -> int:
+        return self._write[slot]
+
+    def latest(self, slot: int, out: np.ndarray) -> bool:
+        """Copia as últimas len(out) amostras do slot. False se a cópia rasgou."""
+        n = len(out)
+        w = self._write[slot]
+        start = (w - n) & self._mask
+        first = min(n, self.capacity - start)
+        row = self._data[slot]
+        out[:first] = row[start:start + first]
+        out[first:] = row[:n - first]
+        # O produtor avançou tanto que sobrescreveu o começo da janela?
+        return self._write[slot] - w <= self.capacity - n
+
+    def __repr__(self) -> str:
+        return f"<AnalysisRing {self._data.shape[0]}×{self.capacity}>"
+
+
+# ------------------------------------------------------------------
+# Analisador
+# ------------------------------------------------------------------
+
+def band_edges(bands: int = SPECTRUM_BANDS) -> np.ndarray:
+    """Bordas (bands + 1,) em Hz, espaçadas em log entre MIN e MAX."""
+    return np.geomspace(SPECTRUM_MIN_HZ, SPECTRUM_MAX_HZ, bands + 1)
+
+
+class SpectrumAnalyzer:
+    """
+    Espectro suavizado de SPECTRUM_SLOTS fontes, calculado numa worker thread.
+
+        analyzer = SpectrumAnalyzer(sample_rate)
+        mixer.set_analyzer(analyzer)          # master no slot 0
+        mixer.analyze_channel(1, 3)           # canal 3 no slot 1
+        analyzer.start()
+        levels = analyzer.read()              # (SPECTRUM_SLOTS, SPECTRUM_BANDS) 0–1
+
+    analyze() faz um passo à mão (render offline, testes) — start() só o
+    chama periodicamente.
+    """
+
+    def __init__(self, sample_rate: int = 48000, fft_size: int = FFT_SIZE) -> None:
+        self.sample_rate = sample_rate
+        self.fft_size = fft_size
+        self.ring = AnalysisRing(SPECTRUM_SLOTS, 4 * fft_size)
+
+        self._window = np.hanning(fft_size).astype(np.float32)
+        # Seno de amplitude 1 → potência 1 (0 dBFS) no bin do pico
+        self._scale = (2.0 / self._window.sum()) ** 2
+        self._frames = np.zeros((SPECTRUM_SLOTS, fft_size), dtype=np.float32)
+        self._build_bands()
+
+        self._db = np.full((SPECTRUM_SLOTS, SPECTRUM_BANDS), SPECTRUM_FLOOR_DB)
+        self._seen = [0] * SPECTRUM_SLOTS     # ring.written() da última análise
+        self._last: Optional[float] = None
+
+        # Publicação: dois buffers, o worker escreve no de trás e troca.
+        # 'seq' sobe a cada troca — read() confere se não trocou duas
+        # vezes durante a cópia (mesma ideia do seqlock do StateBlock).
+        self._published = np.zeros((2, SPECTRUM_SLOTS, SPECTRUM_BANDS), dtype=np.float32)
+        self._front = 0
+        self.seq = 0
+
+        self._thread: Optional[threading.Thread] = None
+        self._stop = threading.Event()
+
+    def _build_bands(self) -> None:
+        """Bins de cada banda: interpolação no grave, reduceat (máximo) acima."""
+        bin_hz = self.sample_rate / self.fft_size
+        edges = band_edges() / bin_hz                       # em bins (fracionário)
+        nyquist = self.fft_size // 2
+        width = np.diff(edges)
+        narrow = int(np.count_nonzero(width < 1.0))         # prefixo: largura cresce com a banda
+        self._narrow = narrow
+        self._centers = np.sqrt(edges[:-1] * edges[1:])[:narrow]
+        starts = np.clip(np.rint(edges[narrow:-1]).astype(np.intp), 0, nyquist)
+        self._lo = int(starts[0]) if len(starts) else nyquist
+        self._hi = int(min(nyquist, np.rint(edges[-1]))) + 1
+        self._starts = np.minimum(starts - self._lo, self._hi - self._lo - 1)
+        self._bins = np.arange(nyquist + 1, dtype=np.float64)
+
+    def set_sample_rate(self, sample_rate: int) -> None:
+        """Bins das bandas mudam com o rate; o espectro recomeça do piso."""
+        self.sample_rate = sample_rate
+        self._build_bands()
+        self.reset()
+
+    # ------------------------------------------------------------------
+    # Audio thread
+    # ------------------------------------------------------------------
+
+    def capture(self, block: np.ndarray, slot: int = MASTER_SLOT) -> None:
+        """Chamado pelo Mixer no callback: só copia para o ring."""
+        self.ring.write(slot, block)
+
+    # ------------------------------------------------------------------
+    # Worker
+    # ------------------------------------------------------------------
+
+    def start(self) -> None:
+        if self._thread is not None and self._thread.is_alive():
+            return
+        self._stop.clear()
+        self._thread = threading.Thread(target=self._run, name="daw-spectrum", daemon=True)
+        self._thread.start()
+
+    def stop(self, timeout: float = 1.0) -> None:
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join(timeout)
+        self._thread = None
+
+    @property
+    def running(self) -> bool:
+        return self._thread is not None and self._thread.is_alive()
+
+    def _run(self) -> None:
+        while not self._stop.wait(1.0 / ANALYSIS_RATE):
+            try:
+                self.analyze()
+            except Exception as e:
+                LOGGER.error("Spectrum", f"Análise falhou: {e}")
+
+    def analyze(self, now: Optional[float] = None) -> None:
+        """Um passo: FFT das janelas mais recentes, bandas, suavização, publica."""
+        now = time.monotonic() if now is None else now
+        dt = 1.0 / ANALYSIS_RATE if self._last is None else max(1e-3, now - self._last)
+        self._last = now
+
+        ring, frames = self.ring, self._frames
+        fresh = np.zeros(SPECTRUM_SLOTS, dtype=bool)
+        for slot in range(SPECTRUM_SLOTS):
+            written = ring.written(slot)
+            if written != self._seen[slot] and ring.latest(slot, frames[slot]):
+                fresh[slot] = True
+            self._seen[slot] = written
+
+        target = np.full_like(self._db, SPECTRUM_FLOOR_DB)
+        rows = np.flatnonzero(fresh)
+        if len(rows):
+            spectrum = np.fft.rfft(frames[rows] * self._window, axis=1)
+            power = spectrum.real ** 2 + spectrum.imag ** 2
+            power *= self._scale
+            bands = np.empty((len(rows), SPECTRUM_BANDS))
+            n = self._narrow
+            for k in range(len(rows)):          # slots (≤ 4), não bandas
+                bands[k, :n] = np.interp(self._centers, self._bins, power[k])
+            if n < SPECTRUM_BANDS:
+                bands[:, n:] = np.maximum.reduceat(power[:, self._lo:self._hi], self._starts, axis=1)
+            np.maximum(bands, 1e-12, out=bands)
+            target[rows] = np.maximum(10.0 * np.log10(bands), SPECTRUM_FLOOR_DB)
+
+        # Balística: sobe com ATTACK_TIME, desce com RELEASE_TIME
+        rise = 1.0 - np.exp(-dt / ATTACK_TIME)
+        fall = 1.0 - np.exp(-dt / RELEASE_TIME)
+        db = self._db
+        db += np.where(target > db, rise, fall) * (target - db)
+
+        back = 1 - self._front
+        np.divide(db - SPECTRUM_FLOOR_DB, -SPECTRUM_FLOOR_DB, out=self._published[back], casting="unsafe")
+        np.clip(self._published[back], 0.0, 1.0, out=self._published[back])
+        self._front = back
+        self.seq += 1
+
+    # ------------------------------------------------------------------
+    # Leitura (qualquer thread)
+    # ------------------------------------------------------------------
+
+    def read(self, out: Optional[np.ndarray] = None) -> np.ndarray:
+        """Cópia (SPECTRUM_SLOTS, SPECTRUM_BANDS) float32 do último espectro, 0–1."""
+        if out is None:
+            out = np.empty((SPECTRUM_SLOTS, SPECTRUM_BANDS), dtype=np.float32)
+        for _ in range(4):
+            seq = self.seq
+            out[:] = self._published[self._front]
+            if self.seq - seq < 2:          # o buffer copiado não foi reescrito
+                break
+        return out
+
+    def reset(self) -> None:
+        self._db.fill(SPECTRUM_FLOOR_DB)
+        self._published.fill(0.0)
+
+    def __repr__(self) -> str:
+        state = "rodando" if self.running else "parado"
+        return f"SpectrumAnalyzer({SPECTRUM_BANDS} bandas, FFT {self.fft_size}, {state})"
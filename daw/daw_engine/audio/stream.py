@@ -9,7 +9,10 @@ from __future__ import annotations
 
 import sounddevice as sd
 
+from .arena import ENGINE_ARENA
+from .buffer import BUFFER_POOL
 from .config import ENGINE_CONFIG
+from .realtime import REALTIME
 
 
 class OutputStream:
@@ -28,6 +31,28 @@ class OutputStream:
 
             return
 
+        # Buffers do tamanho do bloco prontos antes do primeiro callback
+
+        BUFFER_POOL.preallocate(
+
+            4,
+
+            ENGINE_CONFIG.buffer_size,
+
+            ENGINE_CONFIG.channels,
+        )
+
+        # Scratch por bloco dimensionado pelo buffer_size atual
+
+        if ENGINE_ARENA.buffer_size != ENGINE_CONFIG.buffer_size:
+
+            ENGINE_ARENA.configure(ENGINE_CONFIG.buffer_size)
+
+        # Modo tempo real (opt-in): prefault + mlock dos pools; o callback
+        # registra a própria thread no primeiro bloco
+
+        REALTIME.prepare()
+
         self.stream = sd.OutputStream(
 
             samplerate=ENGINE_CONFIG.sample_rate,
@@ -58,6 +83,14 @@ class OutputStream:
 
         self.stream = None
 
+        ENGINE_ARENA.release_thread()
+
+        REALTIME.release()
+
+        if ENGINE_ARENA.debug:
+
+            ENGINE_ARENA.report()
+
     # ------------------------------------------
 
     @property
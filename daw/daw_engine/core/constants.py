@@ -38,7 +38,7 @@ DEFAULT_BPM = 120
 
 DEFAULT_PPQ = 960
 
-MAX_CHANNELS = 2
+MAX_CHANNELS = 16    # até ambisônico de 3ª ordem — ver audio/layout.py
 
 MIN_BPM = 20
 
@@ -37,6 +37,9 @@ from .logger import LOGGER
 from .constants import EngineState, DEFAULT_BPM
 
 
+LOADER_POLL_INTERVAL = 0.05     # s — entrega de mídia do ProjectLoader
+
+
 class Engine:
     """
     Singleton do motor DAW.
@@ -77,6 +80,7 @@ class Engine:
         self.scheduler = Scheduler()
         self.session = Session()
         self.state = State()
+        self.state.events = self.events     # seleção emite EVENT_SELECTION_CHANGE
         self.history = History()
         self.registry = Registry()
 
@@ -90,6 +94,8 @@ class Engine:
         # Guardamos a referência da *função* para poder removê-la depois
         # (bpy.app.handlers.append retorna None, não a função)
         self._frame_handler = self._update
+        # Mesmo motivo: timers.is_registered/unregister comparam a referência
+        self._loader_timer = self._poll_loader
 
         LOGGER.info("Engine", f"Motor DAW inicializado — BPM padrão: {DEFAULT_BPM}")
 
@@ -112,10 +118,13 @@ class Engine:
         # Adiciona o handler de frame (a referência da função, não o retorno)
         if self._frame_handler not in bpy.app.handlers.frame_change_post:
             bpy.app.handlers.frame_change_post.append(self._frame_handler)
+        if not bpy.app.timers.is_registered(self._loader_timer):
+            bpy.app.timers.register(self._loader_timer, persistent=True)
 
         # Garante que existe um projeto ativo
         if self.session.current_project is None:
             self.session.new_project()
+        self._bind_project()
 
         LOGGER.info("Engine", "Motor iniciado.")
 
@@ -142,9 +151,19 @@ class Engine:
                 bpy.app.handlers.frame_change_post.remove(self._frame_handler)
         except (ValueError, AttributeError):
             pass
+        if bpy.app.timers.is_registered(self._loader_timer):
+            bpy.app.timers.unregister(self._loader_timer)
+        from ...modules.project.load import LOADER
+        LOADER.cancel()
 
         LOGGER.info("Engine", "Motor encerrado.")
 
+    def _poll_loader(self) -> float:
+        """Timer do Blender: entrega progresso/clips prontos do ProjectLoader."""
+        from ...modules.project.load import LOADER
+        LOADER.poll()
+        return LOADER_POLL_INTERVAL
+
     # ------------------------------------------------------------------
     # Handler de frame do Blender
     # ------------------------------------------------------------------
@@ -260,19 +279,34 @@ class Engine:
         """Cria um novo projeto vazio."""
         self._stop_transport()
         self.history.clear()
+        from ...modules.project.load import LOADER
+        LOADER.cancel()             # mídia do projeto anterior não interessa mais
         self.session.new_project(name)
+        self._bind_project()
         LOGGER.info("Engine", f"Novo projeto: '{name}'")
 
     def open_project(self, filepath: str) -> None:
-        """Abre um projeto salvo em disco."""
+        """
+        Abre um projeto salvo em disco pelo ProjectLoader: retorna assim que
+        a estrutura é lida; a mídia chega pelo timer _poll_loader.
+        """
+        from ...modules.project.load import LOADER
+
         self._stop_transport()
         self.history.clear()
         try:
-            self.session.open_project(filepath)
+            self.session.open_project(filepath, loader=LOADER)
+            self._bind_project()
             LOGGER.info("Engine", f"Projeto aberto: {filepath}")
         except Exception as e:
             LOGGER.error("Engine", f"Falha ao abrir projeto '{filepath}': {e}")
 
+    def _bind_project(self) -> None:
+        """Clips do projeto atual viram alvos magnéticos do SNAP."""
+        from ...modules.playlist.snapping import SNAP
+        proj = self.session.current_project
+        SNAP.bind_timeline(proj.timeline if proj is not None else None)
+
     def save_project(self) -> None:
         """Salva o projeto atual."""
         if self.session.current_project is None:
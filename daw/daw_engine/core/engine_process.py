@@ -0,0 +1,342 @@
+# core/engine_process.py
+"""
+Supervisor da engine de áudio fora do processo (lado do Blender).
+
+Por que:
+- register.py carregava a DLL no processo do Blender via ctypes e um
+  timer '_watchdog' perguntava a cada 5 s se ela ainda estava viva: um
+  crash na engine derrubava o Blender, e um travamento levava até 5 s
+  para ser notado (e nem era detectado — só _engine_ok=False era).
+- Agora a engine roda em outro processo (ipc/engine_host.py). Comandos
+  vão por um CommandRing em memória compartilhada; o estado (posição,
+  picos, CPU, xruns, espectro) volta num StateBlock com seqlock — ler o
+  estado no redraw é uma cópia de ~1.7 KB, sem chamada à engine.
+
+Heartbeat:
+    O host incrementa 'heartbeat' a cada volta (~5 ms). check() — barato,
+    chamado pelo timer do Blender a cada CHECK_INTERVAL — compara com o
+    último valor visto: parado por mais de HEARTBEAT_TIMEOUT, ou processo
+    morto, e o host é morto e relançado. BPM/volume/faixas enviados antes
+    são reenviados ao novo processo.
+
+API compatível com o DAWEngine do daw_bridge (play, stop, record,
+set_bpm, set_master_volume, add_track, load_audio, get_state, shutdown)
+para o register.py trocar um pelo outro sem mexer nos operadores.
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+import os
+import subprocess
+import sys
+import time
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+from ..ipc.shm import CommandRing, EngineStatus, Op, StateBlock
+from .logger import LOGGER
+
+
+HEARTBEAT_TIMEOUT = 1.0        # s sem heartbeat → engine travada
+STARTUP_TIMEOUT   = 10.0       # s até o primeiro heartbeat (imports, dispositivo)
+CHECK_INTERVAL    = 0.25       # s — período sugerido do timer que chama check()
+MAX_RESTARTS      = 5          # seguidos sem um heartbeat saudável no meio
+
+
+def _python_executable() -> str:
+    """
+    Interpretador para o processo da engine. Dentro do Blender,
+    sys.executable já é o Python embutido nas versões atuais; em builds
+    antigas era o binário do Blender — procura o python em sys.prefix.
+    """
+    exe = Path(sys.executable)
+    if "blender" not in exe.stem.lower():
+        return str(exe)
+    for cand in sorted((Path(sys.prefix) / "bin").glob("python*")):
+        if cand.is_file():
+            return str(cand)
+    return str(exe)
+
+
+class EngineProcess:
+    """Lança, comanda e vigia o processo da engine."""
+
+    def __init__(self) -> None:
+        self._proc: Optional[subprocess.Popen] = None
+        self._ring:  Optional[CommandRing] = None
+        self._state: Optional[StateBlock] = None
+        self._options: Dict[str, object] = {}
+
+        self._last_beat: int = 0
+        self._last_beat_at: float = 0.0
+        self._started_at: float = 0.0
+        self._healthy: bool = False
+
+        self.restarts: int = 0
+        self._failures: int = 0
+
+        # Reenviados após um restart: último valor de cada ajuste, faixas
+        # e faixas no analisador de espectro
+        self._sticky: Dict[Op, Tuple] = {}
+        self._tracks: List[Tuple] = []
+        self._analysis: Dict[int, int] = {}      # slot do espectro → id local da faixa
+        self._next_track_id: int = 1
+
+    # ------------------------------------------------------------------
+    # Ciclo de vida
+    # ------------------------------------------------------------------
+
+    def launch(
+        self,
+        dll_path:    Optional[str] = None,
+        audio:       bool = True,
+        sample_rate: int = 0,
+        buffer_size: int = 0,
+        realtime:    bool = False,
+    ) -> bool:
+        """
+        Sobe o processo da engine. True se o processo foi criado.
+
+        realtime=True: callback em SCHED_FIFO e mlockall no processo da
+        engine (audio/realtime.py) — o Blender continua normal.
+        """
+        if self.running:
+            return True
+        self._options = {"dll_path": dll_path, "audio": audio,
+                         "sample_rate": sample_rate, "buffer_size": buffer_size,
+                         "realtime": realtime}
+        return self._spawn()
+
+    def _spawn(self) -> bool:
+        opts = self._options
+        self._ring = CommandRing(capacity=256)
+        self._state = StateBlock()
+
+        addon_root = Path(__file__).resolve().parent.parent.parent     # .../daw
+        package = __package__.rsplit(".daw_engine", 1)[0]
+        cmd = [
+            _python_executable(),
+            str(Path(__file__).resolve().parent.parent / "ipc" / "launch.py"),
+            "--root", str(addon_root),
+            "--package", package,
+            "--ring", self._ring.name,
+            "--state", self._state.name,
+            "--parent-pid", str(os.getpid()),
+        ]
+        if opts.get("dll_path"):
+            cmd += ["--dll", str(opts["dll_path"])]
+        if not opts.get("audio", True):
+            cmd.append("--no-audio")
+        if opts.get("sample_rate"):
+            cmd += ["--sample-rate", str(opts["sample_rate"])]
+        if opts.get("buffer_size"):
+            cmd += ["--buffer-size", str(opts["buffer_size"])]
+        if opts.get("realtime"):
+            cmd.append("--realtime")
+
+        try:
+            self._proc = subprocess.Popen(cmd, stdin=subprocess.DEVNULL)
+        except OSError as e:
+            LOGGER.error("EngineProcess", f"Falha ao lançar a engine: {e}")
+            self._close_blocks()
+            return False
+
+        self._started_at = time.monotonic()
+        self._last_beat = 0
+        self._last_beat_at = self._started_at
+        self._healthy = False
+        self._replay()
+        LOGGER.info("EngineProcess", f"Engine lançada (pid {self._proc.pid})")
+        return True
+
+    def shutdown(self, timeout: float = 2.0) -> None:
+        """Pede SHUTDOWN, espera e mata se preciso."""
+        proc = self._proc
+        if proc is not None:
+            if proc.poll() is None and self._ring is not None:
+                self._ring.push(Op.SHUTDOWN)
+                try:
+                    proc.wait(timeout)
+                except subprocess.TimeoutExpired:
+                    proc.kill()
+                    proc.wait()
+            LOGGER.info("EngineProcess", "Engine encerrada")
+        self._proc = None
+        self._close_blocks()
+
+    def _kill(self) -> None:
+        proc = self._proc
+        if proc is not None and proc.poll() is None:
+            proc.kill()
+            try:
+                proc.wait(2.0)
+            except subprocess.TimeoutExpired:
+                pass
+        self._proc = None
+        self._close_blocks()
+
+    def _close_blocks(self) -> None:
+        for block in (self._ring, self._state):
+            if block is not None:
+                block.close()
+        self._ring = self._state = None
+
+    # ------------------------------------------------------------------
+    # Heartbeat
+    # ------------------------------------------------------------------
+
+    @property
+    def running(self) -> bool:
+        return self._proc is not None and self._proc.poll() is None
+
+    @property
+    def alive(self) -> bool:
+        """Processo de pé e heartbeat andando."""
+        return self.running and self._healthy
+
+    def check(self) -> bool:
+        """
+        Chamar periodicamente (timer do Blender). Reinicia a engine se o
+        processo morreu ou o heartbeat parou. Retorna alive.
+        """
+        if self._proc is None:
+            return False
+
+        now = time.monotonic()
+        status = self._state.read() if self._state is not None else None
+        if status is not None and status.heartbeat != self._last_beat:
+            self._last_beat = status.heartbeat
+            self._last_beat_at = now
+            if not self._healthy:
+                self._healthy = True
+                self._failures = 0
+
+        if not self.running:
+            reason = f"processo saiu (código {self._proc.returncode})"
+        else:
+            limit = HEARTBEAT_TIMEOUT if self._healthy else STARTUP_TIMEOUT
+            if now - self._last_beat_at <= limit:
+                return self._healthy
+            reason = f"sem heartbeat há {now - self._last_beat_at:.1f}s"
+
+        self._healthy = False
+        self._failures += 1
+        if self._failures > MAX_RESTARTS:
+            LOGGER.error("EngineProcess", f"Engine caiu ({reason}) — desistindo após {MAX_RESTARTS} tentativas")
+            self._kill()
+            return False
+
+        LOGGER.warning("EngineProcess", f"Engine caiu ({reason}) — reiniciando")
+        self._kill()
+        self.restarts += 1
+        self._spawn()
+        return False
+
+    # ------------------------------------------------------------------
+    # Comandos
+    # ------------------------------------------------------------------
+
+    def send(self, op: Op, i0: int = 0, i1: int = 0, f0: float = 0.0, f1: float = 0.0,
+             text: str = "") -> bool:
+        if self._ring is None:
+            return False
+        return self._ring.push(op, i0, i1, f0, f1, text)
+
+    def _set(self, op: Op, *args) -> bool:
+        self._sticky[op] = args
+        return self.send(op, *args)
+
+    def _replay(self) -> None:
+        for args in self._tracks:
+            self.send(Op.ADD_TRACK, *args[:2], text=args[2])
+            if args[3]:
+                self.send(Op.LOAD_AUDIO, args[0], text=args[3])
+            for key in args[4]:
+                self.send(Op.ADD_PLUGIN, args[0], text=key)
+        for op, args in self._sticky.items():
+            self.send(op, *args)
+        for slot, track_id in self._analysis.items():
+            self.send(Op.ANALYZE_TRACK, slot, track_id)
+
+    # API do DAWEngine ------------------------------------------------
+
+    def play(self) -> bool:
+        return self.send(Op.PLAY)
+
+    def stop(self) -> bool:
+        return self.send(Op.STOP)
+
+    def pause(self) -> bool:
+        return self.send(Op.PAUSE)
+
+    def record(self) -> bool:
+        return self.send(Op.RECORD)
+
+    def set_position(self, seconds: float) -> bool:
+        return self.send(Op.SET_POSITION, f0=seconds)
+
+    def set_bpm(self, bpm: float) -> bool:
+        return self._set(Op.SET_BPM, 0, 0, float(bpm))
+
+    def set_master_volume(self, volume: float) -> bool:
+        return self._set(Op.SET_MASTER_VOLUME, 0, 0, float(volume))
+
+    def note_on(self, channel: int, note: int, velocity: int = 100) -> bool:
+        return self.send(Op.NOTE_ON, channel, note, float(velocity))
+
+    def note_off(self, channel: int, note: int) -> bool:
+        return self.send(Op.NOTE_OFF, channel, note)
+
+    def reconfigure(self, sample_rate: int = 0, buffer_size: int = 0) -> bool:
+        return self._set(Op.RECONFIGURE, int(sample_rate or 0), int(buffer_size or 0))
+
+    def add_track(self, name: str, kind: int = 0) -> int:
+        """Id local da faixa — o host mapeia para o id real da engine."""
+        track_id = self._next_track_id
+        self._next_track_id += 1
+        self._tracks.append([track_id, kind, name, "", []])
+        self.send(Op.ADD_TRACK, track_id, kind, text=name)
+        return track_id
+
+    def load_audio(self, track_id: int, path: str) -> bool:
+        for t in self._tracks:
+            if t[0] == track_id:
+                t[3] = path
+        return self.send(Op.LOAD_AUDIO, track_id, text=path)
+
+    def add_plugin(self, track_id: int, key: str) -> bool:
+        """Insert LV2/CLAP ('clap:<id>' / 'lv2:<uri>') — roda no sandbox da engine."""
+        for t in self._tracks:
+            if t[0] == track_id:
+                t[4].append(key)
+        return self.send(Op.ADD_PLUGIN, track_id, text=key)
+
+    def open_midi_input(self, port: str = "", virtual: bool = False, track_id: int = 0) -> bool:
+        """
+        Abre a entrada MIDI ao vivo no processo da engine (porta vazia =
+        primeira). track_id arma a faixa que recebe as notas. Reaberta
+        depois de um restart.
+        """
+        return self._set(Op.MIDI_OPEN, int(virtual), int(track_id), 0.0, 0.0, port)
+
+    def close_midi_input(self) -> bool:
+        self._sticky.pop(Op.MIDI_OPEN, None)
+        return self.send(Op.MIDI_CLOSE)
+
+    def analyze_track(self, slot: int, track_id: int) -> bool:
+        """Espectro da faixa no slot 'slot' (1…) do StateBlock; track_id 0 libera o slot."""
+        self._analysis[slot] = track_id
+        return self.send(Op.ANALYZE_TRACK, slot, track_id)
+
+    def get_state(self) -> Optional[EngineStatus]:
+        """Último estado publicado (cópia consistente, sem chamar a engine)."""
+        return self._state.read() if self._state is not None else None
+
+    def __repr__(self) -> str:
+        pid = self._proc.pid if self._proc is not None else None
+        return f"EngineProcess(pid={pid}, alive={self.alive}, restarts={self.restarts})"
+
+
+# Instância global
+ENGINE_PROCESS = EngineProcess()
@@ -33,6 +33,7 @@ EVENT_TRACK_ADD    = "track_add"
 EVENT_TRACK_REMOVE = "track_remove"
 EVENT_CLIP_ADD     = "clip_add"
 EVENT_CLIP_REMOVE  = "clip_remove"
+EVENT_SELECTION_CHANGE = "selection_change"
 
 
 class EventSystem:
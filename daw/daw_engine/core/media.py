@@ -0,0 +1,461 @@
+# core/media.py
+"""
+Pool de mídia endereçado por conteúdo.
+
+Por que:
+- Project.media_files era uma lista com teste de pertença O(n), e dois
+  clips apontando para o mesmo arquivo (ou para cópias idênticas em
+  pastas diferentes) decodificavam o áudio duas vezes.
+
+MediaPool:
+    Cada arquivo é identificado pelo hash BLAKE2b do CONTEÚDO. O hash é
+    caro (lê o arquivo inteiro), então fica num índice persistente por
+    (caminho, tamanho, mtime) — só é recalculado se o arquivo mudar.
+    Um MediaAsset por hash: WAV PCM/float é mapeado com np.memmap (zero
+    cópia, o SO pagina sob demanda); outros formatos são decodificados
+    uma vez com soundfile. Clips pegam o asset com acquire() e devolvem
+    com release(); com refcount 0 o áudio sai da memória.
+
+DerivedCache:
+    Artefatos derivados de um asset (versões reamostradas, pirâmides de
+    picos, renders com time-stretch...) em disco, um .npy por
+    (asset, tipo, parâmetros), lidos por mmap. Tamanho total limitado por
+    orçamento em bytes com despejo LRU (último acesso).
+"""
+from __future__ import annotations
+
+import hashlib
+import json
+import os
+import struct
+import threading
+import time
+from dataclasses import dataclass, field
+from typing import Any, Dict, List, Optional, Set, Tuple
+
+import numpy as np
+
+from .logger import LOGGER
+
+
+HASH_CHUNK = 1 << 20                         # leitura em blocos de 1 MiB
+DEFAULT_DERIVED_BUDGET = 2 * 1024 ** 3       # 2 GiB de artefatos derivados
+
+
+def _media_dir() -> str:
+    base = os.path.join(os.path.expanduser("~"), ".config", "blender_daw", "media")
+    os.makedirs(base, exist_ok=True)
+    return base
+
+
+def content_hash(path: str) -> str:
+    """BLAKE2b (128 bits) do conteúdo inteiro do arquivo."""
+    h = hashlib.blake2b(digest_size=16)
+    with open(path, "rb") as f:
+        while True:
+            chunk = f.read(HASH_CHUNK)
+            if not chunk:
+                break
+            h.update(chunk)
+    return h.hexdigest()
+
+
+# ------------------------------------------------------------------
+# Leitura zero-cópia de WAV
+# ------------------------------------------------------------------
+
+# formato WAVE (1 = PCM, 3 = IEEE float, 0xFFFE = extensible) + bits → dtype
+_WAV_DTYPES = {
+    (1, 16): np.dtype("<i2"),
+    (1, 32): np.dtype("<i4"),
+    (3, 32): np.dtype("<f4"),
+    (3, 64): np.dtype("<f8"),
+}
+
+
+def _wav_layout(path: str) -> Optional[Tuple[int, int, int, np.dtype]]:
+    """
+    (offset do chunk data, frames, canais, dtype) se o arquivo for um WAV
+    que pode ser mapeado direto; None caso contrário (24 bits, compressão...).
+    """
+    try:
+        with open(path, "rb") as f:
+            riff = f.read(12)
+            if len(riff) < 12 or riff[:4] != b"RIFF" or riff[8:12] != b"WAVE":
+                return None
+            fmt = None
+            while True:
+                head = f.read(8)
+                if len(head) < 8:
+                    return None
+                cid, size = head[:4], struct.unpack("<I", head[4:])[0]
+                if cid == b"fmt ":
+                    body = f.read(size)
+                    tag, channels, _sr, _br, _align, bits = struct.unpack("<HHIIHH", body[:16])
+                    if tag == 0xFFFE and len(body) >= 26:
+                        tag = struct.unpack("<H", body[24:26])[0]
+                    fmt = (tag, bits, channels)
+                    if size & 1:
+                        f.seek(1, 1)
+                elif cid == b"data":
+                    if fmt is None:
+                        return None
+                    dtype = _WAV_DTYPES.get((fmt[0], fmt[1]))
+                    if dtype is None:
+                        return None
+                    frames = size // (dtype.itemsize * fmt[2])
+                    return f.tell(), frames, fmt[2], dtype
+                else:
+                    f.seek(size + (size & 1), 1)
+    except (OSError, struct.error):
+        return None
+
+
+# ------------------------------------------------------------------
+# Asset
+# ------------------------------------------------------------------
+
+@dataclass
+class MediaAsset:
+    """Um conteúdo de áudio único, compartilhado por todos os clips que o usam."""
+    hash:        str
+    path:        str
+    paths:       Set[str] = field(default_factory=set)   # todos os caminhos com esse conteúdo
+    refcount:    int   = 0
+    sample_rate: int   = 0
+    channels:    int   = 0
+    frames:      int   = 0
+    size:        int   = 0
+    mapped:      bool  = False       # True = np.memmap do arquivo; False = decodificado
+    _data:       Optional[np.ndarray] = None
+    _scale:      float = 1.0         # PCM inteiro mapeado → float
+
+    @property
+    def loaded(self) -> bool:
+        return self._data is not None
+
+    @property
+    def duration(self) -> float:
+        return self.frames / self.sample_rate if self.sample_rate else 0.0
+
+    def read(self, start: int = 0, frames: Optional[int] = None) -> np.ndarray:
+        """Trecho (frames, canais) float32. Mapeado: só as páginas tocadas são lidas."""
+        if self._data is None:
+            raise RuntimeError(f"MediaAsset {self.hash[:8]} não carregado (acquire() antes)")
+        end = self.frames if frames is None else min(self.frames, start + frames)
+        chunk = self._data[start:end]
+        if chunk.dtype == np.float32:
+            return chunk if not self.mapped else np.array(chunk)
+        out = chunk.astype(np.float32)
+        if self._scale != 1.0:
+            out *= self._scale
+        return out
+
+    @property
+    def data(self) -> np.ndarray:
+        """Array completo (memmap ou decodificado) no dtype de origem."""
+        if self._data is None:
+            raise RuntimeError(f"MediaAsset {self.hash[:8]} não carregado")
+        return self._data
+
+    def __repr__(self) -> str:
+        mode = "mmap" if self.mapped else ("decoded" if self.loaded else "unloaded")
+        return f"MediaAsset({self.hash[:8]}, {os.path.basename(self.path)}, refs={self.refcount}, {mode})"
+
+
+# ------------------------------------------------------------------
+# Pool
+# ------------------------------------------------------------------
+
+class MediaPool:
+    """
+    Assets únicos por hash de conteúdo, com contagem de referências.
+
+    Uso:
+        asset = MEDIA_POOL.acquire(path)      # carrega (ou reaproveita)
+        block = asset.read(start, frames)
+        MEDIA_POOL.release(asset)             # refcount 0 → libera áudio
+    """
+
+    def __init__(self, index_path: Optional[str] = None) -> None:
+        self._index_path = index_path
+        self._lock = threading.RLock()
+        self._assets: Dict[str, MediaAsset] = {}            # hash → asset
+        self._by_path: Dict[str, str] = {}                  # caminho → hash
+        self._index: Optional[Dict[str, List[Any]]] = None  # caminho → [size, mtime, hash]
+        self._index_dirty = False
+
+    # ------------------------------------------------------------------
+    # Hash com índice persistente
+    # ------------------------------------------------------------------
+
+    def _load_index(self) -> Dict[str, List[Any]]:
+        if self._index is None:
+            self._index = {}
+            path = self._index_path or os.path.join(_media_dir(), "index.json")
+            self._index_path = path
+            try:
+                with open(path, "r", encoding="utf-8") as f:
+                    self._index = json.load(f)
+            except (OSError, ValueError):
+                pass
+        return self._index
+
+    def save_index(self) -> None:
+        with self._lock:
+            if not self._index_dirty or self._index is None:
+                return
+            tmp = f"{self._index_path}.tmp"
+            try:
+                with open(tmp, "w", encoding="utf-8") as f:
+                    json.dump(self._index, f)
+                os.replace(tmp, self._index_path)
+                self._index_dirty = False
+            except OSError as e:
+                LOGGER.warning("MediaPool", f"Índice de hashes não gravado: {e}")
+
+    def known_hash(self, path: str, size: int, mtime: float) -> Optional[str]:
+        """Hash já calculado para esse (caminho, tamanho, mtime), sem ler o arquivo."""
+        with self._lock:
+            rec = self._load_index().get(os.path.normpath(path))
+        if rec and rec[0] == size and rec[1] == mtime:
+            return rec[2]
+        return None
+
+    def hash_of(self, path: str) -> str:
+        """Hash do conteúdo — do índice se o arquivo não mudou, senão calculado."""
+        path = os.path.normpath(path)
+        st = os.stat(path)
+        known = self.known_hash(path, st.st_size, st.st_mtime)
+        if known is not None:
+            return known
+        digest = content_hash(path)
+        with self._lock:
+            self._load_index()[path] = [st.st_size, st.st_mtime, digest]
+            self._index_dirty = True
+        return digest
+
+    # ------------------------------------------------------------------
+    # Referências
+    # ------------------------------------------------------------------
+
+    def acquire(self, path: str) -> MediaAsset:
+        """Asset do conteúdo de 'path' com o áudio carregado; refcount += 1."""
+        path = os.path.normpath(path)
+        digest = self.hash_of(path)
+        with self._lock:
+            asset = self._assets.get(digest)
+            if asset is None:
+                asset = MediaAsset(hash=digest, path=path)
+                self._assets[digest] = asset
+            asset.paths.add(path)
+            self._by_path[path] = digest
+            asset.refcount += 1
+            if not asset.loaded:
+                self._load(asset)
+            return asset
+
+    def release(self, asset: MediaAsset) -> None:
+        """Devolve uma referência. Com refcount 0 o áudio é liberado."""
+        with self._lock:
+            asset.refcount = max(0, asset.refcount - 1)
+            if asset.refcount == 0:
+                asset._data = None
+
+    def _load(self, asset: MediaAsset) -> None:
+        asset.size = os.path.getsize(asset.path)
+        layout = _wav_layout(asset.path)
+        if layout is not None:
+            offset, frames, channels, dtype = layout
+            import soundfile as sf
+            asset.sample_rate = int(sf.info(asset.path).samplerate)
+            asset.channels = channels
+            asset.frames = frames
+            asset._data = np.memmap(asset.path, dtype=dtype, mode="r",
+                                    offset=offset, shape=(frames, channels))
+            asset._scale = 1.0 / (1 << (dtype.itemsize * 8 - 1)) if dtype.kind == "i" else 1.0
+            asset.mapped = True
+            return
+
+        import soundfile as sf
+        data, sr = sf.read(asset.path, dtype="float32", always_2d=True)
+        asset.sample_rate = int(sr)
+        asset.channels = data.shape[1]
+        asset.frames = data.shape[0]
+        asset._data = data
+        asset._scale = 1.0
+        asset.mapped = False
+
+    # ------------------------------------------------------------------
+    # Consulta
+    # ------------------------------------------------------------------
+
+    def get(self, digest: str) -> Optional[MediaAsset]:
+        return self._assets.get(digest)
+
+    def asset_for_path(self, path: str) -> Optional[MediaAsset]:
+        digest = self._by_path.get(os.path.normpath(path))
+        return self._assets.get(digest) if digest else None
+
+    @property
+    def assets(self) -> List[MediaAsset]:
+        return list(self._assets.values())
+
+    def resident_bytes(self) -> int:
+        """Bytes decodificados em memória (mapeados não contam — são do page cache)."""
+        return sum(a._data.nbytes for a in self._assets.values()
+                   if a._data is not None and not a.mapped)
+
+    def purge(self) -> int:
+        """Esquece assets sem referências. Retorna quantos saíram."""
+        with self._lock:
+            dead = [h for h, a in self._assets.items() if a.refcount == 0]
+            for h in dead:
+                for p in self._assets[h].paths:
+                    self._by_path.pop(p, None)
+                del self._assets[h]
+            return len(dead)
+
+    def __len__(self) -> int:
+        return len(self._assets)
+
+    def __repr__(self) -> str:
+        live = sum(1 for a in self._assets.values() if a.refcount)
+        return f"MediaPool({len(self._assets)} assets, {live} em uso)"
+
+
+# ------------------------------------------------------------------
+# Cache de derivados
+# ------------------------------------------------------------------
+
+class DerivedCache:
+    """
+    Artefatos derivados por asset em disco, com despejo LRU por orçamento.
+
+        <root>/<hash[:2]>/<hash>/<tipo>-<params>.npy
+
+    O índice (caminho → [bytes, último acesso]) é reconstruído varrendo a
+    pasta na primeira consulta; o "último acesso" vem do mtime do arquivo,
+    atualizado com os.utime() a cada get() — sobrevive entre sessões.
+    """
+
+    def __init__(self, root: Optional[str] = None, budget: int = DEFAULT_DERIVED_BUDGET) -> None:
+        # Pasta criada só na primeira gravação — importar não toca o disco
+        self.root = root or os.path.join(
+            os.path.expanduser("~"), ".config", "blender_daw", "media", "derived")
+        self.budget = int(budget)
+        self._lock = threading.Lock()
+        self._entries: Optional[Dict[str, List[float]]] = None
+        self._total = 0
+
+    @staticmethod
+    def _key(kind: str, params: Optional[Dict[str, Any]]) -> str:
+        if not params:
+            return kind
+        blob = json.dumps(params, sort_keys=True, separators=(",", ":"))
+        return f"{kind}-{hashlib.blake2b(blob.encode('utf-8'), digest_size=8).hexdigest()}"
+
+    def path_for(self, asset_id: str, kind: str, params: Optional[Dict[str, Any]] = None) -> str:
+        return os.path.join(self.root, asset_id[:2], asset_id, f"{self._key(kind, params)}.npy")
+
+    def _scan(self) -> Dict[str, List[float]]:
+        if self._entries is None:
+            self._entries = {}
+            self._total = 0
+            for dirpath, _dirs, files in os.walk(self.root):
+                for name in files:
+                    if name.endswith(".npy"):
+                        full = os.path.join(dirpath, name)
+                        try:
+                            st = os.stat(full)
+                        except OSError:
+                            continue
+                        self._entries[full] = [st.st_size, st.st_mtime]
+                        self._total += st.st_size
+        return self._entries
+
+    # ------------------------------------------------------------------
+
+    def get(self, asset_id: str, kind: str, params: Optional[Dict[str, Any]] = None,
+            mmap: bool = True) -> Optional[np.ndarray]:
+        """Artefato em cache (por mmap) ou None."""
+        path = self.path_for(asset_id, kind, params)
+        with self._lock:
+            entry = self._scan().get(path)
+            if entry is None:
+                return None
+            now = time.time()
+            entry[1] = now
+        try:
+            os.utime(path, (now, now))
+            return np.load(path, mmap_mode="r" if mmap else None)
+        except (OSError, ValueError):
+            self._forget(path)
+            return None
+
+    def put(self, asset_id: str, kind: str, array: np.ndarray,
+            params: Optional[Dict[str, Any]] = None) -> str:
+        """Grava um artefato e despeja os menos usados se passar do orçamento."""
+        path = self.path_for(asset_id, kind, params)
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        tmp = f"{path}.tmp.npy"
+        np.save(tmp, np.ascontiguousarray(array))
+        os.replace(tmp, path)
+        size = os.path.getsize(path)
+        with self._lock:
+            entries = self._scan()
+            old = entries.get(path)
+            if old is not None:
+                self._total -= int(old[0])
+            entries[path] = [size, time.time()]
+            self._total += size
+            self._evict(keep=path)
+        return path
+
+    def _evict(self, keep: str = "") -> None:
+        if self._total <= self.budget:
+            return
+        victims = sorted(self._entries.items(), key=lambda kv: kv[1][1])
+        for path, (size, _atime) in victims:
+            if self._total <= self.budget:
+                break
+            if path == keep:
+                continue
+            try:
+                os.remove(path)
+            except OSError:
+                pass
+            del self._entries[path]
+            self._total -= int(size)
+        LOGGER.info("DerivedCache", f"Cache de derivados reduzido para {self._total / 1e6:.1f} MB")
+
+    def _forget(self, path: str) -> None:
+        with self._lock:
+            entry = self._scan().pop(path, None)
+            if entry is not None:
+                self._total -= int(entry[0])
+
+    def drop_asset(self, asset_id: str) -> None:
+        """Remove todos os derivados de um asset."""
+        folder = os.path.join(self.root, asset_id[:2], asset_id)
+        with self._lock:
+            for path in [p for p in self._scan() if p.startswith(folder + os.sep)]:
+                try:
+                    os.remove(path)
+                except OSError:
+                    pass
+                self._total -= int(self._entries.pop(path)[0])
+
+    @property
+    def total_bytes(self) -> int:
+        with self._lock:
+            self._scan()
+            return self._total
+
+    def __repr__(self) -> str:
+        return f"DerivedCache({self.total_bytes / 1e6:.1f}/{self.budget / 1e6:.0f} MB)"
+
+
+# Instâncias globais
+MEDIA_POOL = MediaPool()
+DERIVED_CACHE = DerivedCache()
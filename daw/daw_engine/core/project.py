@@ -16,12 +16,14 @@ Correção vs versão anterior:
   mas loga o aviso para facilitar debug de migração futura).
 - Extensão de arquivo usava ".dawproj" hardcoded — agora usa
   PROJECT_EXTENSION de constants.py para manter consistência.
+- media_files era uma lista com teste `in` O(n) a cada add — agora tem um
+  set espelho; a mídia em si é compartilhada pelo MEDIA_POOL (core/media.py).
 """
 from __future__ import annotations
 
 import os
 import json
-from typing import Any, Dict, List, Optional
+from typing import Any, Dict, Iterable, List, Optional, Set
 
 from .settings import Settings
 from .timeline import Timeline
@@ -39,7 +41,11 @@ class Project:
         self.path: str = path or os.getcwd()
         self.settings = Settings()
         self.timeline = Timeline()
-        self.media_files: List[str] = []   # caminhos de arquivos de áudio referenciados
+        # Caminhos de arquivos de áudio referenciados. Lista (ordem estável
+        # para salvar) + set espelho para pertença O(1) — ver media_files.
+        self._media_files: List[str] = []
+        self._media_set:   Set[str]  = set()
+        self._assets:      List[Any] = []    # MediaAssets em uso (acquire_media)
 
     # ------------------------------------------------------------------
     # Persistência
@@ -117,20 +123,73 @@ class Project:
     # Gerenciamento de arquivos de mídia
     # ------------------------------------------------------------------
 
+    @property
+    def media_files(self) -> List[str]:
+        """Cópia da lista de mídia — edite com add/remove_media_file."""
+        return list(self._media_files)
+
+    @media_files.setter
+    def media_files(self, paths: Iterable[str]) -> None:
+        self._media_files = []
+        self._media_set = set()
+        for p in paths:
+            self.add_media_file(p)
+
+    def has_media_file(self, filepath: str) -> bool:
+        return filepath in self._media_set
+
     def add_media_file(self, filepath: str) -> None:
         """Registra um arquivo de áudio usado pelo projeto (evita duplicatas)."""
-        if filepath not in self.media_files:
-            self.media_files.append(filepath)
+        if filepath not in self._media_set:
+            self._media_set.add(filepath)
+            self._media_files.append(filepath)
 
     def remove_media_file(self, filepath: str) -> bool:
-        if filepath in self.media_files:
-            self.media_files.remove(filepath)
+        if filepath in self._media_set:
+            self._media_set.discard(filepath)
+            self._media_files.remove(filepath)
             return True
         return False
 
+    def acquire_media(self) -> List[Any]:
+        """
+        Carrega toda a mídia do projeto pelo MEDIA_POOL (core/media.py):
+        arquivos com o mesmo conteúdo viram um único asset compartilhado.
+        Devolva com release_media() ao fechar o projeto.
+        """
+        from .media import MEDIA_POOL
+        assets = []
+        for path in self._media_files:
+            try:
+                assets.append(MEDIA_POOL.acquire(path))
+            except OSError:
+                pass            # ausente — get_missing_media() reporta
+        self._assets = assets
+        MEDIA_POOL.save_index()
+        return assets
+
+    def release_media(self) -> None:
+        from .media import MEDIA_POOL
+        for asset in self._assets:
+            MEDIA_POOL.release(asset)
+        self._assets = []
+
     def get_missing_media(self) -> List[str]:
-        """Retorna a lista de arquivos de mídia referenciados que não existem no disco."""
-        return [f for f in self.media_files if not os.path.isfile(f)]
+        """
+        Retorna a lista de arquivos de mídia referenciados que não existem no disco.
+
+        Com muitos arquivos (ou mídia em rede/HD externo) os stat() rodam em
+        paralelo — cada um é dominado por latência de I/O, não por CPU.
+        """
+        files = self._media_files
+        if len(files) < 16:
+            return [f for f in files if not os.path.isfile(f)]
+
+        from concurrent.futures import ThreadPoolExecutor
+        with ThreadPoolExecutor(max_workers=min(16, len(files)),
+                                thread_name_prefix="daw-stat") as pool:
+            exists = list(pool.map(os.path.isfile, files))
+        return [f for f, ok in zip(files, exists) if not ok]
 
     def __repr__(self) -> str:
         return f"Project('{self.name}', tracks={len(self.timeline.tracks)})"
\ No newline at end of file
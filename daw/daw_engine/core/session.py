@@ -50,16 +50,21 @@ class Session:
         self._dirty = False
         return self.current_project
 
-    def open_project(self, filepath: str) -> Project:
+    def open_project(self, filepath: str, loader=None) -> Project:
         """
         Abre um projeto do disco.
         Levanta FileNotFoundError se o caminho não existir.
+        Com loader (ProjectLoader), só a estrutura é lida aqui — a mídia
+        carrega em segundo plano e chega por loader.poll().
         """
         if not os.path.isfile(filepath):
             raise FileNotFoundError(f"Arquivo de projeto não encontrado: {filepath}")
 
-        proj = Project()
-        proj.load(filepath)
+        if loader is not None:
+            proj = loader.open(filepath)
+        else:
+            proj = Project()
+            proj.load(filepath)
         self.current_project = proj
         self._dirty = False
         return proj
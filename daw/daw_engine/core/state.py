@@ -10,11 +10,107 @@ Correção vs versão anterior:
   (bug sutil: __init__ do Python roda de novo mesmo em singleton, mas como
   os atributos eram setados dentro do if cls._instance is None, estava
   correto — documentado aqui para deixar claro que é intencional).
+- selected_tracks/selected_clips eram listas: cada select/is_selected era
+  um 'in' O(n) e selecionar 20k clips por retângulo ficava quadrático.
+  Agora são Selection — dict id(obj) → obj: O(1), mantém a ordem de
+  inserção e não depende de __eq__/__hash__ (Clip é dataclass mutável,
+  sem hash, e dois clips com os mesmos campos continuam sendo dois).
+- Operações em lote (select_clips, select_clips_in por intervalo) e
+  batch(): cada operação emite UM EVENT_SELECTION_CHANGE com o saldo do
+  que entrou/saiu, em vez de um evento por item.
 """
 from __future__ import annotations
 
-from typing import Any, List, Optional
+from contextlib import contextmanager
+from typing import Any, Dict, Iterable, Iterator, List, Optional
 
+from .events import EVENT_SELECTION_CHANGE
+
+
+# ------------------------------------------------------------------
+# Conjunto de seleção
+# ------------------------------------------------------------------
+
+class Selection:
+    """
+    Conjunto de objetos indexado por identidade, em ordem de inserção.
+
+    Para leitura se comporta como a lista antiga ('in', len, iteração,
+    índice) — mas 'in', add e discard são O(1). Mudanças são reportadas ao
+    State dono, que as agrupa num único evento por operação.
+    """
+
+    __slots__ = ("kind", "_items", "_state")
+
+    def __init__(self, kind: str, state: Optional["State"] = None) -> None:
+        self.kind = kind
+        self._items: Dict[int, Any] = {}
+        self._state = state
+
+    def __contains__(self, obj: Any) -> bool:
+        return id(obj) in self._items
+
+    def __iter__(self) -> Iterator[Any]:
+        return iter(list(self._items.values()))
+
+    def __len__(self) -> int:
+        return len(self._items)
+
+    def __getitem__(self, index: int) -> Any:
+        return list(self._items.values())[index]
+
+    # ------------------------------------------------------------------
+
+    def add(self, obj: Any) -> bool:
+        return self.update((obj,)) > 0
+
+    def discard(self, obj: Any) -> bool:
+        return self.difference_update((obj,)) > 0
+
+    def update(self, objs: Iterable[Any]) -> int:
+        """Adiciona vários objetos. Retorna quantos eram novos."""
+        items = self._items
+        added: List[Any] = []
+        for o in objs:
+            k = id(o)
+            if k not in items:
+                items[k] = o
+                added.append(o)
+        return self._changed(added, ())
+
+    def difference_update(self, objs: Iterable[Any]) -> int:
+        """Remove vários objetos. Retorna quantos estavam selecionados."""
+        items = self._items
+        removed = [o for o in objs if items.pop(id(o), None) is not None]
+        return self._changed((), removed)
+
+    def replace(self, objs: Iterable[Any]) -> int:
+        """A seleção passa a ser exatamente 'objs' (clique/retângulo sem Shift)."""
+        new = {id(o): o for o in objs}
+        old = self._items
+        removed = [o for k, o in old.items() if k not in new]
+        added   = [o for k, o in new.items() if k not in old]
+        self._items = new
+        return self._changed(added, removed)
+
+    def clear(self) -> int:
+        removed = list(self._items.values())
+        self._items = {}
+        return self._changed((), removed)
+
+    def _changed(self, added, removed) -> int:
+        n = len(added) + len(removed)
+        if n and self._state is not None:
+            self._state._record(self.kind, added, removed)
+        return n
+
+    def __repr__(self) -> str:
+        return f"Selection('{self.kind}', {len(self._items)})"
+
+
+# ------------------------------------------------------------------
+# Estado global de edição
+# ------------------------------------------------------------------
 
 class State:
     """
@@ -23,6 +119,12 @@ class State:
     Singleton — sempre retorna a mesma instância.
     NÃO confundir com Session (que guarda o projeto) nem com EngineState
     (que é o estado de transporte da Engine).
+
+    Evento de seleção: 'events' (o EventSystem da Engine) recebe
+    EVENT_SELECTION_CHANGE com {kind: {"added": [...], "removed": [...]}}
+    — só os tipos ("tracks", "clips") que mudaram, saldo líquido da
+    operação (selecionar e desselecionar o mesmo clip no mesmo batch não
+    aparece).
     """
 
     _instance: Optional["State"] = None
@@ -31,11 +133,14 @@ class State:
         if cls._instance is None:
             inst = super().__new__(cls)
             inst.mode: str = "object"          # "object", "edit", "paint", etc.
-            inst.selected_tracks: List[Any] = []
-            inst.selected_clips:  List[Any] = []
+            inst.selected_tracks = Selection("tracks", inst)
+            inst.selected_clips  = Selection("clips", inst)
             inst.cursor_position: float = 0.0  # em segundos
             inst.loop_start: float = 0.0
             inst.loop_end:   float = 4.0
+            inst.events = None                 # EventSystem — ligado pela Engine
+            inst._batch_depth: int = 0
+            inst._pending: Dict[str, tuple] = {}
             cls._instance = inst
         return cls._instance
 
@@ -56,14 +161,20 @@ class State:
         Se exclusive=True, limpa a seleção anterior antes (clique simples,
         sem Shift/Ctrl).
         """
-        if exclusive:
-            self.selected_tracks.clear()
-        if track not in self.selected_tracks:
-            self.selected_tracks.append(track)
+        self.select_tracks((track,), exclusive)
+
+    def select_tracks(self, tracks: Iterable[Any], exclusive: bool = False) -> int:
+        with self.batch():
+            if exclusive:
+                return self.selected_tracks.replace(tracks)
+            return self.selected_tracks.update(tracks)
 
     def deselect_track(self, track: Any) -> None:
-        if track in self.selected_tracks:
-            self.selected_tracks.remove(track)
+        self.selected_tracks.discard(track)
+
+    def deselect_tracks(self, tracks: Iterable[Any]) -> int:
+        with self.batch():
+            return self.selected_tracks.difference_update(tracks)
 
     def is_track_selected(self, track: Any) -> bool:
         return track in self.selected_tracks
@@ -73,26 +184,89 @@ class State:
     # ------------------------------------------------------------------
 
     def select_clip(self, clip: Any, exclusive: bool = False) -> None:
-        if exclusive:
-            self.selected_clips.clear()
-        if clip not in self.selected_clips:
-            self.selected_clips.append(clip)
+        self.select_clips((clip,), exclusive)
+
+    def select_clips(self, clips: Iterable[Any], exclusive: bool = False) -> int:
+        with self.batch():
+            if exclusive:
+                return self.selected_clips.replace(clips)
+            return self.selected_clips.update(clips)
 
     def deselect_clip(self, clip: Any) -> None:
-        if clip in self.selected_clips:
-            self.selected_clips.remove(clip)
+        self.selected_clips.discard(clip)
+
+    def deselect_clips(self, clips: Iterable[Any]) -> int:
+        with self.batch():
+            return self.selected_clips.difference_update(clips)
 
     def is_clip_selected(self, clip: Any) -> bool:
         return clip in self.selected_clips
 
+    def select_clips_in(
+        self,
+        tracks:    Iterable[Any],
+        t0:        float,
+        t1:        float,
+        exclusive: bool = False,
+    ) -> int:
+        """
+        Seleção por retângulo: clips das faixas dadas que cobrem [t0, t1).
+        A busca usa o índice por start do snapshot da faixa (bisect), não
+        uma varredura de todos os clips.
+        """
+        return self.select_clips(_clips_in(tracks, t0, t1), exclusive)
+
+    def deselect_clips_in(self, tracks: Iterable[Any], t0: float, t1: float) -> int:
+        return self.deselect_clips(_clips_in(tracks, t0, t1))
+
     # ------------------------------------------------------------------
     # Geral
     # ------------------------------------------------------------------
 
     def deselect_all(self) -> None:
         """Limpa toda a seleção (faixas e clips)."""
-        self.selected_tracks.clear()
-        self.selected_clips.clear()
+        with self.batch():
+            self.selected_tracks.clear()
+            self.selected_clips.clear()
+
+    @contextmanager
+    def batch(self) -> Iterator["State"]:
+        """
+        Agrupa mudanças de seleção num único evento, emitido ao sair do
+        bloco mais externo:
+
+            with state.batch():
+                state.deselect_all()
+                state.select_clips_in(tracks, 4.0, 8.0)
+        """
+        self._batch_depth += 1
+        try:
+            yield self
+        finally:
+            self._batch_depth -= 1
+            if self._batch_depth == 0:
+                self._flush()
+
+    def _record(self, kind: str, added: Iterable[Any], removed: Iterable[Any]) -> None:
+        pend_add, pend_rem = self._pending.setdefault(kind, ({}, {}))
+        for o in added:
+            if pend_rem.pop(id(o), None) is None:
+                pend_add[id(o)] = o
+        for o in removed:
+            if pend_add.pop(id(o), None) is None:
+                pend_rem[id(o)] = o
+        if self._batch_depth == 0:
+            self._flush()
+
+    def _flush(self) -> None:
+        pending, self._pending = self._pending, {}
+        change = {
+            kind: {"added": list(a.values()), "removed": list(r.values())}
+            for kind, (a, r) in pending.items()
+            if a or r
+        }
+        if change and self.events is not None:
+            self.events.emit(EVENT_SELECTION_CHANGE, change)
 
     def reset(self) -> None:
         """
@@ -101,8 +275,7 @@ class State:
         de um projeto anterior.
         """
         self.mode = "object"
-        self.selected_tracks.clear()
-        self.selected_clips.clear()
+        self.deselect_all()
         self.cursor_position = 0.0
         self.loop_start = 0.0
         self.loop_end = 4.0
@@ -113,4 +286,13 @@ class State:
             f"tracks_selected={len(self.selected_tracks)}, "
             f"clips_selected={len(self.selected_clips)}, "
             f"cursor={self.cursor_position:.2f}s)"
-        )
\ No newline at end of file
+        )
+
+
+def _clips_in(tracks: Iterable[Any], t0: float, t1: float) -> Iterator[Any]:
+    """Clips vivos de cada faixa em [t0, t1), via TrackSnapshot.indices_in."""
+    for track in tracks:
+        snap = track.freeze()          # ordena track.clips — índices batem com o snapshot
+        clips = track.clips
+        for i in snap.indices_in(t0, t1):
+            yield clips[i]
@@ -9,11 +9,22 @@ Correção vs versão anterior:
 - Adicionados métodos de consulta: get_clips_at(), get_track_by_name().
 - Clip tem campo 'type' (ClipType) e 'color' para identificação visual.
 - Track tem campo 'type' (TrackType) correto.
+- Timeline/Track/Clip eram mutados no lugar pelos operadores da UI —
+  qualquer leitor na thread de áudio disputava com a edição. Agora cada
+  commit() publica um TimelineSnapshot imutável (ver seção "Snapshots"):
+  faixas não editadas reaproveitam o TrackSnapshot da versão anterior
+  (compartilhamento estrutural) e a troca é uma única atribuição de
+  referência. O leitor pega `timeline.snapshot` uma vez por bloco e lê
+  sem lock; versões antigas somem quando o último leitor solta a
+  referência (contagem de referências do Python).
 """
 from __future__ import annotations
 
+import weakref
+from bisect import bisect_left, bisect_right
+from contextlib import contextmanager
 from dataclasses import dataclass, field
-from typing import Any, Dict, List, Optional
+from typing import Any, Dict, Iterator, List, Optional, Tuple
 
 from .constants import ClipType, TrackType
 
@@ -42,6 +53,24 @@ class Clip:
     data:     Any       = None
     color:    tuple     = field(default_factory=lambda: (0.18, 0.63, 0.93))
 
+    # Revisão e faixa dona — só para invalidar snapshots, fora de repr/eq
+    _rev:     int       = field(default=0, init=False, repr=False, compare=False)
+    _owner:   Any       = field(default=None, init=False, repr=False, compare=False)
+
+    def __setattr__(self, name: str, value: Any) -> None:
+        object.__setattr__(self, name, value)
+        if name[0] != "_":
+            self.touch()
+
+    def touch(self) -> None:
+        """
+        Marca o clip (e a faixa dona) como editado. Atribuições já chamam
+        isto; use direto após mutar o payload no lugar (ex.: lista de notas).
+        """
+        object.__setattr__(self, "_rev", self._rev + 1)
+        if self._owner is not None:
+            self._owner.touch()
+
     # Propriedade calculada
     @property
     def end(self) -> float:
@@ -104,6 +133,9 @@ class Track:
         name: str = "",
         track_type: TrackType | str = TrackType.AUDIO,
     ) -> None:
+        self._rev:  int = 0
+        self._snap: Optional[TrackSnapshot] = None
+        self._snap_key: Tuple[int, int] = (-1, -1)
         self.name: str = name
 
         # Normaliza para TrackType
@@ -122,22 +154,35 @@ class Track:
         self.solo:   bool  = False
         self.color:  tuple = (0.35, 0.35, 0.35)
 
+    def __setattr__(self, name: str, value: Any) -> None:
+        object.__setattr__(self, name, value)
+        if name[0] != "_":
+            self._rev += 1
+
+    def touch(self) -> None:
+        """Marca a faixa como editada (o próximo commit() refaz o snapshot dela)."""
+        self._rev += 1
+
     # ------------------------------------------------------------------
     # Gerenciamento de clips
     # ------------------------------------------------------------------
 
     def add_clip(self, clip: Clip) -> None:
         """Adiciona um clip e mantém a lista ordenada por start."""
+        clip._owner = self
         self.clips.append(clip)
         self.clips.sort(key=lambda c: c.start)
+        self._rev += 1
 
     def remove_clip(self, clip: Clip) -> bool:
         """Remove um clip. Retorna True se encontrado."""
         try:
             self.clips.remove(clip)
-            return True
         except ValueError:
             return False
+        clip._owner = None
+        self._rev += 1
+        return True
 
     def get_clips_at(self, time: float) -> List[Clip]:
         """Retorna todos os clips que cobrem o instante 'time'."""
@@ -149,6 +194,22 @@ class Track:
             return 0.0
         return max(c.end for c in self.clips)
 
+    def freeze(self) -> "TrackSnapshot":
+        """
+        Snapshot imutável da faixa. Reaproveita o anterior se nada mudou
+        desde então (revisão da faixa e número de clips — o último pega
+        append direto em self.clips).
+        """
+        key = (self._rev, len(self.clips))
+        if self._snap is not None and key == self._snap_key:
+            return self._snap
+        for c in self.clips:
+            c._owner = self                  # edições futuras do clip sujam a faixa
+        self.clips.sort(key=lambda c: c.start)
+        self._snap = TrackSnapshot(self)
+        self._snap_key = key
+        return self._snap
+
     # ------------------------------------------------------------------
     # Serialização
     # ------------------------------------------------------------------
@@ -178,7 +239,9 @@ class Track:
         track.color  = tuple(data.get("color", [0.35, 0.35, 0.35]))
 
         for clip_data in data.get("clips", []):
-            track.clips.append(Clip.from_dict(clip_data))
+            clip = Clip.from_dict(clip_data)
+            clip._owner = track
+            track.clips.append(clip)
 
         return track
 
@@ -186,6 +249,120 @@ class Track:
         return f"Track('{self.name}', {self.type.value}, clips={len(self.clips)})"
 
 
+# ------------------------------------------------------------------
+# Snapshots imutáveis (leitura sem lock pela thread de áudio)
+# ------------------------------------------------------------------
+
+@dataclass(frozen=True, slots=True)
+class ClipSnapshot:
+    """Cópia congelada de um Clip. Payload em lista vira tupla."""
+    name:     str
+    start:    float
+    duration: float
+    end:      float
+    type:     ClipType
+    data:     Any
+    color:    tuple
+
+    @classmethod
+    def of(cls, clip: Clip) -> "ClipSnapshot":
+        data = clip.data
+        if isinstance(data, list):
+            data = tuple(data)
+        return cls(clip.name, clip.start, clip.duration, clip.start + clip.duration,
+                   clip.type, data, tuple(clip.color))
+
+
+class TrackSnapshot:
+    """
+    Faixa congelada: clips ordenados por start + índice para consulta por
+    intervalo (bisect em starts, recuado pela maior duração).
+    """
+
+    __slots__ = ("name", "type", "volume", "pan", "mute", "solo", "color",
+                 "clips", "starts", "max_duration", "duration")
+
+    def __init__(self, track: Track) -> None:
+        self.name   = track.name
+        self.type   = track.type
+        self.volume = track.volume
+        self.pan    = track.pan
+        self.mute   = track.mute
+        self.solo   = track.solo
+        self.color  = tuple(track.color)
+        self.clips: Tuple[ClipSnapshot, ...] = tuple(ClipSnapshot.of(c) for c in track.clips)
+        self.starts: Tuple[float, ...] = tuple(c.start for c in self.clips)
+        self.max_duration = max((c.duration for c in self.clips), default=0.0)
+        self.duration     = max((c.end for c in self.clips), default=0.0)
+
+    def clips_in(self, t0: float, t1: float) -> Tuple[ClipSnapshot, ...]:
+        """Clips que cobrem algum instante de [t0, t1)."""
+        hi = bisect_left(self.starts, t1)
+        lo = bisect_left(self.starts, t0 - self.max_duration, 0, hi)
+        return tuple(c for c in self.clips[lo:hi] if c.end > t0)
+
+    def indices_in(self, t0: float, t1: float) -> List[int]:
+        """Índices (em clips, igual a Track.clips após freeze) dos clips em [t0, t1)."""
+        hi = bisect_left(self.starts, t1)
+        lo = bisect_left(self.starts, t0 - self.max_duration, 0, hi)
+        clips = self.clips
+        return [i for i in range(lo, hi) if clips[i].end > t0]
+
+    def clips_at(self, time: float) -> Tuple[ClipSnapshot, ...]:
+        hi = bisect_right(self.starts, time)       # start <= time
+        lo = bisect_left(self.starts, time - self.max_duration, 0, hi)
+        return tuple(c for c in self.clips[lo:hi] if c.end > time)
+
+    def __repr__(self) -> str:
+        return f"TrackSnapshot('{self.name}', clips={len(self.clips)})"
+
+
+class TimelineSnapshot:
+    """
+    Uma versão publicada da timeline. Nunca muda depois de criada — quem
+    a segura vê um estado consistente, não importa o que a UI faça.
+    """
+
+    __slots__ = ("version", "tracks", "length", "any_solo", "__weakref__")
+
+    def __init__(self, version: int, tracks: Tuple[TrackSnapshot, ...]) -> None:
+        self.version  = version
+        self.tracks   = tracks
+        self.length   = max((t.duration for t in tracks), default=0.0)
+        self.any_solo = any(t.solo for t in tracks)
+
+    def audible(self, track: TrackSnapshot) -> bool:
+        """Regra de mute/solo aplicada sobre a versão inteira."""
+        return not track.mute and (track.solo or not self.any_solo)
+
+    def clips_in(self, t0: float, t1: float) -> Iterator[Tuple[int, ClipSnapshot]]:
+        """(índice da faixa, clip) para tudo que toca [t0, t1) — o que o scheduler precisa por bloco."""
+        for i, t in enumerate(self.tracks):
+            for c in t.clips_in(t0, t1):
+                yield i, c
+
+    def get_active_tracks(self, time: float) -> List[TrackSnapshot]:
+        return [t for t in self.tracks if t.clips_at(time)]
+
+    def get_track_by_name(self, name: str) -> Optional[TrackSnapshot]:
+        for t in self.tracks:
+            if t.name == name:
+                return t
+        return None
+
+    def __repr__(self) -> str:
+        return f"TimelineSnapshot(v{self.version}, tracks={len(self.tracks)}, length={self.length:.2f}s)"
+
+
+# Versões ainda referenciadas por alguém (diagnóstico — não segura nada)
+_LIVE_SNAPSHOTS: "weakref.WeakValueDictionary[int, TimelineSnapshot]" = weakref.WeakValueDictionary()
+
+
+def live_snapshot_versions() -> List[int]:
+    """Versões de TimelineSnapshot ainda não coletadas."""
+    return sorted(_LIVE_SNAPSHOTS.keys())
+
+
 # ------------------------------------------------------------------
 # Timeline
 # ------------------------------------------------------------------
@@ -193,11 +370,59 @@ class Track:
 class Timeline:
     """
     Agrupa todas as faixas e fornece métodos de edição da linha do tempo.
+
+    Lado da UI (mutável) — edite e chame commit(), ou use `with edit():`.
+    Lado do áudio — leia `snapshot` (uma referência, troca atômica).
     """
 
+    _versions = 0    # contador global: versões de timelines distintas nunca colidem
+
     def __init__(self) -> None:
         self.tracks: List[Track] = []
-        self.length: float = 0.0     # duração total calculada em segundos
+        self._snapshot: TimelineSnapshot = self._publish(())
+
+    # ------------------------------------------------------------------
+    # Publicação de snapshots
+    # ------------------------------------------------------------------
+
+    @property
+    def snapshot(self) -> TimelineSnapshot:
+        """Versão publicada atual. Leitores guardam a referência pelo bloco inteiro."""
+        return self._snapshot
+
+    @property
+    def version(self) -> int:
+        return self._snapshot.version
+
+    def commit(self) -> TimelineSnapshot:
+        """
+        Publica as edições feitas desde o último commit. Faixas sem
+        mudança entram com o mesmo TrackSnapshot; se nenhuma mudou (nem a
+        lista de faixas), a versão atual é mantida.
+        """
+        tracks = tuple(t.freeze() for t in self.tracks)
+        current = self._snapshot
+        if len(tracks) == len(current.tracks) and all(
+            a is b for a, b in zip(tracks, current.tracks)
+        ):
+            return current
+        self._snapshot = self._publish(tracks)     # troca de referência — atômica sob o GIL
+        return self._snapshot
+
+    @contextmanager
+    def edit(self) -> Iterator["Timeline"]:
+        """`with timeline.edit(): ...` — um único commit ao fim do bloco."""
+        try:
+            yield self
+        finally:
+            self.commit()
+
+    @staticmethod
+    def _publish(tracks: Tuple[TrackSnapshot, ...]) -> TimelineSnapshot:
+        Timeline._versions += 1
+        snap = TimelineSnapshot(Timeline._versions, tracks)
+        _LIVE_SNAPSHOTS[snap.version] = snap
+        return snap
 
     # ------------------------------------------------------------------
     # Gerenciamento de faixas
@@ -205,15 +430,15 @@ class Timeline:
 
     def add_track(self, track: Track) -> None:
         self.tracks.append(track)
-        self._update_length()
+        self.commit()
 
     def remove_track(self, track: Track) -> bool:
         try:
             self.tracks.remove(track)
-            self._update_length()
-            return True
         except ValueError:
             return False
+        self.commit()
+        return True
 
     def get_track_by_name(self, name: str) -> Optional[Track]:
         """Retorna a primeira faixa com o nome dado, ou None."""
@@ -234,13 +459,14 @@ class Timeline:
     # Duração
     # ------------------------------------------------------------------
 
-    def _update_length(self) -> None:
-        """Recalcula a duração total como o fim do clip mais distante."""
-        if not self.tracks:
-            self.length = 0.0
-            return
-        ends = [t.get_duration() for t in self.tracks]
-        self.length = max(ends) if ends else 0.0
+    @property
+    def length(self) -> float:
+        """
+        Duração total (fim do clip mais distante) do estado editável —
+        vale também para edições ainda sem commit(). A da versão publicada
+        é snapshot.length.
+        """
+        return max((t.get_duration() for t in self.tracks), default=0.0)
 
     # ------------------------------------------------------------------
     # Serialização
@@ -257,8 +483,7 @@ class Timeline:
         self.tracks = []
         for track_data in data.get("tracks", []):
             self.tracks.append(Track.from_dict(track_data))
-        self.length = data.get("length", 0.0)
-        self._update_length()   # recalcula para garantir consistência
+        self.commit()           # length é calculado dos clips (ignora o salvo)
 
     def __repr__(self) -> str:
         return f"Timeline(tracks={len(self.tracks)}, length={self.length:.2f}s)"
\ No newline at end of file
@@ -3,7 +3,8 @@
 Pacote de processamento de sinal digital (DSP) da DAW.
 
 Contém os blocos de construção de baixo nível usados pelos instrumentos
-(daw_engine/instruments/) e pelo mixer: osciladores e envelopes.
+(daw_engine/instruments/) e pelo mixer: osciladores (e o banco com unison), envelopes, o filtro das vozes
+e a matriz de modulação (LFOs e rotas).
 
 Estava vazio antes — exportar aqui evita que outros módulos precisem
 saber o caminho interno exato de cada classe (ex: instruments/synth.py
@@ -20,8 +21,12 @@ from .oscillator import (
     TriangleOsc,
     create_oscillator,
     available_waveforms,
+    render_waveform,
 )
-from .adsr import ADSR, ADSRStage
+from .adsr import ADSR, ADSRStage, EnvelopeBank
+from .filter import FILTER_MODES, FILTER_SLOPES, FilterBank
+from .unison import MAX_UNISON, OscillatorBank
+from .modulation import LFO, LFO_SHAPES, MOD_DESTINATIONS, MOD_SOURCES, ModMatrix
 
 __all__ = [
     "Oscillator",
@@ -31,6 +36,18 @@ __all__ = [
     "TriangleOsc",
     "create_oscillator",
     "available_waveforms",
+    "render_waveform",
     "ADSR",
     "ADSRStage",
+    "EnvelopeBank",
+    "FILTER_MODES",
+    "FILTER_SLOPES",
+    "FilterBank",
+    "MAX_UNISON",
+    "OscillatorBank",
+    "LFO",
+    "LFO_SHAPES",
+    "MOD_DESTINATIONS",
+    "MOD_SOURCES",
+    "ModMatrix",
 ]
\ No newline at end of file
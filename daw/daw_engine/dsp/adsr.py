@@ -17,26 +17,239 @@ Uso típico dentro de uma voz de sintetizador:
     ...
     env.note_off()
     # continua chamando process() até env.is_finished virar True
+
+Segmentos exponenciais (estilo analógico):
+    Cada estágio é um one-pole indo em direção a um alvo um pouco além
+    do nível final:
+
+        nível[k] = alvo + (nível₀ − alvo) · c^k
+
+    O attack mira acima de 1.0 (curva levemente côncava, como o
+    capacitor carregando num envelope analógico); decay e release miram
+    um pouco abaixo do fim (queda exponencial, que o ouvido percebe como
+    linear em dB). Alvo e coeficiente c saem do tempo do estágio, de modo
+    que o estágio completo (1 → sustain, 1 → 0) dura exatamente o tempo
+    configurado.
+
+    Por ser one-pole, o futuro só depende do nível atual — não há
+    "progresso" para recuperar. Retrigger parte do nível em que está,
+    release a partir de qualquer ponto é só mudar o alvo, e trocar o
+    sample rate no meio da nota só muda c.
+
+EnvelopeBank — todas as vozes de uma vez:
+    Estágio e nível ficam em arrays, um slot por voz (como o
+    OscillatorBank e o FilterBank). process(slots, frames) avança todas
+    as vozes numa passada por estágio: cada passada escreve, para todas
+    as vozes ainda no meio do bloco, o trecho do estágio atual pela
+    fórmula fechada acima, e as vozes que terminaram o estágio trocam de
+    estágio por máscara. Um bloco tem no máximo algumas passadas
+    (ATTACK → DECAY → SUSTAIN), não uma por voz.
+
+    ADSR (uma voz) é um EnvelopeBank de um slot — o mesmo kernel, então
+    a saída de uma voz isolada é idêntica à da voz dentro do banco.
+
+Os buffers de saída vêm da ENGINE_ARENA — valem até o próximo bloco,
+como o resto do scratch do callback.
 """
 from __future__ import annotations
 
-from enum import Enum, auto
+from enum import IntEnum
 
 import numpy as np
 
+from ..audio.arena import ENGINE_ARENA
+
+
+# Quanto o alvo passa do nível final, relativo ao salto do estágio.
+# Menor = mais exponencial; maior = mais perto de linear.
+ATTACK_RATIO = 0.3
+DECAY_RATIO = 1e-4          # ~ -80 dB: o fim do estágio é o "zero" audível
+
+
+class ADSRStage(IntEnum):
+    IDLE     = 1
+    ATTACK   = 2
+    DECAY    = 3
+    SUSTAIN  = 4
+    RELEASE  = 5
+
+
+_IDLE, _ATTACK, _DECAY, _SUSTAIN, _RELEASE = (int(s) for s in ADSRStage)
+
+
+# ------------------------------------------------------------------
+# Banco de envelopes
+# ------------------------------------------------------------------
+
+class EnvelopeBank:
+    """
+    Envelopes ADSR de todas as vozes de um Synth, um slot por voz.
+
+        bank = EnvelopeBank(slots=16)
+        bank.note_on(slot, attack, decay, sustain, release)
+        env = bank.process(slots, frames, sample_rate)     # (V, frames)
+        bank.note_off(slot)
+        bank.finished(slot)
+    """
+
+    def __init__(self, slots: int = 16) -> None:
+        self.stage = np.full(slots, _IDLE, dtype=np.int8)
+        self.level = np.zeros(slots)
+        # Tempos (s) e nível de sustain de cada slot, fixados no note_on
+        self.times = np.zeros((slots, 4))          # attack, decay, sustain, release
+
+    # ------------------------------------------------------------------
+    # Slots
+    # ------------------------------------------------------------------
+
+    @property
+    def slots(self) -> int:
+        return len(self.stage)
+
+    def ensure(self, slots: int) -> None:
+        """Garante pelo menos 'slots' slots (mantém os envelopes existentes)."""
+        n = len(self.stage)
+        if slots > n:
+            self.stage = np.concatenate([self.stage, np.full(slots - n, _IDLE, dtype=np.int8)])
+            self.level = np.concatenate([self.level, np.zeros(slots - n)])
+            self.times = np.concatenate([self.times, np.zeros((slots - n, 4))])
+
+    def set_times(self, slot: int, attack: float, decay: float, sustain: float, release: float) -> None:
+        self.times[slot] = (max(0.0, attack), max(0.0, decay),
+                            min(1.0, max(0.0, sustain)), max(0.0, release))
+
+    def note_on(self, slot: int, attack: float, decay: float, sustain: float, release: float) -> None:
+        """Voz nova no slot: parâmetros, nível zerado, ATTACK."""
+        self.set_times(slot, attack, decay, sustain, release)
+        self.level[slot] = 0.0
+        self.stage[slot] = _ATTACK
+
+    def note_off(self, slot) -> None:
+        """RELEASE a partir do nível atual (slot ou array de slots)."""
+        stage = self.stage[slot]
+        self.stage[slot] = np.where(stage == _IDLE, _IDLE, _RELEASE)
+
+    def reset(self, slot=slice(None)) -> None:
+        """Volta a IDLE imediatamente, sem release (todos por padrão)."""
+        self.stage[slot] = _IDLE
+        self.level[slot] = 0.0
+
+    def finished(self, slot: int) -> bool:
+        return self.stage[slot] == _IDLE
+
+    # ------------------------------------------------------------------
+    # Processamento
+    # ------------------------------------------------------------------
 
-class ADSRStage(Enum):
-    IDLE     = auto()
-    ATTACK   = auto()
-    DECAY    = auto()
-    SUSTAIN  = auto()
-    RELEASE  = auto()
+    def process(self, slots: np.ndarray, frames: int, sample_rate: int) -> np.ndarray:
+        """
+        Avança os envelopes dos slots 'frames' amostras. Retorna o ganho
+        (len(slots), frames) float32 da ENGINE_ARENA.
+        """
+        out = ENGINE_ARENA.scratch((len(slots), frames))
+        if len(slots) == 0 or frames == 0:
+            return out
+        stage, level = self.stage[slots], self.level[slots]
+        _advance(stage, level, self.times[slots], frames, sample_rate, out)
+        self.stage[slots], self.level[slots] = stage, level
+        return out
 
+    def __repr__(self) -> str:
+        active = int(np.count_nonzero(self.stage != _IDLE))
+        return f"EnvelopeBank(slots={self.slots}, ativos={active})"
+
+
+def _advance(
+    stage:  np.ndarray,
+    level:  np.ndarray,
+    times:  np.ndarray,
+    frames: int,
+    sr:     int,
+    out:    np.ndarray,
+) -> None:
+    """
+    Kernel: escreve 'frames' amostras de cada envelope em out (V, frames)
+    e atualiza stage/level (V,) no lugar. Uma passada por estágio; em cada
+    uma só as vozes que ainda não chegaram ao fim do bloco entram.
+    """
+    t = ENGINE_ARENA.ramp(frames, np.float32)
+    pos = np.zeros(len(stage), dtype=np.int64)          # próxima amostra a escrever
+    rows = np.arange(len(stage))
+
+    while len(rows):
+        st, lv, p = stage[rows], level[rows], pos[rows]
+
+        # SUSTAIN e IDLE: nível constante até o fim do bloco
+        hold = (st == _SUSTAIN) | (st == _IDLE)
+        if hold.any():
+            h = rows[hold]
+            held = np.where(st[hold] == _SUSTAIN, times[h, 2], 0.0)
+            level[h] = held
+            if (p[hold] == 0).all():
+                out[h] = held[:, None]
+            else:
+                for i, start, value in zip(h, p[hold], held):
+                    out[i, start:] = value
+            rows, st, lv, p = rows[~hold], st[~hold], lv[~hold], p[~hold]
+            if len(rows) == 0:
+                return
+
+        # Alvo, coeficiente (em log), nível final e duração do estágio
+        a, d, sus, r = times[rows].T
+        is_att, is_dec = st == _ATTACK, st == _DECAY
+        span = np.where(is_att, a, np.where(is_dec, d, r))
+        ratio = np.where(is_att, ATTACK_RATIO, DECAY_RATIO)
+        end = np.where(is_att, 1.0, np.where(is_dec, sus, 0.0))
+        # Salto do estágio completo (0→1, 1→sustain, 1→0) define o alvo
+        jump = np.where(is_dec, 1.0 - sus, 1.0)
+        target = np.where(is_att, 1.0 + ratio, end - ratio * jump)
+        log_c = -np.log1p(1.0 / ratio) / np.maximum(span * sr, 1.0)
+
+        # Amostras até cruzar o nível final: c^k = (end − alvo)/(nível − alvo).
+        # Já no fim, tempo zero ou salto nulo: troca de estágio sem amostras
+        with np.errstate(divide="ignore", invalid="ignore"):
+            k = np.log((end - target) / (lv - target)) / log_c
+        k = np.ceil(k - 1e-9)
+        done = np.where(is_att, lv >= 1.0, np.where(is_dec, lv <= sus, lv <= 0.0))
+        done |= (span <= 0.0) | (jump <= 0.0) | ~np.isfinite(k)
+        k = np.where(done, 0.0, np.maximum(k, 0.0))
+        stop = np.minimum(p + k, frames).astype(np.int64)
+
+        # Trecho [p, stop) de cada voz pela fórmula fechada — em float32,
+        # o dtype de out (o slab float64 da arena fica para as fases)
+        seg = stop > p
+        if seg.any():
+            r_seg, p_seg, stop_seg = rows[seg], p[seg], stop[seg]
+            curve = ENGINE_ARENA.scratch((len(r_seg), frames))
+            np.subtract(t[None, :], p_seg[:, None], out=curve)
+            curve *= log_c[seg, None]
+            np.exp(curve, out=curve)
+            curve *= (lv - target)[seg, None]
+            curve += target[seg, None]
+            if (p_seg == 0).all() and (stop_seg == frames).all():
+                out[r_seg] = curve
+            else:
+                for i, (row, start, stop_i) in enumerate(zip(r_seg, p_seg, stop_seg)):
+                    out[row, start:stop_i] = curve[i, start:stop_i]
+
+        # Estágio completo dentro do bloco → nível final e próximo estágio;
+        # senão o nível da próxima amostra e fim do bloco
+        complete = p + k <= frames
+        n = (stop - p).astype(np.float64)
+        level[rows] = np.where(complete, end, target + (lv - target) * np.exp(log_c * n))
+        stage[rows] = np.where(complete, np.where(is_att, _DECAY, np.where(is_dec, _SUSTAIN, _IDLE)), st)
+        pos[rows] = stop
+        rows = rows[complete & (stop < frames)]
+
+
+# ------------------------------------------------------------------
+# ADSR de uma voz
+# ------------------------------------------------------------------
 
 class ADSR:
     """
-    Gerador de envelope de amplitude, processado em blocos (vetorizado com numpy)
-    para ser eficiente o suficiente para rodar dentro do audio callback.
+    Gerador de envelope de uma voz, processado em blocos — um
+    EnvelopeBank de um slot (mesmo kernel vetorizado, mesma saída).
 
     Todos os tempos são em segundos. Sustain é um nível (0.0–1.0), não um tempo.
     """
@@ -52,10 +265,8 @@ class ADSR:
         self.decay   = max(0.0, decay)
         self.sustain = min(1.0, max(0.0, sustain))
         self.release = max(0.0, release)
-
-        self._stage: ADSRStage = ADSRStage.IDLE
-        self._level: float = 0.0          # nível de amplitude atual (0.0–1.0)
-        self._release_start_level: float = 0.0  # nível no instante do note_off
+        self._bank = EnvelopeBank(1)
+        self._slot = np.zeros(1, dtype=np.intp)
 
     # ------------------------------------------------------------------
     # Controle de nota
@@ -63,21 +274,17 @@ class ADSR:
 
     def note_on(self) -> None:
         """Inicia o envelope a partir do estágio ATTACK."""
-        self._stage = ADSRStage.ATTACK
-        # Não zera _level: se a nota for retriggada antes de soltar
+        # Não zera o nível: se a nota for retriggada antes de soltar
         # totalmente, o attack parte do nível atual (evita clique).
+        self._bank.stage[0] = _ATTACK
 
     def note_off(self) -> None:
         """Inicia o estágio RELEASE a partir do nível atual."""
-        if self._stage == ADSRStage.IDLE:
-            return
-        self._release_start_level = self._level
-        self._stage = ADSRStage.RELEASE
+        self._bank.note_off(0)
 
     def reset(self) -> None:
         """Força o envelope de volta a IDLE imediatamente (sem release)."""
-        self._stage = ADSRStage.IDLE
-        self._level = 0.0
+        self._bank.reset(0)
 
     # ------------------------------------------------------------------
     # Processamento em bloco
@@ -91,118 +298,8 @@ class ADSR:
         Deve ser chamado uma vez por bloco de áudio, na ordem correta
         (não pula tempo).
         """
-        out = np.empty(frames, dtype=np.float32)
-
-        i = 0
-        while i < frames:
-            if self._stage == ADSRStage.IDLE:
-                out[i:] = 0.0
-                self._level = 0.0
-                break
-
-            elif self._stage == ADSRStage.ATTACK:
-                i = self._process_attack(out, i, frames, sample_rate)
-
-            elif self._stage == ADSRStage.DECAY:
-                i = self._process_decay(out, i, frames, sample_rate)
-
-            elif self._stage == ADSRStage.SUSTAIN:
-                remaining = frames - i
-                out[i:] = self.sustain
-                self._level = self.sustain
-                i = frames
-
-            elif self._stage == ADSRStage.RELEASE:
-                i = self._process_release(out, i, frames, sample_rate)
-
-        return out
-
-    # ------------------------------------------------------------------
-    # Estágios individuais
-    # ------------------------------------------------------------------
-
-    def _process_attack(self, out: np.ndarray, i: int, frames: int, sr: int) -> int:
-        if self.attack <= 0.0:
-            self._level = 1.0
-            self._stage = ADSRStage.DECAY
-            return i
-
-        attack_samples = max(1, int(self.attack * sr))
-        # Quantas amostras já passamos do attack, baseado no nível atual
-        start_progress = self._level  # 0.0 (nível atual) até 1.0
-        remaining_samples = int(attack_samples * (1.0 - start_progress))
-        remaining_samples = max(1, remaining_samples)
-
-        n = min(remaining_samples, frames - i)
-        ramp = np.linspace(self._level, 1.0, n, endpoint=False, dtype=np.float32)
-        out[i:i + n] = ramp
-        self._level = float(ramp[-1]) if n > 0 else self._level
-        i += n
-
-        if n >= remaining_samples:
-            self._level = 1.0
-            self._stage = ADSRStage.DECAY
-
-        return i
-
-    def _process_decay(self, out: np.ndarray, i: int, frames: int, sr: int) -> int:
-        if self.decay <= 0.0:
-            self._level = self.sustain
-            self._stage = ADSRStage.SUSTAIN
-            return i
-
-        decay_samples = max(1, int(self.decay * sr))
-        # Progresso atual dentro do decay, baseado em onde _level está
-        # entre 1.0 (início) e sustain (fim)
-        span = 1.0 - self.sustain
-        if span <= 0.0:
-            self._level = self.sustain
-            self._stage = ADSRStage.SUSTAIN
-            return i
-
-        progress = 1.0 - ((self._level - self.sustain) / span)
-        progress = min(1.0, max(0.0, progress))
-        remaining_samples = max(1, int(decay_samples * (1.0 - progress)))
-
-        n = min(remaining_samples, frames - i)
-        ramp = np.linspace(self._level, self.sustain, n, endpoint=False, dtype=np.float32)
-        out[i:i + n] = ramp
-        self._level = float(ramp[-1]) if n > 0 else self._level
-        i += n
-
-        if n >= remaining_samples:
-            self._level = self.sustain
-            self._stage = ADSRStage.SUSTAIN
-
-        return i
-
-    def _process_release(self, out: np.ndarray, i: int, frames: int, sr: int) -> int:
-        if self.release <= 0.0:
-            self._level = 0.0
-            self._stage = ADSRStage.IDLE
-            return i
-
-        release_samples = max(1, int(self.release * sr))
-        if self._release_start_level <= 0.0:
-            self._level = 0.0
-            self._stage = ADSRStage.IDLE
-            return i
-
-        progress = 1.0 - (self._level / self._release_start_level)
-        progress = min(1.0, max(0.0, progress))
-        remaining_samples = max(1, int(release_samples * (1.0 - progress)))
-
-        n = min(remaining_samples, frames - i)
-        ramp = np.linspace(self._level, 0.0, n, endpoint=False, dtype=np.float32)
-        out[i:i + n] = ramp
-        self._level = float(ramp[-1]) if n > 0 else self._level
-        i += n
-
-        if n >= remaining_samples:
-            self._level = 0.0
-            self._stage = ADSRStage.IDLE
-
-        return i
+        self._bank.set_times(0, self.attack, self.decay, self.sustain, self.release)
+        return self._bank.process(self._slot, frames, sample_rate)[0]
 
     # ------------------------------------------------------------------
     # Estado
@@ -210,23 +307,23 @@ class ADSR:
 
     @property
     def stage(self) -> ADSRStage:
-        return self._stage
+        return ADSRStage(int(self._bank.stage[0]))
 
     @property
     def is_finished(self) -> bool:
         """True quando a voz pode ser descartada (envelope chegou a zero)."""
-        return self._stage == ADSRStage.IDLE
+        return self.stage == ADSRStage.IDLE
 
     @property
     def is_active(self) -> bool:
-        return self._stage != ADSRStage.IDLE
+        return self.stage != ADSRStage.IDLE
 
     @property
     def current_level(self) -> float:
-        return self._level
+        return float(self._bank.level[0])
 
     def __repr__(self) -> str:
         return (
-            f"ADSR(stage={self._stage.name}, level={self._level:.3f}, "
+            f"ADSR(stage={self.stage.name}, level={self.current_level:.3f}, "
             f"A={self.attack} D={self.decay} S={self.sustain} R={self.release})"
-        )
\ No newline at end of file
+        )
@@ -0,0 +1,250 @@
+# dsp/modulation.py
+"""
+Matriz de modulação do Synth: fontes (LFOs, envelopes, velocity, pitch
+bend, mod wheel, aftertouch) roteadas para destinos (pitch, cutoff, amp,
+pan, pulse width).
+
+Por que uma matriz e não um laço de rotas:
+- Um laço "para cada voz, para cada rota" em Python cresce com
+  vozes × rotas, e cada rota nova adicionaria chamadas por bloco. Aqui
+  as rotas são compiladas numa matriz (destinos × fontes) e a avaliação
+  de todas as vozes e todas as rotas é UM matmul:
+
+      fontes (V, NS, P) ──[ M (D, NS) ]──> destinos (V, D, P)
+
+  com P pontos de controle por bloco. Rota nova = um coeficiente a mais
+  na matriz, não uma chamada a mais.
+
+Taxa de controle:
+    As fontes são avaliadas a cada 'control_block' amostras (e na última
+    amostra do bloco) — os pontos de controle. Os destinos que precisam
+    de precisão de amostra (pitch, amp, pan, pulse width) são
+    interpolados linearmente entre os pontos, em (V, frames) de uma vez;
+    o cutoff usa os pontos direto, que é a taxa em que o FilterBank
+    recalcula os coeficientes.
+
+Unidades dos destinos (amount 1.0 com a fonte em 1.0):
+    pitch        semitons
+    cutoff       oitavas (somadas ao cutoff do preset)
+    amp          ganho relativo: × (1 + m), nunca negativo
+    pan          -1.0 (L) … +1.0 (R), equal-power
+    pulse_width  somado ao duty da square (0.5), limitado a 0.05–0.95
+
+Faixa das fontes:
+    lfo1/lfo2              -1 … +1 (globais do Synth, rodam livres)
+    amp_env/filter_env      0 … 1  (por voz)
+    velocity                0 … 1  (por voz)
+    pitch_bend             -1 … +1 (canal; rampa do valor anterior)
+    mod_wheel/aftertouch    0 … 1  (canal; aftertouch soma a pressão
+                                    da nota — poly aftertouch ou MPE)
+    note_bend              -1 … +1 (por nota, MPE)
+    timbre                  0 … 1  (CC 74: canal + por nota em MPE)
+
+Expressão por nota (MPE, poly aftertouch):
+    Os valores chegam por evento, mas só são gravados num array por
+    slot de voz. O render suaviza todas as vozes de uma vez nos pontos
+    de controle (smooth_points: one-pole de EXPRESSION_SMOOTHING), então
+    um stream denso de expressão custa uma escrita por evento, não
+    trabalho por evento no áudio — e o degrau de um controlador de 7 bits
+    não vira zipper noise.
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+from typing import Dict, Iterable, Tuple
+
+import numpy as np
+
+from ..audio.arena import ENGINE_ARENA
+
+
+MOD_SOURCES = (
+    "lfo1", "lfo2", "amp_env", "filter_env",
+    "velocity", "pitch_bend", "mod_wheel", "aftertouch",
+    "note_bend", "timbre",
+)
+MOD_DESTINATIONS = ("pitch", "cutoff", "amp", "pan", "pulse_width")
+LFO_SHAPES = ("sine", "triangle", "saw", "square", "random")
+
+EXPRESSION_SMOOTHING = 0.005        # s — constante de tempo da expressão por nota
+
+SOURCE_INDEX = {name: i for i, name in enumerate(MOD_SOURCES)}
+DEST_INDEX = {name: i for i, name in enumerate(MOD_DESTINATIONS)}
+
+
+def control_times(frames: int, control_block: int) -> np.ndarray:
+    """Amostras dos pontos de controle de um bloco: 0, K, 2K, … e frames − 1."""
+    times = np.arange(0, frames, control_block)
+    if frames > 1 and times[-1] != frames - 1:
+        times = np.append(times, frames - 1)
+    return times
+
+
+def smooth_points(
+    state:       np.ndarray,
+    target:      np.ndarray,
+    times:       np.ndarray,
+    frames:      int,
+    sample_rate: int,
+    tau:         float = EXPRESSION_SMOOTHING,
+) -> np.ndarray:
+    """
+    One-pole de 'state' (V, E) em direção a 'target' (V, E), avaliado nos
+    pontos de controle: (V, E, P) float32 da ENGINE_ARENA — o dtype da
+    matriz de fontes que recebe os valores. state (float64) é atualizado
+    no lugar para o fim do bloco.
+    """
+    rate = -1.0 / (tau * sample_rate)
+    delta = state - target
+    out = ENGINE_ARENA.scratch((*state.shape, len(times)))
+    np.multiply(delta[..., None], np.exp(times * rate), out=out)
+    out += target[..., None]
+    np.multiply(delta, np.exp(frames * rate), out=state)
+    state += target
+    return out
+
+
+# ------------------------------------------------------------------
+# LFO
+# ------------------------------------------------------------------
+
+class LFO:
+    """
+    Oscilador de baixa frequência, avaliado só nos pontos de controle.
+
+        lfo = LFO("triangle", rate=4.0)
+        values = lfo.process(times, frames, sample_rate)   # (P,) em -1…+1
+
+    'random' é sample & hold: um valor novo por ciclo, derivado do número
+    do ciclo (determinístico, o mesmo render sempre dá o mesmo som).
+    """
+
+    def __init__(self, shape: str = "sine", rate: float = 1.0) -> None:
+        self.shape = "sine"
+        self.rate = 1.0
+        self._phase = 0.0           # ciclos acumulados (a parte inteira é o ciclo do S&H)
+        self.configure(shape, rate)
+
+    def configure(self, shape: str, rate: float) -> None:
+        shape = shape.lower()
+        if shape not in LFO_SHAPES:
+            raise ValueError(f"Forma de LFO desconhecida: '{shape}'. Disponíveis: {list(LFO_SHAPES)}")
+        self.shape, self.rate = shape, max(0.0, float(rate))
+
+    def reset(self) -> None:
+        self._phase = 0.0
+
+    def process(self, times: np.ndarray, frames: int, sample_rate: int) -> np.ndarray:
+        """Valores (P,) nas amostras 'times' do bloco; avança 'frames' amostras."""
+        step = self.rate / sample_rate
+        cycles = times * step + self._phase
+        self._phase = (self._phase + frames * step) % 1e6
+        phase = cycles % 1.0
+        shape = self.shape
+        if shape == "sine":
+            return np.sin(2.0 * np.pi * phase)
+        if shape == "triangle":
+            return 1.0 - 4.0 * np.abs(phase - 0.5)
+        if shape == "saw":
+            return 2.0 * phase - 1.0
+        if shape == "square":
+            return np.where(phase < 0.5, 1.0, -1.0)
+        # random: hash inteiro do número do ciclo → -1…+1
+        n = np.floor(cycles).astype(np.uint64)
+        h = (n * np.uint64(2654435761) + np.uint64(0x9E3779B9)) & np.uint64(0xFFFFFFFF)
+        h ^= h >> np.uint64(15)
+        h = (h * np.uint64(2246822519)) & np.uint64(0xFFFFFFFF)
+        return h / 2147483647.5 - 1.0
+
+    def __repr__(self) -> str:
+        return f"LFO({self.shape}, {self.rate:.2f} Hz)"
+
+
+# ------------------------------------------------------------------
+# Matriz
+# ------------------------------------------------------------------
+
+class ModMatrix:
+    """
+    Rotas fonte → destino compiladas numa matriz (D, NS).
+
+        mm = ModMatrix()
+        mm.set_routes([{"source": "lfo1", "dest": "pitch", "amount": 0.3}])
+        mm.sources          # índices das fontes usadas (só essas são calculadas)
+        out = mm.evaluate(src)                   # (V, NS, P) → (V, D, P)
+        mm.interpolate(out[:, d], times, frames) # (V, P) → (V, frames)
+    """
+
+    def __init__(self) -> None:
+        self.matrix = np.zeros((len(MOD_DESTINATIONS), len(MOD_SOURCES)), dtype=np.float32)
+        self.sources = np.zeros(0, dtype=np.intp)
+        self.dests = np.zeros(0, dtype=np.intp)
+        self._key: tuple = ()
+        self._interp: Dict[Tuple[int, int], Tuple[np.ndarray, np.ndarray]] = {}
+
+    def set_routes(self, routes: Iterable[dict], extra: Iterable[Tuple[str, str, float]] = ()) -> None:
+        """
+        Compila as rotas. Rotas repetidas (mesma fonte e destino) somam.
+        'extra' são rotas fixas do instrumento (pitch bend → pitch).
+        Fonte ou destino desconhecido levanta ValueError.
+        """
+        items = [(r["source"], r["dest"], float(r.get("amount", 1.0))) for r in routes]
+        items += list(extra)
+        key = tuple(items)
+        if key == self._key:
+            return
+
+        matrix = np.zeros_like(self.matrix)
+        for source, dest, amount in items:
+            if source not in SOURCE_INDEX:
+                raise ValueError(f"Fonte de modulação desconhecida: '{source}'. Disponíveis: {list(MOD_SOURCES)}")
+            if dest not in DEST_INDEX:
+                raise ValueError(f"Destino de modulação desconhecido: '{dest}'. Disponíveis: {list(MOD_DESTINATIONS)}")
+            matrix[DEST_INDEX[dest], SOURCE_INDEX[source]] += amount
+
+        self.matrix = matrix
+        self.sources = np.flatnonzero(matrix.any(axis=0))
+        self.dests = np.flatnonzero(matrix.any(axis=1))
+        self._key = key
+
+    def uses(self, source: str) -> bool:
+        return bool(self.matrix[:, SOURCE_INDEX[source]].any())
+
+    def evaluate(self, src: np.ndarray) -> np.ndarray:
+        """
+        Todas as rotas de todas as vozes: (V, NS, P) → (V, D, P), um matmul.
+        Fontes fora de 'sources' não são calculadas: vêm zeradas.
+        """
+        V, _, P = src.shape
+        out = ENGINE_ARENA.scratch((V, len(MOD_DESTINATIONS), P))
+        return np.matmul(self.matrix, src, out=out)
+
+    def interpolate(self, points: np.ndarray, times: np.ndarray, frames: int) -> np.ndarray:
+        """Pontos de controle (V, P) → curva por amostra (V, frames), linear."""
+        V, P = points.shape
+        out = ENGINE_ARENA.scratch((V, frames))
+        if P == 1:
+            out[:] = points
+            return out
+        index, frac = self._segments(times, frames)
+        start = points[:, index]
+        np.subtract(points[:, index + 1], start, out=out)
+        out *= frac
+        out += start
+        return out
+
+    def _segments(self, times: np.ndarray, frames: int) -> Tuple[np.ndarray, np.ndarray]:
+        """Segmento e fração de cada amostra — fixos por (frames, K), em cache."""
+        key = (frames, int(times[1] - times[0]))
+        seg = self._interp.get(key)
+        if seg is None:
+            t = np.arange(frames)
+            index = np.clip(np.searchsorted(times, t, side="right") - 1, 0, len(times) - 2)
+            frac = ((t - times[index]) / (times[index + 1] - times[index])).astype(np.float32)
+            seg = self._interp[key] = (index, frac)
+        return seg
+
+    def __repr__(self) -> str:
+        routes = int(np.count_nonzero(self.matrix))
+        return f"ModMatrix({routes} rotas)"
@@ -19,6 +19,9 @@ Esta versão:
 - Oferece osciladores comuns de synth: seno, dente-de-serra, quadrada,
   triângulo — todos com a mesma interface, então o Mixer/Synth pode
   trocar de forma de onda sem mudar lógica.
+- Fases e saída vêm da ENGINE_ARENA (audio/arena.py) e as formas de onda
+  são calculadas in-place (ufuncs com out=) — nenhum array novo por bloco
+  na thread de áudio. O array retornado vale até o próximo bloco.
 """
 from __future__ import annotations
 
@@ -26,6 +29,8 @@ from abc import ABC, abstractmethod
 
 import numpy as np
 
+from ..audio.arena import ENGINE_ARENA
+
 
 class Oscillator(ABC):
     """
@@ -56,9 +61,11 @@ class Oscillator(ABC):
         fase -> forma de onda.
         """
         phase_inc = freq / self.sample_rate
-        phases = self._phase + phase_inc * np.arange(frames, dtype=np.float64)
+        phases = ENGINE_ARENA.temp(frames)     # efêmero: some antes do próximo generate()
+        np.multiply(ENGINE_ARENA.ramp(frames), phase_inc, out=phases)
+        phases += self._phase
         self._phase = float((self._phase + phase_inc * frames) % 1.0)
-        return np.mod(phases, 1.0)
+        return np.mod(phases, 1.0, out=phases)
 
     def __repr__(self) -> str:
         return f"{self.__class__.__name__}(sr={self.sample_rate}, phase={self._phase:.4f})"
@@ -69,7 +76,8 @@ class SineOsc(Oscillator):
 
     def generate(self, freq: float, frames: int) -> np.ndarray:
         phases = self._advance_phase(freq, frames)
-        return np.sin(2.0 * np.pi * phases).astype(np.float32)
+        phases *= 2.0 * np.pi
+        return np.sin(phases, out=ENGINE_ARENA.scratch(frames))
 
 
 class SawOsc(Oscillator):
@@ -81,7 +89,9 @@ class SawOsc(Oscillator):
     def generate(self, freq: float, frames: int) -> np.ndarray:
         phases = self._advance_phase(freq, frames)
         # Mapeia fase [0,1) para [-1, 1)
-        return (2.0 * phases - 1.0).astype(np.float32)
+        out = np.multiply(phases, 2.0, out=ENGINE_ARENA.scratch(frames))
+        out -= 1.0
+        return out
 
 
 class SquareOsc(Oscillator):
@@ -96,8 +106,11 @@ class SquareOsc(Oscillator):
 
     def generate(self, freq: float, frames: int) -> np.ndarray:
         phases = self._advance_phase(freq, frames)
-        out = np.where(phases < self.duty, 1.0, -1.0)
-        return out.astype(np.float32)
+        # 1 - 2·(fase >= duty): +1 antes do duty, -1 depois
+        out = np.greater_equal(phases, self.duty, out=ENGINE_ARENA.scratch(frames))
+        out *= -2.0
+        out += 1.0
+        return out
 
 
 class TriangleOsc(Oscillator):
@@ -106,12 +119,12 @@ class TriangleOsc(Oscillator):
     def generate(self, freq: float, frames: int) -> np.ndarray:
         phases = self._advance_phase(freq, frames)
         # Triângulo: sobe de -1 a 1 na primeira metade, desce na segunda
-        out = np.where(
-            phases < 0.5,
-            4.0 * phases - 1.0,
-            3.0 - 4.0 * phases,
-        )
-        return out.astype(np.float32)
+        # (1 - 4·|fase - 0.5|, mesma curva dos dois ramos antigos)
+        phases -= 0.5
+        np.abs(phases, out=phases)
+        out = np.multiply(phases, -4.0, out=ENGINE_ARENA.scratch(frames))
+        out += 1.0
+        return out
 
 
 # ------------------------------------------------------------------
@@ -143,4 +156,86 @@ def create_oscillator(wave_type: str, sample_rate: int = 48000) -> Oscillator:
 
 def available_waveforms() -> list[str]:
     """Lista os nomes de forma de onda disponíveis (para popular UI)."""
-    return list(_OSCILLATOR_TYPES.keys())
\ No newline at end of file
+    return list(_OSCILLATOR_TYPES.keys())
+
+
+# ------------------------------------------------------------------
+# Formas de onda band-limited (PolyBLEP), em lote
+#
+# Os osciladores acima são "ingênuos": o salto da serra/quadrada cai
+# entre amostras e rebate (aliasing) — audível em notas agudas e muito
+# pior com unison, onde N cópias desafinadas rebatem cada uma num lugar.
+# render_waveform() corrige só as amostras vizinhas de cada
+# descontinuidade com o resíduo polinomial do degrau (BLEP) ou da rampa
+# (BLAMP, quinas do triângulo). Trabalha sobre um array 2D de fases —
+# (osciladores, frames) — para o banco de osciladores (dsp/unison.py).
+# ------------------------------------------------------------------
+
+def _polyblep(phases: np.ndarray, dt: np.ndarray, out: np.ndarray, scale: float) -> None:
+    """out += scale × resíduo BLEP de um degrau em fase 0 (dt: incremento por amostra)."""
+    dt = np.broadcast_to(dt, phases.shape)
+    m = phases < dt
+    x = phases[m] / dt[m]
+    out[m] += scale * (2.0 * x - x * x - 1.0)
+    m = phases > 1.0 - dt
+    x = (phases[m] - 1.0) / dt[m]
+    out[m] += scale * (x * x + 2.0 * x + 1.0)
+
+
+def _polyblamp(phases: np.ndarray, dt: np.ndarray, out: np.ndarray, scale: float) -> None:
+    """out += scale × dt × resíduo BLAMP de uma quina em fase 0."""
+    dt = np.broadcast_to(dt, phases.shape)
+    m = phases < dt
+    x = phases[m] / dt[m] - 1.0
+    out[m] += scale * dt[m] * (-x * x * x / 3.0)
+    m = phases > 1.0 - dt
+    x = (phases[m] - 1.0) / dt[m] + 1.0
+    out[m] += scale * dt[m] * (x * x * x / 3.0)
+
+
+def render_waveform(
+    wave_type: str,
+    phases:    np.ndarray,
+    dt:        np.ndarray,
+    out:       np.ndarray,
+    duty:      float | np.ndarray = 0.5,
+) -> np.ndarray:
+    """
+    Escreve em 'out' a forma de onda band-limited para as fases (M, F)
+    em [0, 1). dt (M, 1) ou (M, F): incremento de fase por amostra de
+    cada oscilador. duty (square) escalar ou por amostra, (M, F).
+    'phases' é usado como rascunho.
+    """
+    wave = wave_type.lower()
+    if wave == "sine":
+        np.multiply(phases, 2.0 * np.pi, out=out)
+        return np.sin(out, out=out)
+    if wave == "saw":
+        np.multiply(phases, 2.0, out=out)
+        out -= 1.0
+        _polyblep(phases, dt, out, -1.0)
+        return out
+    if wave == "square":
+        duty = np.clip(duty, 0.05, 0.95)
+        np.greater_equal(phases, duty, out=out)
+        out *= -2.0
+        out += 1.0
+        _polyblep(phases, dt, out, 1.0)
+        phases -= duty
+        np.mod(phases, 1.0, out=phases)
+        _polyblep(phases, dt, out, -1.0)
+        return out
+    if wave == "triangle":
+        np.subtract(phases, 0.5, out=out)
+        np.abs(out, out=out)
+        out *= -4.0
+        out += 1.0
+        _polyblamp(phases, dt, out, 4.0)
+        phases += 0.5
+        np.mod(phases, 1.0, out=phases)
+        _polyblamp(phases, dt, out, -4.0)
+        return out
+    raise ValueError(
+        f"Tipo de oscilador desconhecido: '{wave_type}'. "
+        f"Disponíveis: {list(_OSCILLATOR_TYPES.keys())}"
+    )
\ No newline at end of file
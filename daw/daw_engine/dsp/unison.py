@@ -0,0 +1,182 @@
+# dsp/unison.py
+"""
+Banco de osciladores das vozes do Synth, com unison (supersaw).
+
+Por que não N objetos Oscillator por voz:
+- Unison de 7 numa nota seriam 7 Oscillator, 7 generate(), 7 arrays —
+  um acorde de 6 notas, 42 chamadas Python por bloco só para gerar
+  forma de onda. O custo cresceria com vozes × unison.
+
+Como é feito aqui — OscillatorBank, um slot por voz (o mesmo slot do
+FilterBank):
+
+    fase[slot, u]   fase de cada sub-oscilador u (até MAX_UNISON)
+
+    process(slots, freqs, frames) monta UM array de fases 2D
+    (vozes × unison, frames), gera a forma de onda band-limited de todos
+    de uma vez (render_waveform, PolyBLEP) e distribui cada
+    sub-oscilador em L/R com uma soma ponderada por voz. Um acorde de 6
+    notas com supersaw de 7 custa o mesmo número de chamadas numpy que
+    uma nota só — só os arrays são maiores.
+
+Detune e largura estéreo:
+    Os sub-osciladores ficam espalhados simetricamente em [-1, 1]:
+    afinação = freq × 2^(posição × detune / 1200) (detune em cents, o
+    desvio dos dois extremos) e pan = posição × width, equal-power. O
+    ganho é 1/√N, para o unison não estourar o volume.
+
+    Com width 0 (ou unison 1) a saída é mono: (vozes, 1, frames). Com
+    width > 0, estéreo: (vozes, 2, frames).
+
+As fases iniciais de uma voz nova são fixas e espalhadas (razão áurea):
+sub-osciladores não começam em fase (o que soaria como um só, mais
+alto, no ataque) e o render continua determinístico.
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+import numpy as np
+
+from ..audio.arena import ENGINE_ARENA
+from .oscillator import available_waveforms, render_waveform
+
+
+MAX_UNISON = 16
+
+_GOLDEN = 0.6180339887498949
+
+
+class OscillatorBank:
+    """
+    Osciladores de todas as vozes de um Synth.
+
+        bank = OscillatorBank(slots=16, sample_rate=48000)
+        bank.set_unison(7, detune=25.0, width=0.8)
+        bank.reset(slot)                                    # voz nova
+        out = bank.process(slots, freqs, frames)            # (V, C, frames)
+        out = bank.process(slots, freqs_vf, frames, duty)   # pitch/pw por amostra
+    """
+
+    def __init__(
+        self,
+        slots:       int   = 16,
+        sample_rate: int   = 48000,
+        wave_type:   str   = "sine",
+    ) -> None:
+        self.sample_rate = sample_rate
+        self.wave_type = "sine"
+        self.pulse_width = 0.5
+        self._phase = np.zeros((slots, MAX_UNISON))
+        self._start = (np.arange(MAX_UNISON) * _GOLDEN) % 1.0
+        self._start[0] = 0.0
+        self.set_wave(wave_type)
+        self.set_unison(1)
+
+    # ------------------------------------------------------------------
+    # Configuração
+    # ------------------------------------------------------------------
+
+    def set_wave(self, wave_type: str) -> None:
+        wave = wave_type.lower()
+        if wave not in available_waveforms():
+            raise ValueError(
+                f"Tipo de oscilador desconhecido: '{wave_type}'. "
+                f"Disponíveis: {available_waveforms()}"
+            )
+        self.wave_type = wave
+
+    def set_unison(self, count: int = 1, detune: float = 0.0, width: float = 0.0) -> None:
+        """count sub-osciladores por voz, detune (cents) nos extremos, width 0–1."""
+        count = min(MAX_UNISON, max(1, int(count)))
+        width = min(1.0, max(0.0, width))
+        self.unison, self.detune, self.width = count, float(detune), width
+
+        spread = np.linspace(-1.0, 1.0, count) if count > 1 else np.zeros(1)
+        self._ratios = np.exp2(spread * self.detune / 1200.0)
+        self.channels = 2 if (width > 0.0 and count > 1) else 1
+        gain = 1.0 / np.sqrt(count)
+        if self.channels == 1:
+            self._pan = np.full((1, count), gain, dtype=np.float32)
+        else:
+            angle = (spread * width + 1.0) * (np.pi / 4.0)                  # equal-power
+            self._pan = (np.stack([np.cos(angle), np.sin(angle)]) * gain * np.sqrt(2.0)).astype(np.float32)
+
+    # ------------------------------------------------------------------
+    # Slots
+    # ------------------------------------------------------------------
+
+    @property
+    def slots(self) -> int:
+        return len(self._phase)
+
+    def ensure(self, slots: int) -> None:
+        """Garante pelo menos 'slots' slots (mantém as fases existentes)."""
+        if slots > len(self._phase):
+            phase = np.zeros((slots, MAX_UNISON))
+            phase[:len(self._phase)] = self._phase
+            self._phase = phase
+
+    def reset(self, slot: int) -> None:
+        self._phase[slot] = self._start
+
+    # ------------------------------------------------------------------
+    # Áudio
+    # ------------------------------------------------------------------
+
+    def process(
+        self,
+        slots:  np.ndarray,
+        freqs:  np.ndarray,
+        frames: int,
+        duty:   np.ndarray | None = None,
+    ) -> np.ndarray:
+        """
+        Gera 'frames' amostras de cada voz: (V, channels, frames) float32
+        da ENGINE_ARENA; avança as fases dos slots.
+
+        freqs (V,) em Hz, ou (V, frames) quando o pitch é modulado por
+        amostra (a fase vira a soma acumulada do incremento). duty
+        (V, frames) opcional: pulse width da square por amostra.
+        """
+        V, U = len(slots), self.unison
+        out = ENGINE_ARENA.scratch((V, self.channels, frames))
+        if V == 0 or frames == 0:
+            return out
+
+        freqs = np.asarray(freqs, dtype=np.float64)
+        start = self._phase[slots, :U].reshape(V * U, 1)
+        # Fases (V·U, frames) em float64 da arena — precisão de fase
+        phases = ENGINE_ARENA.scratch((V * U, frames), np.float64)
+        if freqs.ndim == 1:
+            # Incremento de fase de cada sub-oscilador: (V·U, 1)
+            dt = (freqs[:, None] * self._ratios[None, :] / self.sample_rate).reshape(V * U, 1)
+            np.multiply(ENGINE_ARENA.ramp(frames)[None, :], dt, out=phases)
+            end = start + dt * frames
+        else:
+            # Incremento por amostra (V·U, frames): fase = soma acumulada
+            dt = ENGINE_ARENA.scratch((V * U, frames), np.float64)
+            np.multiply(freqs[:, None, :], (self._ratios / self.sample_rate)[None, :, None],
+                        out=dt.reshape(V, U, frames))
+            np.cumsum(dt, axis=1, out=phases)
+            end = start + phases[:, -1:]
+            phases -= dt
+        # Fases 2D (V·U, frames) e a forma de onda de todos de uma vez
+        phases += start
+        np.mod(phases, 1.0, out=phases)
+        if duty is None or self.wave_type != "square":
+            duty = self.pulse_width
+        elif U > 1:
+            duty = np.repeat(duty, U, axis=0)
+        waves = ENGINE_ARENA.scratch((V * U, frames))
+        render_waveform(self.wave_type, phases, dt, waves, duty)
+
+        # Distribui no estéreo: (C, U) × (V, U, F) → (V, C, F)
+        np.matmul(self._pan, waves.reshape(V, U, frames), out=out)
+
+        self._phase[slots, :U] = (end % 1.0).reshape(V, U)
+        return out
+
+    def __repr__(self) -> str:
+        return (f"OscillatorBank({self.wave_type}, unison={self.unison}, detune={self.detune:.1f}c, "
+                f"width={self.width:.2f}, slots={self.slots})")
@@ -3,7 +3,8 @@
 Pacote de instrumentos virtuais da DAW.
 
 Atualmente:
-    Synth — sintetizador subtrativo polifônico (oscilador + ADSR por voz)
+    Synth — sintetizador subtrativo polifônico (osciladores em unison +
+            filtro + ADSR por voz)
 
 Futuros instrumentos seguirão a mesma interface:
     .note_on(note, velocity)
@@ -11,6 +12,13 @@ Futuros instrumentos seguirão a mesma interface:
     .all_notes_off()
     .process(frames) -> np.ndarray shape (frames, 2) float32
 
+Controladores opcionais — o Channel só chama se o instrumento tiver:
+    .set_pitch_bend(-1..1)  .set_mod_wheel(0..1)  .set_timbre(0..1)
+    .set_channel_pressure(0..1)  .set_poly_pressure(note, 0..1)
+    .set_bend_range(semitons, member)
+    .set_note_expression(member, índice, valor) — MPE; com ele, o Channel
+        também chama note_on/note_off com o canal membro
+
 Essa interface comum permite que o Mixer trate qualquer instrumento
 da mesma forma, sem saber qual é.
 """
@@ -4,27 +4,72 @@ Sintetizador polifônico subtrativo básico.
 
 Arquitetura de uma voz:
     MIDI note_on
-        └─> Voice(note, velocity)
-                ├─ Oscillator  (gera forma de onda: sine/saw/square/triangle)
-                └─ ADSR        (molda o volume ao longo do tempo)
+        └─> Voice(note, velocity, slot)
+                ├─ osciladores (slot no OscillatorBank: 1–16 em unison,
+                │               sine/saw/square/triangle band-limited)
+                ├─ filtro      (slot no FilterBank + envelope de filtro)
+                └─ ADSR        (slot no EnvelopeBank: molda o volume ao
+                                longo do tempo, segmentos exponenciais)
 
     O Synth gerencia N vozes simultâneas (polifonia) e mistura o áudio
     de todas elas num único buffer float32 estéreo, pronto para o Mixer.
+    Fase, estado de filtro e envelopes não ficam na Voice: ficam nos
+    bancos, uma linha por slot, e cada etapa roda para todas as vozes
+    numa chamada.
 
 Integração com o resto da DAW:
     - Mixer chama synth.process(frames) a cada bloco de áudio
     - Engine/Scheduler chama synth.note_on() / synth.note_off() via eventos
     - A forma de onda e os parâmetros ADSR são configuráveis por preset
+    - Buffers de voz e de saída vêm da ENGINE_ARENA (audio/arena.py): o
+      retorno de process() vale até o próximo bloco — quem guarda, copia
+
+Unison (dsp/unison.py):
+    unison sub-osciladores por voz, desafinados em ±unison_detune cents
+    e abertos no estéreo por unison_width. Todas as vozes × unison saem
+    de um único array de fases 2D por bloco.
+
+Filtro (dsp/filter.py):
+    SVF ZDF passa-baixa/banda/alta/notch, 12 ou 24 dB/oct. O estado não
+    fica na Voice: cada voz ganha um slot do FilterBank do Synth, e o
+    banco filtra todas as vozes do bloco numa chamada, empilhadas em
+    (vozes, frames). O cutoff de cada voz é recalculado a taxa de
+    controle (a cada control_block amostras):
+
+        cutoff × 2^(key_tracking·(nota − 60)/12 + filter_env_amount·env + mod)
+
+    com env o envelope de filtro da voz, filter_env_amount em oitavas e
+    mod a soma das rotas para "cutoff". filter_mode "off" (padrão) pula
+    o filtro.
+
+Modulação (dsp/modulation.py):
+    mod_routes liga fontes (lfo1, lfo2, amp_env, filter_env, velocity,
+    pitch_bend, mod_wheel, aftertouch) a destinos (pitch, cutoff, amp,
+    pan, pulse_width). As rotas viram uma matriz; a cada bloco as fontes
+    são calculadas nos pontos de controle para todas as vozes, um matmul
+    dá todos os destinos, e só os destinos com rota são interpolados por
+    amostra. Pitch bend → pitch (bend_range semitons) é uma rota fixa.
+
+Expressão por nota (MPE):
+    Com o Channel em modo MPE, cada nota chega num canal MIDI membro e
+    leva o número dele (member) para a Voice. Pitch bend, pressure e
+    CC 74 do canal membro são gravados nos arrays por slot (alvo) e
+    suavizados no render para todas as vozes juntas; entram na matriz
+    como note_bend (rota fixa → pitch, mpe_bend_range semitons),
+    aftertouch e timbre. Poly aftertouch usa o mesmo array de pressão.
 """
 from __future__ import annotations
 
-from dataclasses import dataclass, field
+from dataclasses import dataclass, field, fields
 from typing import Dict, List, Optional
 
 import numpy as np
 
-from ..dsp.oscillator import Oscillator, create_oscillator
-from ..dsp.adsr import ADSR
+from ..audio.arena import ENGINE_ARENA
+from ..dsp.adsr import ADSRStage, EnvelopeBank
+from ..dsp.filter import FilterBank
+from ..dsp.modulation import DEST_INDEX, LFO, SOURCE_INDEX, ModMatrix, control_times, smooth_points
+from ..dsp.unison import OscillatorBank
 
 
 # ------------------------------------------------------------------
@@ -36,6 +81,17 @@ MIDI_NOTE_FREQS: Dict[int, float] = {
     for n in range(128)
 }
 
+# Expressão por nota — colunas dos arrays por slot (MPE, poly aftertouch)
+NOTE_BEND, NOTE_PRESSURE, NOTE_TIMBRE = 0, 1, 2
+
+# Fonte da matriz → (controlador do canal em _controls, expressão da nota somada)
+_CHANNEL_SOURCES = {
+    SOURCE_INDEX["pitch_bend"]: (0, None),
+    SOURCE_INDEX["mod_wheel"]:  (1, None),
+    SOURCE_INDEX["aftertouch"]: (2, NOTE_PRESSURE),
+    SOURCE_INDEX["timbre"]:     (3, NOTE_TIMBRE),
+}
+
 
 # ------------------------------------------------------------------
 # Voz individual (uma nota soando)
@@ -43,50 +99,51 @@ MIDI_NOTE_FREQS: Dict[int, float] = {
 
 class Voice:
     """
-    Uma única voz do sintetizador: um par (Oscillator + ADSR).
+    Uma única voz do sintetizador: nota, velocity e o slot da voz nos
+    bancos do Synth (osciladores, filtro e os dois envelopes — amplitude
+    e filtro). O estado que muda a cada amostra fica nos bancos; a Voice
+    só aponta para o slot.
 
-    Gerada ao receber note_on; descartada quando o envelope chega a IDLE
-    após o note_off (is_finished == True).
+    Gerada ao receber note_on; descartada quando o envelope de amplitude
+    chega a IDLE após o note_off (is_finished == True).
     """
 
     def __init__(
         self,
-        note:        int,
-        velocity:    int,
-        wave_type:   str,
-        sample_rate: int,
-        attack:      float,
-        decay:       float,
-        sustain:     float,
-        release:     float,
+        note:       int,
+        velocity:   int,
+        slot:       int,
+        envelopes:  EnvelopeBank,
+        filter_env: EnvelopeBank,
+        member:     int = -1,
     ) -> None:
         self.note     = note
         self.velocity = velocity
+        self.member   = member          # canal MIDI membro (MPE); -1 fora de MPE
         self.freq     = MIDI_NOTE_FREQS.get(note, 440.0)
 
         # Ganho baseado em velocity (0–127 → 0.0–1.0, escala quadrática
         # para soar mais natural do que linear)
         self.gain = (velocity / 127.0) ** 2
 
-        self.osc  = create_oscillator(wave_type, sample_rate)
-        self.adsr = ADSR(attack=attack, decay=decay, sustain=sustain, release=release)
-        self.adsr.note_on()
+        self.slot = slot
+        self._envelopes = envelopes
+        self._filter_env = filter_env
 
     def note_off(self) -> None:
-        self.adsr.note_off()
+        self._envelopes.note_off(self.slot)
+        self._filter_env.note_off(self.slot)
 
-    def process(self, frames: int, sample_rate: int) -> np.ndarray:
-        """Gera 'frames' amostras mono float32 desta voz."""
-        wave     = self.osc.generate(self.freq, frames)        # forma de onda
-        envelope = self.adsr.process(frames, sample_rate)      # ganho ADSR
-        return wave * envelope * self.gain
+    @property
+    def stage(self) -> ADSRStage:
+        return ADSRStage(int(self._envelopes.stage[self.slot]))
 
     @property
     def is_finished(self) -> bool:
-        return self.adsr.is_finished
+        return self._envelopes.finished(self.slot)
 
     def __repr__(self) -> str:
-        return f"Voice(note={self.note}, freq={self.freq:.1f}Hz, {self.adsr.stage.name})"
+        return f"Voice(note={self.note}, freq={self.freq:.1f}Hz, {self.stage.name})"
 
 
 # ------------------------------------------------------------------
@@ -108,6 +165,34 @@ class SynthPreset:
     volume:     float = 0.7         # volume master do instrumento (0.0–1.0)
     max_voices: int   = 16          # limite de polifonia
 
+    # Unison (dsp/unison.py)
+    unison:        int   = 1        # sub-osciladores por voz (1–16)
+    unison_detune: float = 20.0     # cents nos extremos
+    unison_width:  float = 0.5      # abertura estéreo (0.0 = mono)
+
+    # Filtro (dsp/filter.py)
+    filter_mode:       str   = "off"     # off | lowpass | bandpass | highpass | notch
+    filter_slope:      int   = 12        # dB/oitava: 12 | 24
+    cutoff:            float = 8000.0    # Hz
+    resonance:         float = 0.0       # 0.0–1.0
+    key_tracking:      float = 0.0       # 0.0–1.0 (1.0 = cutoff acompanha a nota)
+    filter_env_amount: float = 0.0       # oitavas (negativo fecha o filtro)
+    filter_attack:     float = 0.01
+    filter_decay:      float = 0.3
+    filter_sustain:    float = 0.0
+    filter_release:    float = 0.3
+
+    # Modulação (dsp/modulation.py)
+    lfo1_shape:    str   = "sine"    # sine | triangle | saw | square | random
+    lfo1_rate:     float = 5.0       # Hz
+    lfo2_shape:    str   = "triangle"
+    lfo2_rate:     float = 0.5
+    bend_range:    float = 2.0       # semitons do pitch bend (rota fixa bend → pitch)
+    mpe_bend_range: float = 48.0     # semitons do pitch bend por nota (canais membro MPE)
+    control_block: int   = 32        # amostras por ponto de controle (modulação e filtro)
+    # Rotas da matriz: {"source": "lfo1", "dest": "pitch", "amount": 0.2}
+    mod_routes:    List[dict] = field(default_factory=list)
+
     def to_dict(self) -> dict:
         return {
             "name":       self.name,
@@ -118,11 +203,33 @@ class SynthPreset:
             "release":    self.release,
             "volume":     self.volume,
             "max_voices": self.max_voices,
+            "unison":        self.unison,
+            "unison_detune": self.unison_detune,
+            "unison_width":  self.unison_width,
+            "filter_mode":       self.filter_mode,
+            "filter_slope":      self.filter_slope,
+            "cutoff":            self.cutoff,
+            "resonance":         self.resonance,
+            "key_tracking":      self.key_tracking,
+            "filter_env_amount": self.filter_env_amount,
+            "filter_attack":     self.filter_attack,
+            "filter_decay":      self.filter_decay,
+            "filter_sustain":    self.filter_sustain,
+            "filter_release":    self.filter_release,
+            "lfo1_shape":    self.lfo1_shape,
+            "lfo1_rate":     self.lfo1_rate,
+            "lfo2_shape":    self.lfo2_shape,
+            "lfo2_rate":     self.lfo2_rate,
+            "bend_range":    self.bend_range,
+            "mpe_bend_range": self.mpe_bend_range,
+            "control_block": self.control_block,
+            "mod_routes":    [dict(r) for r in self.mod_routes],
         }
 
     @classmethod
     def from_dict(cls, data: dict) -> "SynthPreset":
-        return cls(**{k: v for k, v in data.items() if hasattr(cls, k)})
+        names = {f.name for f in fields(cls)}
+        return cls(**{k: v for k, v in data.items() if k in names})
 
 
 # ------------------------------------------------------------------
@@ -147,8 +254,19 @@ class Synth:
         sample_rate: int = 48000,
         preset: Optional[SynthPreset] = None,
     ) -> None:
+        self._setup(sample_rate, preset or SynthPreset())
+
+    @classmethod
+    def _from_params(cls, sample_rate: int, preset: SynthPreset) -> "Synth":
+        """Synth de um preset já resolvido (thaw de templates) — mesmo _setup do __init__."""
+        synth = cls.__new__(cls)
+        synth._setup(sample_rate, preset)
+        return synth
+
+    def _setup(self, sample_rate: int, preset: SynthPreset) -> None:
+        """Todo o estado da instância: preset, vozes e bancos vazios."""
         self.sample_rate = sample_rate
-        self.preset = preset or SynthPreset()
+        self.preset = preset
 
         # note -> lista de vozes (lista porque retrigger pode gerar
         # mais de uma voz para a mesma nota antes da anterior terminar)
@@ -157,61 +275,93 @@ class Synth:
         # Vozes em release (note_off disparado, mas envelope ainda decaindo)
         self._releasing: List[Voice] = []
 
+        # Bancos com um slot por voz viva; slots livres numa pilha. O
+        # filtro tem duas linhas por slot (L/R, quando o unison é estéreo)
+        slots = self.preset.max_voices
+        self.oscillators = OscillatorBank(slots=slots, sample_rate=sample_rate)
+        self.filter = FilterBank(slots=2 * slots, sample_rate=sample_rate)
+        self.envelopes = EnvelopeBank(slots)
+        self.filter_envelopes = EnvelopeBank(slots)
+        self._free_slots: List[int] = list(range(slots - 1, -1, -1))
+        self._unison: tuple = ()              # (unison, detune, width) aplicado no banco
+
+        # Modulação: LFOs globais, matriz de rotas, controladores do canal
+        # (pitch bend, mod wheel, channel pressure, timbre — valor atual e
+        # o do bloco anterior, para a rampa)
+        self.lfos = (LFO(), LFO())
+        self.modulation = ModMatrix()
+        self._controls = np.zeros(4)
+        self._controls_prev = np.zeros(4)
+
+        # Expressão por nota, por slot: alvo (o que chegou por evento) e o
+        # valor suavizado; canal membro MPE de cada slot e o último valor
+        # de cada canal membro (vale para a próxima nota nele)
+        self._expr_target = np.zeros((slots, 3))
+        self._expr = np.zeros((slots, 3))
+        self._member = np.full(slots, -1, dtype=np.int8)
+        self._member_expr = np.zeros((16, 3))
+
     # ------------------------------------------------------------------
     # Controle de notas
     # ------------------------------------------------------------------
 
-    def note_on(self, note: int, velocity: int = 100) -> None:
+    def note_on(self, note: int, velocity: int = 100, member: int = -1) -> None:
         """
         Inicia uma nota. Se a nota já estiver ativa, faz retrigger
         (a voz antiga vai para release e uma nova começa).
+
+        member: canal MIDI membro da nota em MPE (-1 fora de MPE). A voz
+        herda a expressão atual do canal e só responde à dele; a mesma
+        nota em dois canais membro são duas vozes.
         """
         note     = int(np.clip(note, 0, 127))
         velocity = int(np.clip(velocity, 0, 127))
 
         # Retrigger: manda a voz anterior para release sem silenciar
-        if note in self._voices:
-            for v in self._voices[note]:
-                v.note_off()
-                self._releasing.append(v)
-            del self._voices[note]
+        self._release(note, member)
 
         # Limite de polifonia: mata a voz mais antiga em release
         total = sum(len(vs) for vs in self._voices.values()) + len(self._releasing)
         if total >= self.preset.max_voices:
             self._steal_voice()
 
-        voice = Voice(
-            note=note,
-            velocity=velocity,
-            wave_type=self.preset.wave_type,
-            sample_rate=self.sample_rate,
-            attack=self.preset.attack,
-            decay=self.preset.decay,
-            sustain=self.preset.sustain,
-            release=self.preset.release,
-        )
-        self._voices[note] = [voice]
-
-    def note_off(self, note: int) -> None:
-        """Inicia o release para a nota dada."""
-        note = int(np.clip(note, 0, 127))
-        if note in self._voices:
-            for v in self._voices[note]:
+        p = self.preset
+        slot = self._acquire_slot()
+        self.envelopes.note_on(slot, p.attack, p.decay, p.sustain, p.release)
+        self.filter_envelopes.note_on(slot, p.filter_attack, p.filter_decay, p.filter_sustain, p.filter_release)
+        self._member[slot] = member
+        if member >= 0:
+            self._expr_target[slot] = self._expr[slot] = self._member_expr[member]
+        voice = Voice(note, velocity, slot, self.envelopes, self.filter_envelopes, member)
+        self._voices.setdefault(note, []).append(voice)
+
+    def note_off(self, note: int, member: int = -1) -> None:
+        """Inicia o release para a nota dada (no canal membro, em MPE)."""
+        self._release(int(np.clip(note, 0, 127)), member)
+
+    def _release(self, note: int, member: int) -> None:
+        voices = self._voices.get(note)
+        if not voices:
+            return
+        keep = []
+        for v in voices:
+            if v.member == member:
                 v.note_off()
                 self._releasing.append(v)
+            else:
+                keep.append(v)
+        if keep:
+            self._voices[note] = keep
+        else:
             del self._voices[note]
 
     def all_notes_off(self) -> None:
         """Para todas as notas imediatamente (útil em stop/panic)."""
-        for voices in self._voices.values():
-            for v in voices:
-                v.adsr.reset()
+        self.envelopes.reset()
+        self.filter_envelopes.reset()
         self._voices.clear()
-
-        for v in self._releasing:
-            v.adsr.reset()
         self._releasing.clear()
+        self._free_slots = list(range(self.oscillators.slots - 1, -1, -1))
 
     # ------------------------------------------------------------------
     # Processamento de áudio — chamado pelo Mixer a cada bloco
@@ -222,27 +372,188 @@ class Synth:
         Gera 'frames' amostras estéreo (shape: frames x 2, dtype float32).
         Soma as contribuições de todas as vozes ativas e em release.
         """
-        mono = np.zeros(frames, dtype=np.float32)
-
-        # Vozes ativas (sustain)
-        for voices in self._voices.values():
-            for v in voices:
-                mono += v.process(frames, self.sample_rate)
-
-        # Vozes em release — processa e descarta as que terminaram
+        # Vozes ativas (sustain) e em release
+        voices = [v for vs in self._voices.values() for v in vs] + self._releasing
+        stereo = ENGINE_ARENA.scratch((frames, 2))
+        if voices:
+            stereo[:] = self._render(voices, frames).T     # (1 ou 2, frames): mono vai ao centro
+        else:
+            stereo.fill(0.0)
+
+        # Descarta as vozes em release que terminaram
         still_releasing: List[Voice] = []
         for v in self._releasing:
-            mono += v.process(frames, self.sample_rate)
-            if not v.is_finished:
+            if v.is_finished:
+                self._free_slots.append(v.slot)
+            else:
                 still_releasing.append(v)
         self._releasing = still_releasing
+        self._controls_prev[:] = self._controls
 
         # Aplica volume master e previne clipping
-        mono *= self.preset.volume
-        mono  = np.clip(mono, -1.0, 1.0)
+        stereo *= self.preset.volume
+        np.clip(stereo, -1.0, 1.0, out=stereo)
+        return stereo
 
-        # Duplica para estéreo (mono center)
-        return np.column_stack([mono, mono])
+    def _render(self, voices: List[Voice], frames: int) -> np.ndarray:
+        """
+        Osciladores → filtro → ADSR de todas as vozes, somadas: (C, frames)
+        com C = 1 (mono) ou 2 (unison estéreo ou pan modulado). As vozes
+        são empilhadas em (vozes, C, frames) e cada banco processa a pilha
+        inteira de uma vez.
+        """
+        p, sr = self.preset, self.sample_rate
+        osc = self.oscillators
+        if osc.wave_type != p.wave_type.lower():
+            osc.set_wave(p.wave_type)
+        unison = (p.unison, p.unison_detune, p.unison_width)
+        if unison != self._unison:
+            osc.set_unison(*unison)
+            self._unison = unison
+        mod = self.modulation
+        mod.set_routes(p.mod_routes, self._fixed_routes())
+
+        # Envelopes por amostra: o de amplitude sempre, o de filtro quando
+        # o filtro está ligado ou é fonte de alguma rota
+        slots = np.array([v.slot for v in voices], dtype=np.intp)
+        filtered = p.filter_mode != "off"
+        amp_env = self.envelopes.process(slots, frames, sr)
+        filter_env = None
+        if filtered or mod.uses("filter_env"):
+            filter_env = self.filter_envelopes.process(slots, frames, sr)
+        times = control_times(frames, p.control_block)
+        points = self._modulate(voices, slots, amp_env, filter_env, times, frames)
+
+        def curve(dest: str) -> Optional[np.ndarray]:
+            # Destino sem rota (ou com todas as fontes em zero): None
+            row = points[:, DEST_INDEX[dest]]
+            return mod.interpolate(row, times, frames) if row.any() else None
+
+        freqs = np.array([v.freq for v in voices])
+        pitch = curve("pitch")
+        if pitch is not None:
+            pitch *= 1.0 / 12.0
+            freqs = np.exp2(pitch, out=pitch) * freqs[:, None]
+        duty = curve("pulse_width")
+        if duty is not None:
+            duty += osc.pulse_width
+
+        stack = osc.process(slots, freqs, frames, duty)        # (V, C, frames)
+        if filtered:
+            self._filter(voices, slots, stack, filter_env, points[:, DEST_INDEX["cutoff"]], frames)
+
+        gain = amp_env
+        gain *= np.array([v.gain for v in voices], dtype=np.float32)[:, None]
+        amp = curve("amp")
+        if amp is not None:
+            amp += 1.0
+            gain *= np.maximum(amp, 0.0, out=amp)
+        stack *= gain[:, None, :]
+
+        pan = curve("pan")
+        if pan is not None:
+            stack = self._pan(stack, pan)
+        return np.sum(stack, axis=0, out=ENGINE_ARENA.scratch(stack.shape[1:]))
+
+    def _modulate(
+        self,
+        voices:     List[Voice],
+        slots:      np.ndarray,
+        amp_env:    np.ndarray,
+        filter_env: Optional[np.ndarray],
+        times:      np.ndarray,
+        frames:     int,
+    ) -> np.ndarray:
+        """
+        Fontes nos pontos de controle → matriz → destinos (V, D, P). Só as
+        fontes usadas por alguma rota são calculadas.
+        """
+        p, sr, mod = self.preset, self.sample_rate, self.modulation
+        for lfo, shape, rate in zip(self.lfos, (p.lfo1_shape, p.lfo2_shape), (p.lfo1_rate, p.lfo2_rate)):
+            if (lfo.shape, lfo.rate) != (shape, rate):
+                lfo.configure(shape, rate)
+        lfo_values = [lfo.process(times, frames, sr) for lfo in self.lfos]
+
+        src = ENGINE_ARENA.zeros((len(voices), len(SOURCE_INDEX), len(times)))
+        # Controladores do canal: rampa do valor do bloco anterior ao atual
+        ramp = times / max(frames - 1, 1)
+        prev, cur = self._controls_prev, self._controls
+
+        # Expressão por nota de todas as vozes, suavizada nos pontos de controle
+        state = self._expr[slots]
+        expr = smooth_points(state, self._expr_target[slots], times, frames, sr)
+        self._expr[slots] = state
+
+        for s in mod.sources:
+            if s == SOURCE_INDEX["lfo1"]:
+                src[:, s] = lfo_values[0]
+            elif s == SOURCE_INDEX["lfo2"]:
+                src[:, s] = lfo_values[1]
+            elif s == SOURCE_INDEX["amp_env"]:
+                src[:, s] = amp_env[:, times]
+            elif s == SOURCE_INDEX["filter_env"]:
+                src[:, s] = filter_env[:, times]
+            elif s == SOURCE_INDEX["velocity"]:
+                src[:, s] = np.array([v.velocity / 127.0 for v in voices])[:, None]
+            elif s == SOURCE_INDEX["note_bend"]:
+                src[:, s] = expr[:, NOTE_BEND]
+            else:
+                c, note = _CHANNEL_SOURCES[s]
+                src[:, s] = prev[c] + (cur[c] - prev[c]) * ramp
+                if note is not None:
+                    src[:, s] += expr[:, note]
+                    np.minimum(src[:, s], 1.0, out=src[:, s])
+        return mod.evaluate(src)
+
+    def _fixed_routes(self) -> tuple:
+        """Rotas do instrumento, fora de mod_routes: pitch bend de canal e por nota → pitch."""
+        p = self.preset
+        return (("pitch_bend", "pitch", p.bend_range), ("note_bend", "pitch", p.mpe_bend_range))
+
+    def _filter(
+        self,
+        voices:     List[Voice],
+        slots:      np.ndarray,
+        stack:      np.ndarray,
+        filter_env: np.ndarray,
+        mod:        np.ndarray,
+        frames:     int,
+    ) -> None:
+        """
+        Filtra a pilha (V, C, frames) no lugar; a linha (voz, c) usa o slot
+        2·slot + c. mod (V, P): oitavas de modulação nos pontos de controle.
+        """
+        p, bank = self.preset, self.filter
+        if (bank.mode, bank.slope) != (p.filter_mode, p.filter_slope):
+            bank.set_mode(p.filter_mode, p.filter_slope)
+        bank.resonance = p.resonance
+        bank.control_block = p.control_block
+
+        # Envelope e modulação no início de cada sub-bloco de controle
+        n, channels = stack.shape[:2]
+        step = bank.control_block
+        points = bank.control_points(frames)
+        notes = np.array([v.note for v in voices], dtype=np.float32)
+        octaves = filter_env[:, ::step] * p.filter_env_amount
+        octaves += (p.key_tracking / 12.0 * (notes - 60.0))[:, None]
+        octaves += mod[:, :points]
+        cutoff = np.exp2(octaves, out=octaves)
+        cutoff *= p.cutoff
+
+        rows = (2 * slots[:, None] + np.arange(channels)).ravel()
+        bank.process(rows, stack.reshape(n * channels, frames), np.repeat(cutoff, channels, axis=0))
+
+    def _pan(self, stack: np.ndarray, pan: np.ndarray) -> np.ndarray:
+        """Pan por amostra (V, frames), equal-power; pilha mono vira estéreo."""
+        n, channels, frames = stack.shape
+        out = stack if channels == 2 else ENGINE_ARENA.scratch((n, 2, frames))
+        angle = np.clip(pan, -1.0, 1.0, out=pan)
+        angle += 1.0
+        angle *= np.pi / 4.0
+        # √2: pan central mantém o ganho do caminho sem pan (mono no centro)
+        np.multiply(stack[:, 0], np.cos(angle) * np.sqrt(2.0), out=out[:, 0])
+        np.multiply(stack[:, -1], np.sin(angle) * np.sqrt(2.0), out=out[:, 1])
+        return out
 
     # ------------------------------------------------------------------
     # Preset
@@ -257,6 +568,7 @@ class Synth:
 
     def set_wave(self, wave_type: str) -> None:
         """Atalho para mudar a forma de onda sem trocar o preset inteiro."""
+        self.oscillators.set_wave(wave_type)          # valida (ValueError)
         self.preset.wave_type = wave_type
 
     def set_adsr(
@@ -272,6 +584,110 @@ class Synth:
         if sustain is not None: self.preset.sustain = sustain
         if release is not None: self.preset.release = release
 
+    def set_unison(
+        self,
+        voices: Optional[int]   = None,
+        detune: Optional[float] = None,
+        width:  Optional[float] = None,
+    ) -> None:
+        """Atalho para o unison: sub-osciladores por voz, detune (cents), largura."""
+        if voices is not None: self.preset.unison        = voices
+        if detune is not None: self.preset.unison_detune = detune
+        if width  is not None: self.preset.unison_width  = width
+
+    def set_filter(
+        self,
+        mode:      Optional[str]   = None,
+        cutoff:    Optional[float] = None,
+        resonance: Optional[float] = None,
+        slope:     Optional[int]   = None,
+    ) -> None:
+        """Atalho para o filtro. Modo/inclinação inválidos levantam ValueError."""
+        if mode is not None or slope is not None:
+            mode = self.preset.filter_mode if mode is None else mode
+            slope = self.preset.filter_slope if slope is None else slope
+            if mode != "off":
+                self.filter.set_mode(mode, slope)
+            self.preset.filter_mode, self.preset.filter_slope = mode, slope
+        if cutoff    is not None: self.preset.cutoff    = cutoff
+        if resonance is not None: self.preset.resonance = resonance
+
+    def set_lfo(self, index: int, shape: Optional[str] = None, rate: Optional[float] = None) -> None:
+        """Atalho para o LFO 1 ou 2. Forma inválida levanta ValueError."""
+        p = self.preset
+        shape = getattr(p, f"lfo{index}_shape") if shape is None else shape
+        rate = getattr(p, f"lfo{index}_rate") if rate is None else rate
+        LFO(shape, rate)                              # valida; o render aplica no LFO
+        setattr(p, f"lfo{index}_shape", shape)
+        setattr(p, f"lfo{index}_rate", rate)
+
+    def add_mod_route(self, source: str, dest: str, amount: float = 1.0) -> None:
+        """Adiciona uma rota à matriz. Fonte/destino inválido levanta ValueError."""
+        routes = self.preset.mod_routes + [{"source": source, "dest": dest, "amount": amount}]
+        ModMatrix().set_routes(routes)                # valida fora da matriz do render
+        self.preset.mod_routes = routes
+
+    def clear_mod_routes(self) -> None:
+        self.preset.mod_routes = []
+
+    # ------------------------------------------------------------------
+    # Controladores do canal (fontes da matriz de modulação)
+    # ------------------------------------------------------------------
+
+    def set_pitch_bend(self, value: float) -> None:
+        """Pitch bend normalizado, -1.0–+1.0 (bend_range semitons nos extremos)."""
+        self._controls[0] = min(1.0, max(-1.0, value))
+
+    def set_mod_wheel(self, value: float) -> None:
+        """Mod wheel (CC 1) normalizado, 0.0–1.0."""
+        self._controls[1] = min(1.0, max(0.0, value))
+
+    def set_channel_pressure(self, value: float) -> None:
+        """Channel pressure (aftertouch de canal) normalizado, 0.0–1.0."""
+        self._controls[2] = min(1.0, max(0.0, value))
+
+    def set_timbre(self, value: float) -> None:
+        """Timbre (CC 74) do canal, 0.0–1.0."""
+        self._controls[3] = min(1.0, max(0.0, value))
+
+    def set_bend_range(self, semitones: float, member: bool = False) -> None:
+        """Faixa do pitch bend (RPN 0): do canal, ou dos canais membro MPE."""
+        if member:
+            self.preset.mpe_bend_range = float(semitones)
+        else:
+            self.preset.bend_range = float(semitones)
+
+    def set_poly_pressure(self, note: int, value: float) -> None:
+        """Aftertouch polifônico: pressão das vozes da nota, somada ao de canal."""
+        for v in self._voices.get(int(note), ()):
+            self._expr_target[v.slot, NOTE_PRESSURE] = min(1.0, max(0.0, value))
+
+    def set_note_expression(self, member: int, index: int, value: float) -> None:
+        """
+        Expressão de um canal membro MPE (NOTE_BEND -1..1, NOTE_PRESSURE e
+        NOTE_TIMBRE 0..1): vale para as vozes do canal e para a próxima
+        nota nele. Uma escrita por evento — a suavização fica no render.
+        """
+        value = min(1.0, max(-1.0 if index == NOTE_BEND else 0.0, value))
+        self._member_expr[member, index] = value
+        self._expr_target[self._member == member, index] = value
+
+    # ------------------------------------------------------------------
+    # Sample rate
+    # ------------------------------------------------------------------
+
+    def set_sample_rate(self, sample_rate: int) -> None:
+        """
+        Troca o sample rate sem matar as vozes (AudioOutput.reconfigure).
+
+        A fase dos osciladores é normalizada (0–1) e o estado dos
+        envelopes é só o nível (one-pole), então as notas seguem
+        contínuas — só o incremento/coeficiente por sample muda.
+        """
+        self.sample_rate = sample_rate
+        self.oscillators.sample_rate = sample_rate
+        self.filter.sample_rate = sample_rate
+
     # ------------------------------------------------------------------
     # Consulta de estado
     # ------------------------------------------------------------------
@@ -292,7 +708,30 @@ class Synth:
     def _steal_voice(self) -> None:
         """Remove a voz em release mais antiga para liberar polifonia."""
         if self._releasing:
-            self._releasing.pop(0)
+            self._free_slots.append(self._releasing.pop(0).slot)
+
+    def _acquire_slot(self) -> int:
+        """
+        Slot livre nos bancos, com fases e filtro zerados. Sem slot livre
+        (todas as vozes presas em sustain — _steal_voice só rouba release),
+        os bancos crescem.
+        """
+        if not self._free_slots:
+            start = self.oscillators.slots
+            self.oscillators.ensure(2 * start)
+            self.filter.ensure(4 * start)
+            self.envelopes.ensure(2 * start)
+            self.filter_envelopes.ensure(2 * start)
+            self._expr_target = np.concatenate([self._expr_target, np.zeros((start, 3))])
+            self._expr = np.concatenate([self._expr, np.zeros((start, 3))])
+            self._member = np.concatenate([self._member, np.full(start, -1, dtype=np.int8)])
+            self._free_slots = list(range(2 * start - 1, start - 1, -1))
+        slot = self._free_slots.pop()
+        self.oscillators.reset(slot)
+        self.filter.reset(2 * slot)
+        self.filter.reset(2 * slot + 1)
+        self._expr_target[slot] = self._expr[slot] = 0.0
+        return slot
 
     def __repr__(self) -> str:
         return (
@@ -0,0 +1,33 @@
+# ipc/__init__.py
+"""
+Comunicação com a engine de áudio fora do processo do Blender.
+
+    shm.py          — CommandRing (SPSC) e StateBlock (seqlock) em
+                      memória compartilhada
+    engine_host.py  — main() do processo da engine: drena comandos, roda o
+                      motor (Python ou a DLL via daw_bridge) e publica o
+                      estado com heartbeat
+
+O supervisor do lado do Blender é core/engine_process.py.
+"""
+from __future__ import annotations
+
+from .shm import (
+    COMMAND_DTYPE,
+    STATE_DTYPE,
+    Command,
+    CommandRing,
+    EngineStatus,
+    Op,
+    StateBlock,
+)
+
+__all__ = [
+    "COMMAND_DTYPE",
+    "STATE_DTYPE",
+    "Command",
+    "CommandRing",
+    "EngineStatus",
+    "Op",
+    "StateBlock",
+]
@@ -0,0 +1,419 @@
+# ipc/engine_host.py
+"""
+Processo da engine de áudio.
+
+Por que fora do Blender:
+- Um crash na engine (DLL nativa ou extensão numpy/PortAudio) derrubava o
+  Blender junto. Em outro processo, o Blender só vê o heartbeat parar e
+  o supervisor (core/engine_process.py) sobe outro.
+- O callback de áudio disputava o GIL com o Python do Blender (redraw,
+  operadores, handlers): um operador lento segurava o GIL e o bloco
+  atrasava. Aqui o GIL é só da engine.
+
+Laço principal (uma volta a cada LOOP_INTERVAL):
+    1. drena o CommandRing e aplica os comandos no backend
+    1b. backend.poll(): entrega o que os workers terminaram (freeze de
+        faixa) nesta thread, fora do callback
+    2. publica o StateBlock (posição, picos, CPU, xruns, espectro) + heartbeat
+    3. sai se recebeu SHUTDOWN ou se o processo pai morreu
+
+Backends:
+    PythonBackend — Mixer + AudioOutput desta árvore (sounddevice). Com
+                    audio=False não abre dispositivo: a posição anda pelo
+                    relógio (servidores, testes, máquina sem placa). O
+                    SpectrumAnalyzer roda numa thread própria; o laço só
+                    copia o último espectro para o StateBlock. A entrada
+                    MIDI ao vivo (MIDI_OPEN) abre a porta AQUI: a fila
+                    dela é a que o AudioCallback drena a cada bloco.
+    DllBackend    — o motor C++ via daw_bridge, como o register.py fazia
+                    dentro do Blender.
+
+Lançado por ipc/launch.py (que monta os pacotes sem importar o addon).
+Sem bpy.
+"""
+from __future__ import annotations
+
+import os
+import sys
+import time
+from pathlib import Path
+from typing import Any, Dict, Optional
+
+import numpy as np
+
+from ..audio.arena import ENGINE_ARENA
+from ..audio.config import ENGINE_CONFIG
+from ..audio.realtime import REALTIME
+from ..audio.spectrum import SPECTRUM_BANDS, SPECTRUM_SLOTS, SpectrumAnalyzer
+from ..audio.state import ENGINE_STATE
+from ..core.logger import LOGGER
+from .shm import MAX_PEAK_CHANNELS, Command, CommandRing, Op, StateBlock
+
+
+LOOP_INTERVAL = 0.005          # s — latência de comando e taxa do heartbeat
+
+
+# ------------------------------------------------------------------
+# Medição no callback
+# ------------------------------------------------------------------
+
+class _MeteredGenerator:
+    """
+    Envolve o Mixer no AudioCallback: guarda o pico por canal desde a
+    última publicação e a carga de CPU (tempo do bloco / duração do bloco).
+    """
+
+    def __init__(self, mixer: Any) -> None:
+        self.mixer = mixer
+        self.hold = np.zeros(MAX_PEAK_CHANNELS, dtype=np.float32)
+        self.cpu_load = 0.0
+
+    def process(self, frames: int, events=None) -> np.ndarray:
+        t0 = time.perf_counter()
+        out = self.mixer.process(frames, events)
+        n = min(out.shape[1], MAX_PEAK_CHANNELS)
+        mag = np.abs(out[:, :n], out=ENGINE_ARENA.scratch((frames, n)))
+        np.maximum(self.hold[:n], mag.max(axis=0), out=self.hold[:n])
+        load = (time.perf_counter() - t0) * ENGINE_CONFIG.sample_rate / frames
+        self.cpu_load += 0.1 * (load - self.cpu_load)
+        return out
+
+    def take_peaks(self) -> np.ndarray:
+        peaks = self.hold.copy()
+        self.hold.fill(0.0)
+        return peaks
+
+
+# ------------------------------------------------------------------
+# Backends
+# ------------------------------------------------------------------
+
+class PythonBackend:
+
+    kind = 0
+
+    def __init__(self, audio: bool = True) -> None:
+        from ...modules.instruments.midi import MidiInputService
+        from ...modules.mixer.tracks import FREEZER
+        from ..audio.output import AudioOutput
+        from ..mixer.mixer import Mixer
+
+        self.mixer = Mixer(ENGINE_CONFIG.sample_rate, ENGINE_CONFIG.channels)
+        self.meter = _MeteredGenerator(self.mixer)
+        self.analyzer = SpectrumAnalyzer(ENGINE_CONFIG.sample_rate)
+        self.mixer.set_analyzer(self.analyzer)
+        self.analyzer.start()
+        self._spectrum = np.zeros((SPECTRUM_SLOTS, SPECTRUM_BANDS), dtype=np.float32)
+        self.output = AudioOutput() if audio else None
+        self.midi_in = MidiInputService()
+        if self.output is not None:
+            self.output.set_generator(self.meter)
+            self.output.set_midi_queue(self.midi_in.queue)
+        self.midi_in.start()                      # NOTE_ON/OFF usam a fila mesmo sem porta
+        self.freezer = FREEZER                    # faixas congeladas seguem o transport daqui
+        self.tracks: Dict[int, int] = {}         # id local → índice do canal
+        self.playing = False
+        self.recording = False
+        self.bpm = float(ENGINE_CONFIG.bpm)
+        self._origin = 0                          # frame da posição 0
+        self._offset = 0.0                        # posição (s) no play
+        self._t0 = 0.0                            # relógio sem dispositivo
+
+    # ------------------------------------------------------------------
+
+    def handle(self, cmd: Command) -> None:
+        op = cmd.op
+        if op in (Op.PLAY, Op.RECORD):
+            self.recording = op == Op.RECORD
+            self._play()
+        elif op in (Op.STOP, Op.PAUSE):
+            pos = self.position()
+            self._stop()
+            self._offset = 0.0 if op == Op.STOP else pos
+        elif op == Op.SET_POSITION:
+            self._offset = max(0.0, cmd.f0)
+            self._origin = ENGINE_STATE.frames_processed
+            self._t0 = time.monotonic()
+            self.freezer.seek(self.mixer, self._offset)
+        elif op == Op.SET_BPM:
+            self.bpm = cmd.f0
+        elif op == Op.SET_MASTER_VOLUME:
+            self.mixer.master.volume = cmd.f0
+        elif op in (Op.NOTE_ON, Op.NOTE_OFF):
+            # Pela fila MIDI, nunca direto no instrumento: o callback toca a
+            # nota dentro do bloco (sem correr com Synth.process) e passa
+            # pelo gate de mute/solo do Channel. target = canal + 1.
+            if 0 <= cmd.i0 < 0xFF:
+                if op == Op.NOTE_ON:
+                    self.midi_in.send(0x90, cmd.i1, int(cmd.f0), target=cmd.i0 + 1)
+                else:
+                    self.midi_in.send(0x80, cmd.i1, 0, target=cmd.i0 + 1)
+        elif op == Op.ADD_TRACK:
+            self.mixer.add_channel(cmd.text or f"Track {cmd.i0}")
+            self.tracks[cmd.i0] = self.mixer.channel_count - 1
+        elif op == Op.LOAD_AUDIO:
+            LOGGER.warning("EngineHost", f"Motor Python ainda não toca clips de áudio: {cmd.text}")
+        elif op == Op.ADD_PLUGIN:
+            self._add_plugin(cmd.i0, cmd.text)
+        elif op == Op.ANALYZE_TRACK:
+            try:
+                self.mixer.analyze_channel(cmd.i0, self.tracks.get(cmd.i1))
+            except ValueError as e:
+                LOGGER.warning("EngineHost", str(e))
+        elif op == Op.MIDI_OPEN:
+            if cmd.i1 in self.tracks:
+                self.mixer.midi_input_channel = self.tracks[cmd.i1]
+            self.midi_in.open(cmd.text or None, virtual=bool(cmd.i0))
+        elif op == Op.MIDI_CLOSE:
+            self.midi_in.close()
+        elif op == Op.RECONFIGURE and self.output is not None:
+            self.output.reconfigure(cmd.i0 or None, cmd.i1 or None)
+
+    def _add_plugin(self, track_id: int, key: str) -> None:
+        """Insert LV2/CLAP no canal da faixa — o plugin roda no sandbox, não aqui."""
+        from ..plugins import SandboxedPlugin, scan_plugins
+        from ..core.registry import Registry
+
+        ch = self.mixer.get_channel(self.tracks.get(track_id, 0))
+        if ch is None:
+            return
+        if Registry().get("plugins", key) is None:
+            scan_plugins()
+        try:
+            ch.add_insert(SandboxedPlugin.create(key))
+        except Exception as e:
+            LOGGER.error("EngineHost", f"Plugin '{key}': {e}")
+
+    def _play(self) -> None:
+        if self.playing:
+            return
+        self.freezer.seek(self.mixer, self._offset)
+        self.playing = ENGINE_STATE.playing = True
+        self._origin = ENGINE_STATE.frames_processed
+        self._t0 = time.monotonic()
+        if self.output is not None:
+            self.output.start()
+
+    def _stop(self) -> None:
+        self.playing = self.recording = False
+        ENGINE_STATE.playing = False              # players congelados param de andar
+        self.mixer.all_notes_off()
+        if self.output is not None:
+            self.output.stop()
+
+    def poll(self) -> None:
+        """Aplica freezes concluídos — o Mixer mora neste processo, não no Blender."""
+        self.freezer.poll()
+
+    def position(self) -> float:
+        if not self.playing:
+            return self._offset
+        if self.output is None:
+            return self._offset + time.monotonic() - self._t0
+        return self._offset + (ENGINE_STATE.frames_processed - self._origin) / ENGINE_CONFIG.sample_rate
+
+    def status(self) -> Dict[str, Any]:
+        pos = self.position()
+        return {
+            "position":        pos,
+            "position_frames": int(pos * ENGINE_CONFIG.sample_rate),
+            "sample_rate":     ENGINE_CONFIG.sample_rate,
+            "buffer_size":     ENGINE_CONFIG.buffer_size,
+            "channels":        self.mixer.output_channels,
+            "track_count":     self.mixer.channel_count,
+            "playing":         self.playing,
+            "recording":       self.recording,
+            "xruns":           ENGINE_STATE.xruns,
+            "cpu_load":        self.meter.cpu_load,
+            "bpm":             self.bpm,
+            "peaks":           self.meter.take_peaks(),
+            "spectrum":        self.analyzer.read(self._spectrum),
+            "midi_input":      self.midi_in.is_open,
+        }
+
+    def shutdown(self) -> None:
+        self._stop()
+        self.freezer.shutdown()
+        self.midi_in.stop()
+        self.analyzer.stop()
+        from ..plugins import PLUGIN_SANDBOX
+        PLUGIN_SANDBOX.shutdown()
+
+
+def _preload_windows_deps(dll_path: Path) -> None:
+    """Pasta bin/ no buscador de DLLs + runtime do MinGW, se estiver ao lado."""
+    import ctypes
+
+    bin_dir = dll_path.parent
+    if hasattr(os, "add_dll_directory"):
+        os.add_dll_directory(str(bin_dir))
+    os.environ["PATH"] = str(bin_dir) + os.pathsep + os.environ.get("PATH", "")
+    for dep in ("libwinpthread-1.dll", "libgcc_s_seh-1.dll", "libstdc++-6.dll", "libgomp-1.dll"):
+        if (bin_dir / dep).exists():
+            try:
+                ctypes.CDLL(str(bin_dir / dep))
+            except OSError as e:
+                LOGGER.warning("EngineHost", f"Falha ao pré-carregar {dep}: {e}")
+
+
+class DllBackend:
+    """O motor C++ (daw_bridge.DAWEngine), agora isolado neste processo."""
+
+    kind = 1
+
+    def __init__(self, dll_path: str, sample_rate: int, buffer_size: int) -> None:
+        py_dir = Path(dll_path).parent.parent / "python"
+        if str(py_dir) not in sys.path:
+            sys.path.insert(0, str(py_dir))
+        if sys.platform == "win32":
+            _preload_windows_deps(Path(dll_path))
+        from daw_bridge import DAWEngine
+
+        e = DAWEngine(dll_path)
+        if not e.load():
+            raise RuntimeError("daw_bridge: load() falhou")
+        if not e.init(sample_rate=sample_rate, bit_depth=24, buffer_frames=buffer_size, bpm=120.0):
+            raise RuntimeError("daw_bridge: init() falhou")
+        self.e = e
+        self.sample_rate = sample_rate
+        self.buffer_size = buffer_size
+        self.tracks: Dict[int, int] = {}
+        self.playing = self.recording = False
+        self.bpm = 120.0
+
+    def handle(self, cmd: Command) -> None:
+        e, op = self.e, cmd.op
+        if op == Op.PLAY:
+            e.play(); self.playing = True
+        elif op == Op.RECORD:
+            try:
+                e.record()
+            except Exception:
+                e.play()
+            self.playing = self.recording = True
+        elif op in (Op.STOP, Op.PAUSE):
+            e.stop(); self.playing = self.recording = False
+        elif op == Op.SET_BPM:
+            e.set_bpm(cmd.f0); self.bpm = cmd.f0
+        elif op == Op.SET_MASTER_VOLUME:
+            e.set_master_volume(cmd.f0)
+        elif op == Op.ADD_TRACK:
+            self.tracks[cmd.i0] = e.add_track(cmd.text or "Audio", cmd.i1)
+        elif op == Op.LOAD_AUDIO:
+            e.load_audio(self.tracks.get(cmd.i0, cmd.i0), cmd.text)
+
+    def poll(self) -> None:
+        pass
+
+    def status(self) -> Dict[str, Any]:
+        s = self.e.get_state()
+        peaks = np.zeros(MAX_PEAK_CHANNELS, dtype=np.float32)
+        if s is not None:
+            peaks[0] = getattr(s, "peak_left", 0.0)
+            peaks[1] = getattr(s, "peak_right", 0.0)
+        pos = float(getattr(s, "position", 0.0) or 0.0)
+        return {
+            "position":        pos,
+            "position_frames": int(pos * self.sample_rate),
+            "sample_rate":     self.sample_rate,
+            "buffer_size":     self.buffer_size,
+            "channels":        2,
+            "track_count":     int(getattr(s, "track_count", len(self.tracks)) or 0),
+            "playing":         self.playing,
+            "recording":       self.recording,
+            "xruns":           int(getattr(s, "xruns", 0) or 0),
+            "cpu_load":        float(getattr(s, "cpu_load", 0.0) or 0.0),
+            "bpm":             self.bpm,
+            "peaks":           peaks,
+        }
+
+    def shutdown(self) -> None:
+        self.e.shutdown()
+
+
+# ------------------------------------------------------------------
+# main
+# ------------------------------------------------------------------
+
+def _parent_alive(parent_pid: int) -> bool:
+    return parent_pid <= 0 or os.getppid() == parent_pid
+
+
+def main(
+    ring_name:   str,
+    state_name:  str,
+    dll:         Optional[str] = None,
+    audio:       bool = True,
+    sample_rate: int = 0,
+    buffer_size: int = 0,
+    parent_pid:  int = 0,
+    realtime:    bool = False,
+) -> int:
+    """Laço do processo da engine. Retorna o código de saída."""
+    ring  = CommandRing.attach(ring_name)
+    state = StateBlock.attach(state_name)
+    if realtime:
+        # Processo só da engine: pode travar a memória toda (mlockall)
+        ENGINE_CONFIG.realtime = True
+        ENGINE_CONFIG.lock_memory = "all"
+    if sample_rate:
+        ENGINE_CONFIG.sample_rate = sample_rate
+    if buffer_size:
+        ENGINE_CONFIG.buffer_size = buffer_size
+
+    try:
+        backend = (DllBackend(dll, ENGINE_CONFIG.sample_rate, ENGINE_CONFIG.buffer_size)
+                   if dll else PythonBackend(audio=audio))
+    except Exception as e:
+        LOGGER.error("EngineHost", f"Falha ao iniciar o backend: {e}")
+        ring.close()
+        state.close()
+        return 2
+
+    LOGGER.info("EngineHost", f"Engine no processo {os.getpid()} ({type(backend).__name__})")
+    if realtime:
+        # Laço de comandos logo abaixo do callback: drenar o ring não
+        # pode esperar pela UI de outro processo
+        REALTIME.promote_current_thread("worker")
+    heartbeat = 0
+    processed = 0
+    code = 0
+    running = True
+    while running:
+        for cmd in ring.drain():
+            processed += 1
+            if cmd.op == Op.SHUTDOWN:
+                running = False
+                break
+            try:
+                backend.handle(cmd)
+            except Exception as e:
+                LOGGER.error("EngineHost", f"Comando {cmd.op.name} falhou: {e}")
+        try:
+            backend.poll()
+        except Exception as e:
+            LOGGER.error("EngineHost", f"poll falhou: {e}")
+
+        heartbeat += 1
+        state.write(
+            heartbeat=heartbeat,
+            heartbeat_time=time.monotonic(),
+            pid=os.getpid(),
+            backend=backend.kind,
+            commands=processed,
+            **backend.status(),
+        )
+
+        if not _parent_alive(parent_pid):
+            LOGGER.warning("EngineHost", "Processo pai sumiu — encerrando")
+            code = 1
+            break
+        time.sleep(LOOP_INTERVAL)
+
+    try:
+        backend.shutdown()
+        REALTIME.shutdown()
+    finally:
+        ring.close()
+        state.close()
+    return code
@@ -0,0 +1,83 @@
+# ipc/launch.py
+"""
+Ponto de entrada dos processos auxiliares (engine, sandbox de plugins,
+scan de plugins):
+
+    python launch.py --root <pasta do addon> --package <nome> \
+                     --ring <shm> --state <shm> [--dll ...] [--no-audio]
+    python launch.py ... --host plugins --ring <shm> --state <shm> --fds <kick>,<ack>
+    python launch.py ... --host scan [--paths a:b]
+
+Por que um script separado de engine_host.py:
+- O addon é importado pelo Blender com um nome que só ele conhece (pasta
+  de addons, extensões 'bl_ext.*'), e o __init__ do addon — assim como
+  core/engine.py — importa bpy, que não existe fora do Blender.
+- Aqui os pacotes do caminho (addon, daw_engine, daw_engine.core) são
+  registrados vazios em sys.modules, sem rodar os __init__ que puxam bpy;
+  os submódulos e seus imports relativos funcionam normalmente.
+
+Sem imports do addon no topo — este arquivo roda como script.
+"""
+from __future__ import annotations
+
+import argparse
+import importlib
+import os
+import sys
+import types
+
+
+def _namespace(name: str, path: str) -> None:
+    if name not in sys.modules:
+        mod = types.ModuleType(name)
+        mod.__path__ = [path]
+        sys.modules[name] = mod
+
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description="Processo da engine de áudio da DAW")
+    parser.add_argument("--root", required=True, help="pasta do addon (contém daw_engine/)")
+    parser.add_argument("--package", default="daw")
+    parser.add_argument("--host", choices=("engine", "plugins", "scan"), default="engine")
+    parser.add_argument("--ring", default="")
+    parser.add_argument("--state", default="")
+    parser.add_argument("--fds", default="", help="pipes do sandbox: kick,ack")
+    parser.add_argument("--paths", default="", help="pastas do scan, separadas por ':'")
+    parser.add_argument("--dll", default=None)
+    parser.add_argument("--no-audio", action="store_true")
+    parser.add_argument("--sample-rate", type=int, default=0)
+    parser.add_argument("--buffer-size", type=int, default=0)
+    parser.add_argument("--parent-pid", type=int, default=0)
+    parser.add_argument("--realtime", action="store_true")
+    args = parser.parse_args(argv)
+
+    root, pkg = args.root.rstrip("/\\"), args.package
+    _namespace(pkg, root)
+    _namespace(f"{pkg}.daw_engine", f"{root}/daw_engine")
+    _namespace(f"{pkg}.daw_engine.core", f"{root}/daw_engine/core")
+
+    if args.host == "scan":
+        host = importlib.import_module(f"{pkg}.daw_engine.plugins.host")
+        return host.scan_main([p for p in args.paths.split(os.pathsep) if p])
+    if not (args.ring and args.state):
+        parser.error("--ring e --state são obrigatórios")
+    if args.host == "plugins":
+        host = importlib.import_module(f"{pkg}.daw_engine.plugins.host")
+        kick_fd, ack_fd = (int(fd) for fd in args.fds.split(","))
+        return host.main(args.ring, args.state, kick_fd, ack_fd, parent_pid=args.parent_pid)
+
+    host = importlib.import_module(f"{pkg}.daw_engine.ipc.engine_host")
+    return host.main(
+        args.ring,
+        args.state,
+        dll=args.dll,
+        audio=not args.no_audio,
+        sample_rate=args.sample_rate,
+        buffer_size=args.buffer_size,
+        parent_pid=args.parent_pid,
+        realtime=args.realtime,
+    )
+
+
+if __name__ == "__main__":
+    sys.exit(main())
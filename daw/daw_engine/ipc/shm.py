@@ -0,0 +1,357 @@
+# ipc/shm.py
+"""
+Blocos de memória compartilhada entre o Blender e o processo da engine.
+
+Por que memória compartilhada (e não pipe/socket/Queue):
+- O lado do Blender manda comandos a partir de operadores e callbacks de
+  propriedade; ler o estado acontece a cada redraw. Um pipe exigiria
+  serializar (pickle) e uma chamada de sistema por mensagem, e o leitor
+  do estado teria que drenar mensagens antigas para chegar na última.
+- Aqui o comando é um registro de tamanho fixo num ring SPSC, e o estado
+  é UM bloco sobrescrito no lugar: quem lê sempre vê o mais recente.
+
+CommandRing — SPSC (Blender produz, engine consome):
+    Mesmo modelo da midi/queue.py, só que entre processos: cada lado só
+    escreve o próprio índice (write / read, em linhas de cache separadas),
+    e o slot é gravado ANTES de publicar write. Capacidade potência de 2.
+
+StateBlock — seqlock (engine escreve, Blender lê):
+    O escritor incrementa 'seq' (fica ímpar), grava os campos, incrementa
+    de novo (par). O leitor copia o registro entre duas leituras de 'seq'
+    e repete se elas diferem ou se a primeira era ímpar. Nenhum lado
+    bloqueia o outro — o escritor nunca espera pelo Blender.
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+from enum import IntEnum
+from multiprocessing import shared_memory
+from typing import List, NamedTuple, Optional
+
+import numpy as np
+
+from ..audio.spectrum import SPECTRUM_BANDS, SPECTRUM_SLOTS
+
+
+MAX_PEAK_CHANNELS = 16
+
+
+# ------------------------------------------------------------------
+# Comandos
+# ------------------------------------------------------------------
+
+class Op(IntEnum):
+    NOP               = 0
+    PLAY              = 1
+    STOP              = 2
+    RECORD            = 3
+    PAUSE             = 4
+    SET_BPM           = 5      # f0 = bpm
+    SET_MASTER_VOLUME = 6      # f0 = volume
+    SET_POSITION      = 7      # f0 = segundos
+    NOTE_ON           = 8      # i0 = canal, i1 = nota, f0 = velocity
+    NOTE_OFF          = 9      # i0 = canal, i1 = nota
+    ADD_TRACK         = 10     # i0 = id local, i1 = tipo, text = nome
+    LOAD_AUDIO        = 11     # i0 = id local da faixa, text = caminho
+    RECONFIGURE       = 12     # i0 = sample rate, i1 = buffer size (0 = manter)
+    SHUTDOWN          = 13
+    PLUGIN_LOAD       = 14     # sandbox: i0 = slot (caminho/id no BlockExchange)
+    PLUGIN_UNLOAD     = 15     # sandbox: i0 = slot
+    PLUGIN_PARAM      = 16     # sandbox: i0 = slot, i1 = id do parâmetro, f0 = valor
+    ADD_PLUGIN        = 17     # engine: i0 = id local da faixa, text = chave no Registry
+    ANALYZE_TRACK     = 18     # i0 = slot do espectro (1…), i1 = id local da faixa (0 = libera)
+    MIDI_OPEN         = 19     # text = porta ("" = primeira), i0 = 1 → porta virtual,
+                               # i1 = id local da faixa armada (0 = manter)
+    MIDI_CLOSE        = 20
+
+
+COMMAND_DTYPE = np.dtype([
+    ("op",   np.uint16),
+    ("_pad", np.uint16),
+    ("i0",   np.int32),
+    ("i1",   np.int32),
+    ("_pad2", np.int32),
+    ("f0",   np.float64),
+    ("f1",   np.float64),
+    ("text", "S224"),          # UTF-8 (nomes, caminhos)
+])
+
+
+class Command(NamedTuple):
+    op:   Op
+    i0:   int
+    i1:   int
+    f0:   float
+    f1:   float
+    text: str
+
+
+# write e read em linhas de cache (64 bytes) diferentes: os dois processos
+# escrevem cada um o seu sem disputar a mesma linha
+_RING_HEADER_DTYPE = np.dtype([
+    ("write", np.uint64), ("_pad0", np.uint64, 7),
+    ("read",  np.uint64), ("_pad1", np.uint64, 7),
+])
+
+
+# ------------------------------------------------------------------
+# Estado publicado
+# ------------------------------------------------------------------
+
+STATE_DTYPE = np.dtype([
+    ("seq",             np.uint64),
+    ("heartbeat",       np.uint64),   # incrementado a cada volta do host
+    ("heartbeat_time",  np.float64),  # time.monotonic() da última volta
+    ("pid",             np.int64),
+    ("position_frames", np.int64),
+    ("position",        np.float64),  # segundos
+    ("sample_rate",     np.int32),
+    ("buffer_size",     np.int32),
+    ("channels",        np.int32),
+    ("track_count",     np.int32),
+    ("playing",         np.uint8),
+    ("recording",       np.uint8),
+    ("backend",         np.uint8),    # 0 = python, 1 = dll
+    ("midi_input",      np.uint8),    # porta MIDI aberta no processo da engine
+    ("_pad",            np.uint8, 4),
+    ("xruns",           np.uint64),
+    ("commands",        np.uint64),   # comandos processados
+    ("cpu_load",        np.float32),
+    ("bpm",             np.float32),
+    ("peaks",           np.float32, MAX_PEAK_CHANNELS),
+    # Espectro (audio/spectrum.py): slot 0 = master, 0–1 por banda log
+    ("spectrum",        np.float32, (SPECTRUM_SLOTS, SPECTRUM_BANDS)),
+])
+
+
+class EngineStatus:
+    """
+    Cópia consistente do StateBlock (o que StateBlock.read() devolve).
+
+    peak_left/peak_right/track_count mantêm os nomes do get_state() do
+    bridge C++ — o painel do Blender lê os dois do mesmo jeito.
+    """
+
+    __slots__ = ("_rec",)
+
+    def __init__(self, rec: np.void) -> None:
+        self._rec = rec
+
+    def __getattr__(self, name: str):
+        try:
+            value = self._rec[name]
+        except (KeyError, ValueError, IndexError):
+            raise AttributeError(name) from None
+        return value.item() if np.ndim(value) == 0 else value
+
+    @property
+    def peaks(self) -> np.ndarray:
+        return self._rec["peaks"][:max(1, int(self._rec["channels"]))]
+
+    @property
+    def peak_left(self) -> float:
+        return float(self._rec["peaks"][0])
+
+    @property
+    def peak_right(self) -> float:
+        ch = int(self._rec["channels"])
+        return float(self._rec["peaks"][1 if ch > 1 else 0])
+
+    def __repr__(self) -> str:
+        return (
+            f"EngineStatus(pid={self.pid}, hb={self.heartbeat}, "
+            f"{'playing' if self.playing else 'stopped'} @ {self.position:.2f}s, "
+            f"cpu={self.cpu_load:.0%}, xruns={self.xruns})"
+        )
+
+
+# ------------------------------------------------------------------
+# Base
+# ------------------------------------------------------------------
+
+def _attach(name: str) -> shared_memory.SharedMemory:
+    """
+    Anexa sem registrar no resource_tracker deste processo. Antes do 3.13
+    anexar também registrava — e o tracker do processo da engine apagava
+    o segmento do Blender ao sair.
+    """
+    try:
+        return shared_memory.SharedMemory(name=name, track=False)
+    except TypeError:
+        pass
+    # < 3.13: sem 'track'. Desregistrar depois não serve — no mesmo
+    # processo do dono apagaria o registro dele. Suprime o registro.
+    from multiprocessing import resource_tracker
+    register = resource_tracker.register
+    resource_tracker.register = lambda *args, **kwargs: None
+    try:
+        return shared_memory.SharedMemory(name=name)
+    finally:
+        resource_tracker.register = register
+
+
+class _SharedBlock:
+    """Dono (create=True) cria e remove o segmento; o outro lado só anexa."""
+
+    def __init__(self, name: Optional[str], size: int, create: bool) -> None:
+        if create:
+            self._shm = shared_memory.SharedMemory(name=name, create=True, size=size)
+            self._shm.buf[:size] = bytes(size)
+        else:
+            self._shm = _attach(name)
+        self.owner = create
+
+    @property
+    def name(self) -> str:
+        return self._shm.name
+
+    def close(self) -> None:
+        """Solta o mapeamento; o dono também remove o segmento."""
+        self._release_views()
+        try:
+            self._shm.close()
+        except BufferError:
+            return                           # ainda há views vivas — o GC fecha depois
+        if self.owner:
+            try:
+                self._shm.unlink()
+            except FileNotFoundError:
+                pass
+
+    def _release_views(self) -> None:
+        pass
+
+
+# ------------------------------------------------------------------
+# Ring de comandos
+# ------------------------------------------------------------------
+
+class CommandRing(_SharedBlock):
+    """
+    Fila SPSC de Command em memória compartilhada.
+
+        ring = CommandRing(capacity=256)                 # Blender (dono)
+        ring.push(Op.SET_BPM, f0=128.0)
+        ...
+        ring = CommandRing.attach(name)                  # engine
+        for cmd in ring.drain(): ...
+    """
+
+    def __init__(self, capacity: int = 256, name: Optional[str] = None, create: bool = True) -> None:
+        size = 1
+        while size < capacity:
+            size <<= 1
+        super().__init__(name, _RING_HEADER_DTYPE.itemsize + size * COMMAND_DTYPE.itemsize, create)
+        if not create:
+            # O tamanho real vem do segmento (o dono escolheu a capacidade)
+            size = (self._shm.size - _RING_HEADER_DTYPE.itemsize) // COMMAND_DTYPE.itemsize
+            p = 1
+            while p * 2 <= size:
+                p *= 2
+            size = p
+        self.capacity = size
+        self._mask = size - 1
+        self._hdr = np.ndarray((1,), dtype=_RING_HEADER_DTYPE, buffer=self._shm.buf)
+        self._slots = np.ndarray((size,), dtype=COMMAND_DTYPE, buffer=self._shm.buf,
+                                 offset=_RING_HEADER_DTYPE.itemsize)
+        self.dropped = 0
+
+    @classmethod
+    def attach(cls, name: str) -> "CommandRing":
+        return cls(name=name, create=False)
+
+    def _release_views(self) -> None:
+        self._hdr = self._slots = None
+
+    # ------------------------------------------------------------------
+    # Produtor
+    # ------------------------------------------------------------------
+
+    def push(self, op: Op, i0: int = 0, i1: int = 0, f0: float = 0.0, f1: float = 0.0,
+             text: str = "") -> bool:
+        """Enfileira um comando. False se a fila está cheia (a engine não está drenando)."""
+        hdr = self._hdr
+        w = int(hdr["write"][0])
+        if w - int(hdr["read"][0]) >= self.capacity:
+            self.dropped += 1
+            return False
+        self._slots[w & self._mask] = (int(op), 0, i0, i1, 0, f0, f1,
+                                       text.encode("utf-8")[:COMMAND_DTYPE["text"].itemsize])
+        hdr["write"][0] = w + 1              # publica só depois do slot gravado
+        return True
+
+    # ------------------------------------------------------------------
+    # Consumidor
+    # ------------------------------------------------------------------
+
+    def drain(self, max_commands: int = 64) -> List[Command]:
+        hdr = self._hdr
+        r = int(hdr["read"][0])
+        n = min(int(hdr["write"][0]) - r, max_commands)
+        out: List[Command] = []
+        for k in range(n):
+            rec = self._slots[(r + k) & self._mask]
+            try:
+                op = Op(int(rec["op"]))
+            except ValueError:
+                op = Op.NOP
+            out.append(Command(op, int(rec["i0"]), int(rec["i1"]), float(rec["f0"]),
+                               float(rec["f1"]), bytes(rec["text"]).decode("utf-8", "replace")))
+        if n:
+            hdr["read"][0] = r + n
+        return out
+
+    def __len__(self) -> int:
+        return int(self._hdr["write"][0]) - int(self._hdr["read"][0])
+
+    def __repr__(self) -> str:
+        return f"<CommandRing {self.name} {len(self)}/{self.capacity} dropped={self.dropped}>"
+
+
+# ------------------------------------------------------------------
+# Bloco de estado (seqlock)
+# ------------------------------------------------------------------
+
+class StateBlock(_SharedBlock):
+    """Um registro STATE_DTYPE protegido por seqlock. Um escritor, N leitores."""
+
+    def __init__(self, name: Optional[str] = None, create: bool = True) -> None:
+        super().__init__(name, STATE_DTYPE.itemsize, create)
+        self._rec = np.ndarray((1,), dtype=STATE_DTYPE, buffer=self._shm.buf)
+        self._seq = self._rec["seq"]          # view do contador
+        self.retries = 0
+
+    @classmethod
+    def attach(cls, name: str) -> "StateBlock":
+        return cls(name=name, create=False)
+
+    def _release_views(self) -> None:
+        self._rec = self._seq = None
+
+    def write(self, **fields) -> None:
+        """Escritor único: publica os campos dados num passo consistente."""
+        seq = self._seq
+        rec = self._rec[0]
+        seq[0] += 1                           # ímpar: escrita em andamento
+        for k, v in fields.items():
+            rec[k] = v
+        seq[0] += 1                           # par: consistente
+
+    def read(self, max_tries: int = 1000) -> Optional[EngineStatus]:
+        """Cópia consistente do estado. None se o escritor nunca liberou (travado no meio)."""
+        seq = self._seq
+        rec = self._rec
+        for _ in range(max_tries):
+            s1 = int(seq[0])
+            if s1 & 1:
+                self.retries += 1
+                continue
+            copy = rec[0].copy()
+            if int(seq[0]) == s1:
+                return EngineStatus(copy)
+            self.retries += 1
+        return None
+
+    def __repr__(self) -> str:
+        return f"<StateBlock {self.name} seq={int(self._seq[0])}>"
@@ -7,7 +7,8 @@ Exporta os tipos de evento e utilitários usados por:
 - Scheduler (core): despacha eventos pelo tempo durante a reprodução
 - Synth (instruments): recebe NoteOnEvent e chama synth.note_on()
 - Mixer (mixer): encaminha CCs e pitch bend para os canais corretos
-- Futuro: midi_input.py (captura de teclado físico via rtmidi/mido)
+- mpe.py: zonas MPE (canal master/membros) para expressão por nota
+- modules/instruments/midi.py: entrada ao vivo (rtmidi/mido) → MidiEventQueue
 """
 from __future__ import annotations
 
@@ -23,14 +24,25 @@ from .events import (
     PitchBendEvent,
     ProgramChangeEvent,
     AftertouchEvent,
+    ChannelPressureEvent,
     # Sequência
     MidiSequence,
     # Helpers
     event_from_dict,
     event_from_raw,
+    # Representação compacta (tempo real)
+    MIDI_EVENT_DTYPE,
+    pack_raw,
+    unpack_raw,
+    make_event_block,
+    events_to_block,
+    coalesce_block,
+    expression_mask,
     # Compat
     NoteEvent,
 )
+from .queue import MidiEventQueue, make_block_buffer
+from .mpe import MpeRole, MpeZones
 
 __all__ = [
     "MidiStatus",
@@ -42,8 +54,20 @@ __all__ = [
     "PitchBendEvent",
     "ProgramChangeEvent",
     "AftertouchEvent",
+    "ChannelPressureEvent",
     "MidiSequence",
     "event_from_dict",
     "event_from_raw",
+    "MIDI_EVENT_DTYPE",
+    "pack_raw",
+    "unpack_raw",
+    "make_event_block",
+    "events_to_block",
+    "coalesce_block",
+    "expression_mask",
     "NoteEvent",
+    "MidiEventQueue",
+    "make_block_buffer",
+    "MpeRole",
+    "MpeZones",
 ]
\ No newline at end of file
@@ -17,12 +17,18 @@ Esta versão:
 - Inclui helpers de conversão (bytes raw <-> dataclass) para integração
   com dispositivos físicos via python-rtmidi ou mido.
 - MidiSequence: lista ordenada de eventos que representa um clip MIDI.
+- Representação compacta para o caminho de tempo real: inteiros empacotados
+  (status | data1 << 8 | data2 << 16) e arrays estruturados numpy
+  (MIDI_EVENT_DTYPE). As dataclasses continuam sendo o formato de edição
+  e serialização; o audio thread só enxerga a forma compacta.
 """
 from __future__ import annotations
 
 from dataclasses import dataclass, field
 from enum import IntEnum
-from typing import Any, Dict, List, Optional, Tuple
+from typing import Any, Dict, Iterable, List, Optional, Tuple
+
+import numpy as np
 
 
 # ------------------------------------------------------------------
@@ -49,11 +55,17 @@ class MidiStatus(IntEnum):
 # ------------------------------------------------------------------
 
 class CC(IntEnum):
+    BANK_SELECT   = 0      # MSB do banco (vale para o próximo program change)
     MODULATION    = 1
+    DATA_ENTRY    = 6      # valor do RPN selecionado
     VOLUME        = 7
     PAN           = 10
     EXPRESSION    = 11
+    BANK_SELECT_LSB = 32
     SUSTAIN_PEDAL = 64
+    TIMBRE        = 74     # brilho/timbre (eixo Y do MPE)
+    RPN_LSB       = 100
+    RPN_MSB       = 101
     ALL_SOUND_OFF = 120
     ALL_NOTES_OFF = 123
 
@@ -86,6 +98,11 @@ class MidiEvent:
             "channel":  self.channel,
         }
 
+    def to_packed(self) -> int:
+        """Versão compacta (ver pack_raw) — usada pelo caminho de tempo real."""
+        raw = self.to_raw()   # type: ignore[attr-defined]
+        return pack_raw(raw[0], raw[1], raw[2] if len(raw) > 2 else 0)
+
 
 # ------------------------------------------------------------------
 # Note On / Note Off
@@ -240,6 +257,31 @@ class AftertouchEvent(MidiEvent):
         return d
 
 
+# ------------------------------------------------------------------
+# Channel pressure
+# ------------------------------------------------------------------
+
+@dataclass
+class ChannelPressureEvent(MidiEvent):
+    """
+    Pressão do canal inteiro (channel aftertouch). Em MPE, num canal
+    membro, é a pressão da nota daquele canal.
+    """
+    pressure: int = 0    # 0–127
+
+    def __post_init__(self) -> None:
+        super().__post_init__()
+        self.pressure = int(self.pressure) & 0x7F
+
+    def to_raw(self) -> Tuple[int, int]:
+        return (MidiStatus.CHANNEL_PRESSURE | self.channel, self.pressure)
+
+    def to_dict(self) -> Dict[str, Any]:
+        d = super().to_dict()
+        d.update({"pressure": self.pressure})
+        return d
+
+
 # ------------------------------------------------------------------
 # Factory — reconstrói evento a partir de dict (para carregar projeto)
 # ------------------------------------------------------------------
@@ -251,6 +293,7 @@ _EVENT_CLASSES = {
     "PitchBendEvent":    PitchBendEvent,
     "ProgramChangeEvent": ProgramChangeEvent,
     "AftertouchEvent":   AftertouchEvent,
+    "ChannelPressureEvent": ChannelPressureEvent,
 }
 
 
@@ -307,9 +350,159 @@ def event_from_raw(
     elif status_type == MidiStatus.AFTERTOUCH:
         return AftertouchEvent(**base, note=data1, pressure=data2)
 
+    elif status_type == MidiStatus.CHANNEL_PRESSURE:
+        return ChannelPressureEvent(**base, pressure=data1)
+
     return None
 
 
+# ------------------------------------------------------------------
+# Representação compacta — caminho de tempo real
+#
+# Criar uma dataclass por evento (com __post_init__ mascarando campos)
+# custa caro quando chegam CCs densos (mod wheel, aftertouch a ~1 kHz).
+# No audio thread os eventos viajam como:
+#   - int empacotado: status | data1 << 8 | data2 << 16 | target << 24
+#   - linhas de um array estruturado MIDI_EVENT_DTYPE (um bloco inteiro)
+# e são despachados por tabela indexada pelo nibble de status.
+# ------------------------------------------------------------------
+
+MIDI_EVENT_DTYPE = np.dtype([
+    ("frame",  np.uint32),   # offset em samples dentro do bloco (ou absoluto)
+    ("status", np.uint8),    # status byte completo (tipo | canal)
+    ("data1",  np.uint8),
+    ("data2",  np.uint8),
+    ("target", np.uint8),    # canal do Mixer + 1 (0 = midi_input_channel)
+])
+
+
+def pack_raw(status: int, data1: int, data2: int = 0, target: int = 0) -> int:
+    """
+    Empacota uma mensagem MIDI de até 3 bytes num único int.
+
+    target (byte alto) escolhe o canal do Mixer que recebe o evento:
+    índice + 1, ou 0 = canal armado para entrada ao vivo.
+    """
+    return (
+        (status & 0xFF) | ((data1 & 0x7F) << 8) | ((data2 & 0x7F) << 16)
+        | ((target & 0xFF) << 24)
+    )
+
+
+def unpack_raw(packed: int) -> Tuple[int, int, int]:
+    """Inverso de pack_raw: retorna (status, data1, data2) — sem o target."""
+    return packed & 0xFF, (packed >> 8) & 0x7F, (packed >> 16) & 0x7F
+
+
+def make_event_block(capacity: int) -> np.ndarray:
+    """Array estruturado vazio (zerado) para um bloco de eventos compactos."""
+    return np.zeros(capacity, dtype=MIDI_EVENT_DTYPE)
+
+
+def events_to_block(
+    events: Iterable[MidiEvent],
+    frames: Optional[Iterable[int]] = None,
+) -> np.ndarray:
+    """
+    Converte eventos (dataclasses) para um array MIDI_EVENT_DTYPE.
+
+    frames: offset em samples de cada evento. Se None, todos ficam no frame 0.
+    Eventos sem to_raw() (ex: compat NoteEvent) são ignorados.
+    """
+    rows = []
+    frame_iter = iter(frames) if frames is not None else None
+    for ev in events:
+        frame = next(frame_iter) if frame_iter is not None else 0
+        to_raw = getattr(ev, "to_raw", None)
+        if to_raw is None:
+            continue
+        raw = to_raw()
+        rows.append((frame, raw[0], raw[1], raw[2] if len(raw) > 2 else 0, 0))
+    return np.array(rows, dtype=MIDI_EVENT_DTYPE)
+
+
+# Controladores contínuos (0–63: MSB/LSB) podem ser coalescidos sem perder
+# informação relevante. Switches (64+: sustain, sostenuto...) e mensagens de
+# modo de canal (120+) nunca são descartados — a ordem deles importa. Data
+# entry (6) também não: cada valor vale para o RPN selecionado antes dele.
+# Nem bank select (0/32): cada par escolhe o banco do program change que
+# vem depois dele no mesmo bloco.
+_COALESCE_MAX_CC = 63
+_COALESCE_EXCLUDED_CC = np.array([CC.BANK_SELECT, CC.DATA_ENTRY, CC.BANK_SELECT_LSB], dtype=np.uint8)
+
+
+def coalesce_block(block: np.ndarray) -> np.ndarray:
+    """
+    Descarta mensagens redundantes de um bloco de eventos compactos.
+
+    Dentro do mesmo bloco, só o ÚLTIMO valor de cada fluxo contínuo
+    chega ao instrumento:
+        - CC contínuo    → por (status, controller)
+        - Poly aftertouch → por (status, nota)
+        - Channel pressure / pitch bend → por status
+    Notas, program change, bank select, data entry e CCs de switch/modo
+    passam intactos e na ordem.
+    Na prática isso decima streams densos para a taxa de blocos.
+
+    Retorna um novo array (ou o mesmo, se nada foi descartado).
+    """
+    if len(block) < 2:
+        return block
+
+    status = block["status"]
+    data1 = block["data1"]
+    kind = status & 0xF0
+
+    keyed_by_data1 = (
+        ((kind == MidiStatus.CONTROL_CHANGE) & (data1 <= _COALESCE_MAX_CC)
+         & ~np.isin(data1, _COALESCE_EXCLUDED_CC))
+        | (kind == MidiStatus.AFTERTOUCH)
+    )
+    coalescible = (
+        keyed_by_data1
+        | (kind == MidiStatus.PITCH_BEND)
+        | (kind == MidiStatus.CHANNEL_PRESSURE)
+    )
+    idx = np.flatnonzero(coalescible)
+    if len(idx) < 2:
+        return block
+
+    # Fluxos de canais-alvo diferentes nunca se fundem
+    key = (
+        (block["target"].astype(np.uint32) << 16)
+        | (status.astype(np.uint32) << 8)
+        | np.where(keyed_by_data1, data1, 0)
+    )
+    # Último de cada chave = primeiro na ordem reversa
+    rev = idx[::-1]
+    _, first = np.unique(key[rev], return_index=True)
+    if len(first) == len(idx):
+        return block
+
+    keep = ~coalescible
+    keep[rev[first]] = True
+    return block[keep]
+
+
+def expression_mask(block: np.ndarray) -> np.ndarray:
+    """
+    Máscara dos eventos de expressão contínua de um bloco: pitch bend,
+    pressure (canal e polifônica), mod wheel e timbre (CC 74). O
+    instrumento suaviza esses valores na taxa de controle, então eles não
+    precisam partir o render no frame exato do evento — um stream MPE
+    denso não vira dezenas de segmentos por bloco.
+    """
+    status = block["status"]
+    kind = status & 0xF0
+    data1 = block["data1"]
+    return (
+        (kind == MidiStatus.PITCH_BEND)
+        | (kind == MidiStatus.CHANNEL_PRESSURE)
+        | (kind == MidiStatus.AFTERTOUCH)
+        | ((kind == MidiStatus.CONTROL_CHANGE) & ((data1 == CC.MODULATION) | (data1 == CC.TIMBRE)))
+    )
+
+
 # ------------------------------------------------------------------
 # MidiSequence — lista ordenada de eventos (conteúdo de um clip MIDI)
 # ------------------------------------------------------------------
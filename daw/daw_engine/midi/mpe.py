@@ -0,0 +1,94 @@
+# midi/mpe.py
+"""
+Zonas MPE (MIDI Polyphonic Expression).
+
+Em MPE cada nota tocada ganha um canal MIDI só dela (canal "membro"):
+pitch bend, channel pressure e CC 74 nesse canal viram expressão DA
+NOTA — glide, pressão e timbre por dedo. O canal "master" da zona manda
+o que vale para a zona inteira (pitch bend global, pedal, volume).
+
+    Zona lower:  master = canal 1 (índice 0), membros 2 … 1+N
+    Zona upper:  master = canal 16 (índice 15), membros 15 … 16−N
+
+As duas zonas dividem os 14 canais do meio; configurar uma encolhe a
+outra se não couber (como na especificação). N = 0 desliga a zona.
+
+O controlador anuncia as zonas com a MCM (MPE Configuration Message):
+RPN 6 no canal master, com N no data entry. O Channel do mixer trata a
+MCM e chama configure() — ver mixer/mixer.py.
+
+Aqui só fica o mapa canal → papel; a expressão em si é estado do
+instrumento (arrays por slot de voz no Synth).
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+from enum import IntEnum
+from typing import List
+
+
+MPE_LOWER_MASTER = 0
+MPE_UPPER_MASTER = 15
+MPE_MAX_MEMBERS = 15
+
+# RPNs (número = MSB << 7 | LSB)
+RPN_PITCH_BEND_RANGE = 0
+RPN_MPE_CONFIGURATION = 6
+RPN_NULL = 0x3FFF
+
+
+class MpeRole(IntEnum):
+    NONE   = 0      # fora das zonas: tratado como canal comum
+    MASTER = 1
+    MEMBER = 2
+
+
+class MpeZones:
+    """
+    Papel de cada um dos 16 canais MIDI.
+
+        zones = MpeZones(lower=15)            # layout padrão: tudo na lower
+        zones.role[ch]                        # MpeRole, lista indexada
+        zones.configure(MPE_UPPER_MASTER, 4)  # MCM no canal 16
+    """
+
+    def __init__(self, lower: int = 15, upper: int = 0) -> None:
+        self.lower = 0
+        self.upper = 0
+        self.role: List[int] = [MpeRole.NONE] * 16
+        self.configure(MPE_LOWER_MASTER, lower)
+        if upper:
+            self.configure(MPE_UPPER_MASTER, upper)
+
+    def configure(self, master: int, members: int) -> None:
+        """Zona do canal master (0 ou 15) com 'members' canais; a outra encolhe se preciso."""
+        if master not in (MPE_LOWER_MASTER, MPE_UPPER_MASTER):
+            raise ValueError(f"Canal master MPE inválido: {master} (use 0 ou 15)")
+        members = min(MPE_MAX_MEMBERS, max(0, int(members)))
+        if master == MPE_LOWER_MASTER:
+            self.lower = members
+            self.upper = min(self.upper, 14 - members) if self.upper else 0
+        else:
+            self.upper = members
+            self.lower = min(self.lower, 14 - members) if self.lower else 0
+        self._build()
+
+    def _build(self) -> None:
+        role = [MpeRole.NONE] * 16
+        if self.lower:
+            role[MPE_LOWER_MASTER] = MpeRole.MASTER
+            for ch in range(1, 1 + self.lower):
+                role[ch] = MpeRole.MEMBER
+        if self.upper:
+            role[MPE_UPPER_MASTER] = MpeRole.MASTER
+            for ch in range(15 - self.upper, 15):
+                role[ch] = MpeRole.MEMBER
+        self.role = role
+
+    @property
+    def enabled(self) -> bool:
+        return bool(self.lower or self.upper)
+
+    def __repr__(self) -> str:
+        return f"MpeZones(lower={self.lower}, upper={self.upper})"
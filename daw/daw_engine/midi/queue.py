@@ -0,0 +1,124 @@
+# midi/queue.py
+"""
+Fila de eventos MIDI entre threads (produtor único → audio thread).
+
+Por que não usar audio/ringbuffer.py:
+- RingBuffer usa um Lock. Se a thread de entrada MIDI estiver segurando o
+  lock quando o callback de áudio rodar, o callback espera — xrun.
+- RingBuffer guarda objetos Python arbitrários; aqui só trafegam inteiros
+  empacotados (midi.events.pack_raw) e timestamps em samples.
+
+Modelo SPSC (single producer, single consumer):
+    - Um único produtor (thread de entrada MIDI) chama push().
+    - Um único consumidor (AudioCallback) chama pop_block().
+    - Cada lado só escreve o próprio índice (_write / _read). Atribuir um
+      int a um atributo é atômico sob o GIL, então nenhum lado precisa de
+      lock. Os slots são gravados ANTES de publicar _write.
+
+Armazenamento pré-alocado (numpy int64); pop_block() escreve num array
+MIDI_EVENT_DTYPE fornecido pelo chamador — nada é alocado no audio thread.
+"""
+from __future__ import annotations
+
+import numpy as np
+
+from .events import MIDI_EVENT_DTYPE
+
+
+class MidiEventQueue:
+    """
+    Fila SPSC sem lock de eventos compactos com timestamp em samples.
+
+    Os eventos devem ser enfileirados em ordem crescente de tempo (é o
+    caso de uma porta MIDI). Eventos cujo tempo já passou saem no frame 0
+    do próximo bloco; eventos futuros ficam na fila até o bloco certo.
+    """
+
+    def __init__(self, capacity: int = 4096) -> None:
+        # Potência de 2 → índice do slot com máscara em vez de módulo
+        size = 1
+        while size < capacity:
+            size <<= 1
+        self.capacity = size
+        self._mask = size - 1
+
+        self._packed = np.zeros(size, dtype=np.int64)
+        self._times  = np.zeros(size, dtype=np.int64)
+
+        self._write: int = 0    # só o produtor escreve
+        self._read:  int = 0    # só o consumidor escreve
+
+        self.dropped: int = 0   # eventos descartados por fila cheia
+
+    # ------------------------------------------------------------------
+    # Produtor
+    # ------------------------------------------------------------------
+
+    def push(self, packed: int, sample_time: int) -> bool:
+        """
+        Enfileira um evento empacotado para o instante 'sample_time'
+        (no relógio de samples do audio thread). Retorna False se cheia.
+        """
+        w = self._write
+        if w - self._read >= self.capacity:
+            self.dropped += 1
+            return False
+        slot = w & self._mask
+        self._packed[slot] = packed
+        self._times[slot] = sample_time
+        self._write = w + 1          # publica só depois de gravar o slot
+        return True
+
+    # ------------------------------------------------------------------
+    # Consumidor (audio thread)
+    # ------------------------------------------------------------------
+
+    def pop_block(self, block_start: int, frames: int, out: np.ndarray) -> int:
+        """
+        Move para 'out' (MIDI_EVENT_DTYPE) todos os eventos com tempo
+        anterior a block_start + frames, com o campo 'frame' relativo ao
+        início do bloco. Retorna quantos eventos foram escritos.
+        """
+        r = self._read
+        available = self._write - r
+        if available <= 0:
+            return 0
+
+        block_end = block_start + frames
+        limit = min(available, len(out))
+        n = 0
+        while n < limit:
+            slot = (r + n) & self._mask
+            t = int(self._times[slot])
+            if t >= block_end:
+                break
+            packed = int(self._packed[slot])
+            row = out[n]
+            row["frame"]  = t - block_start if t > block_start else 0
+            row["status"] = packed & 0xFF
+            row["data1"]  = (packed >> 8) & 0x7F
+            row["data2"]  = (packed >> 16) & 0x7F
+            row["target"] = (packed >> 24) & 0xFF
+            n += 1
+
+        self._read = r + n
+        return n
+
+    def clear(self) -> None:
+        """Descarta tudo (chamar só com o produtor parado)."""
+        self._read = self._write
+
+    # ------------------------------------------------------------------
+    # Consulta
+    # ------------------------------------------------------------------
+
+    def __len__(self) -> int:
+        return self._write - self._read
+
+    def __repr__(self) -> str:
+        return f"<MidiEventQueue {len(self)}/{self.capacity} dropped={self.dropped}>"
+
+
+def make_block_buffer(capacity: int = 512) -> np.ndarray:
+    """Buffer de saída reutilizável para MidiEventQueue.pop_block()."""
+    return np.zeros(capacity, dtype=MIDI_EVENT_DTYPE)
@@ -14,13 +14,22 @@ O Mixer é o ponto central do fluxo de áudio:
                 └─> soma de todos os Channel.process()
                         └─> MasterBus (volume + soft limiter)
                                 └─> np.ndarray (frames, 2) float32 → stream
+
+    Bounce / freeze (render.py)
+        └─> OfflineRenderer.bounce(snapshot, mixer)
+                └─> RENDER_CACHE: render pré-fader por hash de conteúdo da faixa
 """
 from __future__ import annotations
 
 from .mixer import Mixer, Channel, MasterBus
+from .render import OfflineRenderer, RenderCache, RENDER_CACHE, freeze_candidates
 
 __all__ = [
     "Mixer",
     "Channel",
     "MasterBus",
+    "OfflineRenderer",
+    "RenderCache",
+    "RENDER_CACHE",
+    "freeze_candidates",
 ]
\ No newline at end of file
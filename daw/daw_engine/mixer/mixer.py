@@ -10,7 +10,7 @@ Por que reescrever:
   solo e send para o master bus.
 
 Arquitetura:
-    Channel  — faixa individual: instrumento + ganho + pan + mute/solo
+    Channel  — faixa individual: instrumento + inserts + ganho + pan + mute/solo
     MasterBus — soma todos os canais, aplica volume master e limiter
     Mixer    — orquestra canais e master bus, expõe API para o AudioCallback
 
@@ -18,21 +18,106 @@ Fluxo de sinal por bloco de áudio:
     [Channel 0: Synth] ─┐
     [Channel 1: Synth] ─┼─> MasterBus (soma + volume + limiter) ─> saída
     [Channel N: ...]   ─┘
+
+Despacho MIDI:
+    Nada de cadeias de isinstance por evento. Dataclasses são despachadas
+    por tabela indexada pelo tipo (type(event)); eventos compactos (int
+    empacotado / MIDI_EVENT_DTYPE) por tabela indexada pelo nibble de status,
+    e CCs por tabela indexada pelo número do controlador. Blocos de eventos
+    passam por coalesce_block() antes de chegar ao instrumento.
+
+MPE:
+    Com enable_mpe() (ou a MCM vinda do controlador), o nibble de canal
+    MIDI passa a importar: canais membro da zona (midi/mpe.py) levam
+    nota, pitch bend, pressure e CC 74 para a expressão da nota no
+    instrumento; o canal master vale para o canal inteiro. Eventos de
+    expressão contínua não partem o render do bloco — o Synth suaviza
+    na taxa de controle.
+
+Parâmetros de canal:
+    volume/pan/mute/solo e os coeficientes de pan não são atributos soltos
+    de cada Channel: são colunas de um único array estruturado
+    (CHANNEL_PARAMS_DTYPE) do Mixer, uma linha por canal. Channel expõe as
+    mesmas propriedades de antes, lendo/escrevendo a sua linha. O render
+    aplica ganho e pan de todos os canais numa única operação vetorizada,
+    e mute/solo viram uma máscara ('active') recalculada só quando mudam —
+    solo não sobrescreve mais o mute manual dos outros canais.
+
+Barramentos multicanal:
+    O master tem um SpeakerLayout (audio/layout.py): estéreo, 5.1, 7.1 ou
+    ambisônico. Em estéreo o caminho é o de sempre (fonte estéreo × L/R).
+    Nos demais, cada canal é somado em mono e distribuído por uma matriz
+    de pan (canais, N) — VBAP ou codificação ambisônica a partir de
+    pan/azimute/elevação — recalculada só quando um pan muda. Se a saída
+    do dispositivo tiver outro layout, a matriz de downmix é aplicada
+    depois do master, um matmul por bloco.
+
+Compensação de latência (PDC):
+    Cada insert pode declarar 'latency' (samples). A latência do canal é
+    a soma; update_latency() atrasa os demais canais até a maior delas
+    com uma _DelayLine por canal. Plugins no sandbox (plugins/sandbox.py)
+    entram aqui com a latência deles + um bloco de round-trip.
+
+Análise de espectro:
+    Com set_analyzer(), a saída do master (e o sinal pré-fader dos canais
+    escolhidos com analyze_channel) é copiada para o ring do
+    SpectrumAnalyzer (audio/spectrum.py) a cada bloco — só a cópia; a FFT
+    roda na worker thread dele.
 """
 from __future__ import annotations
 
-from typing import Dict, List, Optional
+from typing import Any, Dict, List, Optional
 
 import numpy as np
 
-from ..instruments.synth import Synth, SynthPreset
+from ..audio.arena import ENGINE_ARENA
+from ..audio.layout import (
+    STEREO,
+    SpeakerLayout,
+    downmix_matrix,
+    layout_for_channels,
+    panning_gains,
+)
+from ..audio.spectrum import SPECTRUM_SLOTS
+from ..core.logger import LOGGER
+from ..instruments.synth import NOTE_BEND, NOTE_PRESSURE, NOTE_TIMBRE, Synth, SynthPreset
 from ..midi.events import (
     NoteOnEvent,
     NoteOffEvent,
     ControlChangeEvent,
     PitchBendEvent,
+    AftertouchEvent,
+    ChannelPressureEvent,
     CC,
+    coalesce_block,
+    expression_mask,
+    unpack_raw,
 )
+from ..midi.mpe import RPN_MPE_CONFIGURATION, RPN_NULL, RPN_PITCH_BEND_RANGE, MpeRole, MpeZones
+
+
+# ------------------------------------------------------------------
+# Parâmetros de canal (uma linha por canal, colunas contíguas no Mixer)
+# ------------------------------------------------------------------
+
+CHANNEL_PARAMS_DTYPE = np.dtype([
+    ("volume", np.float32),     # 0.0–1.0 (linear)
+    ("pan",    np.float32),     # -1.0 (esq) .. 0.0 (centro) .. 1.0 (dir)
+    ("pan_l",  np.float32),     # coeficientes da lei de pan, pré-calculados
+    ("pan_r",  np.float32),
+    ("azimuth",   np.float32),  # graus, + = esquerda (barramentos surround/ambisônicos)
+    ("elevation", np.float32),  # graus, + = acima
+    ("mute",   np.uint8),
+    ("solo",   np.uint8),
+    ("active", np.uint8),       # resultado de mute/solo — o que o render lê
+    ("_pad",   np.uint8),
+])
+
+
+def _pan_coefs(pan: float) -> tuple:
+    """Lei de pan de potência constante (constant power panning)."""
+    angle = (pan + 1.0) * 0.25 * np.pi   # 0 .. pi/2
+    return float(np.cos(angle)), float(np.sin(angle))
 
 
 # ------------------------------------------------------------------
@@ -43,54 +128,203 @@ class Channel:
     """
     Um canal do mixer: contém um instrumento e parâmetros de ganho.
 
-    Todos os parâmetros de volume/pan operam em float32 para combinar
-    diretamente com os buffers de áudio numpy sem conversão extra.
+    Os parâmetros (volume, pan, mute, solo) vivem na linha 'self._row' do
+    array de parâmetros do Mixer dono (float32, direto nos buffers numpy).
+    Fora de um Mixer o canal tem um array próprio de uma linha.
     """
 
+    # Nó de playback do render congelado (modules/mixer/tracks.py) ou
+    # None. Uma única referência: congelar/descongelar é uma atribuição.
+    frozen: Optional[Any] = None
+
+    # Atraso de compensação (PDC) definido pelo Mixer, ou None
+    _pdc: Optional["_DelayLine"] = None
+
+    # Slot do SpectrumAnalyzer que recebe o sinal pré-fader (-1 = nenhum)
+    _analysis_slot: int = -1
+
     def __init__(
         self,
         name:        str          = "Channel",
         instrument:  Optional[Synth] = None,
         sample_rate: int          = 48000,
     ) -> None:
+        # Linha de parâmetros: própria até o Mixer adotar o canal (_attach)
+        params = np.zeros(1, dtype=CHANNEL_PARAMS_DTYPE)
+        params[0] = (1.0, 0.0, 1.0, 1.0, 0.0, 0.0, 0, 0, 1, 0)
+        self._setup(name, instrument or Synth(sample_rate=sample_rate), sample_rate, params, 0)
+        self._update_pan()
+
+    @classmethod
+    def _from_params(
+        cls,
+        name:        str,
+        instrument:  Synth,
+        sample_rate: int,
+        params:      np.ndarray,
+        row:         int,
+    ) -> "Channel":
+        """
+        Canal sobre a linha 'row' de um array de parâmetros já preenchido
+        (thaw de templates) — mesmo _setup do __init__; os coeficientes de
+        pan vêm prontos no array.
+        """
+        ch = cls.__new__(cls)
+        ch._setup(name, instrument, sample_rate, params, row)
+        return ch
+
+    def _setup(
+        self,
+        name:        str,
+        instrument:  Synth,
+        sample_rate: int,
+        params:      np.ndarray,
+        row:         int,
+    ) -> None:
+        """Todo o estado da instância, sobre a linha 'row' de 'params'."""
         self.name        = name
-        self.instrument  = instrument or Synth(sample_rate=sample_rate)
+        self.instrument  = instrument
         self.sample_rate = sample_rate
 
-        self.volume: float = 1.0     # 0.0–1.0 (linear)
-        self.pan:    float = 0.0     # -1.0 (esq) .. 0.0 (centro) .. 1.0 (dir)
-        self.mute:   bool  = False
-        self.solo:   bool  = False
+        self._mixer: Optional["Mixer"] = None
+        self._row:   int = row
+        self._p = params
 
-        # Pré-calculados a cada mudança de pan (lei de pan constante)
-        self._pan_l: float = 1.0
-        self._pan_r: float = 1.0
-        self._update_pan()
+        self._init_midi()
+
+        # Cadeia de inserts pré-fader. Cada insert expõe
+        # process(buf (frames, 2)) -> buf e to_dict() (estado, entra no
+        # hash de conteúdo do render — ver mixer/render.py).
+        self.inserts: List[Any] = []
 
     # ------------------------------------------------------------------
-    # Parâmetros
+    # Parâmetros (linha do array do Mixer)
     # ------------------------------------------------------------------
 
+    @property
+    def volume(self) -> float:
+        return float(self._p["volume"][self._row])
+
+    @volume.setter
+    def volume(self, value: float) -> None:
+        self._p["volume"][self._row] = value
+
+    @property
+    def pan(self) -> float:
+        return float(self._p["pan"][self._row])
+
+    @pan.setter
+    def pan(self, value: float) -> None:
+        self._p["pan"][self._row] = value
+        self._update_pan()
+
+    @property
+    def azimuth(self) -> float:
+        return float(self._p["azimuth"][self._row])
+
+    @azimuth.setter
+    def azimuth(self, value: float) -> None:
+        self._p["azimuth"][self._row] = value
+        self._update_pan()
+
+    @property
+    def elevation(self) -> float:
+        return float(self._p["elevation"][self._row])
+
+    @elevation.setter
+    def elevation(self, value: float) -> None:
+        self._p["elevation"][self._row] = float(np.clip(value, -90.0, 90.0))
+        self._update_pan()
+
+    @property
+    def mute(self) -> bool:
+        return bool(self._p["mute"][self._row])
+
+    @mute.setter
+    def mute(self, value: bool) -> None:
+        self._p["mute"][self._row] = bool(value)
+        self._resolve()
+
+    @property
+    def solo(self) -> bool:
+        return bool(self._p["solo"][self._row])
+
+    @solo.setter
+    def solo(self, value: bool) -> None:
+        self._p["solo"][self._row] = bool(value)
+        self._resolve()
+
+    @property
+    def active(self) -> bool:
+        """Soa neste momento (mute/solo de todos os canais já considerados)."""
+        return bool(self._p["active"][self._row])
+
+    @property
+    def _pan_l(self) -> float:
+        return float(self._p["pan_l"][self._row])
+
+    @property
+    def _pan_r(self) -> float:
+        return float(self._p["pan_r"][self._row])
+
+    def _resolve(self) -> None:
+        if self._mixer is not None:
+            self._mixer._resolve_mutes()
+        else:
+            self._p["active"][self._row] = not self._p["mute"][self._row]
+
     def set_volume(self, volume: float) -> None:
         self.volume = float(np.clip(volume, 0.0, 1.0))
 
     def set_pan(self, pan: float) -> None:
         """Pan -1.0 (esq) a +1.0 (dir). Usa lei de potência constante."""
         self.pan = float(np.clip(pan, -1.0, 1.0))
-        self._update_pan()
 
     def _update_pan(self) -> None:
-        """Lei de pan de potência constante (constant power panning)."""
-        angle = (self.pan + 1.0) * 0.25 * np.pi   # 0 .. pi/2
-        self._pan_l = float(np.cos(angle))
-        self._pan_r = float(np.sin(angle))
+        """Recalcula os coeficientes L/R da linha (e a matriz de pan do mixer, se multicanal)."""
+        row = self._row
+        self._p["pan_l"][row], self._p["pan_r"][row] = _pan_coefs(float(self._p["pan"][row]))
+        if self._mixer is not None and self._mixer._pan_gains is not None:
+            self._mixer._update_panning()
+
+    def gains(self) -> np.ndarray:
+        """Ganho por canal de saída do barramento (volume × pan), shape (N,)."""
+        row = self._p[self._row]
+        mixer = self._mixer
+        if mixer is not None and mixer._pan_gains is not None:
+            return mixer._pan_gains[self._row] * row["volume"]
+        return np.array([row["volume"] * row["pan_l"], row["volume"] * row["pan_r"]], dtype=np.float32)
 
     # ------------------------------------------------------------------
     # Controle MIDI
     # ------------------------------------------------------------------
 
+    def _init_midi(self) -> None:
+        """Estado MIDI do canal (pitch bend, MPE, RPN)."""
+        # Último pitch bend recebido, normalizado -1.0..+1.0
+        self.pitch_bend: float = 0.0
+        # Zonas MPE (None = canal comum: o nibble de canal MIDI é ignorado)
+        self.mpe: Optional[MpeZones] = None
+        # RPN selecionado em cada canal MIDI (CC 101/100) e o status da
+        # mensagem em despacho — data entry e MCM dependem do canal MIDI
+        self._rpn: List[int] = [RPN_NULL] * 16
+        self._status: int = 0
+
+    def enable_mpe(self, lower: int = 15, upper: int = 0) -> None:
+        """
+        Liga o modo MPE com as zonas dadas (canais membro de cada uma). O
+        instrumento precisa de expressão por nota (set_note_expression).
+        """
+        if getattr(self.instrument, "set_note_expression", None) is None:
+            raise ValueError(f"Instrumento de '{self.name}' não suporta expressão por nota (MPE)")
+        zones = MpeZones(lower, upper)
+        self.mpe = zones if zones.enabled else None
+
+    def disable_mpe(self) -> None:
+        self.mpe = None
+
     def note_on(self, note: int, velocity: int = 100) -> None:
-        if not self.mute:
+        if self._p["active"][self._row]:
             self.instrument.note_on(note, velocity)
 
     def note_off(self, note: int) -> None:
@@ -101,46 +335,342 @@ class Channel:
 
     def handle_cc(self, controller: int, value: int) -> None:
         """Trata mensagens CC que afetam o canal (volume, pan, etc.)."""
-        if controller == CC.VOLUME:
-            self.set_volume(value / 127.0)
-        elif controller == CC.PAN:
-            self.set_pan((value / 63.5) - 1.0)   # 0–127 → -1.0–+1.0
-        elif controller == CC.ALL_NOTES_OFF or controller == CC.ALL_SOUND_OFF:
-            self.all_notes_off()
+        handler = _CC_TABLE.get(controller)
+        if handler is not None:
+            handler(self, value)
 
     def handle_pitch_bend(self, event: PitchBendEvent) -> None:
-        # Pitch bend é tratado internamente pelo instrumento no futuro;
-        # por ora guardamos o valor normalizado para quando o Synth suportar.
+        self.set_pitch_bend(event.value)
+
+    def set_pitch_bend(self, value: int) -> None:
+        # Guarda o valor normalizado e repassa ao instrumento, se ele tiver
+        # o controlador (fonte "pitch_bend" da matriz de modulação do Synth)
+        self.pitch_bend = value / 8191.0 if value else 0.0
+        handler = getattr(self.instrument, "set_pitch_bend", None)
+        if handler is not None:
+            handler(self.pitch_bend)
+
+    def set_poly_pressure(self, note: int, pressure: int) -> None:
+        handler = getattr(self.instrument, "set_poly_pressure", None)
+        if handler is not None:
+            handler(note, pressure / 127.0)
+
+    def set_channel_pressure(self, pressure: int) -> None:
+        handler = getattr(self.instrument, "set_channel_pressure", None)
+        if handler is not None:
+            handler(pressure / 127.0)
+
+    def handle_raw(self, status: int, data1: int, data2: int = 0) -> None:
+        """
+        Caminho compacto: despacha bytes MIDI crus sem criar dataclasses.
+        Indexa a tabela pelo nibble de status (0x8–0xE → 0–6).
+
+        Em modo MPE, mensagens de canais membro vão para _MPE_TABLE
+        (expressão da nota); as do master e de fora das zonas seguem o
+        caminho comum e valem para o canal inteiro.
+        """
+        self._status = status
+        mpe = self.mpe
+        if mpe is not None and mpe.role[status & 0x0F] == MpeRole.MEMBER:
+            _MPE_TABLE[(status >> 4) & 0x07](self, status & 0x0F, data1, data2)
+            return
+        _RAW_TABLE[(status >> 4) & 0x07](self, data1, data2)
+
+    # --- Handlers de CC (tabela _CC_TABLE) ---------------------------
+
+    def _cc_volume(self, value: int) -> None:
+        self.set_volume(value / 127.0)
+
+    def _cc_pan(self, value: int) -> None:
+        self.set_pan((value / 63.5) - 1.0)   # 0–127 → -1.0–+1.0
+
+    def _cc_all_notes_off(self, value: int) -> None:
+        self.all_notes_off()
+
+    def _cc_modulation(self, value: int) -> None:
+        handler = getattr(self.instrument, "set_mod_wheel", None)
+        if handler is not None:
+            handler(value / 127.0)
+
+    def _cc_timbre(self, value: int) -> None:
+        handler = getattr(self.instrument, "set_timbre", None)
+        if handler is not None:
+            handler(value / 127.0)
+
+    def _cc_rpn_msb(self, value: int) -> None:
+        ch = self._status & 0x0F
+        self._rpn[ch] = (value << 7) | (self._rpn[ch] & 0x7F)
+
+    def _cc_rpn_lsb(self, value: int) -> None:
+        ch = self._status & 0x0F
+        self._rpn[ch] = (self._rpn[ch] & 0x3F80) | value
+
+    def _cc_data_entry(self, value: int) -> None:
+        ch = self._status & 0x0F
+        rpn = self._rpn[ch]
+        if rpn == RPN_MPE_CONFIGURATION and ch in (0, 15):
+            self._configure_mpe(ch, value)
+        elif rpn == RPN_PITCH_BEND_RANGE:
+            handler = getattr(self.instrument, "set_bend_range", None)
+            if handler is not None:
+                member = self.mpe is not None and self.mpe.role[ch] == MpeRole.MEMBER
+                handler(value, member)
+
+    def _configure_mpe(self, master: int, members: int) -> None:
+        """MCM (RPN 6): zona do canal master com 'members' canais; 0 desliga a zona."""
+        if self.mpe is None:
+            if members == 0:
+                return
+            if getattr(self.instrument, "set_note_expression", None) is None:
+                LOGGER.warning("Mixer", f"MCM ignorada em '{self.name}': instrumento sem MPE")
+                return
+            self.mpe = MpeZones(lower=0)
+        self.mpe.configure(master, members)
+        if not self.mpe.enabled:
+            self.mpe = None
+        # A MCM volta a faixa de bend dos membros ao padrão (48 semitons)
+        handler = getattr(self.instrument, "set_bend_range", None)
+        if handler is not None and members:
+            handler(48, True)
+        LOGGER.info("Mixer", f"'{self.name}': {self.mpe or 'MPE desligado'}")
+
+    # --- Handlers crus (tabela _RAW_TABLE) ---------------------------
+
+    def _raw_note_off(self, data1: int, data2: int) -> None:
+        self.note_off(data1)
+
+    def _raw_note_on(self, data1: int, data2: int) -> None:
+        if data2 == 0:
+            self.note_off(data1)        # NoteOn vel 0 == NoteOff
+        else:
+            self.note_on(data1, data2)
+
+    def _raw_cc(self, data1: int, data2: int) -> None:
+        self.handle_cc(data1, data2)
+
+    def _raw_pitch_bend(self, data1: int, data2: int) -> None:
+        self.set_pitch_bend(((data2 << 7) | data1) - 8192)
+
+    def _raw_poly_pressure(self, data1: int, data2: int) -> None:
+        self.set_poly_pressure(data1, data2)
+
+    def _raw_channel_pressure(self, data1: int, data2: int) -> None:
+        self.set_channel_pressure(data1)
+
+    def _raw_ignore(self, data1: int, data2: int) -> None:
+        # Program change e mensagens de sistema ainda não afetam o canal
         pass
 
+    # --- Handlers de canais membro MPE (tabela _MPE_TABLE) -----------
+
+    def _mpe_note_off(self, member: int, data1: int, data2: int) -> None:
+        self.instrument.note_off(data1, member)
+
+    def _mpe_note_on(self, member: int, data1: int, data2: int) -> None:
+        if data2 == 0:
+            self.instrument.note_off(data1, member)
+        elif self._p["active"][self._row]:
+            self.instrument.note_on(data1, data2, member)
+
+    def _mpe_cc(self, member: int, data1: int, data2: int) -> None:
+        if data1 == CC.TIMBRE:
+            self.instrument.set_note_expression(member, NOTE_TIMBRE, data2 / 127.0)
+        elif data1 in (CC.RPN_MSB, CC.RPN_LSB, CC.DATA_ENTRY):
+            self.handle_cc(data1, data2)
+        # Demais CCs num canal membro não têm efeito por nota
+
+    def _mpe_pressure(self, member: int, data1: int, data2: int) -> None:
+        self.instrument.set_note_expression(member, NOTE_PRESSURE, data1 / 127.0)
+
+    def _mpe_pitch_bend(self, member: int, data1: int, data2: int) -> None:
+        self.instrument.set_note_expression(member, NOTE_BEND, (((data2 << 7) | data1) - 8192) / 8191.0)
+
+    def _mpe_ignore(self, member: int, data1: int, data2: int) -> None:
+        pass
+
+    # ------------------------------------------------------------------
+    # Inserts e latência
+    # ------------------------------------------------------------------
+
+    def add_insert(self, fx: Any, index: Optional[int] = None) -> None:
+        """Adiciona um insert. Lista nova: o callback nunca vê uma pela metade."""
+        inserts = list(self.inserts)
+        inserts.insert(len(inserts) if index is None else index, fx)
+        self.inserts = inserts
+        self._latency_changed()
+
+    def remove_insert(self, fx: Any) -> bool:
+        if not any(f is fx for f in self.inserts):
+            return False
+        self.inserts = [f for f in self.inserts if f is not fx]
+        close = getattr(fx, "close", None)
+        if close is not None:
+            close()
+        self._latency_changed()
+        return True
+
+    @property
+    def latency(self) -> int:
+        """Atraso (samples) que os inserts introduzem — a soma das latências deles."""
+        return sum(int(getattr(fx, "latency", 0)) for fx in self.inserts)
+
+    def _latency_changed(self) -> None:
+        if self._mixer is not None:
+            self._mixer.update_latency()
+
     # ------------------------------------------------------------------
     # Processamento de áudio
     # ------------------------------------------------------------------
 
+    def render_dry(self, frames: int) -> np.ndarray:
+        """Sinal pré-fader: instrumento + inserts (ou o áudio congelado). (frames, 2)."""
+        if self.frozen is not None:
+            # Faixa congelada: instrumento + inserts já estão no áudio
+            return self.frozen.process(frames)
+        stereo = self.instrument.process(frames)   # (frames, 2)
+        for fx in self.inserts:
+            stereo = fx.process(stereo)
+        return stereo
+
+    def set_sample_rate(self, sample_rate: int) -> None:
+        """
+        Propaga o novo sample rate para instrumento e inserts que o
+        suportem. Um render congelado em outro rate não serve mais: o
+        canal volta ao vivo (congelar de novo renderiza no rate novo).
+        """
+        self.sample_rate = sample_rate
+        if hasattr(self.instrument, "set_sample_rate"):
+            self.instrument.set_sample_rate(sample_rate)
+        for fx in self.inserts:
+            if hasattr(fx, "set_sample_rate"):
+                fx.set_sample_rate(sample_rate)
+        if self.frozen is not None and getattr(self.frozen, "sample_rate", sample_rate) != sample_rate:
+            self.frozen = None
+
+    def skip(self, frames: int) -> None:
+        """Bloco não renderizado (canal inativo): mantém o áudio congelado em sincronia."""
+        if self.frozen is not None:
+            self.frozen.skip(frames)
+        if self._pdc is not None:
+            self._pdc.stale = True
+
     def process(self, frames: int) -> np.ndarray:
         """
-        Gera 'frames' amostras estéreo para este canal.
-        Retorna zeros se mute ativo ou instrumento silencioso.
-        Shape: (frames, 2) float32.
+        Gera 'frames' amostras para este canal no layout do barramento
+        (estéreo fora de um Mixer). Retorna zeros se o canal não está
+        ativo (mute/solo). Shape: (frames, N) float32.
+
+        O Mixer não passa por aqui — ver Mixer._render (vetorizado).
         """
-        if self.mute:
-            return np.zeros((frames, 2), dtype=np.float32)
+        g = self.gains()
+        if not self._p["active"][self._row]:
+            self.skip(frames)
+            return ENGINE_ARENA.zeros((frames, len(g)))
+
+        dry = self.render_dry(frames)
+        out = ENGINE_ARENA.scratch((frames, len(g)))
+        if len(g) == 2:
+            return np.multiply(dry, g, out=out)                     # fonte estéreo × L/R
+        mono = np.mean(dry, axis=1, keepdims=True, out=ENGINE_ARENA.scratch((frames, 1)))
+        return np.multiply(mono, g, out=out)                        # mono → N canais
 
-        # Delega ao instrumento
-        stereo = self.instrument.process(frames)   # (frames, 2)
+    def __repr__(self) -> str:
+        status = "MUTE" if self.mute else ("SOLO" if self.solo else ("active" if self.active else "muted by solo"))
+        return f"Channel('{self.name}', vol={self.volume:.2f}, pan={self.pan:.2f}, {status})"
 
-        # Aplica volume
-        stereo *= self.volume
 
-        # Aplica pan (multiplica L e R por coeficientes diferentes)
-        stereo[:, 0] *= self._pan_l
-        stereo[:, 1] *= self._pan_r
+# Tabelas de despacho do Channel — montadas uma vez no import.
+_CC_TABLE = {
+    int(CC.MODULATION):    Channel._cc_modulation,
+    int(CC.VOLUME):        Channel._cc_volume,
+    int(CC.PAN):           Channel._cc_pan,
+    int(CC.ALL_NOTES_OFF): Channel._cc_all_notes_off,
+    int(CC.ALL_SOUND_OFF): Channel._cc_all_notes_off,
+    int(CC.TIMBRE):        Channel._cc_timbre,
+    int(CC.RPN_MSB):       Channel._cc_rpn_msb,
+    int(CC.RPN_LSB):       Channel._cc_rpn_lsb,
+    int(CC.DATA_ENTRY):    Channel._cc_data_entry,
+}
+
+# Índice = (status >> 4) & 0x07 — 0x8 NoteOff, 0x9 NoteOn, 0xA Aftertouch,
+# 0xB CC, 0xC Program, 0xD Channel Pressure, 0xE Pitch Bend, 0xF System
+_RAW_TABLE = (
+    Channel._raw_note_off,
+    Channel._raw_note_on,
+    Channel._raw_poly_pressure,
+    Channel._raw_cc,
+    Channel._raw_ignore,
+    Channel._raw_channel_pressure,
+    Channel._raw_pitch_bend,
+    Channel._raw_ignore,
+)
 
-        return stereo
+# Mesmo índice, para mensagens de canais membro MPE (recebem o canal)
+_MPE_TABLE = (
+    Channel._mpe_note_off,
+    Channel._mpe_note_on,
+    Channel._mpe_ignore,          # poly aftertouch: em MPE a pressão vem por canal
+    Channel._mpe_cc,
+    Channel._mpe_ignore,
+    Channel._mpe_pressure,
+    Channel._mpe_pitch_bend,
+    Channel._mpe_ignore,
+)
+
+
+def _on_note_on(ch: Channel, event: NoteOnEvent) -> None:
+    if event.velocity == 0:
+        ch.note_off(event.note)
+    else:
+        ch.note_on(event.note, event.velocity)
 
-    def __repr__(self) -> str:
-        status = "MUTE" if self.mute else ("SOLO" if self.solo else "active")
-        return f"Channel('{self.name}', vol={self.volume:.2f}, pan={self.pan:.2f}, {status})"
+
+# Tipo exato do evento -> handler. Tipos fora da tabela caem no caminho cru.
+_EVENT_TABLE = {
+    NoteOnEvent:        _on_note_on,
+    NoteOffEvent:       lambda ch, ev: ch.note_off(ev.note),
+    ControlChangeEvent: lambda ch, ev: ch.handle_raw(0xB0 | ev.channel, ev.controller, ev.value),
+    PitchBendEvent:     lambda ch, ev: ch.set_pitch_bend(ev.value),
+    AftertouchEvent:    lambda ch, ev: ch.set_poly_pressure(ev.note, ev.pressure),
+    ChannelPressureEvent: lambda ch, ev: ch.set_channel_pressure(ev.pressure),
+}
+
+
+# ------------------------------------------------------------------
+# Compensação de latência
+# ------------------------------------------------------------------
+
+class _DelayLine:
+    """
+    Atraso fixo de 'delay' frames para a compensação de latência (PDC).
+
+    Ring de 'delay' frames em que cada amostra nova troca de lugar com a
+    que entrou 'delay' frames antes: process() atrasa o bloco no lugar.
+    """
+
+    def __init__(self, delay: int, channels: int = 2) -> None:
+        self.delay = delay
+        self._buf = np.zeros((delay, channels), dtype=np.float32)
+        self._pos = 0
+        self.stale = False          # canal ficou inativo: descarta o conteúdo
+
+    def process(self, block: np.ndarray) -> np.ndarray:
+        if self.stale:
+            self._buf.fill(0.0)
+            self.stale = False
+        buf, size = self._buf, self.delay
+        i, n = 0, len(block)
+        while i < n:
+            m = min(n - i, size - self._pos)
+            seg = block[i:i + m]
+            old = buf[self._pos:self._pos + m]
+            tmp = ENGINE_ARENA.scratch(seg.shape)
+            np.copyto(tmp, old)
+            np.copyto(old, seg)
+            np.copyto(seg, tmp)
+            self._pos = (self._pos + m) % size
+            i += m
+        return block
 
 
 # ------------------------------------------------------------------
@@ -159,7 +689,7 @@ class MasterBus:
     def process(self, mixed: np.ndarray) -> np.ndarray:
         """
         Aplica volume master e limiter ao buffer já somado.
-        mixed: (frames, 2) float32 — modificado in-place e retornado.
+        mixed: (frames, N) float32 — modificado in-place e retornado.
         """
         mixed *= self.volume
 
@@ -179,7 +709,7 @@ class Mixer:
     Mixer polifônico com N canais + master bus.
 
     Interface com o AudioCallback:
-        mixer.process(frames) -> np.ndarray (frames, 2) float32
+        mixer.process(frames) -> np.ndarray (frames, output_channels) float32
 
     Interface com o Scheduler/Engine:
         mixer.note_on(channel_idx, note, velocity)
@@ -188,17 +718,241 @@ class Mixer:
 
     Canal 0 sempre existe (canal default). Canais adicionais são
     criados com add_channel().
+
+    self._params (CHANNEL_PARAMS_DTYPE) guarda os parâmetros de todos os
+    canais; linha i = canal i. Lista de canais e array são trocados por
+    cópias (nunca mutados no lugar) ao adicionar/remover, e o array é
+    publicado antes da lista — o callback, que lê a lista e depois o
+    array, sempre vê linhas suficientes.
     """
 
-    def __init__(self, sample_rate: int = 48000, channels: int = 2) -> None:
+    INITIAL_CAPACITY = 16
+
+    def __init__(
+        self,
+        sample_rate: int = 48000,
+        channels:    int = 2,
+        layout:      Optional[SpeakerLayout] = None,
+    ) -> None:
+        self._setup(
+            sample_rate,
+            np.zeros(self.INITIAL_CAPACITY, dtype=CHANNEL_PARAMS_DTYPE),
+            [],
+            layout or layout_for_channels(channels),
+        )
+
+        # Canal default (channel 0)
+        self._attach(Channel("Master Synth", sample_rate=sample_rate))
+
+    @classmethod
+    def _from_params(
+        cls,
+        sample_rate: int,
+        params:      np.ndarray,
+        channels:    List[Channel],
+        layout:      SpeakerLayout,
+    ) -> "Mixer":
+        """
+        Mixer sobre um array de parâmetros já preenchido, uma linha por
+        canal na ordem de 'channels' (thaw de templates) — mesmo _setup do
+        __init__, sem o canal default.
+        """
+        mixer = cls.__new__(cls)
+        mixer._setup(sample_rate, params, channels, layout)
+        return mixer
+
+    def _setup(
+        self,
+        sample_rate: int,
+        params:      np.ndarray,
+        channels:    List[Channel],
+        layout:      SpeakerLayout,
+    ) -> None:
+        """Todo o estado da instância; adota 'channels' nas linhas de 'params'."""
         self.sample_rate    = sample_rate
-        self.num_channels   = channels    # canais estéreo de saída (2)
         self.master         = MasterBus()
 
-        # Canal default (channel 0)
-        self._channels: List[Channel] = [
-            Channel("Master Synth", sample_rate=sample_rate)
-        ]
+        self._params = params
+        self._channels: List[Channel] = list(channels)
+
+        # Compensação de latência (update_latency): maior latência entre os
+        # canais e os sandboxes de plugin a acordar no fim de cada bloco
+        self.latency: int = 0
+        self._plugin_hosts: tuple = ()
+
+        # SpectrumAnalyzer alimentado no fim de cada bloco (set_analyzer)
+        self.analyzer: Optional[Any] = None
+
+        # Canal que recebe a entrada MIDI ao vivo (teclado "armado")
+        self.midi_input_channel: int = 0
+
+        # Layout do barramento master e da saída (ver set_layout)
+        self.layout:        SpeakerLayout = STEREO
+        self.output_layout: SpeakerLayout = STEREO
+        self.num_channels:  int = 2
+        self._pan_gains: Optional[np.ndarray] = None    # (canais, N) — None em estéreo
+        self._downmix:   Optional[np.ndarray] = None    # (N, saída) — None se iguais
+        self._select:    Optional[tuple] = None         # buffers do _render (_alloc_select)
+        self.set_layout(layout)
+
+        self._rebind()
+
+    # ------------------------------------------------------------------
+    # Array de parâmetros
+    # ------------------------------------------------------------------
+
+    def _attach(self, ch: Channel) -> None:
+        """Adota o canal: copia a linha dele para o array do mixer."""
+        n = len(self._channels)
+        params = self._params
+        if n >= len(params):
+            params = np.zeros(max(self.INITIAL_CAPACITY, 2 * len(params)), dtype=CHANNEL_PARAMS_DTYPE)
+            params[:n] = self._params[:n]
+        params[n] = ch._p[ch._row]
+        self._params = params
+        self._alloc_select()                            # buffers antes da lista
+        if self._pan_gains is not None:
+            self._update_panning(n + 1)                 # matriz antes da lista
+        self._channels = self._channels + [ch]
+        self._rebind()
+
+    def _rebind(self) -> None:
+        """Aponta cada canal para a sua linha do array atual."""
+        params = self._params
+        for i, ch in enumerate(self._channels):
+            ch._p, ch._row, ch._mixer = params, i, self
+        self._resolve_mutes()
+        if self._pan_gains is not None:
+            self._update_panning()
+        self.update_latency()
+
+    def _alloc_select(self) -> None:
+        """
+        Buffers em que o _render separa os canais ativos — índices, linhas
+        de parâmetros e linhas da matriz de pan — na capacidade do array de
+        parâmetros. Publicados como tupla nova, só quando a capacidade ou o
+        layout mudam.
+        """
+        cap = len(self._params)
+        sel = self._select
+        if sel is not None and len(sel[0]) >= cap and sel[3].shape[1] == self.num_channels:
+            return
+        self._select = (
+            np.arange(cap, dtype=np.intp),                          # todos os índices
+            np.zeros(cap, dtype=np.intp),                           # índices ativos
+            np.zeros(cap, dtype=CHANNEL_PARAMS_DTYPE),              # linhas ativas
+            np.zeros((cap, self.num_channels), dtype=np.float32),   # pan ativo
+        )
+
+    def _resolve_mutes(self) -> None:
+        """active = não mutado e (em solo ou nenhum canal em solo)."""
+        p = self._params[:len(self._channels)]
+        solo = p["solo"] != 0
+        p["active"] = (p["mute"] == 0) & (solo | ~solo.any())
+
+    @property
+    def params(self) -> np.ndarray:
+        """View (canais,) CHANNEL_PARAMS_DTYPE dos parâmetros de todos os canais."""
+        return self._params[:len(self._channels)]
+
+    # ------------------------------------------------------------------
+    # Layout do barramento
+    # ------------------------------------------------------------------
+
+    def set_layout(self, layout: SpeakerLayout, output: Optional[SpeakerLayout] = None) -> None:
+        """
+        Define o layout do master (e da saída — padrão: o mesmo). Com
+        saída diferente, o downmix entra depois do master bus.
+        """
+        self.layout = layout
+        self.num_channels = layout.channels
+        multichannel = layout.channels != 2 or layout.is_ambisonic
+        self._pan_gains = np.zeros((0, layout.channels), dtype=np.float32) if multichannel else None
+        self._alloc_select()
+        if multichannel:
+            self._update_panning()
+        self.set_output_layout(output or layout)
+
+    def set_output_layout(self, layout: SpeakerLayout) -> None:
+        self.output_layout = layout
+        self._downmix = None if layout == self.layout else downmix_matrix(self.layout, layout)
+
+    @property
+    def output_channels(self) -> int:
+        return self.output_layout.channels
+
+    def _update_panning(self, n: Optional[int] = None) -> None:
+        """Matriz de pan (canais, N) de todos os canais — publicada como array novo."""
+        n = len(self._channels) if n is None else n
+        p = self._params[:n]
+        gains = panning_gains(self.layout, p["pan"], p["azimuth"], p["elevation"])
+        self._pan_gains = gains.astype(np.float32, copy=False)     # dtype dos buffers do _render
+
+    # ------------------------------------------------------------------
+    # Compensação de latência (PDC)
+    # ------------------------------------------------------------------
+
+    def update_latency(self) -> None:
+        """
+        Atrasa cada canal até a maior latência entre os canais: o que passa
+        por um plugin com lookahead (ou pelo sandbox, +1 bloco) chega ao
+        master alinhado com o resto. Chamado quando os inserts mudam e
+        quando um sandbox informa latência nova.
+        """
+        channels = self._channels
+        latencies = [ch.latency for ch in channels]
+        top = max(latencies, default=0)
+        for ch, lat in zip(channels, latencies):
+            delay = top - lat
+            if delay == 0:
+                ch._pdc = None
+            elif ch._pdc is None or ch._pdc.delay != delay:
+                ch._pdc = _DelayLine(delay)
+        self.latency = top
+
+        hosts = {fx.sandbox for ch in channels for fx in ch.inserts if hasattr(fx, "sandbox")}
+        for host in hosts:
+            host.add_listener(self.update_latency)
+        self._plugin_hosts = tuple(hosts)
+
+    # ------------------------------------------------------------------
+    # Sample rate
+    # ------------------------------------------------------------------
+
+    def set_sample_rate(self, sample_rate: int) -> None:
+        """Novo sample rate para o mixer e todos os canais (stream parado)."""
+        if sample_rate == self.sample_rate:
+            return
+        self.sample_rate = sample_rate
+        for ch in self._channels:
+            ch.set_sample_rate(sample_rate)
+        if self.analyzer is not None:
+            self.analyzer.set_sample_rate(sample_rate)
+
+    # ------------------------------------------------------------------
+    # Análise de espectro
+    # ------------------------------------------------------------------
+
+    def set_analyzer(self, analyzer: Optional[Any]) -> None:
+        """SpectrumAnalyzer que recebe o master no slot 0 (None desliga)."""
+        self.analyzer = analyzer
+
+    def analyze_channel(self, slot: int, index: Optional[int]) -> bool:
+        """
+        Manda o sinal pré-fader do canal 'index' para o slot 'slot'
+        (1 … SPECTRUM_SLOTS − 1) do analisador. index None ou -1 libera o
+        slot. Um slot tem no máximo um canal.
+        """
+        if not 1 <= slot < SPECTRUM_SLOTS:
+            raise ValueError(f"Slot de espectro inválido: {slot} (use 1–{SPECTRUM_SLOTS - 1})")
+        for ch in self._channels:
+            if ch._analysis_slot == slot:
+                ch._analysis_slot = -1
+        ch = self.get_channel(index) if index is not None else None
+        if ch is None:
+            return False
+        ch._analysis_slot = slot
+        return True
 
     # ------------------------------------------------------------------
     # Gerenciamento de canais
@@ -212,15 +966,26 @@ class Mixer:
         """Adiciona um novo canal e retorna ele."""
         synth = Synth(sample_rate=self.sample_rate, preset=preset)
         ch = Channel(name=name, instrument=synth, sample_rate=self.sample_rate)
-        self._channels.append(ch)
+        self._attach(ch)
         return ch
 
     def remove_channel(self, index: int) -> bool:
         """Remove um canal pelo índice. Canal 0 não pode ser removido."""
         if index <= 0 or index >= len(self._channels):
             return False
-        self._channels[index].all_notes_off()
-        self._channels.pop(index)
+        ch = self._channels[index]
+        ch.all_notes_off()
+        params = np.delete(self._params, index)
+        # O canal removido leva uma cópia da própria linha (continua utilizável)
+        own = np.zeros(1, dtype=CHANNEL_PARAMS_DTYPE)
+        own[0] = self._params[index]
+        self._params = params
+        self._channels = self._channels[:index] + self._channels[index + 1:]
+        ch._p, ch._row, ch._mixer = own, 0, None
+        ch._pdc = None
+        ch._analysis_slot = -1
+        ch._resolve()
+        self._rebind()
         return True
 
     def get_channel(self, index: int) -> Optional[Channel]:
@@ -255,20 +1020,42 @@ class Mixer:
         if ch is None:
             return
 
-        if isinstance(event, NoteOnEvent):
-            if event.is_note_off:
-                ch.note_off(event.note)
-            else:
-                ch.note_on(event.note, event.velocity)
+        # Em MPE o canal MIDI do evento decide a voz: caminho cru
+        handler = _EVENT_TABLE.get(type(event)) if ch.mpe is None else None
+        if handler is not None:
+            handler(ch, event)
+            return
 
-        elif isinstance(event, NoteOffEvent):
-            ch.note_off(event.note)
+        to_raw = getattr(event, "to_raw", None)
+        if to_raw is not None:
+            raw = to_raw()
+            ch.handle_raw(raw[0], raw[1], raw[2] if len(raw) > 2 else 0)
 
-        elif isinstance(event, ControlChangeEvent):
-            ch.handle_cc(event.controller, event.value)
+    def handle_packed(self, packed: int, channel_idx: int = 0) -> None:
+        """Despacha um evento empacotado (ver midi.events.pack_raw)."""
+        ch = self.get_channel(channel_idx)
+        if ch is not None:
+            ch.handle_raw(*unpack_raw(packed))
+
+    def handle_midi_block(self, block: np.ndarray, channel_idx: int = 0) -> None:
+        """
+        Despacha um bloco inteiro de eventos compactos (MIDI_EVENT_DTYPE).
 
-        elif isinstance(event, PitchBendEvent):
-            ch.handle_pitch_bend(event)
+        CCs contínuos, pitch bend e aftertouch redundantes são coalescidos
+        antes (só o último valor de cada fluxo no bloco chega ao canal).
+        """
+        ch = self.get_channel(channel_idx)
+        if ch is None or len(block) == 0:
+            return
+
+        block = coalesce_block(block)
+        dispatch = ch.handle_raw
+        for status, d1, d2 in zip(
+            block["status"].tolist(),
+            block["data1"].tolist(),
+            block["data2"].tolist(),
+        ):
+            dispatch(status, d1, d2)
 
     def all_notes_off(self) -> None:
         """Para todas as notas em todos os canais (usado no transport.stop())."""
@@ -297,18 +1084,12 @@ class Mixer:
     def set_solo(self, channel_idx: int, solo: bool) -> None:
         """
         Liga/desliga solo num canal.
-        Quando qualquer canal está em solo, todos os outros são mutados.
+        Quando qualquer canal está em solo, só os canais em solo soam — via
+        máscara 'active'; o mute de cada canal fica como o usuário deixou.
         """
         ch = self.get_channel(channel_idx)
         if ch:
-            ch.solo = solo
-
-        any_solo = any(c.solo for c in self._channels)
-        for i, c in enumerate(self._channels):
-            if any_solo:
-                c.mute = not c.solo
-            else:
-                c.mute = False
+            ch.solo = solo      # o setter recalcula a máscara
 
     def set_master_volume(self, volume: float) -> None:
         self.master.volume = float(np.clip(volume, 0.0, 1.0))
@@ -317,19 +1098,124 @@ class Mixer:
     # Processamento de áudio — chamado pelo AudioCallback
     # ------------------------------------------------------------------
 
-    def process(self, frames: int) -> np.ndarray:
+    def process(self, frames: int, events: Optional[np.ndarray] = None) -> np.ndarray:
         """
         Gera 'frames' amostras estéreo somando todos os canais ativos.
 
-        Retorna np.ndarray shape (frames, 2) dtype float32.
+        events: bloco opcional de eventos MIDI ao vivo (MIDI_EVENT_DTYPE)
+        com 'frame' relativo ao início do bloco. O bloco é renderizado em
+        segmentos entre eventos, então cada nota começa no sample exato.
+        Cada evento vai para o canal do seu campo 'target' (índice + 1);
+        target 0 = self.midi_input_channel (entrada ao vivo).
+
+        Retorna np.ndarray shape (frames, output_channels) dtype float32.
         NUNCA retorna None — o AudioCallback depende disso.
+
+        No fim do bloco os sandboxes de plugin são acordados para processar
+        o que os inserts escreveram (ver plugins/sandbox.py).
         """
-        mixed = np.zeros((frames, 2), dtype=np.float32)
+        out = self._process(frames, events)
+        if self.analyzer is not None:
+            self.analyzer.capture(out)
+        for host in self._plugin_hosts:
+            host.submit()
+        return out
+
+    def _process(self, frames: int, events: Optional[np.ndarray]) -> np.ndarray:
+        if events is None or len(events) == 0:
+            return self._render(frames)
+
+        events = coalesce_block(events)
+        live = self.get_channel(self.midi_input_channel)
+
+        out = ENGINE_ARENA.scratch((frames, self.output_channels))
+        pos = 0
+        # Expressão contínua (bend, pressure, CC 1/74) não parte o render:
+        # é aplicada no início do segmento atual — o instrumento suaviza
+        for frame, status, d1, d2, target, smooth in zip(
+            events["frame"].tolist(),
+            events["status"].tolist(),
+            events["data1"].tolist(),
+            events["data2"].tolist(),
+            events["target"].tolist(),
+            expression_mask(events).tolist(),
+        ):
+            ch = live if target == 0 else self.get_channel(target - 1)
+            if ch is None:
+                continue
+            frame = min(frame, frames - 1)
+            if frame > pos and not smooth:
+                out[pos:frame] = self._render(frame - pos)
+                pos = frame
+            ch.handle_raw(status, d1, d2)
+
+        if pos < frames:
+            out[pos:] = self._render(frames - pos)
+        return out
+
+    def _render(self, frames: int) -> np.ndarray:
+        """
+        Soma os canais e aplica o master bus para um segmento de 'frames'.
 
-        for ch in self._channels:
-            mixed += ch.process(frames)
+        Só os canais ativos geram áudio; ganho × pan de todos eles é uma
+        matriz (k, N) e a soma ponderada dos k buffers é um único einsum.
+        Estéreo: fonte estéreo × (L, R). Multicanal: fonte somada em mono ×
+        linha da matriz de pan. O downmix para a saída é um matmul no fim.
 
-        return self.master.process(mixed)
+        Buffers intermediários e o retorno vêm da ENGINE_ARENA (válidos até
+        o próximo bloco). Índices, linhas de parâmetros e de pan dos canais
+        ativos são separados com np.compress(..., out=) nos buffers de
+        _alloc_select, em vez de indexação booleana/fancy (array novo).
+        """
+        channels = self._channels               # lista antes do array (ver docstring da classe)
+        pan_gains = self._pan_gains
+        all_idx, idx_buf, row_buf, pan_buf = self._select
+        n = min(len(channels), len(all_idx))
+        if pan_gains is not None:
+            n = min(n, len(pan_gains))
+        p = self._params[:n]
+        mask = p["active"].view(np.bool_)
+        count = int(np.count_nonzero(mask))
+        active = np.compress(mask, all_idx[:n], out=idx_buf[:count])
+
+        if count < n:
+            for i, on in enumerate(mask.tolist()):
+                if not on:
+                    channels[i].skip(frames)
+
+        if count == 0:
+            mixed = ENGINE_ARENA.zeros((frames, self.num_channels))
+        else:
+            rows = np.compress(mask, p, out=row_buf[:count])
+            dry = ENGINE_ARENA.scratch((len(active), frames, 2))
+            for k, i in enumerate(active.tolist()):
+                dry[k] = channels[i].render_dry(frames)
+                pdc = channels[i]._pdc
+                if pdc is not None:
+                    pdc.process(dry[k])
+                if channels[i]._analysis_slot > 0 and self.analyzer is not None:
+                    self.analyzer.capture(dry[k], channels[i]._analysis_slot)
+
+            if pan_gains is None:
+                gains = ENGINE_ARENA.scratch((len(active), 2))
+                np.multiply(rows["volume"], rows["pan_l"], out=gains[:, 0])
+                np.multiply(rows["volume"], rows["pan_r"], out=gains[:, 1])
+                mixed = np.einsum("kfc,kc->fc", dry, gains,
+                                  out=ENGINE_ARENA.scratch((frames, 2)))
+            else:
+                gains = ENGINE_ARENA.scratch((len(active), self.num_channels))
+                pan = np.compress(mask, pan_gains[:n], axis=0, out=pan_buf[:count])
+                np.multiply(pan, rows["volume"][:, None], out=gains)
+                mono = np.mean(dry, axis=2, out=ENGINE_ARENA.scratch((len(active), frames)))
+                mixed = np.einsum("kf,kn->fn", mono, gains,
+                                  out=ENGINE_ARENA.scratch((frames, self.num_channels)))
+
+        mixed = self.master.process(mixed)
+        downmix = self._downmix
+        if downmix is not None:
+            mixed = np.matmul(mixed, downmix,
+                              out=ENGINE_ARENA.scratch((frames, downmix.shape[1])))
+        return mixed
 
     # ------------------------------------------------------------------
     # Estado
@@ -337,6 +1223,6 @@ class Mixer:
 
     def __repr__(self) -> str:
         return (
-            f"Mixer(channels={len(self._channels)}, "
+            f"Mixer(channels={len(self._channels)}, layout={self.layout.name}, "
             f"sr={self.sample_rate}, master_vol={self.master.volume:.2f})"
         )
\ No newline at end of file
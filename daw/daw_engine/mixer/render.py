@@ -0,0 +1,447 @@
+# mixer/render.py
+"""
+Render offline incremental por faixa.
+
+Por que:
+- Todo playback/bounce re-renderizava todas as faixas do zero, mesmo
+  quando só uma mudou desde o último render.
+
+Hash de conteúdo:
+    clip_digest()   — tipo, posição relativa ao 1º clip da faixa, duração e
+                      payload (eventos MIDI serializados; áudio pelo hash do
+                      conteúdo no MEDIA_POOL, não pelo caminho).
+    track_digest()  — clips + preset do instrumento + estado dos inserts +
+                      sample rate. Volume/pan/mute/solo NÃO entram: são
+                      aplicados na soma, então mexer no fader não invalida
+                      nada. Mover a faixa inteira no tempo também não.
+
+RenderCache:
+    Render pré-fader (instrumento + inserts) de cada faixa congelado no
+    DERIVED_CACHE (core/media.py) sob o digest da faixa — lido por mmap,
+    despejo LRU por orçamento. Guarda também o custo medido do render
+    (segundos de CPU por segundo de áudio) para sugerir congelamento.
+
+OfflineRenderer:
+    bounce(snapshot, mixer) — faixas com digest em cache vêm do disco,
+    só as alteradas são renderizadas. Faixa i da timeline ↔ canal i do
+    mixer (mesma convenção de modules/project/templates.py).
+
+freeze_candidates():
+    Com a carga de CPU do callback acima do limite, escolhe as faixas de
+    maior custo medido até a estimativa cair abaixo dele.
+"""
+from __future__ import annotations
+
+import copy
+import hashlib
+import json
+import threading
+import time
+from dataclasses import dataclass
+from typing import Any, Dict, Iterable, List, Optional, Sequence, Tuple
+
+import numpy as np
+
+from ..audio.resampler import AudioResampler
+from ..core.constants import ClipType
+from ..core.logger import LOGGER
+from ..core.media import DERIVED_CACHE, MEDIA_POOL, DerivedCache
+from ..core.timeline import ClipSnapshot, TimelineSnapshot, TrackSnapshot
+from ..instruments.synth import Synth, SynthPreset
+from ..midi.events import MidiSequence
+from .mixer import Channel, Mixer
+
+
+RENDER_KIND    = "track-render"
+RENDER_BLOCK   = 1024          # frames por bloco do render offline
+MAX_TAIL_SEC   = 10.0          # limite da cauda (release/inserts) após o último clip
+DEFAULT_FREEZE_LOAD = 0.7      # carga do callback a partir da qual sugerir freeze
+
+
+# ------------------------------------------------------------------
+# Hash de conteúdo
+# ------------------------------------------------------------------
+
+def _h() -> "hashlib._Hash":
+    return hashlib.blake2b(digest_size=16)
+
+
+def _midi_events(data: Any) -> List[Any]:
+    """Eventos com time_sec/to_raw do payload de um clip MIDI."""
+    if isinstance(data, MidiSequence):
+        return data.events
+    if isinstance(data, (list, tuple)):
+        return [e for e in data if hasattr(e, "time_sec") and hasattr(e, "to_raw")]
+    return []
+
+
+def _payload_key(data: Any) -> Any:
+    if data is None:
+        return None
+    if isinstance(data, str):
+        # Áudio: o conteúdo do arquivo, não o caminho
+        try:
+            return ["media", MEDIA_POOL.hash_of(data)]
+        except OSError:
+            return ["missing", data]
+    events = _midi_events(data)
+    if events:
+        return [[e.time_sec, list(e.to_raw())] for e in events]
+    to_dict = getattr(data, "to_dict", None)
+    if to_dict is not None:
+        return to_dict()
+    return repr(data)
+
+
+def clip_digest(clip: ClipSnapshot, origin: float = 0.0) -> str:
+    """Hash do conteúdo de um clip, com start relativo a 'origin'."""
+    h = _h()
+    head = [clip.type.value, round(clip.start - origin, 9), round(clip.duration, 9)]
+    h.update(json.dumps([head, _payload_key(clip.data)], default=repr).encode("utf-8"))
+    return h.hexdigest()
+
+
+def _insert_state(fx: Any) -> Any:
+    to_dict = getattr(fx, "to_dict", None)
+    return [type(fx).__name__, to_dict() if to_dict is not None else repr(fx)]
+
+
+def channel_digest(channel: Channel) -> str:
+    """Hash do que o canal faz ao sinal ANTES do fader: preset + inserts."""
+    preset = getattr(channel.instrument, "preset", None)
+    state = [
+        preset.to_dict() if isinstance(preset, SynthPreset) else repr(preset),
+        [_insert_state(fx) for fx in channel.inserts],
+    ]
+    h = _h()
+    h.update(json.dumps(state, sort_keys=True, default=repr).encode("utf-8"))
+    return h.hexdigest()
+
+
+def track_digest(track: TrackSnapshot, channel: Channel, sample_rate: int,
+                 clip_digests: Optional[Sequence[str]] = None) -> str:
+    """Hash do render pré-fader de uma faixa."""
+    origin = track.starts[0] if track.starts else 0.0
+    if clip_digests is None:
+        clip_digests = [clip_digest(c, origin) for c in track.clips]
+    h = _h()
+    h.update(f"{sample_rate}|{channel_digest(channel)}|".encode("ascii"))
+    for d in clip_digests:
+        h.update(d.encode("ascii"))
+    return h.hexdigest()
+
+
+# ------------------------------------------------------------------
+# Render de uma faixa
+# ------------------------------------------------------------------
+
+@dataclass
+class TrackRender:
+    """Render pré-fader de uma faixa: áudio (frames, 2) a partir de 'offset'."""
+    digest: str
+    offset: int                  # frame da timeline onde audio[0] cai
+    audio:  np.ndarray           # float32 (frames, 2) — memmap quando veio do cache
+    cost:   float = 0.0          # segundos de CPU por segundo de áudio (0 = desconhecido)
+    cached: bool  = False
+
+    @property
+    def end(self) -> int:
+        return self.offset + len(self.audio)
+
+
+def _clip_raw_events(clip: ClipSnapshot, origin: float, sr: int) -> List[Tuple[int, int, int, int]]:
+    """(frame, status, d1, d2) de um clip MIDI, cortado no fim do clip."""
+    out = []
+    base = clip.start - origin
+    for ev in _midi_events(clip.data):
+        raw = ev.to_raw()
+        status = raw[0]
+        d1 = raw[1] if len(raw) > 1 else 0
+        d2 = raw[2] if len(raw) > 2 else 0
+        t = ev.time_sec
+        if t >= clip.duration:
+            kind = status & 0xF0
+            if kind != 0x80 and not (kind == 0x90 and d2 == 0):
+                continue
+            t = clip.duration            # note-off depois do fim: solta no fim
+        out.append((int(round((base + t) * sr)), status, d1, d2))
+    return out
+
+
+def _add_audio_clip(buf: np.ndarray, clip: ClipSnapshot, origin: float, sr: int) -> None:
+    try:
+        asset = MEDIA_POOL.acquire(clip.data)
+    except (OSError, RuntimeError) as e:
+        LOGGER.warning("Render", f"Clip '{clip.name}': mídia indisponível ({e})")
+        return
+    try:
+        src_frames = int(round(clip.duration * asset.sample_rate))
+        audio = asset.read(0, src_frames)
+        if asset.sample_rate != sr:
+            audio = AudioResampler.resample(audio, asset.sample_rate, sr).astype(np.float32)
+        if audio.ndim == 1 or audio.shape[1] == 1:
+            audio = np.repeat(audio.reshape(-1, 1), 2, axis=1)
+        start = int(round((clip.start - origin) * sr))
+        n = max(0, min(len(audio), len(buf) - start))
+        buf[start:start + n] += audio[:n, :2]
+    finally:
+        MEDIA_POOL.release(asset)
+
+
+def render_track(track: TrackSnapshot, channel: Channel, sample_rate: int) -> np.ndarray:
+    """
+    Render pré-fader (instrumento + inserts) de uma faixa, do início do
+    primeiro clip até o fim da cauda. Usa cópias do instrumento e dos
+    inserts — o estado do canal ao vivo não é tocado.
+    """
+    sr = sample_rate
+    if not track.clips:
+        return np.zeros((0, 2), dtype=np.float32)
+    origin = track.starts[0]
+    body = int(round((track.duration - origin) * sr))
+
+    preset = copy.deepcopy(getattr(channel.instrument, "preset", None) or SynthPreset())
+    synth = Synth(sample_rate=sr, preset=preset)
+    inserts = [copy.deepcopy(fx) for fx in channel.inserts]
+    for fx in inserts:
+        reset = getattr(fx, "reset", None)
+        if reset is not None:
+            reset()
+    tail = min(MAX_TAIL_SEC, preset.release + max(
+        (float(getattr(fx, "tail_seconds", 0.0)) for fx in inserts), default=0.0))
+    total = body + int(np.ceil(tail * sr))
+
+    events: List[Tuple[int, int, int, int]] = []
+    audio_clips: List[ClipSnapshot] = []
+    for clip in track.clips:
+        if clip.type == ClipType.MIDI:
+            events.extend(_clip_raw_events(clip, origin, sr))
+        elif clip.type == ClipType.AUDIO and isinstance(clip.data, str):
+            audio_clips.append(clip)
+    events.sort(key=lambda e: e[0])
+
+    # Instrumento: segmentos entre eventos, no máximo RENDER_BLOCK frames
+    dry = np.zeros((total, 2), dtype=np.float32)
+    used = total
+    if events:
+        scratch = Channel("render", instrument=synth, sample_rate=sr)   # só para o despacho handle_raw
+        pos, i = 0, 0
+        while pos < total:
+            while i < len(events) and events[i][0] <= pos:
+                _f, status, d1, d2 = events[i]
+                scratch.handle_raw(status, d1, d2)
+                i += 1
+            nxt = events[i][0] if i < len(events) else total
+            stop = min(total, nxt, pos + RENDER_BLOCK)
+            dry[pos:stop] = synth.process(stop - pos)
+            pos = stop
+            if i >= len(events) and pos >= body and synth.active_voice_count == 0 and not inserts:
+                used = pos                          # cauda acabou antes do limite
+                break
+    elif not inserts:
+        used = body                                 # só áudio: sem cauda
+
+    for clip in audio_clips:
+        _add_audio_clip(dry, clip, origin, sr)
+
+    # Inserts em blocos — mesma granularidade do callback
+    if inserts:
+        for pos in range(0, total, RENDER_BLOCK):
+            block = dry[pos:pos + RENDER_BLOCK]
+            for fx in inserts:
+                block = fx.process(block)
+            dry[pos:pos + len(block)] = block
+    return dry[:used]
+
+
+# ------------------------------------------------------------------
+# Cache de renders
+# ------------------------------------------------------------------
+
+class RenderCache:
+    """Renders pré-fader por digest de faixa, guardados no DerivedCache."""
+
+    def __init__(self, store: Optional[DerivedCache] = None) -> None:
+        self.store = store or DERIVED_CACHE
+        self._lock = threading.Lock()
+        self._costs: Dict[str, float] = {}
+        # id(ClipSnapshot) → (snapshot, origin, digest): snapshots são
+        # compartilhados entre versões, então o hash de um clip que não
+        # mudou é calculado uma vez só.
+        self._clip_digests: Dict[int, Tuple[ClipSnapshot, float, str]] = {}
+
+    @staticmethod
+    def _params(sample_rate: int) -> Dict[str, Any]:
+        return {"sr": int(sample_rate)}
+
+    def digest(self, track: TrackSnapshot, channel: Channel, sample_rate: int) -> str:
+        origin = track.starts[0] if track.starts else 0.0
+        digests = []
+        with self._lock:
+            for c in track.clips:
+                hit = self._clip_digests.get(id(c))
+                if hit is None or hit[0] is not c or hit[1] != origin:
+                    hit = (c, origin, clip_digest(c, origin))
+                    self._clip_digests[id(c)] = hit
+                digests.append(hit[2])
+        return track_digest(track, channel, sample_rate, digests)
+
+    def retain(self, snapshot: TimelineSnapshot) -> None:
+        """Esquece hashes de clips que não estão mais em 'snapshot'."""
+        live = {id(c) for t in snapshot.tracks for c in t.clips}
+        with self._lock:
+            for k in [k for k in self._clip_digests if k not in live]:
+                del self._clip_digests[k]
+
+    def get(self, digest: str, sample_rate: int) -> Optional[np.ndarray]:
+        return self.store.get(digest, RENDER_KIND, self._params(sample_rate))
+
+    def put(self, digest: str, sample_rate: int, audio: np.ndarray, cost: float = 0.0) -> None:
+        self.store.put(digest, RENDER_KIND, audio.astype(np.float32, copy=False), self._params(sample_rate))
+        if cost > 0.0:
+            with self._lock:
+                self._costs[digest] = cost
+
+    def cost(self, digest: str) -> float:
+        return self._costs.get(digest, 0.0)
+
+    def render(self, track: TrackSnapshot, channel: Channel, sample_rate: int,
+               digest: Optional[str] = None) -> TrackRender:
+        """Render da faixa: do cache se o digest bater, senão renderiza e guarda."""
+        digest = digest or self.digest(track, channel, sample_rate)
+        offset = int(round(track.starts[0] * sample_rate)) if track.starts else 0
+        audio = self.get(digest, sample_rate)
+        if audio is not None:
+            return TrackRender(digest, offset, audio, self.cost(digest), cached=True)
+
+        t0 = time.perf_counter()
+        audio = render_track(track, channel, sample_rate)
+        elapsed = time.perf_counter() - t0
+        seconds = len(audio) / sample_rate if sample_rate else 0.0
+        cost = elapsed / seconds if seconds > 0 else 0.0
+        if len(audio):
+            self.put(digest, sample_rate, audio, cost)
+        return TrackRender(digest, offset, audio, cost)
+
+
+# ------------------------------------------------------------------
+# Bounce incremental
+# ------------------------------------------------------------------
+
+@dataclass
+class BounceResult:
+    audio:    np.ndarray                 # (frames, saída do mixer) float32, pós master
+    renders:  List[Optional[TrackRender]]
+    rendered: int                        # faixas renderizadas agora
+    reused:   int                        # faixas vindas do cache
+    seconds:  float                      # tempo de parede do bounce
+
+
+class OfflineRenderer:
+    """Bounce da timeline reaproveitando renders de faixas inalteradas."""
+
+    def __init__(self, cache: Optional[RenderCache] = None) -> None:
+        self.cache = cache or RENDER_CACHE
+
+    def renders(self, snapshot: TimelineSnapshot, mixer: Mixer) -> List[Optional[TrackRender]]:
+        """Render pré-fader de cada faixa com canal correspondente (None sem canal/clips)."""
+        sr = mixer.sample_rate
+        out: List[Optional[TrackRender]] = []
+        for i, track in enumerate(snapshot.tracks):
+            ch = mixer.get_channel(i)
+            if ch is None or not track.clips:
+                out.append(None)
+                continue
+            out.append(self.cache.render(track, ch, sr))
+        self.cache.retain(snapshot)
+        return out
+
+    def bounce(
+        self,
+        snapshot: TimelineSnapshot,
+        mixer:    Mixer,
+        start:    float = 0.0,
+        end:      Optional[float] = None,
+    ) -> BounceResult:
+        """
+        Mix de [start, end) em segundos (end padrão: fim da cauda mais
+        longa). Fader, pan, mute e solo vêm do canal no momento do bounce.
+        """
+        t0 = time.perf_counter()
+        sr = mixer.sample_rate
+        renders = self.renders(snapshot, mixer)
+
+        first = int(round(start * sr))
+        if end is None:
+            last = max((r.end for r in renders if r is not None), default=first)
+        else:
+            last = int(round(end * sr))
+        frames = max(0, last - first)
+        mixed = np.zeros((frames, mixer.num_channels), dtype=np.float32)
+
+        any_solo = snapshot.any_solo or any(
+            mixer.get_channel(i).solo for i, r in enumerate(renders) if r is not None)
+        for i, r in enumerate(renders):
+            if r is None:
+                continue
+            ch, track = mixer.get_channel(i), snapshot.tracks[i]
+            solo = ch.solo or track.solo
+            if ch.mute or track.mute or (any_solo and not solo):
+                continue
+            a, b = max(first, r.offset), min(last, r.end)
+            if a >= b:
+                continue
+            seg = r.audio[a - r.offset:b - r.offset]
+            g = ch.gains()                              # volume × pan no layout do barramento
+            if len(g) == 2:
+                mixed[a - first:b - first] += seg * g
+            else:
+                mixed[a - first:b - first] += seg.mean(axis=1, keepdims=True) * g
+
+        mixed = mixer.master.process(mixed)
+        if mixer._downmix is not None:
+            mixed = mixed @ mixer._downmix
+        reused = sum(1 for r in renders if r is not None and r.cached)
+        rendered = sum(1 for r in renders if r is not None and not r.cached)
+        result = BounceResult(mixed, renders, rendered, reused, time.perf_counter() - t0)
+        LOGGER.info(
+            "Render",
+            f"Bounce v{snapshot.version}: {rendered} faixa(s) renderizada(s), "
+            f"{reused} do cache, {result.seconds * 1000:.0f} ms",
+        )
+        return result
+
+
+# ------------------------------------------------------------------
+# Sugestão de freeze sob carga
+# ------------------------------------------------------------------
+
+def freeze_candidates(
+    renders:   Iterable[Optional[TrackRender]],
+    cpu_load:  float,
+    threshold: float = DEFAULT_FREEZE_LOAD,
+) -> List[int]:
+    """
+    Índices de faixas a congelar para trazer a carga do callback
+    (EngineStatistics.cpu_load, 1.0 = orçamento inteiro) abaixo de
+    'threshold'. O custo medido no render offline é a estimativa da fatia
+    de CPU que cada faixa consome ao vivo; as mais caras vão primeiro.
+    """
+    if cpu_load < threshold:
+        return []
+    ranked = sorted(
+        ((r.cost, i) for i, r in enumerate(renders) if r is not None and r.cost > 0.0),
+        reverse=True,
+    )
+    out: List[int] = []
+    load = cpu_load
+    for cost, i in ranked:
+        if load < threshold:
+            break
+        out.append(i)
+        load -= cost
+    return out
+
+
+# Instância global
+RENDER_CACHE = RenderCache()
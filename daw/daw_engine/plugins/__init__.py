@@ -0,0 +1,35 @@
+# plugins/__init__.py
+"""
+Hospedagem de plugins de terceiros (LV2 e CLAP, Linux) fora do processo.
+
+    base.py      — PluginInfo (o que o scan acha e o Registry guarda) e
+                   PluginInstance (plugin carregado, só no sandbox)
+    clap.py      — CLAP via ctypes (clap_entry → factory → plugin)
+    lv2.py       — LV2 via ctypes + leitor de Turtle mínimo (sem lilv)
+    exchange.py  — BlockExchange: slots e rings de áudio em memória
+                   compartilhada entre a engine e o sandbox
+    host.py      — main() do processo sandbox e do scan
+    sandbox.py   — PluginSandbox (processo, round-trip por bloco,
+                   watchdog) e SandboxedPlugin (insert de Channel)
+
+Uso:
+    scan_plugins()                                   # Registry "plugins"
+    fx = SandboxedPlugin.create("lv2:http://.../amp")
+    mixer.get_channel(1).add_insert(fx)              # PDC recalculado
+
+Código de plugin nunca roda no processo do Blender nem no da engine.
+"""
+from __future__ import annotations
+
+from .base import FORMATS, ParamInfo, PluginInfo
+from .sandbox import PLUGIN_SANDBOX, PluginSandbox, SandboxedPlugin, scan_plugins
+
+__all__ = [
+    "FORMATS",
+    "ParamInfo",
+    "PluginInfo",
+    "PLUGIN_SANDBOX",
+    "PluginSandbox",
+    "SandboxedPlugin",
+    "scan_plugins",
+]
@@ -0,0 +1,101 @@
+# plugins/base.py
+"""
+Tipos comuns aos formatos de plugin (LV2, CLAP).
+
+PluginInfo      — o que o scan descobre: formato, id, nome, onde está e
+                  quantos canais de áudio entram/saem. É o que vai para o
+                  Registry (categoria "plugins") e o que o insert guarda.
+PluginInstance  — um plugin carregado DENTRO do processo sandbox
+                  (plugins/host.py). Nunca existe no processo do Blender:
+                  é código de terceiros.
+
+Convenção de áudio do host: planar float32, um ponteiro por canal. O
+host passa ponteiros direto para os rings da memória compartilhada
+(plugins/exchange.py) — o plugin lê e escreve sem cópia intermediária.
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+from dataclasses import asdict, dataclass, field
+from typing import Dict, List, Sequence
+
+
+FORMATS = ("lv2", "clap")
+
+
+@dataclass
+class ParamInfo:
+    id:      int
+    name:    str
+    minimum: float = 0.0
+    maximum: float = 1.0
+    default: float = 0.0
+
+
+@dataclass
+class PluginInfo:
+    format:   str                  # "lv2" | "clap"
+    id:       str                  # URI (LV2) ou plugin id (CLAP)
+    name:     str
+    path:     str                  # pasta do bundle (LV2) ou arquivo .clap
+    vendor:   str = ""
+    inputs:   int = 2              # canais de áudio
+    outputs:  int = 2
+    params:   List[ParamInfo] = field(default_factory=list)
+
+    @property
+    def key(self) -> str:
+        """Chave no Registry: 'clap:com.vendor.plugin' / 'lv2:http://...'."""
+        return f"{self.format}:{self.id}"
+
+    def to_dict(self) -> dict:
+        return asdict(self)
+
+    @classmethod
+    def from_dict(cls, data: dict) -> "PluginInfo":
+        data = dict(data)
+        data["params"] = [ParamInfo(**p) for p in data.get("params", [])]
+        return cls(**data)
+
+
+class PluginInstance:
+    """
+    Interface de um plugin carregado no sandbox.
+
+    Ciclo: activate(sr, max_frames) → process(...)* → deactivate() → close().
+    Tudo chamado pela mesma thread do processo sandbox.
+    """
+
+    info: PluginInfo
+
+    def activate(self, sample_rate: float, max_frames: int) -> None:
+        raise NotImplementedError
+
+    def process(self, inputs: Sequence[int], outputs: Sequence[int], frames: int) -> None:
+        """
+        inputs/outputs: endereços (int) de buffers float32 contíguos de
+        'frames' amostras, um por canal do plugin.
+        """
+        raise NotImplementedError
+
+    @property
+    def latency(self) -> int:
+        """Latência interna em samples (lookahead, FFT...)."""
+        return 0
+
+    def set_param(self, param_id: int, value: float) -> None:
+        pass
+
+    def params(self) -> Dict[int, float]:
+        return {}
+
+    def idle(self) -> None:
+        """Volta do laço do host fora do processamento (callbacks de main thread)."""
+        pass
+
+    def deactivate(self) -> None:
+        pass
+
+    def close(self) -> None:
+        pass
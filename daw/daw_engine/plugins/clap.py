@@ -0,0 +1,536 @@
+# plugins/clap.py
+"""
+Hospedagem de plugins CLAP via ctypes (ABI C estável, sem SDK).
+
+Um .clap é uma biblioteca compartilhada que exporta o símbolo de dados
+'clap_entry' (clap_plugin_entry). O host:
+
+    entry.init(caminho) → get_factory("clap.plugin-factory")
+    factory.create_plugin(host, id) → plugin.init() → activate(sr, min, max)
+    start_processing() → process(clap_process)* → stop/deactivate/destroy
+
+Extensões usadas: clap.audio-ports (canais), clap.latency (compensação)
+e clap.params (lista e valores; mudanças entram como eventos
+CLAP_EVENT_PARAM_VALUE no próximo process()).
+
+As structs abaixo espelham include/clap/*.h (CLAP 1.x). Só o que o host
+usa — campos no fim das structs que não são lidos podem ficar de fora,
+mas nenhum campo do meio.
+
+Só roda no processo sandbox (plugins/host.py). Sem bpy.
+"""
+from __future__ import annotations
+
+import ctypes
+import glob
+import os
+from ctypes import (
+    CFUNCTYPE,
+    POINTER,
+    Structure,
+    c_bool,
+    c_char,
+    c_char_p,
+    c_double,
+    c_float,
+    c_int16,
+    c_int32,
+    c_int64,
+    c_uint16,
+    c_uint32,
+    c_uint64,
+    c_void_p,
+)
+from typing import Dict, List, Sequence, Tuple
+
+from ..audio.errors import PluginLoadError
+from .base import ParamInfo, PluginInfo, PluginInstance
+
+
+CLAP_VERSION = (1, 2, 0)
+
+CLAP_PLUGIN_FACTORY_ID = b"clap.plugin-factory"
+CLAP_EXT_AUDIO_PORTS   = b"clap.audio-ports"
+CLAP_EXT_LATENCY       = b"clap.latency"
+CLAP_EXT_PARAMS        = b"clap.params"
+
+CLAP_CORE_EVENT_SPACE_ID = 0
+CLAP_EVENT_PARAM_VALUE   = 5
+
+
+def search_paths() -> List[str]:
+    """CLAP_PATH (separado por ':') e as pastas padrão do Linux."""
+    paths = [p for p in os.environ.get("CLAP_PATH", "").split(os.pathsep) if p]
+    paths += [os.path.expanduser("~/.clap"), "/usr/local/lib/clap", "/usr/lib/clap"]
+    return paths
+
+
+# ------------------------------------------------------------------
+# Structs
+# ------------------------------------------------------------------
+
+class clap_version(Structure):
+    _fields_ = [("major", c_uint32), ("minor", c_uint32), ("revision", c_uint32)]
+
+
+class clap_plugin_descriptor(Structure):
+    _fields_ = [
+        ("clap_version", clap_version),
+        ("id",           c_char_p),
+        ("name",         c_char_p),
+        ("vendor",       c_char_p),
+        ("url",          c_char_p),
+        ("manual_url",   c_char_p),
+        ("support_url",  c_char_p),
+        ("version",      c_char_p),
+        ("description",  c_char_p),
+        ("features",     POINTER(c_char_p)),
+    ]
+
+
+class clap_host(Structure):
+    pass
+
+
+_HostFn = CFUNCTYPE(None, POINTER(clap_host))
+_HostGetExt = CFUNCTYPE(c_void_p, POINTER(clap_host), c_char_p)
+
+clap_host._fields_ = [
+    ("clap_version",     clap_version),
+    ("host_data",        c_void_p),
+    ("name",             c_char_p),
+    ("vendor",           c_char_p),
+    ("url",              c_char_p),
+    ("version",          c_char_p),
+    ("get_extension",    _HostGetExt),
+    ("request_restart",  _HostFn),
+    ("request_process",  _HostFn),
+    ("request_callback", _HostFn),
+]
+
+
+class clap_event_header(Structure):
+    _fields_ = [
+        ("size",     c_uint32),
+        ("time",     c_uint32),
+        ("space_id", c_uint16),
+        ("type",     c_uint16),
+        ("flags",    c_uint32),
+    ]
+
+
+class clap_event_param_value(Structure):
+    _fields_ = [
+        ("header",     clap_event_header),
+        ("param_id",   c_uint32),
+        ("cookie",     c_void_p),
+        ("note_id",    c_int32),
+        ("port_index", c_int16),
+        ("channel",    c_int16),
+        ("key",        c_int16),
+        ("value",      c_double),
+    ]
+
+
+class clap_input_events(Structure):
+    pass
+
+
+_EventsSize = CFUNCTYPE(c_uint32, POINTER(clap_input_events))
+# Callback ctypes não devolve POINTER: o endereço do header vai como void*
+_EventsGet = CFUNCTYPE(c_void_p, POINTER(clap_input_events), c_uint32)
+
+clap_input_events._fields_ = [
+    ("ctx",  c_void_p),
+    ("size", _EventsSize),
+    ("get",  _EventsGet),
+]
+
+
+class clap_output_events(Structure):
+    pass
+
+
+_EventsPush = CFUNCTYPE(c_bool, POINTER(clap_output_events), POINTER(clap_event_header))
+
+clap_output_events._fields_ = [
+    ("ctx",      c_void_p),
+    ("try_push", _EventsPush),
+]
+
+
+class clap_audio_buffer(Structure):
+    _fields_ = [
+        ("data32",        POINTER(POINTER(c_float))),
+        ("data64",        POINTER(POINTER(c_double))),
+        ("channel_count", c_uint32),
+        ("latency",       c_uint32),
+        ("constant_mask", c_uint64),
+    ]
+
+
+class clap_process(Structure):
+    _fields_ = [
+        ("steady_time",         c_int64),
+        ("frames_count",        c_uint32),
+        ("transport",           c_void_p),
+        ("audio_inputs",        POINTER(clap_audio_buffer)),
+        ("audio_outputs",       POINTER(clap_audio_buffer)),
+        ("audio_inputs_count",  c_uint32),
+        ("audio_outputs_count", c_uint32),
+        ("in_events",           POINTER(clap_input_events)),
+        ("out_events",          POINTER(clap_output_events)),
+    ]
+
+
+class clap_plugin(Structure):
+    pass
+
+
+_P = POINTER(clap_plugin)
+
+clap_plugin._fields_ = [
+    ("desc",             POINTER(clap_plugin_descriptor)),
+    ("plugin_data",      c_void_p),
+    ("init",             CFUNCTYPE(c_bool, _P)),
+    ("destroy",          CFUNCTYPE(None, _P)),
+    ("activate",         CFUNCTYPE(c_bool, _P, c_double, c_uint32, c_uint32)),
+    ("deactivate",       CFUNCTYPE(None, _P)),
+    ("start_processing", CFUNCTYPE(c_bool, _P)),
+    ("stop_processing",  CFUNCTYPE(None, _P)),
+    ("reset",            CFUNCTYPE(None, _P)),
+    ("process",          CFUNCTYPE(c_int32, _P, POINTER(clap_process))),
+    ("get_extension",    CFUNCTYPE(c_void_p, _P, c_char_p)),
+    ("on_main_thread",   CFUNCTYPE(None, _P)),
+]
+
+
+class clap_plugin_factory(Structure):
+    pass
+
+
+clap_plugin_factory._fields_ = [
+    ("get_plugin_count",      CFUNCTYPE(c_uint32, POINTER(clap_plugin_factory))),
+    ("get_plugin_descriptor", CFUNCTYPE(POINTER(clap_plugin_descriptor),
+                                        POINTER(clap_plugin_factory), c_uint32)),
+    ("create_plugin",         CFUNCTYPE(_P, POINTER(clap_plugin_factory),
+                                        POINTER(clap_host), c_char_p)),
+]
+
+
+class clap_plugin_entry(Structure):
+    _fields_ = [
+        ("clap_version", clap_version),
+        ("init",         CFUNCTYPE(c_bool, c_char_p)),
+        ("deinit",       CFUNCTYPE(None)),
+        ("get_factory",  CFUNCTYPE(c_void_p, c_char_p)),
+    ]
+
+
+class clap_audio_port_info(Structure):
+    _fields_ = [
+        ("id",            c_uint32),
+        ("name",          c_char * 256),
+        ("flags",         c_uint32),
+        ("channel_count", c_uint32),
+        ("port_type",     c_char_p),
+        ("in_place_pair", c_uint32),
+    ]
+
+
+class clap_plugin_audio_ports(Structure):
+    _fields_ = [
+        ("count", CFUNCTYPE(c_uint32, _P, c_bool)),
+        ("get",   CFUNCTYPE(c_bool, _P, c_uint32, c_bool, POINTER(clap_audio_port_info))),
+    ]
+
+
+class clap_plugin_latency(Structure):
+    _fields_ = [("get", CFUNCTYPE(c_uint32, _P))]
+
+
+class clap_param_info(Structure):
+    _fields_ = [
+        ("id",            c_uint32),
+        ("flags",         c_uint32),
+        ("cookie",        c_void_p),
+        ("name",          c_char * 256),
+        ("module",        c_char * 1024),
+        ("min_value",     c_double),
+        ("max_value",     c_double),
+        ("default_value", c_double),
+    ]
+
+
+class clap_plugin_params(Structure):
+    _fields_ = [
+        ("count",         CFUNCTYPE(c_uint32, _P)),
+        ("get_info",      CFUNCTYPE(c_bool, _P, c_uint32, POINTER(clap_param_info))),
+        ("get_value",     CFUNCTYPE(c_bool, _P, c_uint32, POINTER(c_double))),
+        ("value_to_text", CFUNCTYPE(c_bool, _P, c_uint32, c_double, c_char_p, c_uint32)),
+        ("text_to_value", CFUNCTYPE(c_bool, _P, c_uint32, c_char_p, POINTER(c_double))),
+        ("flush",         CFUNCTYPE(None, _P, POINTER(clap_input_events),
+                                    POINTER(clap_output_events))),
+    ]
+
+
+def _ext(plugin, ext_id: bytes, struct):
+    ptr = plugin.contents.get_extension(plugin, ext_id)
+    return ctypes.cast(ptr, POINTER(struct)).contents if ptr else None
+
+
+def _text(value) -> str:
+    return value.decode("utf-8", "replace") if value else ""
+
+
+# ------------------------------------------------------------------
+# Biblioteca (.clap)
+# ------------------------------------------------------------------
+
+class _Bundle:
+    """Um .clap carregado: entry inicializado e a factory. Um por arquivo."""
+
+    _open: Dict[str, "_Bundle"] = {}
+
+    def __init__(self, path: str) -> None:
+        try:
+            self.lib = ctypes.CDLL(path)
+            self.entry = clap_plugin_entry.in_dll(self.lib, "clap_entry")
+        except (OSError, ValueError) as e:
+            raise PluginLoadError(f"{path}: não é um plugin CLAP ({e})") from None
+        if self.entry.clap_version.major < 1:
+            raise PluginLoadError(f"{path}: CLAP {self.entry.clap_version.major}.x não suportado")
+        if not self.entry.init(path.encode()):
+            raise PluginLoadError(f"{path}: clap_entry.init falhou")
+        ptr = self.entry.get_factory(CLAP_PLUGIN_FACTORY_ID)
+        if not ptr:
+            raise PluginLoadError(f"{path}: sem clap.plugin-factory")
+        self.factory = ctypes.cast(ptr, POINTER(clap_plugin_factory))
+        self.path = path
+
+    @classmethod
+    def open(cls, path: str) -> "_Bundle":
+        bundle = cls._open.get(path)
+        if bundle is None:
+            bundle = cls._open[path] = cls(path)
+        return bundle
+
+    def descriptors(self) -> List[clap_plugin_descriptor]:
+        f = self.factory
+        count = f.contents.get_plugin_count(f)
+        return [f.contents.get_plugin_descriptor(f, i).contents for i in range(count)]
+
+
+# ------------------------------------------------------------------
+# Host (o que o plugin vê de nós)
+# ------------------------------------------------------------------
+
+class _Host:
+    """clap_host: sem extensões do lado do host; guarda os pedidos do plugin."""
+
+    def __init__(self) -> None:
+        self.callback_requested = False
+        self.restart_requested = False
+        # Os CFUNCTYPE precisam viver enquanto o plugin existir
+        self._fns = (
+            _HostGetExt(lambda host, ext: None),
+            _HostFn(self._restart),
+            _HostFn(lambda host: None),
+            _HostFn(self._callback),
+        )
+        v = clap_version(*CLAP_VERSION)
+        self.struct = clap_host(v, None, b"DAW for Blender", b"DAW for Blender", b"", b"1.0", *self._fns)
+
+    def _restart(self, host) -> None:
+        self.restart_requested = True
+
+    def _callback(self, host) -> None:
+        self.callback_requested = True
+
+
+class _EventList:
+    """clap_input_events sobre uma lista de clap_event_param_value."""
+
+    def __init__(self) -> None:
+        self.events: List[clap_event_param_value] = []
+        # Eventos de saída do plugin (gestos, mudanças internas) são descartados
+        self._fns = (
+            _EventsSize(lambda lst: len(self.events)),
+            _EventsGet(self._get),
+            _EventsPush(lambda lst, ev: True),
+        )
+        self.struct = clap_input_events(None, self._fns[0], self._fns[1])
+        self.out = clap_output_events(None, self._fns[2])
+
+    def _get(self, lst, index):
+        return ctypes.addressof(self.events[index])      # header é o primeiro campo
+
+    def push_param(self, param_id: int, value: float) -> None:
+        header = clap_event_header(ctypes.sizeof(clap_event_param_value), 0,
+                                   CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_PARAM_VALUE, 0)
+        self.events.append(clap_event_param_value(header, param_id, None, -1, -1, -1, -1, value))
+
+
+# ------------------------------------------------------------------
+# Plugin
+# ------------------------------------------------------------------
+
+def _ports(plugin, ext, is_input: bool) -> int:
+    """Canais da porta principal (a primeira). Sem a extensão: estéreo."""
+    if ext is None:
+        return 2
+    if ext.count(plugin, is_input) == 0:
+        return 0
+    info = clap_audio_port_info()
+    if not ext.get(plugin, 0, is_input, ctypes.byref(info)):
+        return 2
+    return int(info.channel_count)
+
+
+def _params(plugin, ext) -> List[ParamInfo]:
+    if ext is None:
+        return []
+    out = []
+    info = clap_param_info()
+    for i in range(ext.count(plugin)):
+        if ext.get_info(plugin, i, ctypes.byref(info)):
+            out.append(ParamInfo(int(info.id), _text(info.name), float(info.min_value),
+                                 float(info.max_value), float(info.default_value)))
+    return out
+
+
+class ClapPlugin(PluginInstance):
+
+    def __init__(self, path: str, plugin_id: str) -> None:
+        self._bundle = _Bundle.open(path)
+        self._host = _Host()
+        self._events = _EventList()
+        ptr = self._bundle.factory.contents.create_plugin(
+            self._bundle.factory, ctypes.byref(self._host.struct), plugin_id.encode())
+        if not ptr:
+            raise PluginLoadError(f"CLAP '{plugin_id}' não encontrado em {path}")
+        self._plugin = ptr
+        if not ptr.contents.init(ptr):
+            ptr.contents.destroy(ptr)
+            raise PluginLoadError(f"CLAP '{plugin_id}': init falhou")
+
+        desc = ptr.contents.desc.contents
+        self._audio_ports = _ext(ptr, CLAP_EXT_AUDIO_PORTS, clap_plugin_audio_ports)
+        self._latency = _ext(ptr, CLAP_EXT_LATENCY, clap_plugin_latency)
+        self._params_ext = _ext(ptr, CLAP_EXT_PARAMS, clap_plugin_params)
+        self.info = PluginInfo(
+            "clap", plugin_id, _text(desc.name), path, _text(desc.vendor),
+            _ports(ptr, self._audio_ports, True), _ports(ptr, self._audio_ports, False),
+            _params(ptr, self._params_ext),
+        )
+
+        n_in, n_out = max(self.info.inputs, 1), max(self.info.outputs, 1)
+        self._in_ptrs = (POINTER(c_float) * n_in)()
+        self._out_ptrs = (POINTER(c_float) * n_out)()
+        self._in_buf = clap_audio_buffer(self._in_ptrs, None, self.info.inputs, 0, 0)
+        self._out_buf = clap_audio_buffer(self._out_ptrs, None, self.info.outputs, 0, 0)
+        self._proc = clap_process(
+            0, 0, None,
+            ctypes.pointer(self._in_buf), ctypes.pointer(self._out_buf),
+            1 if self.info.inputs else 0, 1 if self.info.outputs else 0,
+            ctypes.pointer(self._events.struct), ctypes.pointer(self._events.out),
+        )
+        self._active = False
+        self._steady = 0
+
+    # ------------------------------------------------------------------
+
+    def activate(self, sample_rate: float, max_frames: int) -> None:
+        p = self._plugin
+        if not p.contents.activate(p, float(sample_rate), 1, int(max_frames)):
+            raise PluginLoadError(f"CLAP '{self.info.id}': activate falhou")
+        p.contents.start_processing(p)
+        self._active = True
+
+    def process(self, inputs: Sequence[int], outputs: Sequence[int], frames: int) -> None:
+        for i, addr in enumerate(inputs[:len(self._in_ptrs)]):
+            self._in_ptrs[i] = ctypes.cast(addr, POINTER(c_float))
+        for i, addr in enumerate(outputs[:len(self._out_ptrs)]):
+            self._out_ptrs[i] = ctypes.cast(addr, POINTER(c_float))
+        proc = self._proc
+        proc.frames_count = frames
+        proc.steady_time = self._steady
+        p = self._plugin
+        p.contents.process(p, ctypes.byref(proc))
+        self._events.events.clear()
+        self._steady += frames
+
+    @property
+    def latency(self) -> int:
+        if self._latency is None:
+            return 0
+        return int(self._latency.get(self._plugin))
+
+    def set_param(self, param_id: int, value: float) -> None:
+        self._events.push_param(param_id, value)
+        if not self._active and self._params_ext is not None:
+            # Desativado: process() não roda — flush entrega os eventos
+            p = self._plugin
+            self._params_ext.flush(p, ctypes.byref(self._events.struct), ctypes.byref(self._events.out))
+            self._events.events.clear()
+
+    def params(self) -> Dict[int, float]:
+        ext = self._params_ext
+        if ext is None:
+            return {}
+        value = c_double()
+        out = {}
+        for info in self.info.params:
+            if ext.get_value(self._plugin, info.id, ctypes.byref(value)):
+                out[info.id] = value.value
+        return out
+
+    def idle(self) -> None:
+        if self._host.callback_requested:
+            self._host.callback_requested = False
+            p = self._plugin
+            p.contents.on_main_thread(p)
+
+    def deactivate(self) -> None:
+        if self._active:
+            p = self._plugin
+            p.contents.stop_processing(p)
+            p.contents.deactivate(p)
+            self._active = False
+
+    def close(self) -> None:
+        self.deactivate()
+        if self._plugin:
+            p = self._plugin
+            p.contents.destroy(p)
+            self._plugin = None
+
+    def close_info(self) -> PluginInfo:
+        """Fecha e devolve o info — o scan só instancia para ler portas/parâmetros."""
+        self.close()
+        return self.info
+
+
+# ------------------------------------------------------------------
+# Scan
+# ------------------------------------------------------------------
+
+def scan(paths: Sequence[str] = ()) -> Tuple[List[PluginInfo], List[str]]:
+    """(plugins, erros) de todos os .clap nas pastas. Roda no sandbox de scan."""
+    found: List[PluginInfo] = []
+    errors: List[str] = []
+    for root in paths or search_paths():
+        for path in sorted(glob.glob(os.path.join(root, "**", "*.clap"), recursive=True)):
+            if not os.path.isfile(path):
+                continue                      # macOS bundles ficam de fora
+            try:
+                for desc in _Bundle.open(path).descriptors():
+                    plugin_id = _text(desc.id)
+                    try:
+                        found.append(ClapPlugin(path, plugin_id).close_info())
+                    except PluginLoadError as e:
+                        errors.append(str(e))
+            except PluginLoadError as e:
+                errors.append(str(e))
+    return found, errors
+
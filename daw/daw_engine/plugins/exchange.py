@@ -0,0 +1,157 @@
+# plugins/exchange.py
+"""
+Memória compartilhada de áudio entre a engine e o processo sandbox.
+
+Um segmento com:
+
+    header  — heartbeat/pid do host, tamanho do bloco (L), do ring (R),
+              sample rate, 'kick' (engine) e 'ack' (host)
+    slots   — um por plugin carregado: caminho/id a carregar, estado
+              (vazio, carregando, pronto, falhou), latência interna,
+              canais e os dois contadores de posição (em frames):
+                  write_pos — até onde a engine escreveu entrada
+                  done_pos  — até onde o host já processou
+              cada um na sua linha de cache (um escritor por linha)
+    rings   — (slots, 2, 2, R) float32: entrada e saída estéreo planar
+              de cada slot, circulares em R = RING_BLOCKS × L frames
+
+Por que rings por amostra e não um buffer por bloco:
+- O Mixer divide o bloco em segmentos nos eventos MIDI ao vivo; um
+  plugin recebe pedaços de tamanho variável. Com FIFO em frames, a saída
+  de um pedaço sempre é a entrada de exatamente L frames antes — latência
+  constante, que é o que a compensação de atraso (PDC) do Mixer precisa.
+- O host processa o que estiver entre done_pos e write_pos, de todos os
+  slots, numa volta só: N plugins, um round-trip de IPC por bloco.
+
+Os dados são gravados ANTES de publicar write_pos/done_pos (mesma regra
+do CommandRing em ipc/shm.py).
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+from typing import Optional
+
+import numpy as np
+
+from ..ipc.shm import _SharedBlock
+
+
+MAX_SLOTS = 32
+
+RING_BLOCKS = 4               # R = RING_BLOCKS × L
+
+CHANNELS = 2                  # inserts do Channel são estéreo
+
+
+class SlotState:
+    EMPTY   = 0
+    LOADING = 1               # engine pediu; host ainda não respondeu
+    READY   = 2
+    FAILED  = 3
+
+
+HEADER_DTYPE = np.dtype([
+    ("heartbeat",   np.uint64),
+    ("pid",         np.int64),
+    ("block",       np.int32),        # L
+    ("ring",        np.int32),        # R
+    ("sample_rate", np.int32),
+    ("slots",       np.int32),
+    ("_pad0",       np.uint64, 4),
+    ("kick",        np.uint64),       # engine: blocos submetidos
+    ("_pad1",       np.uint64, 7),
+    ("ack",         np.uint64),       # host: último kick atendido
+    ("_pad2",       np.uint64, 7),
+])
+
+SLOT_DTYPE = np.dtype([
+    ("write_pos",    np.int64),       # engine
+    ("_pad0",        np.int64, 7),
+    ("done_pos",     np.int64),       # host
+    ("_pad1",        np.int64, 7),
+    ("generation",   np.int32),       # engine: incrementa a cada pedido de carga
+    ("loaded",       np.int32),       # host: geração que ele carregou
+    ("state",        np.int32),
+    ("latency",      np.int32),       # samples, interna do plugin
+    ("inputs",       np.int32),
+    ("outputs",      np.int32),
+    ("format",       "S8"),
+    ("plugin_id",    "S256"),
+    ("path",         "S1024"),
+    ("error",        "S256"),
+])
+
+
+class BlockExchange(_SharedBlock):
+    """
+        ex = BlockExchange(block=512, sample_rate=48000)     # engine (dono)
+        ex = BlockExchange.attach(name)                      # sandbox
+    """
+
+    def __init__(
+        self,
+        block:       int = 512,
+        sample_rate: int = 48000,
+        slots:       int = MAX_SLOTS,
+        name:        Optional[str] = None,
+        create:      bool = True,
+    ) -> None:
+        ring = RING_BLOCKS * block
+        size = (HEADER_DTYPE.itemsize + slots * SLOT_DTYPE.itemsize
+                + slots * 2 * CHANNELS * ring * 4)
+        super().__init__(name, size, create)
+        buf = self._shm.buf
+        self.header = np.ndarray((1,), dtype=HEADER_DTYPE, buffer=buf)
+        if create:
+            hdr = self.header
+            hdr["block"], hdr["ring"] = block, ring
+            hdr["sample_rate"], hdr["slots"] = sample_rate, slots
+        hdr = self.header[0]
+        self.block = int(hdr["block"])
+        self.ring = int(hdr["ring"])
+        self.sample_rate = int(hdr["sample_rate"])
+        self.nslots = int(hdr["slots"])
+        off = HEADER_DTYPE.itemsize
+        self.slots = np.ndarray((self.nslots,), dtype=SLOT_DTYPE, buffer=buf, offset=off)
+        off += self.nslots * SLOT_DTYPE.itemsize
+        # rings[slot, 0 = entrada / 1 = saída, canal, frame]
+        self.rings = np.ndarray((self.nslots, 2, CHANNELS, self.ring), dtype=np.float32,
+                                buffer=buf, offset=off)
+
+    @classmethod
+    def attach(cls, name: str) -> "BlockExchange":
+        return cls(name=name, create=False)
+
+    def _release_views(self) -> None:
+        self.header = self.slots = self.rings = None
+
+    def __repr__(self) -> str:
+        ready = int((self.slots["state"] == SlotState.READY).sum()) if self.slots is not None else 0
+        return f"<BlockExchange {self.name} L={self.block} R={self.ring} ready={ready}/{self.nslots}>"
+
+
+# ------------------------------------------------------------------
+# Cópia circular
+# ------------------------------------------------------------------
+
+def ring_write(ring: np.ndarray, pos: int, src: np.ndarray) -> None:
+    """Grava src (canais, n) em ring (canais, R) a partir da posição absoluta pos."""
+    size = ring.shape[1]
+    n = src.shape[1]
+    i = pos % size
+    first = min(n, size - i)
+    ring[:, i:i + first] = src[:, :first]
+    if first < n:
+        ring[:, :n - first] = src[:, first:]
+
+
+def ring_read(ring: np.ndarray, pos: int, dst: np.ndarray) -> None:
+    """Lê dst.shape[1] frames de ring (canais, R) a partir da posição absoluta pos."""
+    size = ring.shape[1]
+    n = dst.shape[1]
+    i = pos % size
+    first = min(n, size - i)
+    dst[:, :first] = ring[:, i:i + first]
+    if first < n:
+        dst[:, first:] = ring[:, :n - first]
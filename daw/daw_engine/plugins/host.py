@@ -0,0 +1,244 @@
+# plugins/host.py
+"""
+main() do processo sandbox de plugins (lançado por plugins/sandbox.py
+via ipc/launch.py --host plugins).
+
+Por que um processo separado:
+- Plugin LV2/CLAP é código nativo de terceiros. Um segfault ou um laço
+  infinito dentro do Blender derruba/trava a sessão inteira. Aqui, o
+  processo morre sozinho: a engine detecta (pid/heartbeat), passa o áudio
+  dos inserts direto (bypass com a mesma latência) e sobe outro sandbox.
+
+Laço:
+    espera o 'kick' da engine (um byte no pipe, ou LOOP_INTERVAL)
+    drena comandos (carregar/descarregar plugin, parâmetro)
+    para cada slot pronto: processa [done_pos, write_pos) em pedaços de
+        até L frames, com ponteiros direto nos rings compartilhados
+    publica done_pos, ack e responde com um byte no pipe de volta
+
+Também tem scan_main(): o scan de plugins roda num processo descartável
+pelo mesmo motivo (carregar um .clap para ler o descritor já executa
+código do plugin).
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+import json
+import os
+import select
+import sys
+from typing import Dict, List
+
+import numpy as np
+
+from ..audio.errors import PluginError
+from ..core.logger import LOGGER
+from ..ipc.shm import CommandRing, Op
+from .base import PluginInstance
+from .exchange import CHANNELS, BlockExchange, SlotState
+
+
+LOOP_INTERVAL = 0.05          # s — sem kick, ainda drena comandos e bate o heartbeat
+
+
+def open_plugin(fmt: str, path: str, plugin_id: str) -> PluginInstance:
+    if fmt == "clap":
+        from .clap import ClapPlugin
+        return ClapPlugin(path, plugin_id)
+    if fmt == "lv2":
+        from .lv2 import Lv2Plugin
+        return Lv2Plugin(path, plugin_id)
+    raise PluginError(f"Formato de plugin desconhecido: '{fmt}'")
+
+
+# ------------------------------------------------------------------
+# Slots
+# ------------------------------------------------------------------
+
+class _Slot:
+    """Um plugin ativo e os ponteiros dele para os rings."""
+
+    def __init__(self, index: int, plugin: PluginInstance, ex: BlockExchange) -> None:
+        self.index = index
+        self.plugin = plugin
+        self.inputs = min(plugin.info.inputs, CHANNELS)
+        self.outputs = min(plugin.info.outputs, CHANNELS)
+        self.ins = ex.rings[index, 0]
+        self.outs = ex.rings[index, 1]
+        # Plugin sem entrada (gerador) ou com mais canais que o insert:
+        # buffers de sobra, fora dos rings
+        self.spare_in = np.zeros((max(plugin.info.inputs - self.inputs, 0), ex.block), np.float32)
+        self.spare_out = np.zeros((max(plugin.info.outputs - self.outputs, 0), ex.block), np.float32)
+
+    def run(self, pos: int, frames: int) -> None:
+        """Processa 'frames' contíguos no ring a partir do índice pos."""
+        ins = [self.ins[c, pos:].ctypes.data for c in range(self.inputs)]
+        ins += [row.ctypes.data for row in self.spare_in]
+        outs = [self.outs[c, pos:].ctypes.data for c in range(self.outputs)]
+        outs += [row.ctypes.data for row in self.spare_out]
+        self.plugin.process(ins, outs, frames)
+        if self.outputs == 1:
+            self.outs[1, pos:pos + frames] = self.outs[0, pos:pos + frames]
+        elif self.outputs == 0:
+            self.outs[:, pos:pos + frames] = 0.0
+
+
+class PluginHost:
+
+    def __init__(self, ex: BlockExchange) -> None:
+        self.ex = ex
+        self.slots: Dict[int, _Slot] = {}
+
+    # ------------------------------------------------------------------
+    # Comandos
+    # ------------------------------------------------------------------
+
+    def handle(self, op: Op, i0: int, i1: int, f0: float) -> None:
+        if op == Op.PLUGIN_LOAD:
+            self.load(i0)
+        elif op == Op.PLUGIN_UNLOAD:
+            self.unload(i0)
+        elif op == Op.PLUGIN_PARAM:
+            slot = self.slots.get(i0)
+            if slot is not None:
+                slot.plugin.set_param(i1, f0)
+
+    def load(self, index: int) -> None:
+        self.unload(index)
+        rec = self.ex.slots[index]
+        fmt = bytes(rec["format"]).decode()
+        path = bytes(rec["path"]).decode("utf-8", "replace")
+        plugin_id = bytes(rec["plugin_id"]).decode("utf-8", "replace")
+        generation = int(rec["generation"])
+        try:
+            plugin = open_plugin(fmt, path, plugin_id)
+            plugin.activate(self.ex.sample_rate, self.ex.block)
+        except Exception as e:
+            LOGGER.error("PluginHost", f"{fmt}:{plugin_id}: {e}")
+            rec["error"] = str(e).encode("utf-8")[:255]
+            rec["state"] = SlotState.FAILED
+            rec["loaded"] = generation
+            return
+        slot = self.slots[index] = _Slot(index, plugin, self.ex)
+        rec["inputs"] = plugin.info.inputs
+        rec["outputs"] = plugin.info.outputs
+        rec["latency"] = plugin.latency
+        rec["error"] = b""
+        # Backlog de antes da carga não é processado: começa onde a engine está
+        rec["done_pos"] = rec["write_pos"]
+        rec["loaded"] = generation
+        rec["state"] = SlotState.READY
+        LOGGER.info("PluginHost", f"Slot {index}: {plugin.info.name} ({fmt}), "
+                                  f"{slot.inputs}→{slot.outputs} canais, latência {plugin.latency}")
+
+    def unload(self, index: int) -> None:
+        slot = self.slots.pop(index, None)
+        if slot is not None:
+            slot.plugin.close()
+        self.ex.slots[index]["state"] = SlotState.EMPTY
+
+    # ------------------------------------------------------------------
+    # Áudio
+    # ------------------------------------------------------------------
+
+    def process(self) -> int:
+        """Processa o pendente de todos os slots. Retorna os frames processados."""
+        ex = self.ex
+        total = 0
+        for index, slot in self.slots.items():
+            rec = ex.slots[index]
+            done = int(rec["done_pos"])
+            end = int(rec["write_pos"])
+            if end - done > ex.ring:
+                done = end - ex.ring          # atrasou mais que o ring: pula
+            while done < end:
+                i = done % ex.ring
+                n = min(end - done, ex.block, ex.ring - i)
+                slot.run(i, n)
+                done += n
+                total += n
+            rec["done_pos"] = done            # publica depois dos dados
+            latency = slot.plugin.latency
+            if latency != rec["latency"]:
+                rec["latency"] = latency
+        return total
+
+    def idle(self) -> None:
+        for slot in self.slots.values():
+            slot.plugin.idle()
+
+    def close(self) -> None:
+        for index in list(self.slots):
+            self.unload(index)
+
+
+# ------------------------------------------------------------------
+# main
+# ------------------------------------------------------------------
+
+def main(ring_name: str, exchange_name: str, kick_fd: int, ack_fd: int, parent_pid: int = 0) -> int:
+    ring = CommandRing.attach(ring_name)
+    ex = BlockExchange.attach(exchange_name)
+    host = PluginHost(ex)
+    hdr = ex.header
+    hdr["pid"] = os.getpid()
+    LOGGER.info("PluginHost", f"Sandbox de plugins no processo {os.getpid()} (L={ex.block})")
+
+    code = 0
+    running = True
+    while running:
+        ready, _, _ = select.select([kick_fd], [], [], LOOP_INTERVAL)
+        if ready:
+            try:
+                os.read(kick_fd, 4096)        # vários kicks acumulados = uma volta
+            except BlockingIOError:
+                pass
+
+        for cmd in ring.drain():
+            if cmd.op == Op.SHUTDOWN:
+                running = False
+                break
+            host.handle(cmd.op, cmd.i0, cmd.i1, cmd.f0)
+
+        kick = int(hdr["kick"][0])
+        host.process()
+        hdr["ack"] = kick
+        if ready:
+            try:
+                os.write(ack_fd, b"\1")
+            except (BlockingIOError, BrokenPipeError):
+                pass
+
+        host.idle()
+        hdr["heartbeat"] += 1
+        if parent_pid > 0 and os.getppid() != parent_pid:
+            LOGGER.warning("PluginHost", "Processo da engine sumiu — encerrando")
+            code = 1
+            break
+
+    try:
+        host.close()
+    finally:
+        ring.close()
+        ex.close()
+    return code
+
+
+def scan_main(paths: List[str]) -> int:
+    """
+    Imprime em stdout os plugins e erros encontrados: uma linha JSON com o
+    prefixo SCAN_MARKER (plugins também podem escrever no stdout).
+    """
+    from .sandbox import SCAN_MARKER
+    from .clap import scan as scan_clap
+    from .lv2 import scan as scan_lv2
+
+    found, errors = [], []
+    for scan in (scan_lv2, scan_clap):
+        f, e = scan(paths)
+        found += [info.to_dict() for info in f]
+        errors += e
+    sys.stdout.write("\n" + SCAN_MARKER + json.dumps({"plugins": found, "errors": errors}) + "\n")
+    sys.stdout.flush()
+    return 0
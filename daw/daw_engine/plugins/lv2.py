@@ -0,0 +1,518 @@
+# plugins/lv2.py
+"""
+Hospedagem de plugins LV2 via ctypes.
+
+Um plugin LV2 é um bundle (pasta *.lv2) com:
+    manifest.ttl  — quais plugins existem (URI), o binário e os .ttl extras
+    <plugin>.ttl  — portas: índice, símbolo, áudio/controle, entrada/saída,
+                    default/min/max, lv2:reportsLatency
+    <plugin>.so   — exporta lv2_descriptor(index) → LV2_Descriptor
+
+Por que sem lilv:
+- lilv (e os bindings Python dele) raramente estão no Python do Blender.
+  O que o host precisa do RDF é pouco — as portas de um plugin —, então
+  um leitor de Turtle mínimo (_Turtle) resolve: prefixos, IRIs relativas,
+  listas com ';' e ',', nós em branco [...] e literais.
+
+Features oferecidas: urid:map (quase todo plugin exige). Portas atom
+recebem uma sequência vazia; portas CV um buffer zerado.
+
+Só roda no processo sandbox (plugins/host.py). Sem bpy.
+"""
+from __future__ import annotations
+
+import ctypes
+import glob
+import os
+import re
+from ctypes import CFUNCTYPE, POINTER, Structure, c_char_p, c_double, c_uint32, c_void_p
+from typing import Dict, List, Optional, Sequence, Tuple
+from urllib.parse import unquote, urljoin, urlparse
+
+import numpy as np
+
+from ..audio.errors import PluginLoadError
+from .base import ParamInfo, PluginInfo, PluginInstance
+
+
+LV2      = "http://lv2plug.in/ns/lv2core#"
+ATOM     = "http://lv2plug.in/ns/ext/atom#"
+RDF_TYPE = "http://www.w3.org/1999/02/22-rdf-syntax-ns#type"
+RDFS     = "http://www.w3.org/2000/01/rdf-schema#"
+DOAP     = "http://usefulinc.com/ns/doap#"
+FOAF     = "http://xmlns.com/foaf/0.1/"
+
+URID_MAP = b"http://lv2plug.in/ns/ext/urid#map"
+
+ATOM_BUFFER_BYTES = 8192
+
+
+def search_paths() -> List[str]:
+    """LV2_PATH (separado por ':') e as pastas padrão do Linux."""
+    paths = [p for p in os.environ.get("LV2_PATH", "").split(os.pathsep) if p]
+    paths += [os.path.expanduser("~/.lv2"), "/usr/local/lib/lv2", "/usr/lib/lv2",
+              "/usr/lib/x86_64-linux-gnu/lv2", "/usr/lib64/lv2"]
+    return paths
+
+
+# ------------------------------------------------------------------
+# Turtle mínimo
+# ------------------------------------------------------------------
+
+_TOKEN = re.compile(r'''
+    (?P<ws>\s+|\#[^\n]*)
+  | (?P<iri><[^>]*>)
+  | (?P<long>"""(?:.|\n)*?""")
+  | (?P<str>"(?:[^"\\]|\\.)*")
+  | (?P<lang>@[a-zA-Z][a-zA-Z0-9-]*)
+  | (?P<dtype>\^\^)
+  | (?P<num>[+-]?(?:\d+\.\d+(?:[eE][+-]?\d+)?|\.\d+(?:[eE][+-]?\d+)?|\d+(?:[eE][+-]?\d+)?))
+  | (?P<pname>[A-Za-z_][\w.-]*?:[\w.-]*|:[\w.-]*|_:[\w.-]+)
+  | (?P<word>[A-Za-z]+)
+  | (?P<punct>[\[\](),;.])
+''', re.VERBOSE)
+
+
+_ESCAPE = re.compile(r"\\(.)")
+
+
+def _unescape(m) -> str:
+    return {"n": "\n", "t": "\t", "r": "\r"}.get(m.group(1), m.group(1))
+
+
+class _Turtle:
+    """
+    Triplas (s, p, o) de um arquivo .ttl. IRIs viram strings absolutas,
+    nós em branco '_:bN', literais viram str/int/float/bool.
+    """
+
+    def __init__(self, text: str, base: str) -> None:
+        self.base = base
+        self.prefixes: Dict[str, str] = {}
+        self.triples: List[Tuple[str, str, object]] = []
+        self._blank = 0
+        self._tokens = self._lex(text)
+        self._i = 0
+        while self._peek() is not None:
+            self._statement()
+
+    @classmethod
+    def load(cls, path: str) -> "_Turtle":
+        with open(path, encoding="utf-8") as f:
+            return cls(f.read(), "file://" + os.path.abspath(path))
+
+    # --- léxico -------------------------------------------------------
+
+    @staticmethod
+    def _lex(text: str) -> List[Tuple[str, str]]:
+        out, pos = [], 0
+        while pos < len(text):
+            m = _TOKEN.match(text, pos)
+            if m is None:
+                raise ValueError(f"Turtle inválido perto de {text[pos:pos + 30]!r}")
+            kind, tok = m.lastgroup, m.group()
+            if kind == "pname" and tok.endswith("."):
+                tok = tok.rstrip(".")         # 'lv2:Plugin.' — o ponto fecha a frase
+            pos = m.start() + len(tok)
+            if kind != "ws":
+                out.append((kind, tok))
+        return out
+
+    def _peek(self) -> Optional[Tuple[str, str]]:
+        return self._tokens[self._i] if self._i < len(self._tokens) else None
+
+    def _next(self) -> Tuple[str, str]:
+        tok = self._tokens[self._i]
+        self._i += 1
+        return tok
+
+    def _expect(self, value: str) -> None:
+        kind, text = self._next()
+        if text != value:
+            raise ValueError(f"Turtle: esperado '{value}', veio '{text}'")
+
+    # --- gramática ----------------------------------------------------
+
+    def _statement(self) -> None:
+        kind, text = self._peek()
+        if text in ("@prefix", "PREFIX") or (kind == "lang" and text == "@prefix"):
+            self._next()
+            name = self._next()[1]
+            self.prefixes[name[:-1]] = self._iri(self._next()[1])
+            if self._peek() and self._peek()[1] == ".":
+                self._next()
+            return
+        if text in ("@base", "BASE") or (kind == "lang" and text == "@base"):
+            self._next()
+            self.base = self._iri(self._next()[1])
+            if self._peek() and self._peek()[1] == ".":
+                self._next()
+            return
+        if text == "[":
+            subject = self._blank_node()
+            if self._peek()[1] != ".":
+                self._predicates(subject)
+        else:
+            subject = self._term()
+            self._predicates(subject)
+        self._expect(".")
+
+    def _predicates(self, subject: str) -> None:
+        while True:
+            kind, text = self._next()
+            pred = RDF_TYPE if text == "a" else self._resolve(kind, text)
+            while True:
+                self.triples.append((subject, pred, self._object()))
+                if self._peek()[1] != ",":
+                    break
+                self._next()
+            if self._peek()[1] != ";":
+                return
+            while self._peek()[1] == ";":
+                self._next()
+            if self._peek()[1] in (".", "]"):
+                return
+
+    def _object(self):
+        kind, text = self._peek()
+        if text == "[":
+            return self._blank_node()
+        if text == "(":
+            self._next()
+            items = []
+            while self._peek()[1] != ")":
+                items.append(self._object())
+            self._next()
+            return tuple(items)
+        return self._term()
+
+    def _blank_node(self) -> str:
+        self._expect("[")
+        self._blank += 1
+        node = f"_:b{self._blank}"
+        if self._peek()[1] != "]":
+            self._predicates(node)
+        self._expect("]")
+        return node
+
+    def _term(self):
+        kind, text = self._next()
+        if kind in ("str", "long"):
+            value = text[3:-3] if kind == "long" else _ESCAPE.sub(_unescape, text[1:-1])
+            nxt = self._peek()
+            if nxt is not None and nxt[0] == "lang":
+                self._next()
+            elif nxt is not None and nxt[0] == "dtype":
+                self._next()
+                self._next()
+            return value
+        if kind == "num":
+            return float(text) if any(c in text for c in ".eE") else int(text)
+        if kind == "word" and text in ("true", "false"):
+            return text == "true"
+        return self._resolve(kind, text)
+
+    def _iri(self, token: str) -> str:
+        return urljoin(self.base, token[1:-1])
+
+    def _resolve(self, kind: str, text: str) -> str:
+        if kind == "iri":
+            return self._iri(text)
+        if text.startswith("_:"):
+            return text
+        prefix, _, local = text.partition(":")
+        if prefix not in self.prefixes:
+            raise ValueError(f"Turtle: prefixo '{prefix}:' não declarado")
+        return self.prefixes[prefix] + local
+
+
+class _Graph:
+    """Índice sujeito → [(predicado, objeto)] sobre as triplas de vários arquivos."""
+
+    def __init__(self) -> None:
+        self._by_subject: Dict[str, List[Tuple[str, object]]] = {}
+
+    def add(self, turtle: _Turtle, scope: str = "") -> None:
+        # Nós em branco são locais ao arquivo
+        for s, p, o in turtle.triples:
+            s = scope + s if s.startswith("_:") else s
+            o = scope + o if isinstance(o, str) and o.startswith("_:") else o
+            self._by_subject.setdefault(s, []).append((p, o))
+
+    def values(self, subject: str, predicate: str) -> List[object]:
+        return [o for p, o in self._by_subject.get(subject, ()) if p == predicate]
+
+    def value(self, subject: str, predicate: str, default=None):
+        vals = self.values(subject, predicate)
+        return vals[0] if vals else default
+
+    def subjects_of_type(self, rdf_type: str) -> List[str]:
+        return [s for s, po in self._by_subject.items() if (RDF_TYPE, rdf_type) in po]
+
+
+def _file_path(iri: str) -> str:
+    return unquote(urlparse(iri).path)
+
+
+# ------------------------------------------------------------------
+# Bundles
+# ------------------------------------------------------------------
+
+class _Port:
+    __slots__ = ("index", "symbol", "name", "audio", "control", "atom", "input",
+                 "default", "minimum", "maximum", "latency")
+
+    def __init__(self, graph: _Graph, node: str) -> None:
+        types = graph.values(node, RDF_TYPE)
+        props = graph.values(node, LV2 + "portProperty")
+        self.index   = int(graph.value(node, LV2 + "index", 0))
+        self.symbol  = str(graph.value(node, LV2 + "symbol", f"port{self.index}"))
+        self.name    = str(graph.value(node, LV2 + "name", self.symbol))
+        self.audio   = LV2 + "AudioPort" in types
+        self.control = LV2 + "ControlPort" in types
+        self.atom    = ATOM + "AtomPort" in types
+        self.input   = LV2 + "InputPort" in types
+        self.minimum = float(graph.value(node, LV2 + "minimum", 0.0))
+        self.maximum = float(graph.value(node, LV2 + "maximum", 1.0))
+        self.default = float(graph.value(node, LV2 + "default", self.minimum))
+        self.latency = (LV2 + "reportsLatency" in props
+                        or graph.value(node, LV2 + "designation") == LV2 + "latency")
+
+
+class _Bundle:
+    """manifest.ttl + arquivos rdfs:seeAlso de um bundle .lv2."""
+
+    def __init__(self, path: str) -> None:
+        self.path = path
+        self.graph = _Graph()
+        manifest = os.path.join(path, "manifest.ttl")
+        ttl = _Turtle.load(manifest)
+        self.graph.add(ttl, manifest)
+        self.plugins = self.graph.subjects_of_type(LV2 + "Plugin")
+        seen = {manifest}
+        for uri in self.plugins:
+            for extra in self.graph.values(uri, RDFS + "seeAlso"):
+                f = _file_path(extra)
+                if f not in seen and os.path.isfile(f):
+                    seen.add(f)
+                    self.graph.add(_Turtle.load(f), f)
+
+    def binary(self, uri: str) -> str:
+        iri = self.graph.value(uri, LV2 + "binary")
+        if iri is None:
+            raise PluginLoadError(f"LV2 '{uri}': sem lv2:binary")
+        return _file_path(iri)
+
+    def ports(self, uri: str) -> List[_Port]:
+        ports = [_Port(self.graph, n) for n in self.graph.values(uri, LV2 + "port")]
+        return sorted(ports, key=lambda p: p.index)
+
+    def info(self, uri: str) -> PluginInfo:
+        g = self.graph
+        ports = self.ports(uri)
+        maker = g.value(uri, DOAP + "maintainer") or g.value(uri, FOAF + "maker")
+        vendor = g.value(maker, FOAF + "name", "") if isinstance(maker, str) else ""
+        return PluginInfo(
+            "lv2", uri, str(g.value(uri, DOAP + "name", uri)), self.path, str(vendor),
+            sum(p.audio and p.input for p in ports),
+            sum(p.audio and not p.input for p in ports),
+            [ParamInfo(p.index, p.name, p.minimum, p.maximum, p.default)
+             for p in ports if p.control and p.input],
+        )
+
+
+# ------------------------------------------------------------------
+# ABI
+# ------------------------------------------------------------------
+
+class LV2_Feature(Structure):
+    _fields_ = [("URI", c_char_p), ("data", c_void_p)]
+
+
+_MapFn = CFUNCTYPE(c_uint32, c_void_p, c_char_p)
+
+
+class LV2_URID_Map(Structure):
+    _fields_ = [("handle", c_void_p), ("map", _MapFn)]
+
+
+class LV2_Descriptor(Structure):
+    pass
+
+
+LV2_Descriptor._fields_ = [
+    ("URI",            c_char_p),
+    ("instantiate",    CFUNCTYPE(c_void_p, POINTER(LV2_Descriptor), c_double, c_char_p,
+                                 POINTER(POINTER(LV2_Feature)))),
+    ("connect_port",   CFUNCTYPE(None, c_void_p, c_uint32, c_void_p)),
+    ("activate",       CFUNCTYPE(None, c_void_p)),
+    ("run",            CFUNCTYPE(None, c_void_p, c_uint32)),
+    ("deactivate",     CFUNCTYPE(None, c_void_p)),
+    ("cleanup",        CFUNCTYPE(None, c_void_p)),
+    ("extension_data", CFUNCTYPE(c_void_p, c_char_p)),
+]
+
+
+class _UridMap:
+    """urid:map compartilhado por todos os plugins do processo."""
+
+    def __init__(self) -> None:
+        self._ids: Dict[bytes, int] = {}
+        self._fn = _MapFn(self._map)
+        self.struct = LV2_URID_Map(None, self._fn)
+        self.feature = LV2_Feature(URID_MAP, ctypes.cast(ctypes.pointer(self.struct), c_void_p))
+
+    def _map(self, handle, uri: bytes) -> int:
+        return self._ids.setdefault(uri, len(self._ids) + 1)
+
+    def __call__(self, uri: str) -> int:
+        return self._map(None, uri.encode())
+
+
+_URID: Optional[_UridMap] = None
+
+
+def _urid() -> _UridMap:
+    global _URID
+    if _URID is None:
+        _URID = _UridMap()
+    return _URID
+
+
+# ------------------------------------------------------------------
+# Plugin
+# ------------------------------------------------------------------
+
+class Lv2Plugin(PluginInstance):
+
+    def __init__(self, bundle_path: str, uri: str) -> None:
+        bundle = _Bundle(bundle_path)
+        if uri not in bundle.plugins:
+            raise PluginLoadError(f"LV2 '{uri}' não está em {bundle_path}")
+        self.info = bundle.info(uri)
+        self._ports = bundle.ports(uri)
+        self._bundle_path = bundle_path
+        self._uri = uri
+        binary = bundle.binary(uri)
+        try:
+            self._lib = ctypes.CDLL(binary)
+            entry = self._lib.lv2_descriptor
+        except (OSError, AttributeError) as e:
+            raise PluginLoadError(f"LV2 '{uri}': {binary} inválido ({e})") from None
+        entry.restype = POINTER(LV2_Descriptor)
+        entry.argtypes = [c_uint32]
+        self._desc = None
+        i = 0
+        while True:
+            d = entry(i)
+            if not d:
+                break
+            if d.contents.URI.decode() == uri:
+                self._desc = d
+                break
+            i += 1
+        if self._desc is None:
+            raise PluginLoadError(f"LV2 '{uri}': binário não exporta o descritor")
+
+        self._audio_in  = [p.index for p in self._ports if p.audio and p.input]
+        self._audio_out = [p.index for p in self._ports if p.audio and not p.input]
+        # Um float por porta de controle, no mesmo array (endereços estáveis)
+        self._controls = np.zeros(max((p.index for p in self._ports), default=0) + 1, dtype=np.float32)
+        for p in self._ports:
+            if p.control:
+                self._controls[p.index] = p.default
+        self._latency_port = next((p.index for p in self._ports
+                                   if p.control and not p.input and p.latency), None)
+        self._atoms: Dict[int, np.ndarray] = {}
+        self._cv: Dict[int, np.ndarray] = {}
+        self._handle = None
+        self._active = False
+
+    # ------------------------------------------------------------------
+
+    def activate(self, sample_rate: float, max_frames: int) -> None:
+        urid = _urid()
+        features = (POINTER(LV2_Feature) * 2)(ctypes.pointer(urid.feature), None)
+        self._features = features
+        desc = self._desc.contents
+        bundle = (self._bundle_path.rstrip("/") + "/").encode()
+        self._handle = desc.instantiate(self._desc, float(sample_rate), bundle, features)
+        if not self._handle:
+            raise PluginLoadError(f"LV2 '{self._uri}': instantiate falhou")
+
+        seq, chunk = urid(ATOM + "Sequence"), urid(ATOM + "Chunk")
+        for p in self._ports:
+            if p.control:
+                addr = self._controls.ctypes.data + 4 * p.index
+            elif p.atom:
+                buf = self._atoms[p.index] = np.zeros(ATOM_BUFFER_BYTES // 4, dtype=np.uint32)
+                # LV2_Atom {size, type} + corpo da sequência {unit, pad}
+                buf[0], buf[1] = (8, seq) if p.input else (ATOM_BUFFER_BYTES - 8, chunk)
+                addr = buf.ctypes.data
+            elif not p.audio:
+                buf = self._cv[p.index] = np.zeros(max_frames, dtype=np.float32)
+                addr = buf.ctypes.data
+            else:
+                continue                      # áudio: conectado a cada process()
+            desc.connect_port(self._handle, p.index, addr)
+        if desc.activate:
+            desc.activate(self._handle)
+        self._active = True
+
+    def process(self, inputs: Sequence[int], outputs: Sequence[int], frames: int) -> None:
+        desc = self._desc.contents
+        h = self._handle
+        for port, addr in zip(self._audio_in, inputs):
+            desc.connect_port(h, port, addr)
+        for port, addr in zip(self._audio_out, outputs):
+            desc.connect_port(h, port, addr)
+        for p in self._ports:
+            if p.atom and not p.input:
+                self._atoms[p.index][0] = ATOM_BUFFER_BYTES - 8
+        desc.run(h, frames)
+
+    @property
+    def latency(self) -> int:
+        if self._latency_port is None:
+            return 0
+        return int(self._controls[self._latency_port])
+
+    def set_param(self, param_id: int, value: float) -> None:
+        if 0 <= param_id < len(self._controls):
+            self._controls[param_id] = value
+
+    def params(self) -> Dict[int, float]:
+        return {p.id: float(self._controls[p.id]) for p in self.info.params}
+
+    def deactivate(self) -> None:
+        if self._active:
+            desc = self._desc.contents
+            if desc.deactivate:
+                desc.deactivate(self._handle)
+            self._active = False
+
+    def close(self) -> None:
+        self.deactivate()
+        if self._handle:
+            self._desc.contents.cleanup(self._handle)
+            self._handle = None
+
+
+# ------------------------------------------------------------------
+# Scan
+# ------------------------------------------------------------------
+
+def scan(paths: Sequence[str] = ()) -> Tuple[List[PluginInfo], List[str]]:
+    """(plugins, erros) de todos os bundles .lv2. Só lê os .ttl — não carrega binários."""
+    found: List[PluginInfo] = []
+    errors: List[str] = []
+    for root in paths or search_paths():
+        for bundle_path in sorted(glob.glob(os.path.join(root, "*.lv2"))):
+            if not os.path.isfile(os.path.join(bundle_path, "manifest.ttl")):
+                continue
+            try:
+                bundle = _Bundle(bundle_path)
+                found.extend(bundle.info(uri) for uri in bundle.plugins)
+            except (OSError, ValueError, PluginLoadError) as e:
+                errors.append(f"{bundle_path}: {e}")
+    return found, errors
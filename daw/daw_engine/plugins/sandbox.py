@@ -0,0 +1,540 @@
+# plugins/sandbox.py
+"""
+Lado da engine do sandbox de plugins: o processo, o round-trip por bloco
+e o insert que o Channel usa.
+
+PluginSandbox — um processo (plugins/host.py) com todos os plugins
+    carregados. Cada plugin ocupa um slot do BlockExchange.
+
+SandboxedPlugin — insert de Channel (process(buf) -> buf, latency,
+    to_dict). Grava a entrada no ring do slot e lê a saída de L frames
+    atrás.
+
+Round-trip (um por bloco, para todos os plugins):
+
+    bloco n:  cada SandboxedPlugin.process() grava a entrada do bloco n
+              e lê a saída do bloco n-1 (já processada)
+    fim do Mixer.process(): submit() — um byte no pipe acorda o host,
+              que processa o bloco n de todos os slots enquanto o
+              PortAudio toca este
+    bloco n+1: a saída de n já está pronta; se não estiver (host lento),
+              sync() espera no pipe de volta até SYNC_TIMEOUT_BLOCKS
+
+Latência: L (o bloco) + a latência interna do plugin. É o que
+SandboxedPlugin.latency informa, e o Mixer compensa nos outros canais
+(ver Mixer.update_latency).
+
+Falhas:
+    Host morto, travado ou atrasado → o insert devolve a própria entrada
+    de L frames atrás (lida do ring de entrada): bypass com a MESMA
+    latência, sem desalinhar a compensação. O watchdog (thread, a cada
+    CHECK_INTERVAL) relança o processo, recarrega os plugins e reaplica
+    os parâmetros. Nada disso passa pelo processo do Blender.
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+import json
+import os
+import select
+import subprocess
+import threading
+import time
+from pathlib import Path
+from typing import Callable, Dict, List, Optional, Sequence
+
+import numpy as np
+
+from ..audio.config import ENGINE_CONFIG
+from ..audio.errors import PluginHostError, PluginNotFound
+from ..core.engine_process import _python_executable
+from ..core.logger import LOGGER
+from ..core.registry import Registry
+from ..ipc.shm import CommandRing, Op
+from .base import PluginInfo
+from .exchange import MAX_SLOTS, BlockExchange, SlotState, ring_read, ring_write
+
+
+HEARTBEAT_TIMEOUT   = 1.0      # s sem heartbeat → host travado
+CHECK_INTERVAL      = 0.25     # s — período do watchdog
+MAX_RESTARTS        = 5        # seguidos sem uma volta saudável no meio
+SYNC_TIMEOUT_BLOCKS = 2        # espera máxima do sync(), em blocos
+SCAN_TIMEOUT        = 60.0     # s
+
+SCAN_MARKER = "@@DAW_PLUGIN_SCAN@@"
+
+# Categoria do Registry onde o scan publica os PluginInfo
+REGISTRY_CATEGORY = "plugins"
+
+
+def _launch_script() -> str:
+    return str(Path(__file__).resolve().parent.parent / "ipc" / "launch.py")
+
+
+def _launch_args() -> List[str]:
+    addon_root = Path(__file__).resolve().parent.parent.parent     # .../daw
+    package = __package__.rsplit(".daw_engine", 1)[0]
+    return [_python_executable(), _launch_script(), "--root", str(addon_root), "--package", package]
+
+
+# ------------------------------------------------------------------
+# Scan
+# ------------------------------------------------------------------
+
+def scan_plugins(paths: Sequence[str] = (), register: bool = True) -> List[PluginInfo]:
+    """
+    Procura plugins LV2/CLAP num processo descartável e publica cada um no
+    Registry (categoria 'plugins', chave 'clap:<id>' / 'lv2:<uri>').
+    """
+    cmd = _launch_args() + ["--host", "scan"]
+    if paths:
+        cmd += ["--paths", os.pathsep.join(paths)]
+    try:
+        done = subprocess.run(cmd, stdin=subprocess.DEVNULL, stdout=subprocess.PIPE,
+                              timeout=SCAN_TIMEOUT, text=True)
+    except (OSError, subprocess.TimeoutExpired) as e:
+        LOGGER.error("PluginSandbox", f"Scan de plugins falhou: {e}")
+        return []
+
+    # Plugins podem escrever no stdout: só a linha marcada é o resultado
+    result = None
+    for line in done.stdout.splitlines():
+        if line.startswith(SCAN_MARKER):
+            result = json.loads(line[len(SCAN_MARKER):])
+    if result is None:
+        LOGGER.error("PluginSandbox", f"Scan de plugins caiu (código {done.returncode})")
+        return []
+
+    for err in result["errors"]:
+        LOGGER.warning("PluginSandbox", f"Scan: {err}")
+    infos = [PluginInfo.from_dict(d) for d in result["plugins"]]
+    if register:
+        registry = Registry()
+        for info in infos:
+            registry.register(REGISTRY_CATEGORY, info.key, info, override=True)
+    LOGGER.info("PluginSandbox", f"{len(infos)} plugins encontrados")
+    return infos
+
+
+# ------------------------------------------------------------------
+# Sandbox
+# ------------------------------------------------------------------
+
+class PluginSandbox:
+    """Processo sandbox com N plugins, um round-trip de IPC por bloco."""
+
+    def __init__(self, slots: int = MAX_SLOTS) -> None:
+        self.max_slots = slots
+        self._proc: Optional[subprocess.Popen] = None
+        self._ring: Optional[CommandRing] = None
+        self._ex: Optional[BlockExchange] = None
+        self._retired: List[object] = []          # blocos de hosts antigos (views vivas)
+        self._kick_w: int = -1
+        self._ack_r: int = -1
+        self._plugins: Dict[int, "SandboxedPlugin"] = {}
+        self._listeners: List[Callable[[], None]] = []
+        self._lock = threading.Lock()             # controle (não o áudio)
+        self._watchdog: Optional[threading.Thread] = None
+        self._stop = threading.Event()
+        self._dirty = False
+
+        self.sample_rate = 0
+        self.block = 0
+        self.restarts = 0
+        self.late_blocks = 0
+        self._failures = 0
+        self._last_beat = 0
+        self._last_beat_at = 0.0
+        self._healthy = False
+        self.gave_up = False
+
+    # ------------------------------------------------------------------
+    # Processo
+    # ------------------------------------------------------------------
+
+    @property
+    def running(self) -> bool:
+        return self._proc is not None and self._proc.poll() is None
+
+    @property
+    def alive(self) -> bool:
+        return self.running and self._healthy
+
+    def start(self) -> bool:
+        with self._lock:
+            if self.running:
+                return True
+            return self._spawn()
+
+    def _spawn(self) -> bool:
+        sample_rate = self.sample_rate or ENGINE_CONFIG.sample_rate
+        block = self.block or ENGINE_CONFIG.buffer_size
+        ring = CommandRing(capacity=256)
+        ex = BlockExchange(block=block, sample_rate=sample_rate, slots=self.max_slots)
+
+        kick_r, kick_w = os.pipe()
+        ack_r, ack_w = os.pipe()
+        os.set_blocking(kick_w, False)
+        os.set_blocking(ack_r, False)
+        cmd = _launch_args() + [
+            "--host", "plugins",
+            "--ring", ring.name,
+            "--state", ex.name,
+            "--fds", f"{kick_r},{ack_w}",
+            "--parent-pid", str(os.getpid()),
+        ]
+        try:
+            proc = subprocess.Popen(cmd, stdin=subprocess.DEVNULL, pass_fds=(kick_r, ack_w))
+        except OSError as e:
+            LOGGER.error("PluginSandbox", f"Falha ao lançar o sandbox: {e}")
+            for fd in (kick_r, kick_w, ack_r, ack_w):
+                os.close(fd)
+            ring.close()
+            ex.close()
+            return False
+        os.close(kick_r)
+        os.close(ack_w)
+
+        # Posições continuam de onde cada plugin está: o host novo começa ali
+        for index, plugin in self._plugins.items():
+            self._write_slot(ex, index, plugin)
+
+        old = (self._ring, self._ex, self._kick_w, self._ack_r)
+        self._proc, self._ring = proc, ring
+        self._kick_w, self._ack_r = kick_w, ack_r
+        self.sample_rate, self.block = sample_rate, block
+        self._ex = ex                               # publicado por último (thread de áudio)
+        self._retire(*old)
+
+        for index, plugin in self._plugins.items():
+            self._request_load(index, plugin)
+        self._last_beat, self._last_beat_at, self._healthy = 0, time.monotonic(), False
+        self._ensure_watchdog()
+        LOGGER.info("PluginSandbox", f"Sandbox de plugins lançado (pid {proc.pid}, L={block})")
+        self._notify()
+        return True
+
+    def _retire(self, ring, ex, kick_w: int, ack_r: int) -> None:
+        """Solta o host anterior. O exchange fica vivo até o próximo restart."""
+        for fd in (kick_w, ack_r):
+            if fd >= 0:
+                os.close(fd)
+        if ring is not None:
+            ring.close()
+        for old in self._retired:
+            old.close()
+        self._retired = [ex] if ex is not None else []
+
+    def _kill(self) -> None:
+        proc = self._proc
+        if proc is not None and proc.poll() is None:
+            proc.kill()
+            try:
+                proc.wait(2.0)
+            except subprocess.TimeoutExpired:
+                pass
+        self._proc = None
+        ex = self._ex
+        if ex is not None:
+            ex.slots["state"] = SlotState.FAILED     # áudio passa a bypass já
+
+    def shutdown(self, timeout: float = 2.0) -> None:
+        self._stop.set()
+        with self._lock:
+            proc = self._proc
+            if proc is not None and proc.poll() is None and self._ring is not None:
+                self._ring.push(Op.SHUTDOWN)
+                try:
+                    proc.wait(timeout)
+                except subprocess.TimeoutExpired:
+                    proc.kill()
+                    proc.wait()
+            self._proc = None
+            ex, self._ex = self._ex, None
+            self._retire(self._ring, ex, self._kick_w, self._ack_r)
+            self._ring, self._kick_w, self._ack_r = None, -1, -1
+            for old in self._retired:
+                old.close()
+            self._retired = []
+
+    def reconfigure(self, sample_rate: int = 0, block: int = 0) -> None:
+        """Novo sample rate / bloco: relança o host (plugins recarregados)."""
+        sample_rate = sample_rate or self.sample_rate
+        block = block or self.block
+        if (sample_rate, block) == (self.sample_rate, self.block):
+            return
+        with self._lock:
+            self.sample_rate, self.block = sample_rate, block
+            if self._proc is None:
+                return
+            self._stop_host()
+            self._spawn()
+
+    def _stop_host(self) -> None:
+        proc = self._proc
+        if proc is not None and proc.poll() is None and self._ring is not None:
+            self._ring.push(Op.SHUTDOWN)
+            try:
+                proc.wait(2.0)
+            except subprocess.TimeoutExpired:
+                pass
+        self._kill()
+
+    # ------------------------------------------------------------------
+    # Watchdog
+    # ------------------------------------------------------------------
+
+    def _ensure_watchdog(self) -> None:
+        if self._watchdog is None or not self._watchdog.is_alive():
+            self._stop.clear()
+            self._watchdog = threading.Thread(target=self._watch, name="daw-plugin-watchdog", daemon=True)
+            self._watchdog.start()
+
+    def _watch(self) -> None:
+        while not self._stop.wait(CHECK_INTERVAL):
+            try:
+                self.check()
+            except Exception as e:
+                LOGGER.error("PluginSandbox", f"Watchdog: {e}")
+
+    def check(self) -> bool:
+        """Heartbeat, restart e latências. Roda no watchdog; pode ser chamado à mão."""
+        with self._lock:
+            if self._proc is None or self._ex is None:
+                return False
+            now = time.monotonic()
+            beat = int(self._ex.header["heartbeat"][0])
+            if beat != self._last_beat:
+                self._last_beat, self._last_beat_at = beat, now
+                if not self._healthy:
+                    self._healthy = True
+                    self._failures = 0
+
+            if self.running and now - self._last_beat_at <= HEARTBEAT_TIMEOUT * (1 if self._healthy else 10):
+                self._update_plugins()
+                return self._healthy
+
+            reason = ("processo saiu" if not self.running
+                      else f"sem heartbeat há {now - self._last_beat_at:.1f}s")
+            self._healthy = False
+            self._failures += 1
+            self._kill()
+            if self._failures > MAX_RESTARTS:
+                if not self.gave_up:
+                    LOGGER.error("PluginSandbox", f"Sandbox caiu ({reason}) — plugins em bypass "
+                                                  f"após {MAX_RESTARTS} tentativas")
+                self.gave_up = True
+                return False
+            LOGGER.warning("PluginSandbox", f"Sandbox caiu ({reason}) — reiniciando")
+            self.restarts += 1
+            self._spawn()
+            return False
+
+    def _update_plugins(self) -> None:
+        """Estado/latência de cada slot publicados pelo host → SandboxedPlugin."""
+        ex = self._ex
+        changed = False
+        for index, plugin in self._plugins.items():
+            rec = ex.slots[index]
+            if int(rec["loaded"]) != plugin.generation:
+                continue
+            state = int(rec["state"])
+            if state == SlotState.FAILED and plugin.error is None:
+                plugin.error = bytes(rec["error"]).decode("utf-8", "replace")
+                LOGGER.error("PluginSandbox", f"{plugin.info.key}: {plugin.error} (bypass)")
+            latency = ex.block + (int(rec["latency"]) if state == SlotState.READY else 0)
+            if latency != plugin.latency:
+                plugin.latency = latency
+                changed = True
+        if changed:
+            self._notify()
+
+    # ------------------------------------------------------------------
+    # Slots
+    # ------------------------------------------------------------------
+
+    def add_listener(self, fn: Callable[[], None]) -> None:
+        """fn() quando a latência de algum plugin muda (Mixer.update_latency)."""
+        if fn not in self._listeners:
+            self._listeners.append(fn)
+
+    def remove_listener(self, fn: Callable[[], None]) -> None:
+        if fn in self._listeners:
+            self._listeners.remove(fn)
+
+    def _notify(self) -> None:
+        for fn in list(self._listeners):
+            fn()
+
+    def attach(self, plugin: "SandboxedPlugin") -> int:
+        if not self.running and not self.gave_up:
+            self.start()
+        with self._lock:
+            free = [i for i in range(self.max_slots) if i not in self._plugins]
+            if not free:
+                raise PluginHostError(f"Sandbox cheio ({self.max_slots} plugins)")
+            index = free[0]
+            self._plugins[index] = plugin
+            plugin.latency = self.block
+            if self._ex is not None:
+                self._write_slot(self._ex, index, plugin)
+                self._request_load(index, plugin)
+            return index
+
+    def detach(self, plugin: "SandboxedPlugin") -> None:
+        with self._lock:
+            index = plugin.slot
+            if self._plugins.get(index) is not plugin:
+                return
+            del self._plugins[index]
+            if self._ring is not None:
+                self._ring.push(Op.PLUGIN_UNLOAD, index)
+
+    def _write_slot(self, ex: BlockExchange, index: int, plugin: "SandboxedPlugin") -> None:
+        rec = ex.slots[index]
+        plugin.generation += 1
+        plugin.error = None
+        rec["state"] = SlotState.LOADING
+        rec["generation"] = plugin.generation
+        rec["format"] = plugin.info.format.encode()
+        rec["plugin_id"] = plugin.info.id.encode("utf-8")
+        rec["path"] = plugin.info.path.encode("utf-8")
+        rec["write_pos"] = rec["done_pos"] = plugin.position
+
+    def _request_load(self, index: int, plugin: "SandboxedPlugin") -> None:
+        ring = self._ring
+        ring.push(Op.PLUGIN_LOAD, index)
+        for param_id, value in plugin.values.items():
+            ring.push(Op.PLUGIN_PARAM, index, param_id, value)
+
+    def send_param(self, index: int, param_id: int, value: float) -> bool:
+        ring = self._ring
+        return ring is not None and ring.push(Op.PLUGIN_PARAM, index, param_id, value)
+
+    # ------------------------------------------------------------------
+    # Round-trip (thread de áudio)
+    # ------------------------------------------------------------------
+
+    def submit(self) -> None:
+        """Fim do bloco: acorda o host para processar o que foi escrito."""
+        if not self._dirty:
+            return
+        self._dirty = False
+        ex = self._ex
+        if ex is None:
+            return
+        ex.header["kick"] += 1
+        try:
+            os.write(self._kick_w, b"\1")
+        except (BlockingIOError, BrokenPipeError, OSError):
+            pass                              # pipe cheio: o host já vai acordar
+
+    def sync(self, ex: BlockExchange, index: int, needed: int) -> bool:
+        """Espera o host processar o slot até 'needed'. False se estourou o prazo."""
+        self.submit()
+        rec = ex.slots[index]
+        deadline = time.perf_counter() + SYNC_TIMEOUT_BLOCKS * ex.block / ex.sample_rate
+        ack = self._ack_r
+        while int(rec["done_pos"]) < needed:
+            left = deadline - time.perf_counter()
+            if left <= 0 or ex is not self._ex or int(rec["state"]) != SlotState.READY:
+                self.late_blocks += 1
+                return False
+            try:
+                ready, _, _ = select.select([ack], [], [], left)
+                if ready:
+                    os.read(ack, 4096)
+            except (OSError, ValueError):
+                return False
+        return True
+
+    def __repr__(self) -> str:
+        state = "alive" if self.alive else ("gave up" if self.gave_up else "down")
+        return (f"PluginSandbox({state}, plugins={len(self._plugins)}, restarts={self.restarts}, "
+                f"late={self.late_blocks})")
+
+
+# ------------------------------------------------------------------
+# Insert
+# ------------------------------------------------------------------
+
+class SandboxedPlugin:
+    """
+    Plugin LV2/CLAP como insert de Channel:
+
+        fx = SandboxedPlugin.create("clap:org.example.gain")
+        channel.add_insert(fx)
+    """
+
+    def __init__(self, info: PluginInfo, sandbox: Optional[PluginSandbox] = None) -> None:
+        self.info = info
+        self.sandbox = sandbox or PLUGIN_SANDBOX
+        self.values: Dict[int, float] = {}
+        self.position = 0                     # frames já entregues (contador absoluto)
+        self.generation = 0
+        self.error: Optional[str] = None
+        self.latency = 0
+        self.slot = self.sandbox.attach(self)
+
+    @classmethod
+    def create(cls, key: str, sandbox: Optional[PluginSandbox] = None) -> "SandboxedPlugin":
+        """Pela chave do Registry ('clap:<id>' / 'lv2:<uri>'), depois de scan_plugins()."""
+        info = Registry().get(REGISTRY_CATEGORY, key)
+        if info is None:
+            raise PluginNotFound(f"Plugin '{key}' não registrado (rode scan_plugins())")
+        return cls(info, sandbox)
+
+    # ------------------------------------------------------------------
+
+    def process(self, buf: np.ndarray) -> np.ndarray:
+        """buf (frames, 2) float32, processado no lugar — sai atrasado de latency."""
+        ex = self.sandbox._ex
+        if ex is None:
+            return buf
+        block = ex.block
+        for start in range(0, len(buf), block):
+            self._chunk(ex, buf[start:start + block].T)
+        return buf
+
+    def _chunk(self, ex: BlockExchange, planar: np.ndarray) -> None:
+        index = self.slot
+        rec = ex.slots[index]
+        rings = ex.rings[index]
+        frames = planar.shape[1]
+        pos = self.position
+        out_pos = pos - ex.block
+
+        ring_write(rings[0], pos, planar)
+        rec["write_pos"] = pos + frames       # publica depois da entrada
+        self.sandbox._dirty = True
+        self.position = pos + frames
+
+        ready = int(rec["state"]) == SlotState.READY and int(rec["loaded"]) == self.generation
+        if ready and int(rec["done_pos"]) < out_pos + frames:
+            ready = self.sandbox.sync(ex, index, out_pos + frames)
+        # Bypass lê a entrada de L frames atrás: mesma latência do plugin
+        ring_read(rings[1] if ready else rings[0], out_pos, planar)
+
+    # ------------------------------------------------------------------
+
+    def set_param(self, param_id: int, value: float) -> None:
+        self.values[param_id] = float(value)
+        self.sandbox.send_param(self.slot, param_id, float(value))
+
+    def set_sample_rate(self, sample_rate: int) -> None:
+        self.sandbox.reconfigure(sample_rate=sample_rate)
+
+    def close(self) -> None:
+        self.sandbox.detach(self)
+
+    def to_dict(self) -> dict:
+        return {"type": "plugin", "key": self.info.key,
+                "params": {str(k): v for k, v in sorted(self.values.items())}}
+
+    def __repr__(self) -> str:
+        return f"SandboxedPlugin('{self.info.key}', slot={self.slot}, latency={self.latency})"
+
+
+# Instância global
+PLUGIN_SANDBOX = PluginSandbox()
@@ -1 +1,349 @@
-"""Stub for instruments/midi.py"""
+# modules/instruments/midi.py
+"""
+Entrada MIDI ao vivo — teclado/controlador físico tocando o Synth da engine.
+
+Responsabilidade:
+    Abrir uma porta MIDI (python-rtmidi, ou mido como alternativa), receber
+    mensagens numa thread dedicada, carimbar cada uma com o relógio de
+    samples do audio thread e empurrar a forma compacta na fila sem lock
+    que o AudioCallback drena a cada bloco.
+
+Fluxo:
+    porta MIDI ──callback do backend──> _inbox (deque, só bytes + perf_counter)
+        └─> thread "daw-midi-in"
+                └─> event_from_raw()  → valida/mascara, descarta tipos não tratados
+                └─> to_packed()       → int compacto (+ canal-alvo, ver send())
+                └─> MidiEventQueue.push(packed, sample_time + latência)
+                        └─> AudioCallback → Mixer.process(frames, eventos)
+
+Notas vindas de comandos (NOTE_ON/NOTE_OFF do engine_host) entram pelo
+mesmo _inbox via send(): a fila é SPSC, então a thread "daw-midi-in" é o
+único produtor, e o instrumento só é tocado dentro do bloco de áudio —
+nunca em paralelo com Synth.process, e sempre pelo gate de mute/solo do
+Channel.
+
+Latência:
+    sample_time = SAMPLE_CLOCK.at(instante de chegada) + buffer_size.
+    Toda nota soa exatamente UM buffer depois de chegar, no sample certo
+    dentro do bloco — latência constante e sem jitter de bloco.
+
+Teste sem hardware:
+    service.open(virtual=True) cria uma porta virtual ALSA/JACK/CoreMIDI
+    ("Blender DAW In"). Conecte qualquer fonte a ela, ex:
+        aconnect -l ; aconnect <cliente:porta> "Blender DAW"
+        amidi -p virtual -S "90 3C 64"
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+import threading
+import time
+from collections import deque
+from typing import List, Optional, Tuple, Union
+
+from ...daw_engine.audio.config import ENGINE_CONFIG
+from ...daw_engine.audio.sampleclock import SAMPLE_CLOCK
+from ...daw_engine.core.logger import LOGGER
+from ...daw_engine.midi.events import event_from_raw
+from ...daw_engine.midi.queue import MidiEventQueue
+
+
+DEFAULT_PORT_NAME = "Blender DAW In"
+CLIENT_NAME = "Blender DAW"
+
+
+def available_backend() -> Optional[str]:
+    """Retorna 'rtmidi', 'mido' ou None conforme o que estiver instalado."""
+    try:
+        import rtmidi  # noqa: F401
+        return "rtmidi"
+    except ImportError:
+        pass
+    try:
+        import mido  # noqa: F401
+        return "mido"
+    except ImportError:
+        return None
+
+
+def list_input_ports() -> List[str]:
+    """Nomes das portas de entrada MIDI disponíveis (para popular a UI)."""
+    backend = available_backend()
+    try:
+        if backend == "rtmidi":
+            import rtmidi
+            probe = rtmidi.MidiIn()
+            try:
+                return list(probe.get_ports())
+            finally:
+                probe.delete()
+        if backend == "mido":
+            import mido
+            return list(mido.get_input_names())
+    except Exception as e:
+        LOGGER.warning("MidiInput", f"Falha ao listar portas MIDI: {e}")
+    return []
+
+
+class MidiInputService:
+    """
+    Serviço de entrada MIDI ao vivo.
+
+    Uso:
+        service = MidiInputService(queue)     # queue = AudioCallback.midi_queue
+        service.open("USB Keyboard")          # ou open(0), ou open(virtual=True)
+        ...
+        service.stop()                        # fecha a porta e para a thread
+
+    start() sobe só a thread (sem porta) — basta para send().
+
+    No addon o serviço vive no processo da engine (ipc/engine_host.py,
+    comandos MIDI_OPEN / MIDI_CLOSE): é lá que está o AudioCallback que
+    drena a fila e o SAMPLE_CLOCK que carimba as mensagens.
+    """
+
+    def __init__(self, queue: Optional[MidiEventQueue] = None) -> None:
+        self.queue: MidiEventQueue = queue or MidiEventQueue()
+
+        # Latência fixa em samples; None = um buffer (ENGINE_CONFIG.buffer_size)
+        self.latency_frames: Optional[int] = None
+
+        self._backend:   Optional[str] = None
+        self._port       = None
+        self._port_name: str = ""
+
+        # Mensagens cruas: (status, d1, d2, perf_counter, target)
+        # deque.append/popleft são atômicos — o callback do backend nunca bloqueia.
+        self._inbox: deque = deque()
+        self._wakeup = threading.Event()
+        self._running = False
+        self._thread: Optional[threading.Thread] = None
+
+        self._last_time: int = 0
+        self.received: int = 0
+        self.last_message: Optional[Tuple[int, int, int]] = None
+
+    # ------------------------------------------------------------------
+    # Ciclo de vida
+    # ------------------------------------------------------------------
+
+    def start(self) -> None:
+        """Inicia a thread de recepção (idempotente; não abre porta)."""
+        if self._thread is not None and self._thread.is_alive():
+            return
+        self._running = True
+        self._thread = threading.Thread(
+            target=self._run,
+            daemon=True,
+            name="daw-midi-in",
+        )
+        self._thread.start()
+
+    def stop(self) -> None:
+        """Fecha a porta (se houver) e para a thread de recepção."""
+        self.close()
+        self._running = False
+        self._wakeup.set()
+        if self._thread is not None and self._thread.is_alive():
+            self._thread.join(timeout=1.0)
+        self._thread = None
+        self._inbox.clear()
+
+    def open(
+        self,
+        port:    Union[int, str, None] = None,
+        virtual: bool = False,
+        name:    str  = DEFAULT_PORT_NAME,
+    ) -> bool:
+        """
+        Abre uma porta de entrada e inicia a thread de recepção (se parada).
+
+        port:    índice ou nome da porta (None = primeira disponível)
+        virtual: cria uma porta virtual chamada 'name' em vez de abrir uma real
+        """
+        self.close()
+
+        backend = available_backend()
+        if backend is None:
+            LOGGER.error("MidiInput", "Nenhum backend MIDI instalado (python-rtmidi ou mido).")
+            return False
+
+        try:
+            if backend == "rtmidi":
+                self._open_rtmidi(port, virtual, name)
+            else:
+                self._open_mido(port, virtual, name)
+        except Exception as e:
+            LOGGER.error("MidiInput", f"Falha ao abrir porta MIDI: {e}")
+            self._port = None
+            return False
+
+        self._backend = backend
+        self.start()
+
+        LOGGER.info("MidiInput", f"Entrada MIDI aberta: '{self._port_name}' ({backend})")
+        return True
+
+    def close(self) -> None:
+        """Fecha a porta. A thread continua de pé para send() (ver stop())."""
+        if self._port is None:
+            return
+
+        try:
+            if self._backend == "rtmidi":
+                self._port.cancel_callback()
+                self._port.close_port()
+                self._port.delete()
+            elif self._port is not None:
+                self._port.close()
+        except Exception:
+            pass
+
+        LOGGER.info("MidiInput", f"Entrada MIDI fechada: '{self._port_name}'")
+        self._port = None
+        self._port_name = ""
+        self._backend = None
+
+    # ------------------------------------------------------------------
+    # Backends — só copiam bytes + horário de chegada para _inbox
+    # ------------------------------------------------------------------
+
+    def _open_rtmidi(self, port, virtual: bool, name: str) -> None:
+        import rtmidi
+
+        midi_in = rtmidi.MidiIn(name=CLIENT_NAME)
+        if virtual:
+            midi_in.open_virtual_port(name)
+            self._port_name = name
+        else:
+            ports = midi_in.get_ports()
+            index = self._resolve_port(port, ports)
+            midi_in.open_port(index)
+            self._port_name = ports[index]
+
+        midi_in.ignore_types(sysex=True, timing=True, active_sense=True)
+        midi_in.set_callback(self._on_rtmidi)
+        self._port = midi_in
+
+    def _open_mido(self, port, virtual: bool, name: str) -> None:
+        import mido
+
+        if virtual:
+            self._port = mido.open_input(name, virtual=True, callback=self._on_mido)
+            self._port_name = name
+        else:
+            ports = mido.get_input_names()
+            index = self._resolve_port(port, ports)
+            self._port = mido.open_input(ports[index], callback=self._on_mido)
+            self._port_name = ports[index]
+
+    @staticmethod
+    def _resolve_port(port, ports: List[str]) -> int:
+        if not ports:
+            raise RuntimeError("Nenhuma porta de entrada MIDI encontrada.")
+        if port is None:
+            return 0
+        if isinstance(port, int):
+            if not 0 <= port < len(ports):
+                raise RuntimeError(f"Porta MIDI {port} inexistente ({len(ports)} disponíveis).")
+            return port
+        for i, p in enumerate(ports):
+            if p == port or p.startswith(port):
+                return i
+        raise RuntimeError(f"Porta MIDI '{port}' não encontrada.")
+
+    def _on_rtmidi(self, message, data=None) -> None:
+        arrived = time.perf_counter()
+        raw, _delta = message
+        if raw:
+            self._inbox.append((
+                raw[0],
+                raw[1] if len(raw) > 1 else 0,
+                raw[2] if len(raw) > 2 else 0,
+                arrived,
+                0,
+            ))
+            self._wakeup.set()
+
+    def _on_mido(self, msg) -> None:
+        arrived = time.perf_counter()
+        raw = msg.bytes()
+        if raw:
+            self._inbox.append((
+                raw[0],
+                raw[1] if len(raw) > 1 else 0,
+                raw[2] if len(raw) > 2 else 0,
+                arrived,
+                0,
+            ))
+            self._wakeup.set()
+
+    def send(self, status: int, d1: int, d2: int = 0, target: int = 0) -> None:
+        """
+        Injeta uma mensagem como se tivesse chegado agora pela porta.
+
+        target: canal do Mixer + 1 que recebe o evento (0 = canal armado
+        para entrada ao vivo). Pode ser chamado de qualquer thread — só
+        faz append no _inbox; quem enfileira é a thread de recepção, que
+        precisa estar de pé (start() ou open()).
+        """
+        self._inbox.append((status, d1, d2, time.perf_counter(), target))
+        self._wakeup.set()
+
+    # ------------------------------------------------------------------
+    # Thread dedicada — converte e enfileira para o audio thread
+    # ------------------------------------------------------------------
+
+    def _run(self) -> None:
+        inbox = self._inbox
+        while self._running:
+            self._wakeup.wait(0.1)
+            self._wakeup.clear()
+            while inbox:
+                status, d1, d2, arrived, target = inbox.popleft()
+                self._dispatch(status, d1, d2, arrived, target)
+
+    def _dispatch(
+        self, status: int, d1: int, d2: int, arrived: float, target: int = 0,
+    ) -> None:
+        event = event_from_raw(status, d1, d2)
+        if event is None:
+            return      # clock, sysex... não tratados
+
+        latency = self.latency_frames
+        if latency is None:
+            latency = ENGINE_CONFIG.buffer_size
+
+        # Relógio monotônico na fila — a âncora do SAMPLE_CLOCK é
+        # remarcada a cada bloco e pode oscilar alguns samples.
+        sample_time = max(SAMPLE_CLOCK.at(arrived) + latency, self._last_time)
+        self._last_time = sample_time
+
+        if self.queue.push(event.to_packed() | ((target & 0xFF) << 24), sample_time):
+            self.received += 1
+            self.last_message = (status, d1, d2)
+
+    # ------------------------------------------------------------------
+    # Consulta
+    # ------------------------------------------------------------------
+
+    @property
+    def is_open(self) -> bool:
+        return self._port is not None and self._running
+
+    @property
+    def port_name(self) -> str:
+        return self._port_name
+
+    @property
+    def backend(self) -> Optional[str]:
+        return self._backend
+
+    def __repr__(self) -> str:
+        status = f"'{self._port_name}' via {self._backend}" if self.is_open else "fechado"
+        return f"MidiInputService({status}, recebidos={self.received})"
+
+
+# Instância global
+MIDI_INPUT = MidiInputService()
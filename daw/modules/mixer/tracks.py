@@ -1 +1,227 @@
-"""Stub for mixer/tracks.py"""
+# modules/mixer/tracks.py
+"""
+Freeze / unfreeze de faixas do mixer.
+
+Por que:
+- Faixas de instrumento pesadas (muitas vozes, cadeia de inserts longa)
+  custam CPU no callback a cada bloco, mesmo sem nenhuma edição. Congelar
+  troca CPU por disco: o instrumento + inserts da faixa são renderizados
+  offline uma vez e o canal passa a tocar o áudio pronto.
+
+Fluxo:
+    freeze(mixer, snapshot, i)
+        └─> worker: RENDER_CACHE.render(...)   (mixer/render.py — render
+            offline pré-fader, reaproveitado se o digest já estiver em cache)
+                └─> poll() na thread principal: channel.frozen = FrozenPlayer
+    unfreeze(mixer, i)
+        └─> channel.frozen = None — instrumento e inserts voltam ao vivo
+
+O canal continua aplicando volume/pan/mute/solo sobre o áudio congelado
+(o render é pré-fader), então mixar uma faixa congelada não exige
+descongelar. Se o preset ou os inserts mudarem enquanto o render roda, o
+resultado é descartado (o digest não bate mais).
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+import queue
+import threading
+from concurrent.futures import Future, ThreadPoolExecutor
+from enum import Enum
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+import numpy as np
+
+from ...daw_engine.audio.arena import ENGINE_ARENA
+from ...daw_engine.audio.state import ENGINE_STATE
+from ...daw_engine.core.logger import LOGGER
+from ...daw_engine.core.timeline import TimelineSnapshot
+from ...daw_engine.mixer.mixer import Channel, Mixer
+from ...daw_engine.mixer.render import RENDER_CACHE, RenderCache, TrackRender
+
+
+class FreezeState(Enum):
+    LIVE     = "live"
+    FREEZING = "freezing"
+    FROZEN   = "frozen"
+
+
+# ------------------------------------------------------------------
+# Nó de playback do áudio congelado
+# ------------------------------------------------------------------
+
+class FrozenPlayer:
+    """
+    Toca um TrackRender no lugar do instrumento + inserts de um canal.
+    O áudio é o memmap do cache — só as páginas tocadas são lidas.
+
+    'position' é o frame da timeline do próximo bloco; só avança com o
+    transport tocando (ENGINE_STATE.playing) e é reposicionado por seek()
+    no locate. Parado, o player devolve silêncio sem andar.
+    """
+
+    def __init__(self, render: TrackRender, position: int = 0, sample_rate: int = 0) -> None:
+        self.render      = render
+        self.audio       = render.audio
+        self.offset      = render.offset
+        self.position    = int(position)
+        self.sample_rate = sample_rate      # rate do render — Channel.set_sample_rate descongela se mudar
+
+    @property
+    def digest(self) -> str:
+        return self.render.digest
+
+    def seek(self, frame: int) -> None:
+        self.position = max(0, int(frame))
+
+    def skip(self, frames: int) -> None:
+        if ENGINE_STATE.playing:
+            self.position += frames
+
+    def process(self, frames: int) -> np.ndarray:
+        out = ENGINE_ARENA.zeros((frames, 2))
+        if not ENGINE_STATE.playing:
+            return out
+        a = self.position - self.offset
+        b = a + frames
+        lo, hi = max(a, 0), min(b, len(self.audio))
+        if lo < hi:
+            out[lo - a:hi - a] = self.audio[lo:hi]
+        self.position += frames
+        return out
+
+    def __repr__(self) -> str:
+        return f"FrozenPlayer({self.digest[:8]}, {len(self.audio)} frames @ {self.offset})"
+
+
+# ------------------------------------------------------------------
+# Freeze / unfreeze
+# ------------------------------------------------------------------
+
+class TrackFreezer:
+    """
+    Congela faixas num worker e troca o canal para o FrozenPlayer.
+
+    Callbacks (on_done(index, ok)) e a troca em si são entregues por
+    poll() na thread principal — mesmo esquema do ProjectLoader. Com
+    deliver_in_thread=True tudo acontece direto no worker (scripts/testes).
+    """
+
+    def __init__(self, cache: Optional[RenderCache] = None, max_workers: int = 1) -> None:
+        self.cache = cache or RENDER_CACHE
+        self.deliver_in_thread = False
+        self._pool = ThreadPoolExecutor(max_workers=max_workers, thread_name_prefix="daw-freeze")
+        self._lock = threading.Lock()
+        self._pending: Dict[int, Future] = {}           # id(channel) → render em andamento
+        self._events: "queue.SimpleQueue[Tuple[Callable, tuple]]" = queue.SimpleQueue()
+        self.sample_position: int = 0                   # posição usada para novos players
+
+    # ------------------------------------------------------------------
+
+    def state(self, mixer: Mixer, index: int) -> FreezeState:
+        ch = mixer.get_channel(index)
+        if ch is None:
+            return FreezeState.LIVE
+        if ch.frozen is not None:
+            return FreezeState.FROZEN
+        with self._lock:
+            return FreezeState.FREEZING if id(ch) in self._pending else FreezeState.LIVE
+
+    def freeze(
+        self,
+        mixer:    Mixer,
+        snapshot: TimelineSnapshot,
+        index:    int,
+        on_done:  Optional[Callable[[int, bool], None]] = None,
+    ) -> Optional[Future]:
+        """Agenda o render offline da faixa 'index'. None se não há o que congelar."""
+        ch = mixer.get_channel(index)
+        if ch is None or index >= len(snapshot.tracks) or not snapshot.tracks[index].clips:
+            LOGGER.warning("Freeze", f"Faixa {index}: nada para congelar")
+            return None
+        if ch.frozen is not None:
+            return None
+        with self._lock:
+            if id(ch) in self._pending:
+                return self._pending[id(ch)]
+            track = snapshot.tracks[index]
+            sr = mixer.sample_rate
+            digest = self.cache.digest(track, ch, sr)   # na thread chamadora — estado atual do canal
+            fut = self._pool.submit(self.cache.render, track, ch, sr, digest)
+            self._pending[id(ch)] = fut
+        LOGGER.info("Freeze", f"Congelando '{track.name}' (canal {index})...")
+        fut.add_done_callback(lambda f: self._post(self._finish, ch, index, track, sr, digest, f, on_done))
+        return fut
+
+    def _finish(self, ch: Channel, index: int, track: Any, sr: int, digest: str, fut: Future,
+                on_done: Optional[Callable[[int, bool], None]]) -> None:
+        with self._lock:
+            self._pending.pop(id(ch), None)
+        ok = False
+        try:
+            render: TrackRender = fut.result()
+            if self.cache.digest(track, ch, sr) == digest:
+                ch.frozen = FrozenPlayer(render, self.sample_position, sr)
+                ch.instrument.all_notes_off()
+                ok = True
+                LOGGER.info("Freeze", f"Canal '{ch.name}' congelado ({len(render.audio)} frames)")
+            else:
+                LOGGER.warning("Freeze", f"Canal '{ch.name}' mudou durante o render — freeze descartado")
+        except Exception as e:
+            LOGGER.error("Freeze", f"Falha ao congelar '{ch.name}': {e}")
+        if on_done is not None:
+            on_done(index, ok)
+
+    def unfreeze(self, mixer: Mixer, index: int) -> bool:
+        """Volta o canal ao processamento ao vivo."""
+        ch = mixer.get_channel(index)
+        if ch is None or ch.frozen is None:
+            return False
+        ch.frozen = None
+        LOGGER.info("Freeze", f"Canal '{ch.name}' descongelado")
+        return True
+
+    def frozen_indices(self, mixer: Mixer) -> List[int]:
+        return [i for i in range(mixer.channel_count) if mixer.get_channel(i).frozen is not None]
+
+    def seek(self, mixer: Mixer, seconds: float) -> None:
+        """Reposiciona todos os players congelados (chamar no locate do transport)."""
+        self.sample_position = int(round(max(0.0, seconds) * mixer.sample_rate))
+        for i in self.frozen_indices(mixer):
+            mixer.get_channel(i).frozen.seek(self.sample_position)
+
+    # ------------------------------------------------------------------
+    # Entrega na thread principal
+    # ------------------------------------------------------------------
+
+    def _post(self, fn: Callable, *args: Any) -> None:
+        if self.deliver_in_thread:
+            try:
+                fn(*args)
+            except Exception as e:
+                LOGGER.error("Freeze", f"Erro em callback: {e}")
+        else:
+            self._events.put((fn, args))
+
+    def poll(self, max_events: int = 64) -> int:
+        """Aplica freezes concluídos. Chamar na thread principal. Retorna quantos."""
+        n = 0
+        while n < max_events:
+            try:
+                fn, args = self._events.get_nowait()
+            except queue.Empty:
+                break
+            try:
+                fn(*args)
+            except Exception as e:
+                LOGGER.error("Freeze", f"Erro em callback: {e}")
+            n += 1
+        return n
+
+    def shutdown(self) -> None:
+        self._pool.shutdown(wait=False, cancel_futures=True)
+
+
+# Instância global
+FREEZER = TrackFreezer()
@@ -1 +1,513 @@
-"""Stub for playlist/snapping.py"""
+# modules/playlist/snapping.py
+"""
+Snapping compartilhado — grade musical + alvos magnéticos.
+
+Responsabilidade:
+    Um único serviço (SNAP) usado pela playlist, pela timeline e pelo piano
+    roll, em vez de cada editor arredondar por conta própria e recalcular
+    as linhas da grade a cada redraw.
+
+Peças:
+    TempoMap        — segmentos de andamento/compasso (em beats = semínimas)
+                      com conversão beat ↔ segundo por bisect.
+    SnapGrid        — linhas de compasso, tempo e subdivisão para a faixa
+                      visível, pré-calculadas em arrays e memorizadas por
+                      (faixa, subdivisão). A subdivisão engrossa sozinha
+                      quando as linhas ficariam a menos de MIN_LINE_PX.
+    MagneticTargets — bordas de clips, marcadores e playhead num array
+                      ordenado; o alvo mais próximo sai por bisect.
+    SnapEngine      — combina os dois: alvo magnético dentro da tolerância
+                      em pixels tem prioridade, senão a grade. Com uma
+                      timeline ligada (bind_timeline), os alvos seguem a
+                      versão do snapshot: cada commit de faixa/clip
+                      refaz o array na próxima consulta.
+
+Unidades: a grade trabalha em beats; os alvos magnéticos são guardados em
+segundos (como os clips) e convertidos pelo TempoMap quando a consulta é
+em beats.
+
+Sem bpy — lógica pura.
+"""
+from __future__ import annotations
+
+import bisect
+from dataclasses import dataclass
+from typing import Any, Dict, Iterable, List, Optional, Sequence, Tuple
+
+import numpy as np
+
+from ...daw_engine.core.constants import (
+    DEFAULT_BPM,
+    DEFAULT_TIME_SIGNATURE_DENOMINATOR,
+    DEFAULT_TIME_SIGNATURE_NUMERATOR,
+)
+
+
+MIN_LINE_PX = 6.0           # espaçamento mínimo entre linhas desenhadas
+MAX_GRID_LINES = 4096       # teto absoluto de linhas por consulta
+
+# Níveis das linhas devolvidas por SnapGrid.lines()
+LEVEL_BAR  = 0
+LEVEL_BEAT = 1
+LEVEL_SUB  = 2
+
+
+# ------------------------------------------------------------------
+# Mapa de andamento
+# ------------------------------------------------------------------
+
+@dataclass
+class TempoSegment:
+    """
+    Trecho com andamento e compasso constantes, a partir de 'beat'.
+    Mudanças de compasso devem cair no início de um compasso.
+    """
+    beat:        float = 0.0
+    bpm:         float = float(DEFAULT_BPM)
+    numerator:   int   = DEFAULT_TIME_SIGNATURE_NUMERATOR
+    denominator: int   = DEFAULT_TIME_SIGNATURE_DENOMINATOR
+
+    @property
+    def beats_per_bar(self) -> float:
+        # beat = semínima; 6/8 → 3 semínimas por compasso
+        return self.numerator * 4.0 / self.denominator
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {
+            "beat": self.beat, "bpm": self.bpm,
+            "numerator": self.numerator, "denominator": self.denominator,
+        }
+
+    @classmethod
+    def from_dict(cls, data: Dict[str, Any]) -> "TempoSegment":
+        return cls(
+            beat=data.get("beat", 0.0),
+            bpm=data.get("bpm", float(DEFAULT_BPM)),
+            numerator=data.get("numerator", DEFAULT_TIME_SIGNATURE_NUMERATOR),
+            denominator=data.get("denominator", DEFAULT_TIME_SIGNATURE_DENOMINATOR),
+        )
+
+
+class TempoMap:
+    """
+    Sequência de TempoSegments ordenada por beat.
+
+    Para cada segmento guarda o tempo (s) e o nº do compasso no seu início,
+    então beat ↔ segundo ↔ compasso é um bisect + uma conta linear.
+    'version' muda a cada edição — caches (SnapGrid) comparam com ela.
+    """
+
+    def __init__(self, segments: Optional[Iterable[TempoSegment]] = None) -> None:
+        self._segments: List[TempoSegment] = list(segments or [TempoSegment()])
+        self.version = 0
+        self._rebuild()
+
+    @classmethod
+    def constant(cls, bpm: float, numerator: int = 4, denominator: int = 4) -> "TempoMap":
+        return cls([TempoSegment(0.0, bpm, numerator, denominator)])
+
+    # ------------------------------------------------------------------
+    # Edição
+    # ------------------------------------------------------------------
+
+    def set_tempo(self, beat: float, bpm: float,
+                  numerator: Optional[int] = None, denominator: Optional[int] = None) -> TempoSegment:
+        """Insere (ou substitui) uma mudança de andamento/compasso em 'beat'."""
+        i = bisect.bisect_right(self._beats, beat) - 1
+        prev = self._segments[max(i, 0)]
+        seg = TempoSegment(
+            beat=max(0.0, beat),
+            bpm=bpm,
+            numerator=numerator or prev.numerator,
+            denominator=denominator or prev.denominator,
+        )
+        if i >= 0 and self._segments[i].beat == seg.beat:
+            self._segments[i] = seg
+        else:
+            self._segments.insert(i + 1, seg)
+        self._rebuild()
+        return seg
+
+    def set_constant(self, bpm: float, numerator: int = 4, denominator: int = 4) -> None:
+        self._segments = [TempoSegment(0.0, bpm, numerator, denominator)]
+        self._rebuild()
+
+    def remove_at(self, beat: float) -> bool:
+        i = bisect.bisect_left(self._beats, beat)
+        if i == 0 or i >= len(self._segments) or self._segments[i].beat != beat:
+            return False            # o primeiro segmento nunca sai
+        del self._segments[i]
+        self._rebuild()
+        return True
+
+    def _rebuild(self) -> None:
+        self._segments.sort(key=lambda s: s.beat)
+        self._segments[0].beat = 0.0
+        self._beats: List[float] = [s.beat for s in self._segments]
+        self._times: List[float] = []
+        self._bars:  List[float] = []
+        t = 0.0
+        bar = 0.0
+        for i, seg in enumerate(self._segments):
+            if i:
+                p = self._segments[i - 1]
+                span = seg.beat - p.beat
+                t += span * 60.0 / p.bpm
+                bar += span / p.beats_per_bar
+            self._times.append(t)
+            self._bars.append(bar)
+        self.version += 1
+
+    # ------------------------------------------------------------------
+    # Conversões
+    # ------------------------------------------------------------------
+
+    def segment_at_beat(self, beat: float) -> int:
+        return max(0, bisect.bisect_right(self._beats, beat) - 1)
+
+    def segment_at_time(self, t: float) -> int:
+        return max(0, bisect.bisect_right(self._times, t) - 1)
+
+    def beat_to_time(self, beat: float) -> float:
+        i = self.segment_at_beat(beat)
+        seg = self._segments[i]
+        return self._times[i] + (beat - seg.beat) * 60.0 / seg.bpm
+
+    def time_to_beat(self, t: float) -> float:
+        i = self.segment_at_time(t)
+        seg = self._segments[i]
+        return seg.beat + (t - self._times[i]) * seg.bpm / 60.0
+
+    def beats_to_times(self, beats: np.ndarray) -> np.ndarray:
+        """Versão vetorizada de beat_to_time."""
+        seg_beats = np.asarray(self._beats)
+        idx = np.clip(np.searchsorted(seg_beats, beats, side="right") - 1, 0, None)
+        bpm = np.array([s.bpm for s in self._segments])[idx]
+        return np.asarray(self._times)[idx] + (beats - seg_beats[idx]) * 60.0 / bpm
+
+    def times_to_beats(self, times: np.ndarray) -> np.ndarray:
+        """Versão vetorizada de time_to_beat."""
+        seg_times = np.asarray(self._times)
+        idx = np.clip(np.searchsorted(seg_times, times, side="right") - 1, 0, None)
+        bpm = np.array([s.bpm for s in self._segments])[idx]
+        return np.asarray(self._beats)[idx] + (times - seg_times[idx]) * bpm / 60.0
+
+    def bar_of(self, beat: float) -> Tuple[int, float]:
+        """(nº do compasso a partir de 0, beat de início desse compasso)."""
+        i = self.segment_at_beat(beat)
+        seg = self._segments[i]
+        k = int((beat - seg.beat) // seg.beats_per_bar + 1e-9)
+        return int(self._bars[i]) + k, seg.beat + k * seg.beats_per_bar
+
+    @property
+    def segments(self) -> List[TempoSegment]:
+        return list(self._segments)
+
+    # ------------------------------------------------------------------
+    # Serialização
+    # ------------------------------------------------------------------
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {"segments": [s.to_dict() for s in self._segments]}
+
+    def from_dict(self, data: Dict[str, Any]) -> None:
+        segs = [TempoSegment.from_dict(d) for d in data.get("segments", [])]
+        self._segments = segs or [TempoSegment()]
+        self._rebuild()
+
+    def __repr__(self) -> str:
+        return f"TempoMap({len(self._segments)} segmentos)"
+
+
+# ------------------------------------------------------------------
+# Grade
+# ------------------------------------------------------------------
+
+class SnapGrid:
+    """
+    Linhas de grade e quantização sob um TempoMap.
+
+    lines() devolve (beats, levels) para a faixa visível; o resultado é
+    memorizado até a faixa, a subdivisão efetiva ou o TempoMap mudarem —
+    um redraw sem scroll/zoom não recalcula nada.
+    """
+
+    def __init__(self, tempo: Optional[TempoMap] = None) -> None:
+        self.tempo = tempo or TempoMap()
+        # Poucas entradas: um redraw pede a grade de snap e a da régua
+        self._cache: Dict[Tuple, Tuple[np.ndarray, np.ndarray]] = {}
+
+    # ------------------------------------------------------------------
+    # Linhas
+    # ------------------------------------------------------------------
+
+    def effective_subdivision(self, subdivision: float, px_per_beat: float) -> float:
+        """
+        Dobra a subdivisão até as linhas ficarem a >= MIN_LINE_PX. Com zoom
+        muito afastado pode passar de 1 beat (linhas só de compasso).
+        """
+        sub = max(subdivision, 1e-6)
+        while sub * px_per_beat < MIN_LINE_PX and sub < 1 << 16:
+            sub *= 2.0
+        return sub
+
+    def lines(
+        self,
+        beat0:       float,
+        beat1:       float,
+        subdivision: float = 1.0,
+        px_per_beat: Optional[float] = None,
+    ) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Posições (beats) e níveis (LEVEL_BAR/BEAT/SUB) das linhas em [beat0, beat1].
+
+        px_per_beat: se dado, engrossa a subdivisão para caber na largura.
+        """
+        if px_per_beat is not None:
+            subdivision = self.effective_subdivision(subdivision, px_per_beat)
+
+        key = (beat0, beat1, subdivision, self.tempo.version)
+        cached = self._cache.get(key)
+        if cached is not None:
+            return cached
+
+        beats: List[np.ndarray] = []
+        levels: List[np.ndarray] = []
+        segs = self.tempo.segments
+        i0 = self.tempo.segment_at_beat(beat0)
+
+        for i in range(i0, len(segs)):
+            seg = segs[i]
+            if seg.beat > beat1:
+                break
+            seg_end = segs[i + 1].beat if i + 1 < len(segs) else beat1 + subdivision
+            lo = max(beat0, seg.beat)
+            hi = min(beat1, seg_end)
+            bpb = seg.beats_per_bar
+
+            # Linhas são múltiplos de 'step' contados a partir do início do segmento
+            step = subdivision if subdivision <= bpb else bpb * np.ceil(subdivision / bpb)
+            k0 = np.ceil((lo - seg.beat) / step - 1e-9)
+            k1 = np.floor((hi - seg.beat) / step + 1e-9)
+            if seg_end <= hi and i + 1 < len(segs):
+                k1 = min(k1, np.ceil((seg_end - seg.beat) / step - 1e-9) - 1)
+            if k1 < k0:
+                continue
+            count = int(min(k1 - k0 + 1, MAX_GRID_LINES - sum(len(b) for b in beats)))
+            if count <= 0:
+                break
+
+            b = seg.beat + (k0 + np.arange(count)) * step
+            rel = b - seg.beat
+            lvl = np.full(count, LEVEL_SUB, dtype=np.int8)
+            lvl[np.isclose(np.mod(rel + 1e-9, 1.0), 0.0, atol=1e-6)] = LEVEL_BEAT
+            lvl[np.isclose(np.mod(rel + 1e-9, bpb), 0.0, atol=1e-6)] = LEVEL_BAR
+            beats.append(b)
+            levels.append(lvl)
+
+        if beats:
+            result = (np.concatenate(beats), np.concatenate(levels))
+        else:
+            result = (np.empty(0), np.empty(0, np.int8))
+        if len(self._cache) >= 8:
+            self._cache.clear()
+        self._cache[key] = result
+        return result
+
+    def bar_labels(self, beat0: float, beat1: float, px_per_beat: float,
+                   min_px: float = 40.0) -> List[Tuple[float, int]]:
+        """(beat, nº do compasso a partir de 1) para rotular a régua sem sobrepor texto."""
+        out: List[Tuple[float, int]] = []
+        last_x = -1e9
+        beats, levels = self.lines(beat0, beat1, 1.0, px_per_beat)
+        for b in beats[levels == LEVEL_BAR]:
+            x = b * px_per_beat
+            if x - last_x >= min_px:
+                out.append((float(b), self.tempo.bar_of(float(b))[0] + 1))
+                last_x = x
+        return out
+
+    # ------------------------------------------------------------------
+    # Quantização
+    # ------------------------------------------------------------------
+
+    def snap_beat(self, beat: float, subdivision: float) -> float:
+        """Arredonda para a linha de grade mais próxima (relativa ao segmento)."""
+        seg = self.tempo.segments[self.tempo.segment_at_beat(beat)]
+        sub = max(subdivision, 1e-6)
+        return seg.beat + float(round((beat - seg.beat) / sub)) * sub
+
+    def floor_beat(self, beat: float, subdivision: float) -> float:
+        seg = self.tempo.segments[self.tempo.segment_at_beat(beat)]
+        sub = max(subdivision, 1e-6)
+        return seg.beat + float(np.floor((beat - seg.beat) / sub + 1e-9)) * sub
+
+    def snap_time(self, t: float, subdivision: float) -> float:
+        return self.tempo.beat_to_time(self.snap_beat(self.tempo.time_to_beat(t), subdivision))
+
+
+# ------------------------------------------------------------------
+# Alvos magnéticos
+# ------------------------------------------------------------------
+
+class MagneticTargets:
+    """
+    Posições (s) que "atraem" o cursor: bordas de clips, marcadores, playhead.
+
+    rebuild() é O(n log n) e só roda quando clips/marcadores mudam; nearest()
+    é O(log n). O playhead muda todo frame e fica fora do array.
+    """
+
+    def __init__(self) -> None:
+        self._times: List[float] = []
+        self.playhead: Optional[float] = None
+        self.version: int = -1          # versão do TimelineSnapshot dos alvos atuais
+
+    def rebuild(
+        self,
+        clips:   Iterable[Any] = (),
+        markers: Iterable[Any] = (),
+        extra:   Iterable[float] = (),
+    ) -> None:
+        times = set(extra)
+        for c in clips:
+            times.add(float(c.start))
+            times.add(float(c.start + c.duration))
+        for m in markers:
+            times.add(float(m.time))
+        self._times = sorted(times)
+
+    def rebuild_from_tracks(self, tracks: Iterable[Any], markers: Iterable[Any] = ()) -> None:
+        self.rebuild((c for t in tracks for c in t.clips), markers)
+
+    def sync(self, snapshot: Any, markers: Iterable[Any] = ()) -> bool:
+        """Refaz a partir de um TimelineSnapshot se a versão mudou. True se refez."""
+        if snapshot.version == self.version:
+            return False
+        self.rebuild_from_tracks(snapshot.tracks, markers)
+        self.version = snapshot.version
+        return True
+
+    def nearest(
+        self,
+        t: float,
+        max_distance: float,
+        exclude: Sequence[float] = (),
+    ) -> Optional[float]:
+        """
+        Alvo mais próximo de t a no máximo max_distance, ou None.
+        exclude: posições a ignorar (ex: as bordas do próprio clip arrastado).
+        """
+        best: Optional[float] = None
+        best_d = max_distance
+        times = self._times
+        i = bisect.bisect_left(times, t)
+
+        # Anda para os dois lados só enquanto ainda dentro da tolerância
+        j = i
+        while j < len(times) and times[j] - t <= best_d:
+            if times[j] not in exclude:
+                best, best_d = times[j], times[j] - t
+                break
+            j += 1
+        j = i - 1
+        while j >= 0 and t - times[j] <= best_d:
+            if times[j] not in exclude:
+                if t - times[j] < best_d or best is None:
+                    best, best_d = times[j], t - times[j]
+                break
+            j -= 1
+
+        if self.playhead is not None and abs(self.playhead - t) < best_d:
+            best = self.playhead
+        return best
+
+    def in_range(self, t0: float, t1: float) -> List[float]:
+        return self._times[bisect.bisect_left(self._times, t0):bisect.bisect_right(self._times, t1)]
+
+    def __len__(self) -> int:
+        return len(self._times)
+
+
+# ------------------------------------------------------------------
+# Serviço
+# ------------------------------------------------------------------
+
+class SnapEngine:
+    """
+    Snapping único da DAW.
+
+    Uso (playlist, em segundos):
+        t = SNAP.snap_time(mouse_t, subdivision=0.25, pps=view.pps)
+    Uso (piano roll, em beats):
+        b = SNAP.snap_beat(mouse_beat, subdivision=0.25, px_per_beat=beat_w)
+    """
+
+    def __init__(self, tempo: Optional[TempoMap] = None) -> None:
+        self.tempo    = tempo or TempoMap()
+        self.grid     = SnapGrid(self.tempo)
+        self.magnets  = MagneticTargets()
+        self.enabled:  bool  = True
+        self.magnetic: bool  = True
+        self.magnet_px: float = 8.0     # tolerância magnética em pixels
+        self.timeline: Optional[Any] = None
+
+    def bind_timeline(self, timeline: Optional[Any]) -> None:
+        """Timeline cujos clips viram alvos magnéticos (Engine: projeto atual)."""
+        self.timeline = timeline
+        self.magnets.version = -1
+        if timeline is None:
+            self.magnets.rebuild()
+
+    def _sync_magnets(self) -> None:
+        # Uma comparação de inteiro por consulta; o rebuild só roda após commit
+        if self.timeline is not None:
+            self.magnets.sync(self.timeline.snapshot)
+
+    def snap_time(
+        self,
+        t:           float,
+        subdivision: float = 1.0,
+        pps:         Optional[float] = None,
+        exclude:     Sequence[float] = (),
+    ) -> float:
+        """Snap em segundos. pps (pixels/s) habilita o ímã com tolerância em pixels."""
+        if not self.enabled:
+            return t
+        self._sync_magnets()
+        if self.magnetic and pps:
+            hit = self.magnets.nearest(t, self.magnet_px / pps, exclude)
+            if hit is not None:
+                return hit
+        return self.grid.snap_time(t, subdivision)
+
+    def snap_beat(
+        self,
+        beat:        float,
+        subdivision: float = 1.0,
+        px_per_beat: Optional[float] = None,
+        exclude:     Sequence[float] = (),
+    ) -> float:
+        """Snap em beats (piano roll). Alvos magnéticos convertidos pelo TempoMap."""
+        if not self.enabled:
+            return beat
+        self._sync_magnets()
+        if self.magnetic and px_per_beat and len(self.magnets):
+            t = self.tempo.beat_to_time(beat)
+            tol = self.tempo.beat_to_time(beat + self.magnet_px / px_per_beat) - t
+            hit = self.magnets.nearest(t, tol, [self.tempo.beat_to_time(e) for e in exclude])
+            if hit is not None:
+                return self.tempo.time_to_beat(hit)
+        return self.grid.snap_beat(beat, subdivision)
+
+    def sync_tempo(self, bpm: float, numerator: int = 4, denominator: int = 4) -> None:
+        """Mapa constante a partir do transporte (projetos sem mudanças de andamento)."""
+        segs = self.tempo.segments
+        if (len(segs) == 1 and segs[0].bpm == bpm
+                and segs[0].numerator == numerator and segs[0].denominator == denominator):
+            return
+        self.tempo.set_constant(bpm, numerator, denominator)
+
+
+# Instância global
+SNAP = SnapEngine()
@@ -1 +1,463 @@
-"""Stub for project/load.py"""
+# modules/project/load.py
+"""
+Abertura rápida de projetos — estrutura síncrona, mídia em segundo plano.
+
+Responsabilidade:
+    open() devolve o Project assim que o JSON é lido (timeline, faixas,
+    clips). Tudo que toca disco por arquivo de mídia roda num pool de
+    threads, com progresso e aviso por clip:
+
+        1. verificação   — os.stat (existe? tamanho/mtime para o cache)
+        2. cabeçalho     — soundfile.info (sample rate, canais, frames)
+        3. picos         — PeakPyramid do DerivedCache, se existir
+        4. pré-carga     — decodifica só os primeiros PRELOAD_SECONDS
+
+    Quando o passo 4 de um arquivo termina, todos os clips que o usam ficam
+    READY (tocáveis). A decodificação completa é adiada: ensure_decoded()
+    sob demanda. Picos ausentes são gerados numa segunda fase, depois que
+    toda a pré-carga terminou — não competem com o que o usuário vai ouvir.
+
+Ordem:
+    Arquivos são enfileirados pelo início do primeiro clip que os usa —
+    o começo do arranjo fica tocável primeiro.
+
+Threads:
+    Callbacks (on_progress, on_clip_ready, on_finished) são entregues em
+    poll(), chamado pela thread principal (timer do Blender) — nunca tocam
+    bpy fora dela. deliver_in_thread=True entrega direto do worker
+    (uso sem UI / testes).
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+import os
+import queue
+import threading
+import time
+from concurrent.futures import Future, ThreadPoolExecutor
+from dataclasses import dataclass, field
+from enum import Enum
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+import numpy as np
+
+from ...daw_engine.core.constants import ClipType
+from ...daw_engine.core.logger import LOGGER
+from ...daw_engine.core.project import Project
+from ...daw_engine.core.media import DERIVED_CACHE, MEDIA_POOL
+from ..timeline.zoom import PEAK_BASE_BLOCK, PeakPyramid
+
+
+PRELOAD_SECONDS = 2.0       # áudio decodificado na abertura, por arquivo
+DEFAULT_WORKERS = min(8, (os.cpu_count() or 4))
+
+
+PEAK_PARAMS = {"base": PEAK_BASE_BLOCK}
+
+
+def media_cache_id(path: str, size: int, mtime: float) -> str:
+    """
+    Id do arquivo no DerivedCache: o hash de conteúdo se o MediaPool já o
+    conhece (índice persistente, sem ler o áudio); senão uma chave barata
+    de (caminho, tamanho, mtime). Editar o arquivo invalida as duas.
+    """
+    known = MEDIA_POOL.known_hash(path, size, mtime)
+    if known is not None:
+        return known
+    import hashlib
+    return "s" + hashlib.blake2b(f"{path}|{size}|{mtime:.6f}".encode("utf-8"), digest_size=16).hexdigest()
+
+
+# ------------------------------------------------------------------
+# Estado por arquivo / progresso
+# ------------------------------------------------------------------
+
+class MediaStatus(Enum):
+    PENDING = "pending"
+    READY   = "ready"       # cabeçalho + pré-carga prontos → tocável
+    MISSING = "missing"
+    ERROR   = "error"
+
+
+@dataclass
+class MediaEntry:
+    """Um arquivo de mídia do projeto e o que já se sabe dele."""
+    path:        str
+    status:      MediaStatus = MediaStatus.PENDING
+    size:        int   = 0
+    mtime:       float = 0.0
+    sample_rate: int   = 0
+    channels:    int   = 0
+    frames:      int   = 0
+    head:        Optional[np.ndarray] = None   # (frames, ch) primeiros PRELOAD_SECONDS
+    data:        Optional[np.ndarray] = None   # decodificação completa (sob demanda)
+    peaks:       Optional[PeakPyramid] = None
+    error:       str = ""
+    cache_id:    str = ""                      # id no DerivedCache (core/media.py)
+    clips:       List[Any] = field(default_factory=list)
+
+    @property
+    def ready(self) -> bool:
+        return self.status == MediaStatus.READY
+
+    @property
+    def duration(self) -> float:
+        return self.frames / self.sample_rate if self.sample_rate else 0.0
+
+    def samples(self) -> Optional[np.ndarray]:
+        """Melhor áudio disponível agora: completo se houver, senão a pré-carga."""
+        return self.data if self.data is not None else self.head
+
+
+@dataclass
+class LoadProgress:
+    stage: str              # "media" | "peaks"
+    done:  int
+    total: int
+    path:  str = ""
+
+    @property
+    def fraction(self) -> float:
+        return self.done / self.total if self.total else 1.0
+
+
+# ------------------------------------------------------------------
+# Loader
+# ------------------------------------------------------------------
+
+class ProjectLoader:
+    """
+    Uso:
+        loader = ProjectLoader()
+        loader.on_clip_ready = lambda clip, entry: redraw()
+        project = loader.open("song.blendaw")     # retorna na hora
+        ...
+        # timer do Blender (thread principal):
+        loader.poll()
+    """
+
+    def __init__(
+        self,
+        max_workers:     int   = DEFAULT_WORKERS,
+        preload_seconds: float = PRELOAD_SECONDS,
+    ) -> None:
+        self.max_workers     = max(1, max_workers)
+        self.preload_seconds = preload_seconds
+        self.deliver_in_thread: bool = False
+
+        self.on_progress:   Optional[Callable[[LoadProgress], None]] = None
+        self.on_clip_ready: Optional[Callable[[Any, MediaEntry], None]] = None
+        self.on_finished:   Optional[Callable[[float], None]] = None
+
+        self.project: Optional[Project] = None
+        self._media:  Dict[str, MediaEntry] = {}
+        self._executor: Optional[ThreadPoolExecutor] = None
+        self._events: "queue.SimpleQueue[Tuple[Callable, tuple]]" = queue.SimpleQueue()
+        self._lock = threading.Lock()
+        self._cancel = threading.Event()
+        self._done = threading.Event()
+        self._done.set()
+
+        self._total = 0
+        self._finished = 0
+        self._peak_jobs: List[MediaEntry] = []
+        self._peaks_total = 0
+        self._peaks_done = 0
+        self._t0 = 0.0
+
+    # ------------------------------------------------------------------
+    # Abertura
+    # ------------------------------------------------------------------
+
+    def open(self, filepath: str, project: Optional[Project] = None) -> Project:
+        """Lê a estrutura (síncrono) e dispara a mídia em segundo plano."""
+        self._t0 = time.perf_counter()
+        project = project or Project()
+        project.load(filepath)
+        LOGGER.info(
+            "ProjectLoader",
+            f"Estrutura de '{project.name}' lida em {(time.perf_counter() - self._t0) * 1000:.0f} ms",
+        )
+        self.start(project)
+        return project
+
+    def start(self, project: Project) -> None:
+        """Agenda verificação/pré-carga de toda a mídia de um projeto já lido."""
+        self.cancel()
+        self.project = project
+        self._media = self._collect(project)
+        self._cancel.clear()
+        self._done.clear()
+        self._total = len(self._media)
+        self._finished = 0
+        self._peak_jobs = []
+        self._peaks_total = 0
+        self._peaks_done = 0
+        if not self._t0:
+            self._t0 = time.perf_counter()
+
+        if not self._media:
+            self._finish()
+            return
+
+        self._executor = ThreadPoolExecutor(
+            max_workers=self.max_workers,
+            thread_name_prefix="daw-load",
+        )
+        for entry in sorted(self._media.values(), key=self._priority):
+            self._executor.submit(self._load_entry, entry)
+
+    def cancel(self) -> None:
+        """Interrompe a carga atual (jobs em andamento terminam o arquivo corrente)."""
+        self._cancel.set()
+        if self._executor is not None:
+            self._executor.shutdown(wait=False, cancel_futures=True)
+            self._executor = None
+        self._done.set()
+
+    def wait(self, timeout: Optional[float] = None) -> bool:
+        """Bloqueia até terminar (inclusive picos). True se terminou."""
+        return self._done.wait(timeout)
+
+    # ------------------------------------------------------------------
+    # Coleta
+    # ------------------------------------------------------------------
+
+    def _resolve(self, project: Project, path: str) -> str:
+        if not os.path.isabs(path):
+            path = os.path.join(project.path, path)
+        return os.path.normpath(path)
+
+    def _collect(self, project: Project) -> Dict[str, MediaEntry]:
+        media: Dict[str, MediaEntry] = {}
+        for path in project.media_files:
+            p = self._resolve(project, path)
+            media.setdefault(p, MediaEntry(p))
+        for track in project.timeline.tracks:
+            for clip in track.clips:
+                if clip.type == ClipType.AUDIO and isinstance(clip.data, str) and clip.data:
+                    p = self._resolve(project, clip.data)
+                    media.setdefault(p, MediaEntry(p)).clips.append(clip)
+        return media
+
+    @staticmethod
+    def _priority(entry: MediaEntry) -> float:
+        return min((c.start for c in entry.clips), default=float("inf"))
+
+    # ------------------------------------------------------------------
+    # Jobs (threads do pool)
+    # ------------------------------------------------------------------
+
+    def _load_entry(self, entry: MediaEntry) -> None:
+        if self._cancel.is_set():
+            return
+        try:
+            try:
+                st = os.stat(entry.path)
+            except OSError:
+                entry.status = MediaStatus.MISSING
+                return
+            entry.size, entry.mtime = st.st_size, st.st_mtime
+
+            import soundfile as sf
+            info = sf.info(entry.path)
+            entry.sample_rate = int(info.samplerate)
+            entry.channels    = int(info.channels)
+            entry.frames      = int(info.frames)
+
+            entry.cache_id = media_cache_id(entry.path, entry.size, entry.mtime)
+            blob = DERIVED_CACHE.get(entry.cache_id, "peaks", PEAK_PARAMS)
+            if blob is not None:
+                try:
+                    entry.peaks = PeakPyramid.unpack(blob)
+                except Exception:
+                    entry.peaks = None
+
+            n = min(entry.frames, int(self.preload_seconds * entry.sample_rate))
+            entry.head, _ = sf.read(entry.path, frames=n, dtype="float32", always_2d=True)
+            entry.status = MediaStatus.READY
+
+            for clip in entry.clips:
+                self._post(self.on_clip_ready, clip, entry)
+
+        except Exception as e:
+            entry.status = MediaStatus.ERROR
+            entry.error = str(e)
+            LOGGER.warning("ProjectLoader", f"Falha ao abrir mídia '{entry.path}': {e}")
+
+        finally:
+            self._entry_done(entry)
+
+    def _entry_done(self, entry: MediaEntry) -> None:
+        with self._lock:
+            self._finished += 1
+            done = self._finished
+            if entry.ready and entry.peaks is None:
+                self._peak_jobs.append(entry)
+            last = done == self._total
+
+        self._post(self.on_progress, LoadProgress("media", done, self._total, entry.path))
+
+        if last:
+            ms = (time.perf_counter() - self._t0) * 1000
+            missing = sum(1 for e in self._media.values() if e.status == MediaStatus.MISSING)
+            LOGGER.info(
+                "ProjectLoader",
+                f"{self._total} arquivo(s) de mídia verificados em {ms:.0f} ms"
+                + (f" — {missing} ausente(s)" if missing else ""),
+            )
+            self._start_peaks()
+
+    def _start_peaks(self) -> None:
+        jobs = self._peak_jobs
+        self._peaks_total = len(jobs)
+        executor = self._executor
+        if not jobs or executor is None or self._cancel.is_set():
+            self._finish()
+            return
+        for entry in sorted(jobs, key=self._priority):
+            executor.submit(self._build_peaks, entry)
+
+    def _build_peaks(self, entry: MediaEntry) -> None:
+        try:
+            if self._cancel.is_set():
+                return
+            # Decodifica só para os picos — o áudio completo não fica em
+            # memória (projetos com GBs de mídia); ensure_decoded() é separado.
+            import soundfile as sf
+            data = entry.data
+            if data is None:
+                data, _ = sf.read(entry.path, dtype="float32", always_2d=True)
+            pyramid = PeakPyramid(data, entry.sample_rate)
+            del data
+            entry.peaks = pyramid
+            try:
+                DERIVED_CACHE.put(entry.cache_id, "peaks", pyramid.pack(), PEAK_PARAMS)
+            except OSError as e:
+                LOGGER.warning("ProjectLoader", f"Cache de picos não gravado: {e}")
+        except Exception as e:
+            LOGGER.warning("ProjectLoader", f"Falha ao gerar picos de '{entry.path}': {e}")
+        finally:
+            with self._lock:
+                self._peaks_done += 1
+                done = self._peaks_done
+            self._post(self.on_progress, LoadProgress("peaks", done, self._peaks_total, entry.path))
+            if done == self._peaks_total:
+                self._finish()
+
+    def _decode(self, entry: MediaEntry) -> np.ndarray:
+        if entry.data is None:
+            import soundfile as sf
+            data, _ = sf.read(entry.path, dtype="float32", always_2d=True)
+            entry.data = data
+            entry.frames = len(data)
+        return entry.data
+
+    def _finish(self) -> None:
+        executor, self._executor = self._executor, None
+        if executor is not None:
+            executor.shutdown(wait=False)
+        self._done.set()
+        self._post(self.on_finished, time.perf_counter() - self._t0)
+        self._t0 = 0.0
+
+    # ------------------------------------------------------------------
+    # Sob demanda
+    # ------------------------------------------------------------------
+
+    def ensure_decoded(self, path: str) -> Future:
+        """
+        Decodificação completa de um arquivo (ex: ao tocar além da pré-carga).
+        Retorna um Future com o array (frames, ch).
+        """
+        fut: Future = Future()
+        entry = self._media.get(os.path.normpath(path))
+        if entry is None or not entry.ready:
+            fut.set_exception(FileNotFoundError(path))
+            return fut
+        if entry.data is not None:
+            fut.set_result(entry.data)
+            return fut
+
+        def job() -> None:
+            try:
+                fut.set_result(self._decode(entry))
+            except Exception as e:
+                fut.set_exception(e)
+
+        threading.Thread(target=job, daemon=True, name="daw-decode").start()
+        return fut
+
+    # ------------------------------------------------------------------
+    # Eventos → thread principal
+    # ------------------------------------------------------------------
+
+    def _post(self, fn: Optional[Callable], *args: Any) -> None:
+        if fn is None:
+            return
+        if self.deliver_in_thread:
+            try:
+                fn(*args)
+            except Exception as e:
+                LOGGER.error("ProjectLoader", f"Erro em callback: {e}")
+        else:
+            self._events.put((fn, args))
+
+    def poll(self, max_events: int = 256) -> int:
+        """Entrega callbacks pendentes. Chamar na thread principal. Retorna quantos."""
+        n = 0
+        while n < max_events:
+            try:
+                fn, args = self._events.get_nowait()
+            except queue.Empty:
+                break
+            try:
+                fn(*args)
+            except Exception as e:
+                LOGGER.error("ProjectLoader", f"Erro em callback: {e}")
+            n += 1
+        return n
+
+    # ------------------------------------------------------------------
+    # Consulta
+    # ------------------------------------------------------------------
+
+    def media(self, path: str) -> Optional[MediaEntry]:
+        return self._media.get(os.path.normpath(path))
+
+    def entry_for_clip(self, clip: Any) -> Optional[MediaEntry]:
+        if self.project is None or not isinstance(clip.data, str):
+            return None
+        return self._media.get(self._resolve(self.project, clip.data))
+
+    def is_clip_ready(self, clip: Any) -> bool:
+        entry = self.entry_for_clip(clip)
+        return entry is not None and entry.ready
+
+    def peaks_for(self, path: str) -> Optional[PeakPyramid]:
+        """Provedor de picos para TimelineLOD (modules/timeline/zoom.py)."""
+        entry = self.media(path) if os.path.isabs(path) or self.project is None \
+            else self._media.get(self._resolve(self.project, path))
+        return entry.peaks if entry is not None else None
+
+    @property
+    def missing(self) -> List[str]:
+        return [e.path for e in self._media.values() if e.status == MediaStatus.MISSING]
+
+    @property
+    def is_loading(self) -> bool:
+        return not self._done.is_set()
+
+    def progress(self) -> LoadProgress:
+        if self._finished < self._total:
+            return LoadProgress("media", self._finished, self._total)
+        return LoadProgress("peaks", self._peaks_done, self._peaks_total)
+
+    def __repr__(self) -> str:
+        p = self.progress()
+        return f"ProjectLoader({p.stage} {p.done}/{p.total}, {'carregando' if self.is_loading else 'ocioso'})"
+
+
+# Instância global
+LOADER = ProjectLoader()
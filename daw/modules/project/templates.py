@@ -1 +1,312 @@
-"""Stub for project/templates.py"""
+# modules/project/templates.py
+"""
+Templates de projeto como imagens de snapshot da engine.
+
+Por que não guardar o template como um projeto JSON comum:
+- Abrir um template de 64 faixas recriaria cada Synth, Channel e preset
+  do zero, parâmetro por parâmetro (np.clip, lei de pan, dicts...).
+- Aqui o template é o estado já "compilado" do Mixer, em arrays:
+
+    <nome>.dawtpl/
+        manifest.json   — versão, sample rate, nomes, tabela de formas de
+                          onda, plano de blocos, metadados do projeto
+        channels.npy    — CHANNEL_DTYPE: ganho/pan (com coeficientes L/R
+                          já calculados), mute/solo e parâmetros do preset
+                          de cada canal, uma linha por canal
+        routing.npy     — plano de roteamento compilado: ordem de render e
+                          barramento de destino por canal (-1 = master)
+
+  load_template() abre os .npy com mmap (np.load(mmap_mode='r')) — nada é
+  lido até o thaw tocar a página — e thaw() monta o Mixer direto dos
+  arrays, sem passar pelos setters: coeficientes de pan já vêm prontos e
+  Synth/Channel/Mixer são criados por _from_params (o mesmo _setup do
+  __init__ de cada um, sem os defaults que o template sobrescreveria).
+
+Imagens abertas ficam em cache por (caminho, mtime): o segundo "novo
+projeto" do mesmo template não toca o disco.
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+import json
+import os
+import shutil
+import time
+from typing import Any, Dict, List, Optional, Tuple
+
+import numpy as np
+
+from ...daw_engine.audio.layout import get_layout, layout_for_channels
+from ...daw_engine.core.logger import LOGGER
+from ...daw_engine.core.constants import TrackType
+from ...daw_engine.core.project import Project
+from ...daw_engine.core.timeline import Track
+from ...daw_engine.instruments.synth import Synth, SynthPreset
+from ...daw_engine.mixer.mixer import CHANNEL_PARAMS_DTYPE, Channel, Mixer
+
+
+TEMPLATE_EXT     = ".dawtpl"
+TEMPLATE_VERSION = 2     # 2: azimuth/elevation por canal
+
+# Uma linha por canal do mixer. Campos alinhados — o array inteiro é
+# lido por mmap e fatiado por coluna no thaw.
+CHANNEL_DTYPE = np.dtype([
+    ("volume",     np.float32),
+    ("pan",        np.float32),
+    ("pan_l",      np.float32),
+    ("pan_r",      np.float32),
+    ("azimuth",    np.float32),     # graus (barramentos surround/ambisônicos)
+    ("elevation",  np.float32),
+    ("mute",       np.uint8),
+    ("solo",       np.uint8),
+    ("wave",       np.uint8),       # índice em manifest["waves"]
+    ("_pad",       np.uint8),
+    ("max_voices", np.uint16),
+    ("_pad2",      np.uint16),
+    ("attack",     np.float32),
+    ("decay",      np.float32),
+    ("sustain",    np.float32),
+    ("release",    np.float32),
+    ("inst_vol",   np.float32),
+])
+
+ROUTING_DTYPE = np.dtype([
+    ("order", np.int32),    # posição do canal na ordem de render
+    ("dest",  np.int32),    # barramento de destino (-1 = master)
+])
+
+
+# Campos do SynthPreset que já têm coluna em CHANNEL_DTYPE; os demais
+# (unison, filtro, ...) vão no manifest, por canal.
+_COLUMN_FIELDS = ("name", "wave_type", "attack", "decay", "sustain", "release", "volume", "max_voices")
+
+# Colunas copiadas 1:1 entre CHANNEL_DTYPE e o array de parâmetros do Mixer
+_PARAM_FIELDS = ("volume", "pan", "pan_l", "pan_r", "azimuth", "elevation", "mute", "solo")
+
+
+def _preset_extras(preset: SynthPreset) -> Dict[str, Any]:
+    return {k: v for k, v in preset.to_dict().items() if k not in _COLUMN_FIELDS}
+
+
+def templates_dir() -> str:
+    base = os.path.join(os.path.expanduser("~"), ".config", "blender_daw", "templates")
+    os.makedirs(base, exist_ok=True)
+    return base
+
+
+# ------------------------------------------------------------------
+# Congelar (Mixer → imagem)
+# ------------------------------------------------------------------
+
+def save_template(
+    mixer: Mixer,
+    name:  str,
+    path:  Optional[str] = None,
+    bpm:   float = 120.0,
+    block_size: int = 512,
+    meta:  Optional[Dict[str, Any]] = None,
+) -> str:
+    """
+    Grava o estado do mixer como imagem de template. Retorna o diretório.
+    A escrita vai para um diretório temporário e é trocada no fim — uma
+    imagem nunca fica pela metade.
+    """
+    path = path or os.path.join(templates_dir(), f"{name}{TEMPLATE_EXT}")
+    channels = [mixer.get_channel(i) for i in range(mixer.channel_count)]
+
+    waves: List[str] = []
+    rows = np.zeros(len(channels), dtype=CHANNEL_DTYPE)
+    for i, ch in enumerate(channels):
+        p = ch.instrument.preset
+        if p.wave_type not in waves:
+            waves.append(p.wave_type)
+        r = rows[i]
+        r["wave"] = waves.index(p.wave_type)
+        r["max_voices"] = p.max_voices
+        r["attack"], r["decay"] = p.attack, p.decay
+        r["sustain"], r["release"] = p.sustain, p.release
+        r["inst_vol"] = p.volume
+
+    # Colunas do mixer copiadas de uma vez do array de parâmetros
+    params = mixer.params
+    for f in _PARAM_FIELDS:
+        rows[f] = params[f]
+
+    routing = np.zeros(len(channels), dtype=ROUTING_DTYPE)
+    routing["order"] = np.arange(len(channels), dtype=np.int32)
+    routing["dest"] = -1
+
+    manifest = {
+        "version":      TEMPLATE_VERSION,
+        "name":         name,
+        "created":      time.time(),
+        "sample_rate":  mixer.sample_rate,
+        "out_channels": mixer.num_channels,
+        "layout":       mixer.layout.name,
+        "block_size":   block_size,
+        "bpm":          bpm,
+        "master":       {"volume": mixer.master.volume},
+        "midi_input":   mixer.midi_input_channel,
+        "waves":        waves,
+        "channels":     [{"name": ch.name, "preset": ch.instrument.preset.name,
+                          "synth": _preset_extras(ch.instrument.preset)} for ch in channels],
+        "meta":         meta or {},
+    }
+
+    tmp = f"{path}.tmp"
+    shutil.rmtree(tmp, ignore_errors=True)
+    os.makedirs(tmp)
+    np.save(os.path.join(tmp, "channels.npy"), rows)
+    np.save(os.path.join(tmp, "routing.npy"), routing)
+    with open(os.path.join(tmp, "manifest.json"), "w", encoding="utf-8") as f:
+        json.dump(manifest, f, indent=2, ensure_ascii=False)
+
+    shutil.rmtree(path, ignore_errors=True)
+    os.replace(tmp, path)
+    _IMAGE_CACHE.pop(os.path.normpath(path), None)
+    LOGGER.info("Templates", f"Template '{name}' salvo ({len(channels)} canais) em {path}")
+    return path
+
+
+# ------------------------------------------------------------------
+# Imagem carregada (mmap) → thaw
+# ------------------------------------------------------------------
+
+class TemplateImage:
+    """Imagem de template aberta por mmap. thaw() cria um Mixer pronto."""
+
+    def __init__(self, path: str) -> None:
+        self.path = path
+        with open(os.path.join(path, "manifest.json"), "r", encoding="utf-8") as f:
+            self.manifest: Dict[str, Any] = json.load(f)
+
+        version = self.manifest.get("version", 0)
+        if version != TEMPLATE_VERSION:
+            raise ValueError(f"Template '{path}' versão {version} (esperada {TEMPLATE_VERSION})")
+
+        self.channels = np.load(os.path.join(path, "channels.npy"), mmap_mode="r")
+        self.routing  = np.load(os.path.join(path, "routing.npy"), mmap_mode="r")
+        if self.channels.dtype != CHANNEL_DTYPE or len(self.channels) != len(self.manifest["channels"]):
+            raise ValueError(f"Template '{path}' inconsistente")
+
+    @property
+    def name(self) -> str:
+        return self.manifest.get("name", "")
+
+    @property
+    def channel_count(self) -> int:
+        return len(self.channels)
+
+    def thaw(self, sample_rate: Optional[int] = None) -> Mixer:
+        """
+        Monta o Mixer a partir dos arrays. Parâmetros de preset estão em
+        segundos/ganho, então um sample rate diferente do salvo é válido.
+        """
+        sr = int(sample_rate or self.manifest["sample_rate"])
+        rows = np.array(self.channels)                  # uma cópia, colunas contíguas
+        names = self.manifest["channels"]
+        waves = self.manifest["waves"]
+
+        # Colunas → listas Python uma vez (evita escalares numpy por campo)
+        cols = {f: rows[f].tolist() for f in CHANNEL_DTYPE.names if not f.startswith("_")}
+
+        # Ordem de render compilada
+        order = np.argsort(np.asarray(self.routing["order"]), kind="stable").tolist()
+
+        # Parâmetros: as colunas do template viram as do array do Mixer
+        # direto — coeficientes de pan já vêm prontos.
+        params = np.zeros(max(Mixer.INITIAL_CAPACITY, len(rows)), dtype=CHANNEL_PARAMS_DTYPE)
+        ordered = rows[order]
+        for f in _PARAM_FIELDS:
+            params[f][:len(rows)] = ordered[f]
+
+        channels: List[Channel] = []
+        for row, i in enumerate(order):
+            # Um preset por canal — editar o som de uma faixa não pode
+            # vazar para as outras que vieram do mesmo preset do template.
+            preset = SynthPreset.from_dict(dict(
+                names[i].get("synth", {}),
+                name=names[i].get("preset", "Default"),
+                wave_type=waves[cols["wave"][i]],
+                attack=cols["attack"][i],
+                decay=cols["decay"][i],
+                sustain=cols["sustain"][i],
+                release=cols["release"][i],
+                volume=cols["inst_vol"][i],
+                max_voices=cols["max_voices"][i],
+            ))
+            synth = Synth._from_params(sr, preset)
+            channels.append(Channel._from_params(names[i]["name"], synth, sr, params, row))
+
+        layout = self.manifest.get("layout")
+        mixer = Mixer._from_params(
+            sr, params, channels,
+            get_layout(layout) if layout else layout_for_channels(self.manifest.get("out_channels", 2)),
+        )
+        mixer.master.volume = self.manifest.get("master", {}).get("volume", mixer.master.volume)
+        mixer.midi_input_channel = self.manifest.get("midi_input", 0)
+        return mixer
+
+    def tracks(self) -> List[Track]:
+        """Faixas MIDI da timeline correspondentes aos canais do template."""
+        out = []
+        for ch in self.manifest["channels"]:
+            out.append(Track(ch["name"], TrackType.MIDI))
+        return out
+
+    def __repr__(self) -> str:
+        return f"TemplateImage('{self.name}', {self.channel_count} canais)"
+
+
+_IMAGE_CACHE: Dict[str, Tuple[float, TemplateImage]] = {}
+
+
+def load_template(path: str) -> TemplateImage:
+    """Abre (ou reaproveita do cache) a imagem de template em 'path'."""
+    path = os.path.normpath(path)
+    mtime = os.path.getmtime(os.path.join(path, "manifest.json"))
+    cached = _IMAGE_CACHE.get(path)
+    if cached is not None and cached[0] == mtime:
+        return cached[1]
+    image = TemplateImage(path)
+    _IMAGE_CACHE[path] = (mtime, image)
+    return image
+
+
+def list_templates(directory: Optional[str] = None) -> List[Tuple[str, str]]:
+    """Pares (nome, caminho) dos templates instalados, ordenados por nome."""
+    directory = directory or templates_dir()
+    out = []
+    for entry in sorted(os.listdir(directory)):
+        full = os.path.join(directory, entry)
+        if entry.endswith(TEMPLATE_EXT) and os.path.isfile(os.path.join(full, "manifest.json")):
+            out.append((entry[: -len(TEMPLATE_EXT)], full))
+    return out
+
+
+def new_project_from_template(
+    path:        str,
+    name:        str = "",
+    sample_rate: Optional[int] = None,
+) -> Tuple[Project, Mixer]:
+    """
+    Cria um projeto novo a partir de um template: timeline com uma faixa
+    MIDI por canal e o Mixer já montado (pronto para set_generator()).
+    """
+    t0 = time.perf_counter()
+    image = load_template(path)
+    mixer = image.thaw(sample_rate)
+
+    project = Project(name or image.name)
+    project.settings.bpm = image.manifest.get("bpm", project.settings.bpm)
+    project.settings.sample_rate = mixer.sample_rate
+    project.timeline.tracks.extend(image.tracks())    # vazias — um único commit abaixo
+    project.timeline.commit()
+
+    LOGGER.info(
+        "Templates",
+        f"Projeto '{project.name}' criado do template '{image.name}' "
+        f"({image.channel_count} canais) em {(time.perf_counter() - t0) * 1000:.1f} ms",
+    )
+    return project, mixer
@@ -1 +1,75 @@
-"""Stub for timeline/cursor.py"""
+# modules/timeline/cursor.py
+"""
+Cursor de reprodução (playhead) da timeline.
+
+Responsabilidade:
+    Posição do playhead em segundos, conversão para pixel via TimelineView
+    e rolagem automática da viewport durante a reprodução (por página ou
+    contínua) — mantém o playhead visível sem o usuário rolar à mão.
+
+Sem bpy — lógica pura.
+"""
+from __future__ import annotations
+
+from enum import Enum
+
+from .zoom import TimelineView
+
+
+class FollowMode(Enum):
+    OFF        = "off"
+    PAGE       = "page"         # salta uma página quando o playhead sai da tela
+    CONTINUOUS = "continuous"   # viewport rola; playhead fica fixo em 'anchor'
+
+
+class PlayheadCursor:
+    """
+    Playhead da timeline.
+
+    Uso (a cada redraw):
+        cursor.set_time(transport.position)
+        cursor.follow(view)
+        x = cursor.x(view)
+    """
+
+    def __init__(self, mode: FollowMode = FollowMode.PAGE, anchor: float = 0.3) -> None:
+        self.time:   float = 0.0
+        self.mode:   FollowMode = mode
+        self.anchor: float = anchor     # fração da largura (modo contínuo)
+
+    def set_time(self, t: float) -> None:
+        self.time = max(0.0, t)
+
+    def x(self, view: TimelineView) -> float:
+        return view.time_to_x(self.time)
+
+    def is_visible(self, view: TimelineView) -> bool:
+        return view.start <= self.time < view.end
+
+    def follow(self, view: TimelineView) -> bool:
+        """
+        Ajusta view.start conforme o modo. Retorna True se a viewport mudou
+        (a UI invalida só nesse caso o cache de desenho dos clips).
+        """
+        if self.mode == FollowMode.OFF:
+            return False
+
+        if self.mode == FollowMode.CONTINUOUS:
+            span = view.end - view.start
+            new_start = max(0.0, self.time - span * self.anchor)
+        else:
+            if self.is_visible(view):
+                return False
+            new_start = self.time if self.time >= view.end else max(0.0, self.time - (view.end - view.start) * 0.1)
+
+        if new_start == view.start:
+            return False
+        view.start = new_start
+        return True
+
+    def hit_test(self, x: float, view: TimelineView, tolerance_px: float = 4.0) -> bool:
+        """True se o clique em x pega o playhead (para arrastar)."""
+        return abs(x - self.x(view)) <= tolerance_px
+
+    def __repr__(self) -> str:
+        return f"PlayheadCursor({self.time:.3f}s, {self.mode.value})"
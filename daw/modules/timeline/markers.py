@@ -1 +1,149 @@
-"""Stub for timeline/markers.py"""
+# modules/timeline/markers.py
+"""
+Marcadores da timeline (seções, cues, pontos de loop).
+
+Responsabilidade:
+    Lista ordenada por tempo com consultas por bisect — a UI só desenha os
+    marcadores da janela visível e o snapping magnético consulta o mais
+    próximo sem varrer a lista inteira.
+
+Sem bpy — lógica pura, serializável.
+"""
+from __future__ import annotations
+
+import bisect
+from dataclasses import dataclass, field
+from typing import Any, Dict, List, Optional
+
+
+@dataclass
+class Marker:
+    """Um marcador: posição em segundos + rótulo e cor."""
+    time:  float = 0.0
+    name:  str   = ""
+    color: tuple = field(default_factory=lambda: (0.95, 0.75, 0.2))
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {"time": self.time, "name": self.name, "color": list(self.color)}
+
+    @classmethod
+    def from_dict(cls, data: Dict[str, Any]) -> "Marker":
+        return cls(
+            time=data.get("time", 0.0),
+            name=data.get("name", ""),
+            color=tuple(data.get("color", [0.95, 0.75, 0.2])),
+        )
+
+
+class MarkerList:
+    """
+    Marcadores ordenados por tempo.
+
+    _times espelha _markers para bisect direto em floats.
+    """
+
+    def __init__(self) -> None:
+        self._markers: List[Marker] = []
+        self._times:   List[float]  = []
+
+    # ------------------------------------------------------------------
+    # Edição
+    # ------------------------------------------------------------------
+
+    def add(self, time: float, name: str = "", color: Optional[tuple] = None) -> Marker:
+        marker = Marker(time=max(0.0, time), name=name or f"M{len(self._markers) + 1}")
+        if color is not None:
+            marker.color = color
+        i = bisect.bisect_right(self._times, marker.time)
+        self._markers.insert(i, marker)
+        self._times.insert(i, marker.time)
+        return marker
+
+    def remove(self, marker: Marker) -> bool:
+        i = self._index_of(marker)
+        if i < 0:
+            return False
+        del self._markers[i]
+        del self._times[i]
+        return True
+
+    def move(self, marker: Marker, new_time: float) -> None:
+        if self.remove(marker):
+            marker.time = max(0.0, new_time)
+            i = bisect.bisect_right(self._times, marker.time)
+            self._markers.insert(i, marker)
+            self._times.insert(i, marker.time)
+
+    def clear(self) -> None:
+        self._markers.clear()
+        self._times.clear()
+
+    def _index_of(self, marker: Marker) -> int:
+        i = bisect.bisect_left(self._times, marker.time)
+        while i < len(self._markers) and self._times[i] == marker.time:
+            if self._markers[i] is marker:
+                return i
+            i += 1
+        return -1
+
+    # ------------------------------------------------------------------
+    # Consulta
+    # ------------------------------------------------------------------
+
+    def in_range(self, start: float, end: float) -> List[Marker]:
+        """Marcadores em [start, end) — usado para desenhar só os visíveis."""
+        lo = bisect.bisect_left(self._times, start)
+        hi = bisect.bisect_left(self._times, end)
+        return self._markers[lo:hi]
+
+    def next_after(self, time: float) -> Optional[Marker]:
+        i = bisect.bisect_right(self._times, time)
+        return self._markers[i] if i < len(self._markers) else None
+
+    def prev_before(self, time: float) -> Optional[Marker]:
+        i = bisect.bisect_left(self._times, time)
+        return self._markers[i - 1] if i > 0 else None
+
+    def nearest(self, time: float, max_distance: float = float("inf")) -> Optional[Marker]:
+        i = bisect.bisect_left(self._times, time)
+        best: Optional[Marker] = None
+        best_d = max_distance
+        for j in (i - 1, i):
+            if 0 <= j < len(self._times):
+                d = abs(self._times[j] - time)
+                if d <= best_d:
+                    best, best_d = self._markers[j], d
+        return best
+
+    def get_by_name(self, name: str) -> Optional[Marker]:
+        for m in self._markers:
+            if m.name == name:
+                return m
+        return None
+
+    @property
+    def times(self) -> List[float]:
+        """Tempos ordenados (somente leitura)."""
+        return list(self._times)
+
+    def __iter__(self):
+        return iter(self._markers)
+
+    def __len__(self) -> int:
+        return len(self._markers)
+
+    # ------------------------------------------------------------------
+    # Serialização
+    # ------------------------------------------------------------------
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {"markers": [m.to_dict() for m in self._markers]}
+
+    def from_dict(self, data: Dict[str, Any]) -> None:
+        self.clear()
+        for d in data.get("markers", []):
+            m = Marker.from_dict(d)
+            self.add(m.time, m.name, m.color)
+
+    def __repr__(self) -> str:
+        return f"MarkerList({len(self._markers)} marcadores)"
@@ -1 +1,28 @@
-"""Stub for timeline/snapping.py"""
+# modules/timeline/snapping.py
+"""
+Snapping da timeline — mesmo serviço da playlist (modules/playlist/snapping.py).
+
+A timeline não mantém grade própria: reexporta SNAP para que timeline,
+playlist e piano roll compartilhem TempoMap, cache de linhas e alvos
+magnéticos.
+
+Sem bpy.
+"""
+from __future__ import annotations
+
+from ..playlist.snapping import (
+    LEVEL_BAR,
+    LEVEL_BEAT,
+    LEVEL_SUB,
+    MagneticTargets,
+    SNAP,
+    SnapEngine,
+    SnapGrid,
+    TempoMap,
+    TempoSegment,
+)
+
+__all__ = [
+    "LEVEL_BAR", "LEVEL_BEAT", "LEVEL_SUB",
+    "MagneticTargets", "SNAP", "SnapEngine", "SnapGrid", "TempoMap", "TempoSegment",
+]
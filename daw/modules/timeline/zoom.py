@@ -1 +1,815 @@
-"""Stub for timeline/zoom.py"""
+# modules/timeline/zoom.py
+"""
+Zoom da timeline com nível de detalhe (LOD).
+
+Responsabilidade:
+    Converter o estado da Timeline em listas de desenho cujo tamanho depende
+    da LARGURA da viewport, não do tamanho do projeto. Com zoom afastado
+    num arranjo longo, desenhar cada clip, nota e ponto de automação faria
+    o tempo de frame crescer sem limite.
+
+Estratégia por tipo de conteúdo:
+    - Clips:      ClipIntervalIndex (bisect + máximo acumulado dos fins)
+                  → só os clips que tocam a janela visível. Clips menores
+                  que MIN_CLIP_PX são fundidos por coluna de pixel.
+    - MIDI:       de perto, retângulos por nota (cortados por bisect);
+                  de longe, blocos de densidade por coluna (contagem de
+                  notas + faixa de altura min/max).
+    - Automação:  dizimação min/max por coluna (M4: primeiro, mín, máx,
+                  último) → no máximo 4 pontos por pixel.
+    - Áudio:      PeakPyramid — níveis de (mín, máx) com blocos de
+                  PEAK_BASE_BLOCK, 2×, 4×... samples; a consulta escolhe o
+                  nível mais grosso que ainda cabe num pixel.
+
+O resultado (TimelineDrawList) são arrays numpy prontos para um único
+batch_for_shader por primitiva — a UI não itera objetos Python.
+
+Sem bpy — lógica pura.
+"""
+from __future__ import annotations
+
+from dataclasses import dataclass, field
+from enum import Enum
+from typing import Any, Callable, Dict, Iterable, List, Optional, Sequence, Tuple
+
+import numpy as np
+
+from ...daw_engine.core.constants import ClipType
+
+
+# ------------------------------------------------------------------
+# Constantes de LOD
+# ------------------------------------------------------------------
+
+MIN_ZOOM_PPS = 0.5          # pixels por segundo (arranjo de ~1h numa tela)
+MAX_ZOOM_PPS = 20000.0      # pixels por segundo (nível de sample a 44.1 kHz)
+
+MIN_CLIP_PX       = 3.0     # clips mais estreitos viram "barra" fundida
+MIN_CONTENT_PX    = 12.0    # abaixo disso o clip é só a caixa (sem notas/curva)
+DETAIL_NOTE_PX    = 2.0     # nota média com >= 2 px → desenha nota a nota
+DENSITY_BLOCK_PX  = 4       # largura de cada bloco de densidade MIDI
+MAX_NOTES_PER_PX  = 2.0     # teto de notas detalhadas por pixel de largura
+PEAK_BASE_BLOCK   = 64      # samples por par (mín, máx) no nível 0 da pirâmide
+
+
+class LODLevel(Enum):
+    DETAIL   = "detail"     # nota a nota / ponto a ponto
+    SUMMARY  = "summary"    # densidade / polilinha dizimada
+    OVERVIEW = "overview"   # só a caixa do clip
+
+
+# ------------------------------------------------------------------
+# Viewport
+# ------------------------------------------------------------------
+
+@dataclass
+class TimelineView:
+    """
+    Janela visível da timeline.
+
+    start:  tempo (s) na borda esquerda
+    pps:    pixels por segundo (zoom horizontal)
+    width:  largura da área de desenho em pixels
+    x0:     deslocamento em pixels da área de desenho na região
+    """
+    start: float = 0.0
+    pps:   float = 100.0
+    width: int   = 1000
+    x0:    float = 0.0
+
+    @property
+    def end(self) -> float:
+        return self.start + self.width / self.pps
+
+    @property
+    def seconds_per_pixel(self) -> float:
+        return 1.0 / self.pps
+
+    def time_to_x(self, t: float) -> float:
+        return self.x0 + (t - self.start) * self.pps
+
+    def x_to_time(self, x: float) -> float:
+        return self.start + (x - self.x0) / self.pps
+
+    def zoom(self, factor: float, anchor_x: Optional[float] = None) -> None:
+        """
+        Multiplica o zoom mantendo fixo o tempo sob anchor_x (cursor do mouse).
+        anchor_x=None ancora no centro da área.
+        """
+        if anchor_x is None:
+            anchor_x = self.x0 + self.width * 0.5
+        anchor_t = self.x_to_time(anchor_x)
+        self.pps = min(MAX_ZOOM_PPS, max(MIN_ZOOM_PPS, self.pps * factor))
+        self.start = max(0.0, anchor_t - (anchor_x - self.x0) / self.pps)
+
+    def scroll(self, dx_px: float) -> None:
+        self.start = max(0.0, self.start + dx_px / self.pps)
+
+    def fit(self, t0: float, t1: float, margin_px: float = 20.0) -> None:
+        """Enquadra o intervalo [t0, t1] na largura da área."""
+        span = max(t1 - t0, 1e-6)
+        usable = max(1.0, self.width - 2 * margin_px)
+        self.pps = min(MAX_ZOOM_PPS, max(MIN_ZOOM_PPS, usable / span))
+        self.start = max(0.0, t0 - margin_px / self.pps)
+
+    def columns(self, t: np.ndarray) -> np.ndarray:
+        """Coluna de pixel (int, relativa à área) de cada tempo em t."""
+        return np.floor((t - self.start) * self.pps).astype(np.int64)
+
+
+# ------------------------------------------------------------------
+# Índice de intervalos — culling de clips
+# ------------------------------------------------------------------
+
+class ClipIntervalIndex:
+    """
+    Índice estático de intervalos [start, end) para consulta por janela.
+
+    Clips ordenados por start + máximo acumulado dos ends. Para a janela
+    [t0, t1):
+        hi = bisect(starts, t1)        → ninguém depois disso começa antes de t1
+        lo = bisect(max_end, t0)       → ninguém antes disso termina depois de t0
+    e só o trecho [lo, hi) é filtrado. O(log n + k) em vez de O(n).
+
+    Reconstruir é O(n log n) — feito só quando a lista de clips muda
+    (ver TimelineLOD.index_for).
+    """
+
+    def __init__(self, items: Iterable[Tuple[float, float, Any]] = ()) -> None:
+        rows = sorted(items, key=lambda r: r[0])
+        self._items: List[Any] = [r[2] for r in rows]
+        self.starts  = np.fromiter((r[0] for r in rows), dtype=np.float64, count=len(rows))
+        self.ends    = np.fromiter((r[1] for r in rows), dtype=np.float64, count=len(rows))
+        self.max_end = np.maximum.accumulate(self.ends) if len(rows) else self.ends
+
+    @classmethod
+    def from_clips(cls, clips: Iterable[Any]) -> "ClipIntervalIndex":
+        return cls((c.start, c.start + c.duration, c) for c in clips)
+
+    def query_indices(self, t0: float, t1: float) -> np.ndarray:
+        hi = int(np.searchsorted(self.starts, t1, side="left"))
+        lo = int(np.searchsorted(self.max_end, t0, side="right"))
+        if lo >= hi:
+            return np.empty(0, dtype=np.int64)
+        idx = np.arange(lo, hi)
+        return idx[self.ends[lo:hi] > t0]
+
+    def query(self, t0: float, t1: float) -> List[Any]:
+        return [self._items[i] for i in self.query_indices(t0, t1)]
+
+    def item(self, i: int) -> Any:
+        return self._items[i]
+
+    def __len__(self) -> int:
+        return len(self._items)
+
+
+# ------------------------------------------------------------------
+# MIDI — tabela de notas + blocos de densidade
+# ------------------------------------------------------------------
+
+class NoteTable:
+    """
+    Notas de um clip MIDI em arrays paralelos (start, end, pitch, velocity),
+    ordenados por start, com máximo acumulado dos ends para culling.
+
+    Tempos relativos ao início do clip.
+    """
+
+    def __init__(
+        self,
+        starts:     np.ndarray,
+        ends:       np.ndarray,
+        pitches:    np.ndarray,
+        velocities: np.ndarray,
+    ) -> None:
+        order = np.argsort(starts, kind="stable")
+        self.starts     = np.asarray(starts, dtype=np.float64)[order]
+        self.ends       = np.asarray(ends, dtype=np.float64)[order]
+        self.pitches    = np.asarray(pitches, dtype=np.int16)[order]
+        self.velocities = np.asarray(velocities, dtype=np.int16)[order]
+        self.max_end    = np.maximum.accumulate(self.ends) if len(order) else self.ends
+        self._density: Dict[Tuple[float, float, int], np.ndarray] = {}
+
+    @classmethod
+    def from_sequence(cls, sequence: Any, default_len: float = 0.25) -> "NoteTable":
+        """Constrói a partir de MidiSequence (pares de get_notes())."""
+        pairs = sequence.get_notes()
+        n = len(pairs)
+        starts = np.empty(n); ends = np.empty(n)
+        pitches = np.empty(n, dtype=np.int16); vels = np.empty(n, dtype=np.int16)
+        for i, (on, off) in enumerate(pairs):
+            starts[i]  = on.time_sec
+            ends[i]    = off.time_sec if off is not None else on.time_sec + default_len
+            pitches[i] = on.note
+            vels[i]    = on.velocity
+        return cls(starts, ends, pitches, vels)
+
+    def visible(self, t0: float, t1: float) -> np.ndarray:
+        hi = int(np.searchsorted(self.starts, t1, side="left"))
+        lo = int(np.searchsorted(self.max_end, t0, side="right"))
+        if lo >= hi:
+            return np.empty(0, dtype=np.int64)
+        idx = np.arange(lo, hi)
+        return idx[self.ends[lo:hi] > t0]
+
+    def density(self, pps: float, duration: float, block_px: int = DENSITY_BLOCK_PX) -> np.ndarray:
+        """
+        Blocos de densidade do trecho [0, duration) com x relativo ao início
+        do clip: (k, 4) [x, pitch_min, pitch_max, densidade 0..1].
+
+        Memorizado por (pps, duration): rolar a timeline e clips repetidos
+        (loops do mesmo padrão) não recalculam nada.
+        """
+        key = (pps, duration, block_px)
+        cached = self._density.get(key)
+        if cached is not None:
+            return cached
+
+        idx = self.visible(0.0, duration)
+        if len(idx) == 0:
+            out = np.empty((0, 4), dtype=np.float32)
+        else:
+            blocks = (self.starts[idx] * pps).astype(np.int64) // block_px
+            n_blocks = int(blocks[-1]) + 1
+            pitches = self.pitches[idx]
+
+            counts = np.bincount(blocks, minlength=n_blocks)
+            pmin = np.full(n_blocks, 127, dtype=np.int16)
+            pmax = np.zeros(n_blocks, dtype=np.int16)
+            np.minimum.at(pmin, blocks, pitches)
+            np.maximum.at(pmax, blocks, pitches)
+
+            used = np.nonzero(counts)[0]
+            out = np.empty((len(used), 4), dtype=np.float32)
+            out[:, 0] = used * block_px
+            out[:, 1] = pmin[used]
+            out[:, 2] = pmax[used]
+            out[:, 3] = counts[used] / counts[used].max()
+
+        if len(self._density) >= 16:
+            self._density.clear()       # zoom mudou — descarta níveis antigos
+        self._density[key] = out
+        return out
+
+    @property
+    def duration(self) -> float:
+        return float(self.max_end[-1]) if len(self.max_end) else 0.0
+
+    @property
+    def mean_length(self) -> float:
+        return float(np.mean(self.ends - self.starts)) if len(self.starts) else 0.0
+
+    def __len__(self) -> int:
+        return len(self.starts)
+
+
+def midi_density_blocks(
+    table:      NoteTable,
+    clip_start: float,
+    view:       TimelineView,
+    clip_end:   Optional[float] = None,
+    block_px:   int = DENSITY_BLOCK_PX,
+) -> np.ndarray:
+    """
+    Resume as notas do clip em blocos de 'block_px' pixels e devolve os
+    que caem na viewport.
+
+    Retorna array (k, 4): [x, pitch_min, pitch_max, densidade 0..1] por
+    bloco não vazio. k <= largura / block_px, independente do nº de notas.
+    """
+    duration = (clip_end - clip_start) if clip_end is not None else table.duration
+    local = table.density(view.pps, duration, block_px)
+    if len(local) == 0:
+        return local
+
+    x_clip = view.time_to_x(clip_start)
+    lo = int(np.searchsorted(local[:, 0], view.x0 - x_clip - block_px, side="right"))
+    hi = int(np.searchsorted(local[:, 0], view.x0 + view.width - x_clip, side="right"))
+    out = local[lo:hi].copy()
+    out[:, 0] += x_clip
+    return out
+
+
+# ------------------------------------------------------------------
+# Automação — dizimação min/max por coluna
+# ------------------------------------------------------------------
+
+def decimate_polyline(
+    times:  np.ndarray,
+    values: np.ndarray,
+    view:   TimelineView,
+) -> Tuple[np.ndarray, np.ndarray]:
+    """
+    Dizimação M4: por coluna de pixel mantém primeiro, mínimo, máximo e
+    último ponto. Visualmente idêntica à polilinha completa e com no
+    máximo 4 × largura pontos. Inclui um ponto fora de cada borda para a
+    linha não "cortar" na entrada/saída da viewport.
+    """
+    n = len(times)
+    if n == 0:
+        return times, values
+
+    lo = max(0, int(np.searchsorted(times, view.start, side="left")) - 1)
+    hi = min(n, int(np.searchsorted(times, view.end, side="right")) + 1)
+    t = times[lo:hi]
+    v = values[lo:hi]
+    if len(t) <= 4 * max(1, view.width):
+        return t, v
+
+    cols = view.columns(t)
+    # Começo/fim de cada coluna (t ordenado → cols não decrescente)
+    starts = np.flatnonzero(np.r_[True, cols[1:] != cols[:-1]])
+    ends = np.r_[starts[1:], len(t)] - 1
+
+    vmin_i = starts + _segment_arg(v, starts, first=True)
+    vmax_i = starts + _segment_arg(v, starts, first=False)
+
+    keep = np.unique(np.concatenate([starts, vmin_i, vmax_i, ends]))
+    return t[keep], v[keep]
+
+
+def _segment_arg(v: np.ndarray, starts: np.ndarray, first: bool) -> np.ndarray:
+    """
+    argmin (first=True) / argmax (first=False) por segmento contíguo, sem
+    laço Python: ordena (segmento, valor) com lexsort e pega o primeiro ou
+    o último de cada segmento. Retorna deslocamentos relativos ao início.
+    """
+    seg = np.repeat(np.arange(len(starts)), np.diff(np.r_[starts, len(v)]))
+    order = np.lexsort((v, seg))
+    bounds = np.flatnonzero(np.diff(seg[order]))
+    if first:
+        pick = order[np.r_[0, bounds + 1]]
+    else:
+        pick = order[np.r_[bounds, len(v) - 1]]
+    return pick - starts
+
+
+def curve_arrays(curve: Any) -> Tuple[np.ndarray, np.ndarray]:
+    """(times, values) de uma AutomationCurve como arrays numpy."""
+    pts = curve.points
+    times = np.fromiter((p.time for p in pts), dtype=np.float64, count=len(pts))
+    values = np.fromiter((p.value for p in pts), dtype=np.float64, count=len(pts))
+    return times, values
+
+
+# ------------------------------------------------------------------
+# Áudio — pirâmide de picos
+# ------------------------------------------------------------------
+
+class PeakPyramid:
+    """
+    Pirâmide de picos (mín, máx) de um sinal mono.
+
+    levels[0] tem um par por PEAK_BASE_BLOCK samples; levels[k] tem um par
+    por PEAK_BASE_BLOCK·2^k samples (combinando pares do nível anterior).
+    Memória total ≈ 2·N/base · 2 floats — 64 samples → ~6% do áudio em float32.
+
+    query() escolhe o nível mais grosso cujo bloco ainda é <= samples por
+    pixel e reduz para exatamente uma coluna por pixel visível.
+    """
+
+    def __init__(
+        self,
+        samples:     np.ndarray,
+        sample_rate: int,
+        base_block:  int = PEAK_BASE_BLOCK,
+    ) -> None:
+        if samples.ndim > 1:
+            # Estéreo (frames, ch) → envelope do canal de maior amplitude
+            mins = samples.min(axis=1)
+            maxs = samples.max(axis=1)
+        else:
+            mins = maxs = samples
+
+        self.sample_rate = int(sample_rate)
+        self.base_block  = int(base_block)
+        self.length      = len(mins)
+
+        n = -(-self.length // base_block) * base_block
+        pad = n - self.length
+        mins = np.pad(mins.astype(np.float32), (0, pad), mode="edge") if pad and self.length else mins.astype(np.float32)
+        maxs = np.pad(maxs.astype(np.float32), (0, pad), mode="edge") if pad and self.length else maxs.astype(np.float32)
+
+        lvl_min = mins.reshape(-1, base_block).min(axis=1) if self.length else np.zeros(0, np.float32)
+        lvl_max = maxs.reshape(-1, base_block).max(axis=1) if self.length else np.zeros(0, np.float32)
+        self.levels: List[Tuple[np.ndarray, np.ndarray]] = [(lvl_min, lvl_max)]
+
+        while len(lvl_min) > 1:
+            if len(lvl_min) & 1:
+                lvl_min = np.r_[lvl_min, lvl_min[-1]]
+                lvl_max = np.r_[lvl_max, lvl_max[-1]]
+            lvl_min = np.minimum(lvl_min[0::2], lvl_min[1::2])
+            lvl_max = np.maximum(lvl_max[0::2], lvl_max[1::2])
+            self.levels.append((lvl_min, lvl_max))
+
+    def block_size(self, level: int) -> int:
+        return self.base_block << level
+
+    def level_for(self, samples_per_pixel: float) -> int:
+        level = 0
+        while level + 1 < len(self.levels) and self.block_size(level + 1) <= samples_per_pixel:
+            level += 1
+        return level
+
+    def query(
+        self,
+        clip_start: float,
+        view:       TimelineView,
+        offset:     float = 0.0,
+    ) -> Tuple[int, np.ndarray, np.ndarray]:
+        """
+        Picos da parte visível do clip.
+
+        clip_start: posição do clip na timeline (s)
+        offset:     início do trecho do arquivo usado pelo clip (s)
+
+        Retorna (primeira_coluna, mins, maxs) com um par por coluna de pixel.
+        """
+        spp = self.sample_rate / view.pps
+        level = self.level_for(spp)
+        mins, maxs = self.levels[level]
+        block = self.block_size(level)
+
+        clip_end = clip_start + self.length / self.sample_rate - offset
+        t0 = max(view.start, clip_start)
+        t1 = min(view.end, clip_end)
+        if t1 <= t0 or len(mins) == 0:
+            return 0, np.empty(0, np.float32), np.empty(0, np.float32)
+
+        col0 = int(np.floor((t0 - view.start) * view.pps))
+        col1 = int(np.ceil((t1 - view.start) * view.pps))
+        cols = np.arange(col0, col1 + 1)
+
+        # Limites em samples de cada coluna → índices de bloco no nível escolhido
+        sample_at = ((view.start + cols / view.pps) - clip_start + offset) * self.sample_rate
+        b = np.clip((sample_at // block).astype(np.int64), 0, len(mins) - 1)
+        b_lo = b[:-1]
+
+        if spp < block:
+            # Mais de um pixel por bloco — sem redução
+            return col0, mins[b_lo], maxs[b_lo]
+
+        # b é não decrescente: o segmento da coluna i é [b[i], b[i+1]).
+        # reduceat leva o último até o fim do array — corta em b[-1].
+        stop = max(int(b[-1]), int(b_lo[-1]) + 1)
+        out_min = np.minimum.reduceat(mins[:stop], b_lo)
+        out_max = np.maximum.reduceat(maxs[:stop], b_lo)
+        return col0, out_min, out_max
+
+    # -- cache em disco --------------------------------------------------
+
+    def save(self, path: str) -> None:
+        arrays = {"meta": np.array([self.sample_rate, self.base_block, self.length], dtype=np.int64)}
+        for i, (mn, mx) in enumerate(self.levels):
+            arrays[f"min{i}"] = mn
+            arrays[f"max{i}"] = mx
+        np.savez(path, **arrays)
+
+    def pack(self) -> np.ndarray:
+        """
+        Pirâmide inteira num único array uint8 (cabeçalho int64 + níveis
+        float32) — formato do DerivedCache (core/media.py), um .npy por artefato.
+        """
+        header = np.array([self.sample_rate, self.base_block, self.length, len(self.levels)]
+                          + [len(mn) for mn, _ in self.levels], dtype=np.int64)
+        parts = [header.view(np.uint8)]
+        for mn, mx in self.levels:
+            parts.append(np.ascontiguousarray(mn, np.float32).view(np.uint8))
+            parts.append(np.ascontiguousarray(mx, np.float32).view(np.uint8))
+        return np.concatenate(parts)
+
+    @classmethod
+    def unpack(cls, blob: np.ndarray) -> "PeakPyramid":
+        """Inverso de pack(). Com blob mmap os níveis continuam mapeados."""
+        head = np.frombuffer(blob[:32], dtype=np.int64) if not isinstance(blob, np.memmap) \
+            else np.asarray(blob[:32]).view(np.int64)
+        n_levels = int(head[3])
+        sizes = np.asarray(blob[32:32 + 8 * n_levels]).view(np.int64)
+        obj = cls.__new__(cls)
+        obj.sample_rate, obj.base_block, obj.length = int(head[0]), int(head[1]), int(head[2])
+        obj.levels = []
+        pos = 32 + 8 * n_levels
+        for n in sizes.tolist():
+            mn = blob[pos:pos + 4 * n].view(np.float32); pos += 4 * n
+            mx = blob[pos:pos + 4 * n].view(np.float32); pos += 4 * n
+            obj.levels.append((mn, mx))
+        return obj
+
+    @classmethod
+    def load(cls, path: str) -> "PeakPyramid":
+        data = np.load(path)
+        obj = cls.__new__(cls)
+        obj.sample_rate, obj.base_block, obj.length = (int(x) for x in data["meta"])
+        obj.levels = []
+        i = 0
+        while f"min{i}" in data:
+            obj.levels.append((data[f"min{i}"], data[f"max{i}"]))
+            i += 1
+        return obj
+
+
+# ------------------------------------------------------------------
+# Lista de desenho
+# ------------------------------------------------------------------
+
+@dataclass
+class TimelineDrawList:
+    """
+    Geometria de um frame da timeline, em arrays prontos para a GPU.
+
+    rects:  (n, 4) float32 [x, y, w, h]  + rect_colors (n, 4) RGBA
+    lines:  (m, 2) float32 vértices em pares (LINES)  + line_colors (m, 4)
+    """
+    rects:       np.ndarray = field(default_factory=lambda: np.empty((0, 4), np.float32))
+    rect_colors: np.ndarray = field(default_factory=lambda: np.empty((0, 4), np.float32))
+    lines:       np.ndarray = field(default_factory=lambda: np.empty((0, 2), np.float32))
+    line_colors: np.ndarray = field(default_factory=lambda: np.empty((0, 4), np.float32))
+    clip_count:  int = 0
+    lod:         Dict[str, int] = field(default_factory=dict)
+
+    def rect_triangles(self) -> np.ndarray:
+        """Vértices (6n, 2) para batch_for_shader(shader, 'TRIS', ...)."""
+        if len(self.rects) == 0:
+            return np.empty((0, 2), np.float32)
+        x, y, w, h = self.rects.T
+        quad = np.stack([
+            np.stack([x,     y    ], axis=1), np.stack([x + w, y    ], axis=1),
+            np.stack([x + w, y + h], axis=1), np.stack([x,     y    ], axis=1),
+            np.stack([x + w, y + h], axis=1), np.stack([x,     y + h], axis=1),
+        ], axis=1)
+        return quad.reshape(-1, 2).astype(np.float32)
+
+    def rect_triangle_colors(self) -> np.ndarray:
+        return np.repeat(self.rect_colors, 6, axis=0)
+
+    @property
+    def primitive_count(self) -> int:
+        return len(self.rects) + len(self.lines) // 2
+
+
+class _Builder:
+    """Acumula listas de arrays e concatena uma vez no fim do frame."""
+
+    def __init__(self) -> None:
+        self.rects:  List[np.ndarray] = []
+        self.rcols:  List[np.ndarray] = []
+        self.lines:  List[np.ndarray] = []
+        self.lcols:  List[np.ndarray] = []
+
+    def add_rects(self, rects: np.ndarray, color: Sequence[float]) -> None:
+        if len(rects):
+            self.rects.append(np.asarray(rects, np.float32))
+            self.rcols.append(np.broadcast_to(np.asarray(color, np.float32), (len(rects), 4)))
+
+    def add_rects_colored(self, rects: np.ndarray, colors: np.ndarray) -> None:
+        if len(rects):
+            self.rects.append(np.asarray(rects, np.float32))
+            self.rcols.append(np.asarray(colors, np.float32))
+
+    def add_strip(self, pts: np.ndarray, color: Sequence[float]) -> None:
+        """Polilinha → pares de segmentos (LINES), para caber no mesmo batch."""
+        if len(pts) >= 2:
+            seg = np.empty((2 * (len(pts) - 1), 2), np.float32)
+            seg[0::2] = pts[:-1]
+            seg[1::2] = pts[1:]
+            self.lines.append(seg)
+            self.lcols.append(np.broadcast_to(np.asarray(color, np.float32), (len(seg), 4)))
+
+    def build(self, draw: TimelineDrawList) -> TimelineDrawList:
+        if self.rects:
+            draw.rects = np.concatenate(self.rects)
+            draw.rect_colors = np.concatenate(self.rcols)
+        if self.lines:
+            draw.lines = np.concatenate(self.lines)
+            draw.line_colors = np.concatenate(self.lcols)
+        return draw
+
+
+def _rgba(color: Sequence[float], alpha: float = 1.0) -> Tuple[float, float, float, float]:
+    c = tuple(color)
+    return (c[0], c[1], c[2], c[3] if len(c) > 3 else alpha)
+
+
+# ------------------------------------------------------------------
+# Planejador de LOD
+# ------------------------------------------------------------------
+
+class TimelineLOD:
+    """
+    Monta a TimelineDrawList de um frame.
+
+    Caches (por identidade do objeto, invalidados por contagem):
+        - ClipIntervalIndex por faixa
+        - NoteTable por MidiSequence
+        - PeakPyramid por caminho de áudio (fornecida por 'peaks_provider',
+          que pode carregar de disco/cache de derivados)
+
+    Uso:
+        lod = TimelineLOD(peaks_provider=lambda path: pyramid_or_None)
+        draw = lod.build(timeline.tracks, view, track_height=48, y0=header)
+    """
+
+    def __init__(
+        self,
+        peaks_provider: Optional[Callable[[str], Optional[PeakPyramid]]] = None,
+    ) -> None:
+        self.peaks_provider = peaks_provider
+        self._indexes: Dict[int, Tuple[int, ClipIntervalIndex]] = {}
+        self._notes:   Dict[int, Tuple[int, NoteTable]] = {}
+
+    # -- caches ------------------------------------------------------------
+
+    def index_for(self, track: Any) -> ClipIntervalIndex:
+        """
+        Índice da faixa, reconstruído quando o nº de clips muda. Edições que
+        só movem/redimensionam clips devem chamar invalidate(track).
+        """
+        count = len(track.clips)
+        cached = self._indexes.get(id(track))
+        if cached is None or cached[0] != count:
+            cached = (count, ClipIntervalIndex.from_clips(track.clips))
+            self._indexes[id(track)] = cached
+        return cached[1]
+
+    def notes_for(self, sequence: Any) -> NoteTable:
+        count = len(sequence)
+        cached = self._notes.get(id(sequence))
+        if cached is None or cached[0] != count:
+            cached = (count, NoteTable.from_sequence(sequence))
+            self._notes[id(sequence)] = cached
+        return cached[1]
+
+    def invalidate(self, obj: Any = None) -> None:
+        """Descarta caches (de um objeto, ou todos)."""
+        if obj is None:
+            self._indexes.clear()
+            self._notes.clear()
+        else:
+            self._indexes.pop(id(obj), None)
+            self._notes.pop(id(obj), None)
+
+    # -- frame ---------------------------------------------------------------
+
+    def build(
+        self,
+        tracks:       Sequence[Any],
+        view:         TimelineView,
+        track_height: float = 48.0,
+        y0:           float = 0.0,
+    ) -> TimelineDrawList:
+        draw = TimelineDrawList()
+        out = _Builder()
+        stats = {lvl.value: 0 for lvl in LODLevel}
+
+        for row, track in enumerate(tracks):
+            y = y0 + row * track_height
+            index = self.index_for(track)
+            visible = index.query_indices(view.start, view.end)
+            if len(visible) == 0:
+                continue
+
+            # Clips sub-pixel nunca viram objetos Python: são fundidos direto
+            # dos arrays do índice. Os largos são no máximo width/MIN_CLIP_PX.
+            widths = (index.ends[visible] - index.starts[visible]) * view.pps
+            tiny = visible[widths < MIN_CLIP_PX]
+            if len(tiny):
+                stats[LODLevel.OVERVIEW.value] += len(tiny)
+                self._draw_merged(out, index, tiny, view, y, track_height)
+
+            for i in visible[widths >= MIN_CLIP_PX]:
+                clip = index.item(i)
+                w_px = clip.duration * view.pps
+                draw.clip_count += 1
+                x = view.time_to_x(clip.start)
+                # Caixa do clip recortada às bordas (evita x negativos enormes)
+                cx0 = max(x, view.x0 - 1)
+                cx1 = min(x + w_px, view.x0 + view.width + 1)
+                out.add_rects(np.array([[cx0, y + 1, cx1 - cx0, track_height - 2]]),
+                              _rgba(clip.color, 0.35))
+
+                if w_px < MIN_CONTENT_PX:
+                    stats[LODLevel.OVERVIEW.value] += 1
+                    continue
+                level = self._draw_content(out, clip, view, y, track_height)
+                stats[level.value] += 1
+
+        draw.lod = stats
+        return out.build(draw)
+
+    def _draw_merged(self, out: _Builder, index: ClipIntervalIndex, idx: np.ndarray,
+                     view: TimelineView, y: float, h: float) -> None:
+        """Funde clips sub-pixel numa barra por run de colunas ocupadas."""
+        starts = index.starts[idx]
+        ends = index.ends[idx]
+        c0 = np.clip(view.columns(starts), 0, view.width)
+        c1 = np.clip(view.columns(ends), 0, view.width)
+        occupied = np.zeros(view.width + 2, np.int32)
+        np.add.at(occupied, c0, 1)
+        np.add.at(occupied, c1 + 1, -1)
+        mask = np.cumsum(occupied)[: view.width + 1] > 0
+        # Runs contíguos de colunas ocupadas → um retângulo cada
+        edges = np.diff(np.r_[0, mask.astype(np.int8), 0])
+        run_start = np.flatnonzero(edges == 1)
+        run_end = np.flatnonzero(edges == -1)
+        rects = np.empty((len(run_start), 4), np.float32)
+        rects[:, 0] = view.x0 + run_start
+        rects[:, 1] = y + 1
+        rects[:, 2] = run_end - run_start
+        rects[:, 3] = h - 2
+        out.add_rects(rects, _rgba(index.item(int(idx[0])).color, 0.6))
+
+    def _draw_content(self, out: _Builder, clip: Any, view: TimelineView,
+                      y: float, h: float) -> LODLevel:
+        data = clip.data
+        ctype = getattr(clip, "type", None)
+
+        if ctype == ClipType.MIDI and data is not None and hasattr(data, "get_notes"):
+            return self._draw_midi(out, clip, self.notes_for(data), view, y, h)
+
+        if hasattr(data, "points"):                  # AutomationCurve
+            return self._draw_curve(out, clip, data, view, y, h)
+        if hasattr(data, "curves"):                  # AutomationClip
+            level = LODLevel.OVERVIEW
+            for curve in data.curves:
+                level = self._draw_curve(out, clip, curve, view, y, h)
+            return level
+
+        if ctype == ClipType.AUDIO and isinstance(data, str) and self.peaks_provider:
+            pyramid = self.peaks_provider(data)
+            if pyramid is not None:
+                return self._draw_peaks(out, clip, pyramid, view, y, h)
+
+        return LODLevel.OVERVIEW
+
+    def _draw_midi(self, out: _Builder, clip: Any, table: NoteTable,
+                   view: TimelineView, y: float, h: float) -> LODLevel:
+        if len(table) == 0:
+            return LODLevel.OVERVIEW
+
+        t0 = max(view.start, clip.start) - clip.start
+        t1 = min(view.end, clip.end) - clip.start
+        idx = table.visible(t0, t1)
+        if len(idx) == 0:
+            return LODLevel.OVERVIEW
+
+        p_lo = int(table.pitches.min())
+        p_hi = int(table.pitches.max())
+        row_h = (h - 4) / max(1, p_hi - p_lo + 1)
+        color = _rgba(clip.color, 0.95)
+
+        detailed = (
+            table.mean_length * view.pps >= DETAIL_NOTE_PX
+            and len(idx) <= MAX_NOTES_PER_PX * view.width
+        )
+        if detailed:
+            rects = np.empty((len(idx), 4), np.float32)
+            rects[:, 0] = view.x0 + (table.starts[idx] + clip.start - view.start) * view.pps
+            rects[:, 1] = y + 2 + (table.pitches[idx] - p_lo) * row_h
+            ends = np.minimum(table.ends[idx], clip.duration)
+            rects[:, 2] = np.maximum(1.0, (ends - table.starts[idx]) * view.pps)
+            rects[:, 3] = max(1.0, row_h)
+            out.add_rects(rects, color)
+            return LODLevel.DETAIL
+
+        blocks = midi_density_blocks(table, clip.start, view, clip.end)
+        rects = np.empty((len(blocks), 4), np.float32)
+        rects[:, 0] = blocks[:, 0]
+        rects[:, 1] = y + 2 + (blocks[:, 1] - p_lo) * row_h
+        rects[:, 2] = DENSITY_BLOCK_PX
+        rects[:, 3] = np.maximum(1.0, (blocks[:, 2] - blocks[:, 1] + 1) * row_h)
+        colors = np.empty((len(blocks), 4), np.float32)
+        colors[:, :3] = color[:3]
+        colors[:, 3] = 0.3 + 0.7 * blocks[:, 3]
+        out.add_rects_colored(rects, colors)
+        return LODLevel.SUMMARY
+
+    def _draw_curve(self, out: _Builder, clip: Any, curve: Any,
+                    view: TimelineView, y: float, h: float) -> LODLevel:
+        times, values = curve_arrays(curve)
+        if len(times) == 0:
+            return LODLevel.OVERVIEW
+        times = times + clip.start
+        t, v = decimate_polyline(times, values, view)
+
+        span = (curve.max_val - curve.min_val) or 1.0
+        pts = np.empty((len(t), 2), np.float32)
+        pts[:, 0] = view.x0 + (t - view.start) * view.pps
+        pts[:, 1] = y + 2 + (v - curve.min_val) / span * (h - 4)
+        out.add_strip(pts, _rgba(clip.color, 1.0))
+        return LODLevel.DETAIL if len(t) == len(times) else LODLevel.SUMMARY
+
+    def _draw_peaks(self, out: _Builder, clip: Any, pyramid: PeakPyramid,
+                    view: TimelineView, y: float, h: float) -> LODLevel:
+        col0, mins, maxs = pyramid.query(clip.start, view, getattr(clip, "offset", 0.0))
+        if len(mins) == 0:
+            return LODLevel.OVERVIEW
+        mid = y + h * 0.5
+        half = (h - 4) * 0.5
+        rects = np.empty((len(mins), 4), np.float32)
+        rects[:, 0] = view.x0 + col0 + np.arange(len(mins))
+        rects[:, 1] = mid + np.clip(mins, -1.0, 1.0) * half
+        rects[:, 2] = 1.0
+        rects[:, 3] = np.maximum(1.0, (np.clip(maxs, -1.0, 1.0) - np.clip(mins, -1.0, 1.0)) * half)
+        out.add_rects(rects, _rgba(clip.color, 0.9))
+        return LODLevel.DETAIL if pyramid.level_for(pyramid.sample_rate / view.pps) == 0 else LODLevel.SUMMARY
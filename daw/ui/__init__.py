@@ -1 +1 @@
-from . import panels, workspace, piano_roll
+from . import panels, workspace, piano_roll, spectrum
@@ -127,6 +127,7 @@ class DAW_PT_MixerPanel(bpy.types.Panel):
         box = layout.box()
         box.label(text="Master Bus")
         box.prop(props, "master_volume", text="Volume", slider=True)
+        box.prop(props, "show_spectrum", icon='SEQ_HISTOGRAM')
 
         layout.separator()
         layout.label(text="Tracks virão aqui...")
@@ -19,6 +19,8 @@ from gpu_extras.batch import batch_for_shader
 from bpy.props import (FloatProperty, IntProperty, BoolProperty,
                        EnumProperty, CollectionProperty, StringProperty)
 
+from ..modules.playlist.snapping import SNAP, LEVEL_BAR, LEVEL_BEAT, LEVEL_SUB
+
 # ─── Layout ───────────────────────────────────────────────────
 PIANO_W     = 56
 TOOLBAR_H   = 34
@@ -310,6 +312,14 @@ def _line(x1,y1,x2,y2,col):
     s=_sh(); b=batch_for_shader(s,'LINES',{"pos":[(x1,y1),(x2,y2)]})
     s.uniform_float("color",col); b.draw(s)
 
+def _vlines(xs,y1,y2,col):
+    # Todas as linhas verticais de uma cor num único batch
+    if not len(xs): return
+    pos=[]
+    for x in xs: pos.append((x,y1)); pos.append((x,y2))
+    s=_sh(); b=batch_for_shader(s,'LINES',{"pos":pos})
+    s.uniform_float("color",col); b.draw(s)
+
 def _tri(pts,col):
     s=_sh(); b=batch_for_shader(s,'TRIS',{"pos":pts})
     s.uniform_float("color",col); b.draw(s)
@@ -360,18 +370,12 @@ def _draw_piano_roll(context):
         _rect(gx, ny, gw, note_h-0.5, col)
         if note%12==0: _line(gx, ny+note_h, gx+gw, ny+note_h, C['octave'])
 
-    # Grid vertical
-    b = 0
-    while True:
-        bx = gx + b*beat_w - (state.scroll_x%snap)*beat_w
-        if bx > gx+gw: break
-        beat_abs = state.scroll_x + b*snap
-        is_bar = abs(beat_abs%4) < 0.001
-        if bx >= gx:
-            col = C['grid_bar'] if is_bar else (C['grid_beat'] if abs(beat_abs%1)<0.001 else C['grid'])
-            _line(bx, gy, bx, gy+gh, col)
-        b += 1
-        if b > 4000: break
+    # Grid vertical — linhas pré-calculadas pelo SnapGrid compartilhado
+    beat_end = state.scroll_x + gw/beat_w
+    g_beats, g_lvls = SNAP.grid.lines(state.scroll_x, beat_end, snap, beat_w)
+    g_x = gx + (g_beats - state.scroll_x)*beat_w
+    for lvl, key in ((LEVEL_SUB,'grid'), (LEVEL_BEAT,'grid_beat'), (LEVEL_BAR,'grid_bar')):
+        _vlines(g_x[g_lvls==lvl].tolist(), gy, gy+gh, C[key])
 
     # Notas MIDI
     notes = _get_active_notes(state)
@@ -417,18 +421,12 @@ def _draw_piano_roll(context):
 
     # Header
     _rect(0, hdr_y, W, HEADER_H, C['header'])
-    b = 0
-    while True:
-        bx = gx + b*beat_w - (state.scroll_x%1)*beat_w
-        if bx > gx+gw: break
-        beat_abs = state.scroll_x + b
-        if bx>=gx and abs(beat_abs%4)<0.001:
-            _txt(str(int(beat_abs/4)+1), bx+3, hdr_y+6, 11, C['header_bar'])
-            _line(bx, hdr_y, bx, hdr_y+HEADER_H, C['grid_bar'])
-        elif bx>=gx and abs(beat_abs%1)<0.001:
-            _line(bx, hdr_y, bx, hdr_y+HEADER_H//2, C['grid'])
-        b += 1
-        if b > 4000: break
+    h_beats, h_lvls = SNAP.grid.lines(state.scroll_x, beat_end, 1.0, beat_w)
+    h_x = gx + (h_beats - state.scroll_x)*beat_w
+    _vlines(h_x[h_lvls==LEVEL_BAR].tolist(),  hdr_y, hdr_y+HEADER_H,    C['grid_bar'])
+    _vlines(h_x[h_lvls==LEVEL_BEAT].tolist(), hdr_y, hdr_y+HEADER_H//2, C['grid'])
+    for bar_beat, bar_no in SNAP.grid.bar_labels(state.scroll_x, beat_end, beat_w):
+        _txt(str(bar_no), gx + (bar_beat - state.scroll_x)*beat_w + 3, hdr_y+6, 11, C['header_bar'])
     if gx <= ph_x <= gx+gw:
         _rect(ph_x-1, hdr_y, 2, HEADER_H, C['playhead'])
 
@@ -543,7 +541,7 @@ class DAW_OT_PianoRollModal(bpy.types.Operator):
         return top - int((L['grid_y']+L['grid_h']-y)/nh)
 
     def _snap(self,beat,state):
-        s=float(state.snap_mode); return round(beat/s)*s
+        return SNAP.snap_beat(beat, float(state.snap_mode), px_per_beat=BEAT_W_BASE*state.zoom_x)
 
     def _in_grid(self,mx,my,region,state):
         L=_layout(region.width,region.height,state)
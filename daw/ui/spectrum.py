@@ -0,0 +1,141 @@
+"""
+ui/spectrum.py — Analisador de espectro no Node Editor (área do Mixer)
+
+- Lê o espectro publicado pela engine no StateBlock (get_state().spectrum):
+  array fixo (slots, bandas) já em 0–1. FFT, bandas log e suavização
+  são feitas na engine (daw_engine/audio/spectrum.py) — aqui não há conta
+  por banda em Python.
+- Todas as barras de todos os slots viram UM array de vértices (numpy) e
+  UM batch_for_shader / draw por redraw.
+- Slot 0 = master (por cima); 1… = faixas escolhidas com analyze_track().
+"""
+
+import bpy
+import gpu
+import numpy as np
+from gpu_extras.batch import batch_for_shader
+
+# ═══════════════════════════════════════════════════════════════
+#  CONSTANTES DE LAYOUT
+# ═══════════════════════════════════════════════════════════════
+
+PANEL_H   = 140
+MARGIN    = 12
+BAR_GAP   = 0.15   # fração da largura da banda sem barra
+
+# Master primeiro; canais com alpha menor (desenhados por baixo)
+SLOT_COLORS = np.array([
+    (0.820, 0.380, 0.120, 0.90),   # master — laranja FL
+    (0.200, 0.750, 0.900, 0.55),
+    (0.550, 0.850, 0.200, 0.55),
+    (0.700, 0.300, 0.900, 0.55),
+], dtype=np.float32)
+BG_COLOR = np.array((0.060, 0.062, 0.090, 0.85), dtype=np.float32)
+
+# ═══════════════════════════════════════════════════════════════
+#  GEOMETRIA (numpy, sem chamadas por barra)
+# ═══════════════════════════════════════════════════════════════
+
+def spectrum_geometry(levels, x, y, w, h):
+    """
+    levels (slots, bandas) 0–1 → (pos (n, 2), color (n, 4)) float32 para
+    batch_for_shader(shader, 'TRIS', ...). Fundo + uma barra por banda e
+    slot; slots altos primeiro, master por último (fica por cima).
+    """
+    slots, bands = levels.shape
+    bw = w / bands
+    x0 = x + np.arange(bands, dtype=np.float32) * bw + bw * BAR_GAP * 0.5
+    x1 = x0 + bw * (1.0 - BAR_GAP)
+    order = np.arange(slots)[::-1]
+    top = y + levels[order] * h                                 # (slots, bandas)
+    xs0 = np.broadcast_to(x0, top.shape)
+    xs1 = np.broadcast_to(x1, top.shape)
+    ys0 = np.full_like(top, y)
+    quad = np.stack([
+        np.stack([xs0, ys0], -1), np.stack([xs1, ys0], -1), np.stack([xs1, top], -1),
+        np.stack([xs0, ys0], -1), np.stack([xs1, top], -1), np.stack([xs0, top], -1),
+    ], axis=2)                                                  # (slots, bandas, 6, 2)
+    bg = np.array([(x, y), (x + w, y), (x + w, y + h),
+                   (x, y), (x + w, y + h), (x, y + h)], dtype=np.float32)
+    pos = np.concatenate([bg, quad.reshape(-1, 2).astype(np.float32)])
+    cols = np.repeat(SLOT_COLORS[order % len(SLOT_COLORS)], bands * 6, axis=0)
+    color = np.concatenate([np.broadcast_to(BG_COLOR, (6, 4)), cols])
+    return pos, color
+
+# ═══════════════════════════════════════════════════════════════
+#  DRAW HANDLER
+# ═══════════════════════════════════════════════════════════════
+
+_shader  = None
+_handle  = None
+
+
+def _sh():
+    global _shader
+    if _shader is None:
+        _shader = gpu.shader.from_builtin('FLAT_COLOR')
+    return _shader
+
+
+def _levels():
+    try:
+        from ..core.register import get_engine
+        e = get_engine()
+        s = e.get_state() if e else None
+        return s.spectrum if s is not None else None
+    except Exception:
+        return None
+
+
+def _draw_spectrum():
+    context = bpy.context
+    props = getattr(context.scene, "daw", None)
+    if props is None or not props.show_spectrum:
+        return
+    levels = _levels()
+    if levels is None:
+        return
+    region = context.region
+    w = region.width - 2 * MARGIN
+    if w <= 0:
+        return
+    pos, color = spectrum_geometry(np.asarray(levels, np.float32), MARGIN, MARGIN, w, PANEL_H)
+    s = _sh()
+    batch = batch_for_shader(s, 'TRIS', {"pos": pos, "color": color})
+    gpu.state.blend_set('ALPHA')
+    batch.draw(s)
+    gpu.state.blend_set('NONE')
+
+
+def _spectrum_redraw():
+    try:
+        scene = bpy.context.scene
+        if scene is None or not scene.daw.show_spectrum:
+            return 0.25
+        for w in bpy.context.window_manager.windows:
+            for a in w.screen.areas:
+                if a.type == 'NODE_EDITOR': a.tag_redraw()
+    except Exception: pass
+    return 1/30
+
+# ═══════════════════════════════════════════════════════════════
+#  REGISTRO
+# ═══════════════════════════════════════════════════════════════
+
+def register():
+    global _handle
+    if _handle is None:
+        _handle = bpy.types.SpaceNodeEditor.draw_handler_add(
+            _draw_spectrum, (), 'WINDOW', 'POST_PIXEL')
+    if not bpy.app.timers.is_registered(_spectrum_redraw):
+        bpy.app.timers.register(_spectrum_redraw, persistent=True)
+
+
+def unregister():
+    global _handle
+    if bpy.app.timers.is_registered(_spectrum_redraw):
+        bpy.app.timers.unregister(_spectrum_redraw)
+    if _handle is not None:
+        try: bpy.types.SpaceNodeEditor.draw_handler_remove(_handle, 'WINDOW')
+        except Exception: pass
+        _handle = None